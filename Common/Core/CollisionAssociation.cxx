@@ -18,3 +18,198 @@
 /// \author Maurice Coquet <maurice.louis.coquet@cern.ch>, CEA-Saclay/Irfu
 
 #include "Common/Core/CollisionAssociation.h" // IWYU pragma: keep
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace o2::aod::track_association;
+
+void TimeCompatSweep::clear()
+{
+  mCollBC.clear();
+  mCollTime.clear();
+  mCollTimeRes2.clear();
+  mTrackBCWindow.clear();
+  mTrackBC.clear();
+  mTrackTime.clear();
+  mTrackTimeRes.clear();
+  mTrackMode.clear();
+  mTrackFilteredIndex.clear();
+  mTrackGlobalIndex.clear();
+  mPairs.clear();
+  mCollOffsets.clear();
+  mCollIds.clear();
+}
+
+void TimeCompatSweep::reserve(std::size_t nCollisions, std::size_t nTracks)
+{
+  mCollBC.reserve(nCollisions);
+  mCollTime.reserve(nCollisions);
+  mCollTimeRes2.reserve(nCollisions);
+  mTrackBCWindow.reserve(nTracks);
+  mTrackBC.reserve(nTracks);
+  mTrackTime.reserve(nTracks);
+  mTrackTimeRes.reserve(nTracks);
+  mTrackMode.reserve(nTracks);
+  mTrackFilteredIndex.reserve(nTracks);
+  mTrackGlobalIndex.reserve(nTracks);
+}
+
+void TimeCompatSweep::addCollision(int64_t bc, float time, float timeRes)
+{
+  mCollBC.push_back(bc);
+  mCollTime.push_back(time);
+  mCollTimeRes2.push_back(timeRes * timeRes);
+}
+
+void TimeCompatSweep::addTrack(int globalIndex, int filteredIndex, int64_t bc, int64_t bcWindow, float time, float timeRes, TimeCompatMode mode)
+{
+  mTrackGlobalIndex.push_back(globalIndex);
+  mTrackFilteredIndex.push_back(filteredIndex);
+  mTrackBC.push_back(bc);
+  mTrackBCWindow.push_back(bcWindow);
+  mTrackTime.push_back(time);
+  mTrackTimeRes.push_back(timeRes);
+  mTrackMode.push_back(mode);
+}
+
+void TimeCompatSweep::sortTracks()
+{
+  // tracks are mostly ordered already (they follow the collisions), so this is cheap
+  const std::size_t nTracks = mTrackBCWindow.size();
+  std::vector<std::size_t> order(nTracks);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return mTrackBCWindow[a] < mTrackBCWindow[b]; });
+
+  auto permute = [&order, nTracks](auto& column) {
+    std::remove_reference_t<decltype(column)> sorted(nTracks);
+    for (std::size_t i = 0; i < nTracks; i++) {
+      sorted[i] = column[order[i]];
+    }
+    column.swap(sorted);
+  };
+  permute(mTrackBCWindow);
+  permute(mTrackBC);
+  permute(mTrackTime);
+  permute(mTrackTimeRes);
+  permute(mTrackMode);
+  permute(mTrackFilteredIndex);
+  permute(mTrackGlobalIndex);
+}
+
+void TimeCompatSweep::runChunk(std::size_t collBegin, std::size_t collEnd, int64_t bcOffsetMax, float nSigma, float timeMargin, std::vector<std::pair<int, int>>& pairs) const
+{
+  pairs.clear();
+  if (collBegin >= collEnd) {
+    return;
+  }
+  const std::size_t nTracks = mTrackBCWindow.size();
+  std::vector<std::size_t> compatibleTracks;
+
+  // two-pointer sweep: the lower edge of the BC window only moves forward as long as collisions are ordered in BC
+  int64_t lastLowBC = mCollBC[collBegin] - bcOffsetMax;
+  std::size_t first = std::lower_bound(mTrackBCWindow.begin(), mTrackBCWindow.end(), lastLowBC) - mTrackBCWindow.begin();
+  for (std::size_t iColl = collBegin; iColl < collEnd; iColl++) {
+    const int64_t collBC = mCollBC[iColl];
+    const float collTime = mCollTime[iColl];
+    const float collTimeRes2 = mCollTimeRes2[iColl];
+    const int64_t lowBC = collBC - bcOffsetMax;
+    const int64_t highBC = collBC + bcOffsetMax;
+    if (lowBC < lastLowBC) {
+      first = std::lower_bound(mTrackBCWindow.begin(), mTrackBCWindow.end(), lowBC) - mTrackBCWindow.begin();
+    } else {
+      while (first < nTracks && mTrackBCWindow[first] < lowBC) {
+        first++;
+      }
+    }
+    lastLowBC = lowBC;
+
+    compatibleTracks.clear();
+    for (std::size_t iTrack = first; iTrack < nTracks && mTrackBCWindow[iTrack] <= highBC; iTrack++) {
+      const int64_t bcOffset = mTrackBC[iTrack] - collBC;
+      const float deltaTime = mTrackTime[iTrack] - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
+      const float trackTimeRes = mTrackTimeRes[iTrack];
+      float thresholdTime = 0.;
+      switch (mTrackMode[iTrack]) {
+        case TimeCompatMode::PvContributor:
+          thresholdTime = trackTimeRes;
+          break;
+        case TimeCompatMode::TimeResIsRange:
+          thresholdTime = trackTimeRes + nSigma * std::sqrt(collTimeRes2) + timeMargin;
+          break;
+        case TimeCompatMode::TimeResIsGaussian: {
+          float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
+          thresholdTime = nSigma * std::sqrt(sigmaTimeRes2) + timeMargin;
+          break;
+        }
+      }
+      if (std::abs(deltaTime) < thresholdTime) {
+        compatibleTracks.push_back(iTrack);
+      }
+    }
+
+    // keep the order of the input track table within each collision
+    std::sort(compatibleTracks.begin(), compatibleTracks.end(), [this](std::size_t a, std::size_t b) { return mTrackFilteredIndex[a] < mTrackFilteredIndex[b]; });
+    for (const auto& iTrack : compatibleTracks) {
+      pairs.emplace_back(static_cast<int>(iColl), mTrackGlobalIndex[iTrack]);
+    }
+  }
+}
+
+void TimeCompatSweep::run(int64_t bcOffsetMax, float nSigma, float timeMargin, int nThreads)
+{
+  sortTracks();
+
+  const std::size_t nCollisions = mCollBC.size();
+  std::size_t nChunks = std::max<std::size_t>(1, std::min<std::size_t>(std::max(nThreads, 1), nCollisions / MinCollisionsPerChunk));
+  const std::size_t chunkSize = (nCollisions + nChunks - 1) / nChunks;
+  mChunkPairs.resize(nChunks);
+
+  auto processChunk = [&](std::size_t iChunk) {
+    const std::size_t collBegin = std::min(iChunk * chunkSize, nCollisions);
+    const std::size_t collEnd = std::min(collBegin + chunkSize, nCollisions);
+    runChunk(collBegin, collEnd, bcOffsetMax, nSigma, timeMargin, mChunkPairs[iChunk]);
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(nChunks - 1);
+  for (std::size_t iChunk = 1; iChunk < nChunks; iChunk++) {
+    workers.emplace_back(processChunk, iChunk);
+  }
+  processChunk(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  std::size_t nPairs = 0;
+  for (const auto& chunkPairs : mChunkPairs) {
+    nPairs += chunkPairs.size();
+  }
+  mPairs.clear();
+  mPairs.reserve(nPairs);
+  for (const auto& chunkPairs : mChunkPairs) {
+    mPairs.insert(mPairs.end(), chunkPairs.begin(), chunkPairs.end());
+  }
+}
+
+void TimeCompatSweep::buildCollisionsPerTrack(std::size_t nTracks)
+{
+  // counting pass followed by a prefix sum: collisions of a track stay in collision order
+  mCollOffsets.assign(nTracks + 1, 0);
+  for (const auto& [collIdx, trackIdx] : mPairs) {
+    mCollOffsets[trackIdx + 1]++;
+  }
+  std::partial_sum(mCollOffsets.begin(), mCollOffsets.end(), mCollOffsets.begin());
+  mCollIds.resize(mPairs.size());
+  std::vector<int> fillPosition(mCollOffsets.begin(), mCollOffsets.end() - 1);
+  for (const auto& [collIdx, trackIdx] : mPairs) {
+    mCollIds[fillPosition[trackIdx]++] = collIdx;
+  }
+}
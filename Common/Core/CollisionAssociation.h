@@ -28,9 +28,9 @@
 #include <Rtypes.h>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
-#include <memory>
 #include <utility>
 #include <vector>
 
@@ -52,6 +52,61 @@ enum PVContrReassocOpt {
   SameBcAndLowMult = 2
 };
 
+/// Threshold model for the time compatibility of a track with a collision
+enum TimeCompatMode : uint8_t {
+  PvContributor = 0, // track time taken from its own vertex, 1 BC resolution
+  TimeResIsRange,    // track time resolution is a range
+  TimeResIsGaussian  // track time resolution is a gaussian sigma
+};
+
+/// Sweep-line engine for the time-based track-to-collision association
+/// Collisions and tracks are stored in flat arrays, tracks are sorted by their
+/// BC once and each collision only visits the tracks inside its BC window.
+/// The collision list is split into contiguous chunks processed in parallel.
+/// The output is ordered by collision index and, for each collision, by the
+/// position of the track in the (filtered) input table.
+class TimeCompatSweep
+{
+ public:
+  void clear();
+  void reserve(std::size_t nCollisions, std::size_t nTracks);
+  void addCollision(int64_t bc, float time, float timeRes);
+  void addTrack(int globalIndex, int filteredIndex, int64_t bc, int64_t bcWindow, float time, float timeRes, TimeCompatMode mode);
+
+  /// find all compatible (collision, track) pairs
+  void run(int64_t bcOffsetMax, float nSigma, float timeMargin, int nThreads = 1);
+  /// build the track -> compatible collisions index in CSR form
+  void buildCollisionsPerTrack(std::size_t nTracks);
+
+  std::vector<std::pair<int, int>> const& pairs() const { return mPairs; }     // (collision index, track global index)
+  std::vector<int> const& collsPerTrackOffsets() const { return mCollOffsets; } // nTracks + 1 entries
+  std::vector<int> const& collsPerTrackIds() const { return mCollIds; }
+
+ private:
+  void sortTracks();
+  void runChunk(std::size_t collBegin, std::size_t collEnd, int64_t bcOffsetMax, float nSigma, float timeMargin, std::vector<std::pair<int, int>>& pairs) const;
+
+  static constexpr std::size_t MinCollisionsPerChunk{32};
+
+  // collisions, in index order
+  std::vector<int64_t> mCollBC;
+  std::vector<float> mCollTime;
+  std::vector<float> mCollTimeRes2;
+  // tracks, sorted by window BC after sortTracks()
+  std::vector<int64_t> mTrackBCWindow;
+  std::vector<int64_t> mTrackBC;
+  std::vector<float> mTrackTime;
+  std::vector<float> mTrackTimeRes;
+  std::vector<TimeCompatMode> mTrackMode;
+  std::vector<int> mTrackFilteredIndex;
+  std::vector<int> mTrackGlobalIndex;
+  // output
+  std::vector<std::vector<std::pair<int, int>>> mChunkPairs;
+  std::vector<std::pair<int, int>> mPairs;
+  std::vector<int> mCollOffsets;
+  std::vector<int> mCollIds;
+};
+
 } // namespace track_association
 } // namespace o2::aod
 
@@ -70,6 +125,7 @@ class CollisionAssociation
   void setFillTableOfCollIdsPerTrack(bool fill = true) { mFillTableOfCollIdsPerTrack = fill; }
   void setBcWindow(int bcWindow = 115) { mBcWindowForOneSigma = bcWindow; }
   void setMaxPvContributorsForLowMultReassoc(int pvContributorsMax) { mMaxPvContributorsForLowMultReassoc = pvContributorsMax; }
+  void setNumThreads(int nThreads) { mNumThreads = nThreads; }
 
   template <typename TTracks, typename Slice, typename Assoc, typename RevIndices>
   void runStandardAssoc(o2::aod::Collisions const& collisions,
@@ -139,172 +195,97 @@ class CollisionAssociation
                         Assoc& association,
                         RevIndices& reverseIndices)
   {
-    // cache globalBC and track time in BC for optimization
-    std::vector<int64_t> globalBC;
-    std::vector<int64_t> trackBCCache;
-    std::vector<std::pair<typename TTracks::iterator, typename TTracks::iterator>> trackIterationWindows; // continous regions in which we can count on increasing globalBC numbers
-    globalBC.reserve(tracks.size());
-    trackBCCache.reserve(tracks.size());
-    auto trackBegin = tracks.begin();
-    int lastCollisionId = 0;
-    if (tracks.size() > 0) {
-      lastCollisionId = trackBegin.collisionId();
-    }
-    auto track = trackBegin;
-    for (; track != tracks.end(); ++track) {
-      int64_t trackBC = -1;
-      if (track.has_collision()) {
-        trackBC = track.collision().bc().globalBC();
-      } else if (mIncludeUnassigned) {
-        for (const auto& ambTrack : ambiguousTracks) {
-          if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
-            if (ambTrack.trackId() == track.globalIndex()) {
-              // special check to avoid crashes (in particular on some MC datasets)
-              // related to shifts in ambiguous tracks association to bc slices (off by 1) - see https://mattermost.web.cern.ch/alice/pl/g9yaaf3tn3g4pgn7c1yex9copy
-              if (ambTrack.bcIds()[0] >= bcs.size() || ambTrack.bcIds()[1] >= bcs.size()) {
-                break;
-              }
-              if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
-                break;
-              }
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          } else {
-            if (ambTrack.template getId<TTracks>() == track.globalIndex()) {
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          }
+    // BC of the ambiguous tracks, looked up once per TF rather than once per track
+    std::vector<int64_t> ambiguousTrackBC;
+    if (mIncludeUnassigned) {
+      ambiguousTrackBC.assign(tracksUnfiltered.size(), -1);
+      std::vector<bool> isAmbiguousTrackSeen(tracksUnfiltered.size(), false);
+      for (const auto& ambTrack : ambiguousTracks) {
+        int64_t trackId = -1;
+        if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
+          trackId = ambTrack.trackId();
+        } else {
+          trackId = ambTrack.template getId<TTracks>();
         }
-      }
-      globalBC.push_back(trackBC);
-      trackBCCache.push_back(trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS);
-      // find uniform blocks
-      if ((track.collisionId() < lastCollisionId) || (lastCollisionId < 0 && track.collisionId() >= 0)) {
-        if (lastCollisionId >= 0 || mIncludeUnassigned) {
-          LOGP(debug, "Found track block from {} to {}, current id {}, last id {}", trackBegin.filteredIndex(), track.filteredIndex() - 1, track.collisionId(), lastCollisionId);
-          trackIterationWindows.push_back(std::make_pair(trackBegin, track));
+        if (trackId < 0 || trackId >= static_cast<int64_t>(ambiguousTrackBC.size()) || isAmbiguousTrackSeen[trackId]) {
+          continue;
         }
-        trackBegin = track;
-      }
-      lastCollisionId = track.collisionId();
-    }
-    // trackIterationWindows.push_back(std::make_pair(trackBegin, tracks.end()));
-    if (lastCollisionId >= 0 || mIncludeUnassigned) {
-      LOGP(debug, "Found track block from {} to {}", trackBegin.filteredIndex(), tracks.size() - 1);
-      trackIterationWindows.push_back(std::make_pair(trackBegin, track));
-    }
-
-    // define vector of vectors to store indices of compatible collisions per track
-    std::vector<std::unique_ptr<std::vector<int>>> collsPerTrack(tracksUnfiltered.size());
-
-    // loop over collisions to find time-compatible tracks
-    int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
-    for (const auto& collision : collisions) {
-      const float collTime = collision.collisionTime();
-      const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
-      uint64_t collBC = collision.bc().globalBC();
-
-      // This is done per block to allow optimization below. Within each block the globalBC increase continously
-      for (auto& iterationWindow : trackIterationWindows) { // o2-linter: disable=const-ref-in-for-loop (iterationWindow is modified)
-        bool iteratorMoved = false;
-        const bool isAssignedTrackWindow = (iterationWindow.first != iterationWindow.second) ? iterationWindow.first.has_collision() : false;
-        for (auto trackInWindow = iterationWindow.first; trackInWindow != iterationWindow.second; ++trackInWindow) {
-          int64_t trackBC = globalBC[trackInWindow.filteredIndex()];
-          if (trackBC < 0) {
+        isAmbiguousTrackSeen[trackId] = true; // only the first entry of a track is considered
+        if constexpr (isCentralBarrel) {
+          // special check to avoid crashes (in particular on some MC datasets)
+          // related to shifts in ambiguous tracks association to bc slices (off by 1) - see https://mattermost.web.cern.ch/alice/pl/g9yaaf3tn3g4pgn7c1yex9copy
+          if (ambTrack.bcIds()[0] >= bcs.size() || ambTrack.bcIds()[1] >= bcs.size()) {
             continue;
           }
-
-          // Optimization to avoid looping over the full track list each time. This builds on that tracks are sorted by BCs (which they should be because collisions are sorted by BCs)
-          const int64_t bcOffset = trackBC - static_cast<int64_t>(collBC);
-          if constexpr (isCentralBarrel) {
-            // only for blocks with collision association
-            if (isAssignedTrackWindow) {
-              constexpr int margin = 200;
-              if (!iteratorMoved && bcOffset > -bcOffsetMax - margin) {
-                iterationWindow.first.setCursor(trackInWindow.filteredIndex());
-                iteratorMoved = true;
-                LOGP(debug, "Moving iterator begin {}", trackInWindow.filteredIndex());
-              } else if (bcOffset > bcOffsetMax + margin) {
-                LOGP(debug, "Stopping iterator {}", trackInWindow.filteredIndex());
-                break;
-              }
-            }
-          }
-
-          int64_t bcOffsetWindow = trackBCCache[trackInWindow.filteredIndex()] - static_cast<int64_t>(collBC);
-          if (std::abs(bcOffsetWindow) > bcOffsetMax) {
+          if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
             continue;
           }
+        }
+        ambiguousTrackBC[trackId] = ambTrack.bc().begin().globalBC();
+      }
+    }
 
-          float trackTime = 0;
-          float trackTimeRes = 0;
-          if constexpr (isCentralBarrel) {
-            if ((mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::OnlySameBc && trackInWindow.isPVContributor()) || (mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::SameBcAndLowMult && trackInWindow.isPVContributor() && trackInWindow.collision().numContrib() > mMaxPvContributorsForLowMultReassoc)) {
-              trackTime = trackInWindow.collision().collisionTime(); // if PV contributor, we assume the time to be the one of the collision
-              trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS;  // 1 BC
-            } else {
-              trackTime = trackInWindow.trackTime();
-              trackTimeRes = trackInWindow.trackTimeRes();
-            }
-          } else {
-            trackTime = trackInWindow.trackTime();
-            trackTimeRes = trackInWindow.trackTimeRes();
-          }
-
-          const float deltaTime = trackTime - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
-          float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
-          LOGP(debug, "collision time={}, collision time res={}, track time={}, track time res={}, bc collision={}, bc track={}, delta time={}", collTime, collision.collisionTimeRes(), trackInWindow.trackTime(), trackInWindow.trackTimeRes(), collBC, trackBC, deltaTime);
+    mSweep.clear();
+    mSweep.reserve(collisions.size(), tracks.size());
+    for (const auto& collision : collisions) {
+      mSweep.addCollision(static_cast<int64_t>(collision.bc().globalBC()), collision.collisionTime(), collision.collisionTimeRes());
+    }
 
-          float thresholdTime = 0.;
-          if constexpr (isCentralBarrel) {
-            if ((mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::OnlySameBc && trackInWindow.isPVContributor()) || (mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::SameBcAndLowMult && trackInWindow.isPVContributor() && trackInWindow.collision().numContrib() > mMaxPvContributorsForLowMultReassoc)) {
-              thresholdTime = trackTimeRes;
-            } else if (TESTBIT(trackInWindow.flags(), o2::aod::track::TrackTimeResIsRange)) {
-              // the track time resolution is a range, not a gaussian resolution
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else {
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          } else {
-            // the track is not a central track
-            if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
-              // then the track is an MFT track, or an MFT track with additionnal joined info
-              // in this case TrackTimeResIsRange
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else if constexpr (TTracks::template contains<o2::aod::FwdTracks>()) {
-              // the track is a fwd track, with a gaussian time resolution
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          }
+    // cache globalBC, track time in BC and time-compatibility model of each track
+    for (const auto& track : tracks) {
+      int64_t trackBC = -1;
+      if (track.has_collision()) {
+        trackBC = track.collision().bc().globalBC();
+      } else if (mIncludeUnassigned) {
+        trackBC = ambiguousTrackBC[track.globalIndex()];
+      }
+      if (trackBC < 0) {
+        continue;
+      }
+      const int64_t trackBCWindow = trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS;
 
-          if (std::abs(deltaTime) < thresholdTime) {
-            const auto collIdx = collision.globalIndex();
-            const auto trackIdx = trackInWindow.globalIndex();
-            LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
-            association(collIdx, trackIdx);
-            if (mFillTableOfCollIdsPerTrack) {
-              if (collsPerTrack[trackIdx] == nullptr) {
-                collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
-              }
-              collsPerTrack[trackIdx].get()->push_back(collIdx);
-            }
-          }
+      float trackTime = track.trackTime();
+      float trackTimeRes = track.trackTimeRes();
+      o2::aod::track_association::TimeCompatMode mode{o2::aod::track_association::TimeCompatMode::TimeResIsGaussian};
+      if constexpr (isCentralBarrel) {
+        if ((mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::OnlySameBc && track.isPVContributor()) || (mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::SameBcAndLowMult && track.isPVContributor() && track.collision().numContrib() > mMaxPvContributorsForLowMultReassoc)) {
+          trackTime = track.collision().collisionTime(); // if PV contributor, we assume the time to be the one of the collision
+          trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS;  // 1 BC
+          mode = o2::aod::track_association::TimeCompatMode::PvContributor;
+        } else if (TESTBIT(track.flags(), o2::aod::track::TrackTimeResIsRange)) {
+          // the track time resolution is a range, not a gaussian resolution
+          mode = o2::aod::track_association::TimeCompatMode::TimeResIsRange;
+        }
+      } else {
+        // the track is not a central track
+        if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
+          // then the track is an MFT track, or an MFT track with additionnal joined info
+          // in this case TrackTimeResIsRange
+          mode = o2::aod::track_association::TimeCompatMode::TimeResIsRange;
+        } else if constexpr (!TTracks::template contains<o2::aod::FwdTracks>()) {
+          continue; // no time compatibility model for this track type
         }
       }
+      mSweep.addTrack(track.globalIndex(), track.filteredIndex(), trackBC, trackBCWindow, trackTime, trackTimeRes, mode);
     }
+
+    // find time-compatible collision-track pairs
+    int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
+    mSweep.run(bcOffsetMax, mNumSigmaForTimeCompat, mTimeMargin, mNumThreads);
+    for (const auto& [collIdx, trackIdx] : mSweep.pairs()) {
+      association(collIdx, trackIdx);
+    }
+
     // create reverse index track to collisions if enabled
     if (mFillTableOfCollIdsPerTrack) {
-      std::vector<int> empty{};
+      mSweep.buildCollisionsPerTrack(tracksUnfiltered.size());
+      const auto& offsets = mSweep.collsPerTrackOffsets();
+      const auto& collIds = mSweep.collsPerTrackIds();
+      std::vector<int> collsThisTrack{};
       for (const auto& trackUnfiltered : tracksUnfiltered) {
-
         const auto trackId = trackUnfiltered.globalIndex();
-        if (collsPerTrack[trackId] == nullptr) {
-          reverseIndices(empty);
-        } else {
-          reverseIndices(*collsPerTrack[trackId].get());
-        }
+        collsThisTrack.assign(collIds.begin() + offsets[trackId], collIds.begin() + offsets[trackId + 1]);
+        reverseIndices(collsThisTrack);
       }
     }
   }
@@ -318,6 +299,8 @@ class CollisionAssociation
   bool mIncludeUnassigned{true};                                                     // include tracks that were originally not assigned to any collision
   bool mFillTableOfCollIdsPerTrack{false};                                           // fill additional table with vectors of compatible collisions per track
   int mBcWindowForOneSigma{115};                                                     // BC window to be multiplied by the number of sigmas to define maximum window to be considered
+  int mNumThreads{1};                                                                // number of threads for the time-based association
+  o2::aod::track_association::TimeCompatSweep mSweep;                                // sweep-line engine for the time-based association
 };
 
 #endif // COMMON_CORE_COLLISIONASSOCIATION_H_
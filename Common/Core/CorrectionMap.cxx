@@ -0,0 +1,183 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CorrectionMap.cxx
+/// \brief  Compiled, read-only copy of a TH1/TH2/TH3/THn used for per-track corrections
+///
+
+#include "Common/Core/CorrectionMap.h"
+
+#include <Framework/Logger.h>
+
+#include <TAxis.h>
+#include <TH1.h>
+#include <THnBase.h>
+#include <THnSparse.h>
+
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace o2::common::core;
+
+void CorrectionMap::reset()
+{
+  mAxes.clear();
+  mContents.clear();
+  mErrors.clear();
+  mSparse = false;
+  mSparseBins.clear();
+  mName.clear();
+}
+
+std::size_t CorrectionMap::setAxes(std::vector<const TAxis*> const& axes)
+{
+  mAxes.clear();
+  mAxes.resize(axes.size());
+  std::size_t stride = 1;
+  for (std::size_t iDim = 0; iDim < axes.size(); iDim++) {
+    const TAxis* source = axes[iDim];
+    Axis& axis = mAxes[iDim];
+    axis.nBins = source->GetNbins();
+    axis.min = source->GetXmin();
+    axis.max = source->GetXmax();
+    axis.uniform = source->GetXbins()->GetSize() == 0;
+    axis.stride = stride;
+    if (!axis.uniform) {
+      axis.edges.assign(source->GetXbins()->GetArray(), source->GetXbins()->GetArray() + axis.nBins + 1);
+    }
+    // take everything the lookups need from TAxis itself, so that the values are bit-identical
+    axis.centers.resize(axis.nBins + 2);
+    axis.centerBins.resize(axis.nBins + 2);
+    axis.upEdges.resize(axis.nBins + 2);
+    axis.halfWidths.resize(axis.nBins + 2);
+    for (int bin = 0; bin <= axis.nBins + 1; bin++) {
+      axis.centers[bin] = source->GetBinCenter(bin);
+      axis.centerBins[bin] = source->FindFixBin(axis.centers[bin]);
+      axis.upEdges[bin] = source->GetBinUpEdge(bin);
+      axis.halfWidths[bin] = source->GetBinWidth(bin) / 2;
+    }
+    const std::size_t nCells = axis.nBins + 2;
+    if (stride > std::numeric_limits<std::size_t>::max() / nCells) {
+      LOGF(fatal, "CorrectionMap %s: the global bin numbering of %zu dimensions does not fit in std::size_t", mName.c_str(), axes.size());
+    }
+    stride *= nCells;
+  }
+  return stride;
+}
+
+void CorrectionMap::compile(const TH1* histogram)
+{
+  reset();
+  if (!histogram) {
+    return;
+  }
+  mName = histogram->GetName();
+  const int nDimensions = histogram->GetDimension();
+  std::vector<const TAxis*> axes{histogram->GetXaxis(), histogram->GetYaxis(), histogram->GetZaxis()};
+  axes.resize(nDimensions);
+  const std::size_t nBins = setAxes(axes);
+  mContents.assign(nBins, 0.);
+  mErrors.assign(nBins, 0.);
+  // the flat layout is the TH1 global bin numbering, so the bins map one to one
+  for (std::size_t bin = 0; bin < mContents.size(); bin++) {
+    mContents[bin] = histogram->GetBinContent(bin);
+    mErrors[bin] = histogram->GetBinError(bin);
+  }
+}
+
+void CorrectionMap::compile(const THnBase* histogram)
+{
+  reset();
+  if (!histogram) {
+    return;
+  }
+  mName = histogram->GetName();
+  const int nDimensions = histogram->GetNdimensions();
+  std::vector<const TAxis*> axes(nDimensions);
+  for (int iDim = 0; iDim < nDimensions; iDim++) {
+    axes[iDim] = histogram->GetAxis(iDim);
+  }
+  const std::size_t nBins = setAxes(axes);
+  // a dense copy of a THnSparse can be far larger than the filled bins: keep only those
+  mSparse = histogram->InheritsFrom(THnSparse::Class());
+  if (mSparse) {
+    mContents.assign(1, 0.);
+    mErrors.assign(1, 0.);
+    mSparseBins.reserve(histogram->GetNbins());
+  } else {
+    mContents.assign(nBins, 0.);
+    mErrors.assign(nBins, 0.);
+  }
+  // THn orders its bins differently and THnSparse only stores filled ones: go through the
+  // stored bins and place them by their coordinates
+  std::vector<int> coordinates(nDimensions);
+  for (Long64_t linearBin = 0; linearBin < histogram->GetNbins(); linearBin++) {
+    const double content = histogram->GetBinContent(linearBin, coordinates.data());
+    std::size_t bin = 0;
+    for (int iDim = 0; iDim < nDimensions; iDim++) {
+      bin += mAxes[iDim].stride * coordinates[iDim];
+    }
+    if (mSparse) {
+      mSparseBins[bin] = mContents.size();
+      mContents.push_back(content);
+      mErrors.push_back(histogram->GetBinError(linearBin));
+    } else {
+      mContents[bin] = content;
+      mErrors[bin] = histogram->GetBinError(linearBin);
+    }
+  }
+}
+
+void CorrectionMap::getBinContents(std::span<const double> x, std::span<double> out) const
+{
+  for (std::size_t i = 0; i < out.size(); i++) {
+    out[i] = getBinContent(x[i]);
+  }
+}
+
+void CorrectionMap::getBinContents(std::span<const double> x, std::span<const double> y, std::span<double> out) const
+{
+  for (std::size_t i = 0; i < out.size(); i++) {
+    out[i] = getBinContent(x[i], y[i]);
+  }
+}
+
+void CorrectionMap::getBinContents(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> out) const
+{
+  for (std::size_t i = 0; i < out.size(); i++) {
+    out[i] = getBinContent(x[i], y[i], z[i]);
+  }
+}
+
+void CorrectionMap::interpolate(std::span<const double> x, std::span<double> out) const
+{
+  for (std::size_t i = 0; i < out.size(); i++) {
+    out[i] = interpolate(x[i]);
+  }
+}
+
+void CorrectionMap::interpolate(std::span<const double> x, std::span<const double> y, std::span<double> out) const
+{
+  for (std::size_t i = 0; i < out.size(); i++) {
+    out[i] = interpolate(x[i], y[i]);
+  }
+}
+
+void CorrectionMap::interpolate(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> out) const
+{
+  for (std::size_t i = 0; i < out.size(); i++) {
+    out[i] = interpolate(x[i], y[i], z[i]);
+  }
+}
@@ -0,0 +1,279 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CorrectionMap.h
+/// \brief  Compiled, read-only copy of a TH1/TH2/TH3/THn used for per-track corrections
+///         (efficiency, purity, NUA, weights). The histogram is flattened once into
+///         contiguous arrays and bin finding / interpolation reproduce the values of
+///         TAxis::FindFixBin, TH1::GetBinContent, TH1::GetBinError and TH1/TH2/TH3::Interpolate.
+///         THnSparse inputs keep only their filled bins. All lookups are const, so a
+///         compiled map can be shared between threads.
+///
+
+#ifndef COMMON_CORE_CORRECTIONMAP_H_
+#define COMMON_CORE_CORRECTIONMAP_H_
+
+#include <Framework/Logger.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TAxis;
+class TH1;
+class THnBase;
+
+namespace o2::common::core
+{
+
+class CorrectionMap
+{
+ public:
+  /// Binning of one axis, copied from a TAxis
+  struct Axis {
+    int nBins = 0;
+    double min = 0.;
+    double max = 0.;
+    bool uniform = true;
+    std::size_t stride = 1;         // offset between consecutive bins in the global bin numbering
+    std::vector<double> edges;      // n+1 edges, variable binning only
+    std::vector<double> centers;    // bin centers for bins 0..n+1, as TAxis::GetBinCenter
+    std::vector<int> centerBins;    // findBin(centers[bin]), used by the 2D interpolation
+    std::vector<double> upEdges;    // TAxis::GetBinUpEdge for bins 0..n+1
+    std::vector<double> halfWidths; // TAxis::GetBinWidth / 2 for bins 0..n+1
+
+    /// Same result as TAxis::FindFixBin: 0 for underflow, n+1 for overflow and NaN
+    int findBin(double x) const
+    {
+      if (x < min) {
+        return 0;
+      }
+      if (!(x < max)) {
+        return nBins + 1;
+      }
+      if (uniform) {
+        return 1 + static_cast<int>(nBins * (x - min) / (max - min));
+      }
+      return static_cast<int>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+    }
+  };
+
+  CorrectionMap() = default;
+  explicit CorrectionMap(const TH1* histogram) { compile(histogram); }
+  explicit CorrectionMap(const THnBase* histogram) { compile(histogram); }
+
+  /// Copy binning, contents and errors of the histogram. A null pointer leaves the map invalid.
+  void compile(const TH1* histogram);
+  void compile(const THnBase* histogram);
+  /// Drop the compiled content, the map becomes invalid
+  void reset();
+
+  bool isValid() const { return !mAxes.empty(); }
+  bool isSparse() const { return mSparse; }
+  int getNdimensions() const { return static_cast<int>(mAxes.size()); }
+  const Axis& getAxis(int dimension) const { return mAxes[dimension]; }
+  const std::string& getName() const { return mName; }
+
+  /// Load an object of type THist from CCDB and compile it. The object is fetched again only
+  /// when the run number changes. Returns false if the object could not be retrieved.
+  template <typename THist, typename TCcdb>
+  bool loadFromCcdb(TCcdb const& ccdb, const std::string& path, uint64_t timestamp, int runNumber)
+  {
+    if (runNumber == mRunNumber && path == mCcdbPath) {
+      return isValid();
+    }
+    mRunNumber = runNumber;
+    mCcdbPath = path;
+    const THist* object = ccdb->template getForTimeStamp<THist>(path, timestamp);
+    if (!object) {
+      LOGF(error, "Correction map %s not found in CCDB for run %d", path.c_str(), runNumber);
+      reset();
+      return false;
+    }
+    compile(object);
+    return isValid();
+  }
+
+  /// Content of the bin containing the point, as TH*::GetBinContent(TH*::FindFixBin(...))
+  double getBinContent(double x) const { return content(globalBin(x)); }
+  double getBinContent(double x, double y) const { return content(globalBin(x, y)); }
+  double getBinContent(double x, double y, double z) const { return content(globalBin(x, y, z)); }
+  /// Coordinates must provide getNdimensions() values, as THnBase::GetBin(const Double_t*)
+  double getBinContent(const double* x) const { return content(globalBin(x)); }
+
+  double getBinError(double x) const { return error(globalBin(x)); }
+  double getBinError(double x, double y) const { return error(globalBin(x, y)); }
+  double getBinError(double x, double y, double z) const { return error(globalBin(x, y, z)); }
+  double getBinError(const double* x) const { return error(globalBin(x)); }
+
+  /// Linear interpolation between bin centers, same values as TH1::Interpolate(x)
+  double interpolate(double x) const
+  {
+    checkDimensions(1);
+    const Axis& ax = mAxes[0];
+    const int n = ax.nBins;
+    if (x <= ax.centers[1]) {
+      return content(1);
+    }
+    if (!(x < ax.centers[n])) {
+      return content(n);
+    }
+    const int bin = ax.findBin(x);
+    const int low = x <= ax.centers[bin] ? bin - 1 : bin;
+    const double x0 = ax.centers[low];
+    const double x1 = ax.centers[low + 1];
+    const double y0 = content(low);
+    const double y1 = content(low + 1);
+    return y0 + (x - x0) * ((y1 - y0) / (x1 - x0));
+  }
+
+  /// Bilinear interpolation, same values as TH2::Interpolate(x, y)
+  double interpolate(double x, double y) const
+  {
+    checkDimensions(2);
+    const Axis& ax = mAxes[0];
+    const Axis& ay = mAxes[1];
+    const int binX = ax.findBin(x);
+    const int binY = ay.findBin(y);
+    if (binX < 1 || binX > ax.nBins || binY < 1 || binY > ay.nBins) {
+      return 0.;
+    }
+    // pick the neighbouring bin on the side of the bin center where the point lies
+    const int lowX = ax.upEdges[binX] - x <= ax.halfWidths[binX] ? binX : binX - 1;
+    const int lowY = ay.upEdges[binY] - y <= ay.halfWidths[binY] ? binY : binY - 1;
+    const double x1 = ax.centers[lowX];
+    const double x2 = ax.centers[lowX + 1];
+    const double y1 = ay.centers[lowY];
+    const double y2 = ay.centers[lowY + 1];
+    const int binX1 = std::max(ax.centerBins[lowX], 1);
+    const int binX2 = std::min(ax.centerBins[lowX + 1], ax.nBins);
+    const int binY1 = std::max(ay.centerBins[lowY], 1);
+    const int binY2 = std::min(ay.centerBins[lowY + 1], ay.nBins);
+    const double q11 = content(binX1 + ay.stride * binY1);
+    const double q12 = content(binX1 + ay.stride * binY2);
+    const double q21 = content(binX2 + ay.stride * binY1);
+    const double q22 = content(binX2 + ay.stride * binY2);
+    const double d = 1.0 * (x2 - x1) * (y2 - y1);
+    return 1.0 * q11 / d * (x2 - x) * (y2 - y) + 1.0 * q21 / d * (x - x1) * (y2 - y) + 1.0 * q12 / d * (x2 - x) * (y - y1) + 1.0 * q22 / d * (x - x1) * (y - y1);
+  }
+
+  /// Trilinear interpolation, same values as TH3::Interpolate(x, y, z)
+  double interpolate(double x, double y, double z) const
+  {
+    checkDimensions(3);
+    const Axis& ax = mAxes[0];
+    const Axis& ay = mAxes[1];
+    const Axis& az = mAxes[2];
+    const int ubx = lowerNeighbour(ax, x);
+    const int uby = lowerNeighbour(ay, y);
+    const int ubz = lowerNeighbour(az, z);
+    if (ubx <= 0 || uby <= 0 || ubz <= 0 || ubx + 1 > ax.nBins || uby + 1 > ay.nBins || ubz + 1 > az.nBins) {
+      return 0.;
+    }
+    const double xd = (x - ax.centers[ubx]) / (ax.centers[ubx + 1] - ax.centers[ubx]);
+    const double yd = (y - ay.centers[uby]) / (ay.centers[uby + 1] - ay.centers[uby]);
+    const double zd = (z - az.centers[ubz]) / (az.centers[ubz + 1] - az.centers[ubz]);
+    const std::size_t v = ubx + ay.stride * uby + az.stride * ubz;
+    const std::size_t sx = 1;
+    const std::size_t sy = ay.stride;
+    const std::size_t sz = az.stride;
+    const double i1 = content(v) * (1 - zd) + content(v + sz) * zd;
+    const double i2 = content(v + sy) * (1 - zd) + content(v + sy + sz) * zd;
+    const double j1 = content(v + sx) * (1 - zd) + content(v + sx + sz) * zd;
+    const double j2 = content(v + sx + sy) * (1 - zd) + content(v + sx + sy + sz) * zd;
+    const double w1 = i1 * (1 - yd) + i2 * yd;
+    const double w2 = j1 * (1 - yd) + j2 * yd;
+    return w1 * (1 - xd) + w2 * xd;
+  }
+
+  /// Batch lookups: out[i] is the value for the i-th point, all spans must have the same size
+  void getBinContents(std::span<const double> x, std::span<double> out) const;
+  void getBinContents(std::span<const double> x, std::span<const double> y, std::span<double> out) const;
+  void getBinContents(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> out) const;
+  void interpolate(std::span<const double> x, std::span<double> out) const;
+  void interpolate(std::span<const double> x, std::span<const double> y, std::span<double> out) const;
+  void interpolate(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> out) const;
+
+ private:
+  std::vector<Axis> mAxes;
+  std::vector<double> mContents; // flat storage including under- and overflow bins, x runs fastest as in TH1::GetBin
+  std::vector<double> mErrors;
+  // THnSparse inputs: mContents/mErrors only hold the filled bins after an empty slot 0,
+  // mSparseBins maps their global bin to that position
+  bool mSparse = false;
+  std::unordered_map<std::size_t, std::size_t> mSparseBins;
+  std::string mName;
+  int mRunNumber = -1;
+  std::string mCcdbPath;
+
+  /// Copy the binning, returns the number of bins of the global bin numbering
+  std::size_t setAxes(std::vector<const TAxis*> const& axes);
+
+  std::size_t storageIndex(std::size_t bin) const
+  {
+    if (!mSparse) {
+      return bin;
+    }
+    const auto filled = mSparseBins.find(bin);
+    return filled == mSparseBins.end() ? 0 : filled->second;
+  }
+  double content(std::size_t bin) const { return mContents[storageIndex(bin)]; }
+  double error(std::size_t bin) const { return mErrors[storageIndex(bin)]; }
+
+  void checkDimensions(int nDimensions) const
+  {
+    if (getNdimensions() != nDimensions) {
+      LOGF(fatal, "CorrectionMap %s has %d dimensions, requested a %d-dimensional lookup", mName.c_str(), getNdimensions(), nDimensions);
+    }
+  }
+
+  static int lowerNeighbour(const Axis& axis, double x)
+  {
+    const int bin = axis.findBin(x);
+    return x < axis.centers[bin] ? bin - 1 : bin;
+  }
+
+  std::size_t globalBin(double x) const
+  {
+    checkDimensions(1);
+    return mAxes[0].findBin(x);
+  }
+  std::size_t globalBin(double x, double y) const
+  {
+    checkDimensions(2);
+    return mAxes[0].findBin(x) + mAxes[1].stride * mAxes[1].findBin(y);
+  }
+  std::size_t globalBin(double x, double y, double z) const
+  {
+    checkDimensions(3);
+    return mAxes[0].findBin(x) + mAxes[1].stride * mAxes[1].findBin(y) + mAxes[2].stride * mAxes[2].findBin(z);
+  }
+  std::size_t globalBin(const double* x) const
+  {
+    if (!isValid()) {
+      LOGF(fatal, "CorrectionMap %s used before being compiled", mName.c_str());
+    }
+    std::size_t bin = 0;
+    for (std::size_t iDim = 0; iDim < mAxes.size(); iDim++) {
+      bin += mAxes[iDim].stride * mAxes[iDim].findBin(x[iDim]);
+    }
+    return bin;
+  }
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_CORRECTIONMAP_H_
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdio>
 #include <iterator>
 #include <memory>
@@ -107,6 +108,60 @@ void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TCom
   sum += ampl;
 }
 
+void EventPlaneHelper::BuildHarmonicTables(const std::vector<int>& harmonics, const o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom)
+{
+  /* Compute once the cos and sin entering SumQvectors for every channel and harmonic,
+    with the same expressions, so that the sums built from the tables are identical. */
+  const std::size_t nHarmonics = harmonics.size();
+  mCosFT0.resize(nHarmonics * NChannelsFT0);
+  mSinFT0.resize(nHarmonics * NChannelsFT0);
+  mCosFV0.resize(nHarmonics * NChannelsFV0);
+  mSinFV0.resize(nHarmonics * NChannelsFV0);
+
+  for (int chno = 0; chno < NChannelsFT0; chno++) {
+    double phi = GetPhiFT0(chno, ft0geom);
+    for (std::size_t iHarm = 0; iHarm < nHarmonics; iHarm++) {
+      mCosFT0[iHarm * NChannelsFT0 + chno] = TMath::Cos(phi * harmonics[iHarm]);
+      mSinFT0[iHarm * NChannelsFT0 + chno] = TMath::Sin(phi * harmonics[iHarm]);
+    }
+  }
+  for (int chno = 0; chno < NChannelsFV0; chno++) {
+    double phi = GetPhiFV0(chno, fv0geom);
+    for (std::size_t iHarm = 0; iHarm < nHarmonics; iHarm++) {
+      mCosFV0[iHarm * NChannelsFV0 + chno] = TMath::Cos(phi * harmonics[iHarm]);
+      mSinFV0[iHarm * NChannelsFV0 + chno] = TMath::Sin(phi * harmonics[iHarm]);
+    }
+  }
+}
+
+void EventPlaneHelper::SumQvectors(int det, const std::vector<int>& channels, const std::vector<float>& ampls, std::size_t iHarmonic, double& qx, double& qy, float& sum) const
+{
+  /* Add the contributions of all the given channels to (qx, qy) and the amplitude sum,
+    in the order of the list. */
+  const double* cosPhi = nullptr;
+  const double* sinPhi = nullptr;
+
+  switch (det) {
+    case 0: // FT0.
+      cosPhi = mCosFT0.data() + iHarmonic * NChannelsFT0;
+      sinPhi = mSinFT0.data() + iHarmonic * NChannelsFT0;
+      break;
+    case 1: // FV0.
+      cosPhi = mCosFV0.data() + iHarmonic * NChannelsFV0;
+      sinPhi = mSinFV0.data() + iHarmonic * NChannelsFV0;
+      break;
+    default:
+      printf("'int det' value does not correspond to any accepted case.\n");
+      return;
+  }
+
+  for (std::size_t i = 0; i < channels.size(); i++) {
+    qx += ampls[i] * cosPhi[channels[i]];
+    qy += ampls[i] * sinPhi[channels[i]];
+    sum += ampls[i];
+  }
+}
+
 int EventPlaneHelper::GetCentBin(float cent)
 {
   const float centClasses[] = {0., 5., 10., 20., 30., 40., 50., 60., 80.};
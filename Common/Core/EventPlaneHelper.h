@@ -29,6 +29,7 @@
 
 #include <Rtypes.h>
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -67,6 +68,14 @@ class EventPlaneHelper
   // the detector and amplitude.
   void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, const o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom);
 
+  // Method to tabulate cos(n*phi) and sin(n*phi) of all FT0 and FV0 channels for the
+  // given harmonics. The offsets are included, so it must be called again when they change.
+  void BuildHarmonicTables(const std::vector<int>& harmonics, const o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom);
+
+  // Same sum as SumQvectors for a list of channels of one detector, with the angles taken
+  // from the tables. 'iHarmonic' is the position of the harmonic given to BuildHarmonicTables.
+  void SumQvectors(int det, const std::vector<int>& channels, const std::vector<float>& ampls, std::size_t iHarmonic, double& qx, double& qy, float& sum) const;
+
   // Method to get the bin corresponding to a centrality percentile, according to the
   // centClasses[] array defined in Tasks/qVectorsQA.cxx.
   // Note: Any change in one task should be reflected in the other.
@@ -107,6 +116,13 @@ class EventPlaneHelper
   double mOffsetFV0rightX = 0.; // X-coordinate of the offset of FV0-A right.
   double mOffsetFV0rightY = 0.; // Y-coordinate of the offset of FV0-A right.
 
+  static constexpr int NChannelsFT0 = 208; // Channels of FT0-A (0-95) and FT0-C (96-207).
+  static constexpr int NChannelsFV0 = 48;  // Readout channels of FV0-A.
+  std::vector<double> mCosFT0{};           //! cos(n*phi) of each FT0 channel, harmonics one after the other.
+  std::vector<double> mSinFT0{};           //! sin(n*phi) of each FT0 channel.
+  std::vector<double> mCosFV0{};           //! cos(n*phi) of each FV0 channel.
+  std::vector<double> mSinFV0{};           //! sin(n*phi) of each FV0 channel.
+
   ClassDefNV(EventPlaneHelper, 2)
 };
 
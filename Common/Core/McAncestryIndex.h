@@ -0,0 +1,266 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file McAncestryIndex.h
+/// \brief Flattened copy of the MC particle family tree for fast truth matching
+///
+/// The index is built once per time frame from the McParticles table and can be passed to the
+/// RecoDecay MC matching functions (getMother, getDaughters, getMatchedMCRec, isMatchedMCGen,
+/// getCharmHadronOrigin, getParticleOrigin) in place of the particle table. The mother and daughter
+/// walks then run on plain arrays instead of table iterators, with identical results.
+/// Reconstructed prongs are converted with prongs() before calling getMatchedMCRec.
+
+#ifndef COMMON_CORE_MCANCESTRYINDEX_H_
+#define COMMON_CORE_MCANCESTRYINDEX_H_
+
+#include <TPDGCode.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+namespace o2::common::core
+{
+
+class McAncestryIndex
+{
+ public:
+  enum GeneratorFlags : uint8_t {
+    ProducedByGenerator = 0x1,
+    PhysicalPrimary = 0x2,
+    FromBackgroundEvent = 0x4
+  };
+
+  class iterator;
+
+  /// Range of consecutive particles, as returned by daughters_as
+  class Range
+  {
+   public:
+    class RangeIterator
+    {
+     public:
+      RangeIterator(const McAncestryIndex* index, int64_t row) : mIndex(index), mRow(row) {}
+      iterator operator*() const { return iterator(mIndex, mRow); }
+      RangeIterator& operator++()
+      {
+        ++mRow;
+        return *this;
+      }
+      bool operator!=(const RangeIterator& other) const { return mRow != other.mRow; }
+
+     private:
+      const McAncestryIndex* mIndex;
+      int64_t mRow;
+    };
+
+    Range(const McAncestryIndex* index, int64_t first, int64_t last) : mIndex(index), mFirst(first), mLast(last) {}
+    RangeIterator begin() const { return {mIndex, mFirst}; }
+    RangeIterator end() const { return {mIndex, mLast + 1}; }
+    std::size_t size() const { return static_cast<std::size_t>(mLast + 1 - mFirst); }
+
+   private:
+    const McAncestryIndex* mIndex;
+    int64_t mFirst;
+    int64_t mLast;
+  };
+
+  /// Row of the index, with the accessors of an McParticles iterator used by the RecoDecay MC matching
+  class iterator
+  {
+   public:
+    using parent_t = McAncestryIndex;
+
+    iterator() = default;
+    iterator(const McAncestryIndex* index, int64_t row) : mIndex(index), mRow(row) {}
+
+    int64_t globalIndex() const { return mRow + mIndex->mOffset; }
+    int pdgCode() const { return mIndex->mPdgCode[mRow]; }
+    int getGenStatusCode() const { return mIndex->mGenStatusCode[mRow]; }
+    int getProcess() const { return mIndex->mProcess[mRow]; }
+    uint8_t flags() const { return mIndex->mFlags[mRow]; }
+    bool producedByGenerator() const { return mIndex->mFlags[mRow] & ProducedByGenerator; }
+    bool isPhysicalPrimary() const { return mIndex->mFlags[mRow] & PhysicalPrimary; }
+    bool fromBackgroundEvent() const { return mIndex->mFlags[mRow] & FromBackgroundEvent; }
+
+    bool has_mothers() const { return mIndex->mMotherOffsets[mRow + 1] > mIndex->mMotherOffsets[mRow]; } // o2-linter: disable=name/function-variable (same name as the table accessor)
+    std::span<const int> mothersIds() const
+    {
+      return {mIndex->mMotherIds.data() + mIndex->mMotherOffsets[mRow], static_cast<std::size_t>(mIndex->mMotherOffsets[mRow + 1] - mIndex->mMotherOffsets[mRow])};
+    }
+    template <typename T>
+    iterator mothers_first_as() const // o2-linter: disable=name/function-variable (same name as the table accessor)
+    {
+      return iterator(mIndex, mIndex->mMotherIds[mIndex->mMotherOffsets[mRow]] - mIndex->mOffset);
+    }
+
+    bool has_daughters() const { return mIndex->mHasDaughters[mRow]; } // o2-linter: disable=name/function-variable (same name as the table accessor)
+    std::span<const int> daughtersIds() const { return {mIndex->mDaughterRanges.data() + 2 * mRow, 2}; }
+    template <typename T>
+    Range daughters_as() const // o2-linter: disable=name/function-variable (same name as the table accessor)
+    {
+      if (!has_daughters()) {
+        return {mIndex, 0, -1};
+      }
+      return {mIndex, mIndex->mDaughterRanges[2 * mRow] - mIndex->mOffset, mIndex->mDaughterRanges[2 * mRow + 1] - mIndex->mOffset};
+    }
+
+    /// Number of generations above the particle, following the first mother
+    int depth() const { return mIndex->mDepth[mRow]; }
+    /// Global index of the closest charm hadron among the first-mother ancestors, -1 if none
+    int firstCharmAncestor() const { return mIndex->mFirstCharmAncestor[mRow]; }
+    /// Global index of the closest beauty hadron among the first-mother ancestors, -1 if none
+    int firstBeautyAncestor() const { return mIndex->mFirstBeautyAncestor[mRow]; }
+
+   private:
+    const McAncestryIndex* mIndex = nullptr;
+    int64_t mRow = -1;
+  };
+
+  /// Reconstructed prong seen through the index, as required by RecoDecay::getMatchedMCRec
+  class Prong
+  {
+   public:
+    Prong() = default;
+    Prong(const McAncestryIndex* index, int64_t mcParticleId) : mIndex(index), mMcParticleId(mcParticleId) {}
+    bool has_mcParticle() const { return mMcParticleId >= 0; } // o2-linter: disable=name/function-variable (same name as the table accessor)
+    int64_t mcParticleId() const { return mMcParticleId; }
+    template <typename T>
+    iterator mcParticle_as() const // o2-linter: disable=name/function-variable (same name as the table accessor)
+    {
+      return iterator(mIndex, mMcParticleId - mIndex->mOffset);
+    }
+
+   private:
+    const McAncestryIndex* mIndex = nullptr;
+    int64_t mMcParticleId = -1;
+  };
+
+  /// Copy the family tree of all particles of the table.
+  /// \param particlesMC  McParticles table (not filtered or sliced, so that mother and daughter indices stay valid)
+  template <typename T>
+  void build(const T& particlesMC)
+  {
+    const auto nParticles = static_cast<std::size_t>(particlesMC.size());
+    mOffset = particlesMC.offset();
+    mPdgCode.resize(nParticles);
+    mGenStatusCode.resize(nParticles);
+    mProcess.resize(nParticles);
+    mFlags.resize(nParticles);
+    mHasDaughters.resize(nParticles);
+    mDaughterRanges.resize(2 * nParticles);
+    mMotherOffsets.resize(nParticles + 1);
+    mMotherIds.clear();
+    mMotherOffsets[0] = 0;
+    std::size_t row = 0;
+    for (const auto& particle : particlesMC) {
+      mPdgCode[row] = particle.pdgCode();
+      mGenStatusCode[row] = particle.getGenStatusCode();
+      mProcess[row] = particle.getProcess();
+      mFlags[row] = (particle.producedByGenerator() ? ProducedByGenerator : 0) | (particle.isPhysicalPrimary() ? PhysicalPrimary : 0) | (particle.fromBackgroundEvent() ? FromBackgroundEvent : 0);
+      if (particle.has_mothers()) {
+        for (const auto& idMother : particle.mothersIds()) {
+          mMotherIds.push_back(idMother);
+        }
+      }
+      mMotherOffsets[row + 1] = static_cast<int>(mMotherIds.size());
+      mHasDaughters[row] = particle.has_daughters();
+      mDaughterRanges[2 * row] = particle.has_daughters() ? particle.daughtersIds().front() : -1;
+      mDaughterRanges[2 * row + 1] = particle.has_daughters() ? particle.daughtersIds().back() : -1;
+      ++row;
+    }
+    buildAncestors();
+  }
+
+  std::size_t size() const { return mPdgCode.size(); }
+  int64_t offset() const { return mOffset; }
+  /// Row at the given position, same convention as the table method
+  iterator rawIteratorAt(int64_t row) const { return iterator(this, row); }
+  iterator iteratorAt(int64_t row) const { return iterator(this, row); }
+
+  /// Prongs pointing to the rows of the index, to be passed to RecoDecay::getMatchedMCRec
+  template <std::size_t N, typename U>
+  std::array<Prong, N> prongs(const std::array<U, N>& arrDaughters) const
+  {
+    std::array<Prong, N> result;
+    for (std::size_t iProng = 0; iProng < N; ++iProng) {
+      result[iProng] = Prong(this, arrDaughters[iProng].has_mcParticle() ? arrDaughters[iProng].mcParticleId() : -1);
+    }
+    return result;
+  }
+
+ private:
+  int64_t mOffset = 0;
+  std::vector<int> mPdgCode;
+  std::vector<int> mGenStatusCode;
+  std::vector<int> mProcess;
+  std::vector<uint8_t> mFlags;
+  std::vector<uint8_t> mHasDaughters;
+  std::vector<int> mDaughterRanges;     // first and last daughter of each particle
+  std::vector<int> mMotherOffsets;      // mothers of row i are mMotherIds[mMotherOffsets[i]..mMotherOffsets[i + 1])
+  std::vector<int> mMotherIds;          // global indices, as in the mothersIds column
+  std::vector<int> mDepth;              // generations above the particle, following the first mother
+  std::vector<int> mFirstCharmAncestor; // global indices, -1 if none
+  std::vector<int> mFirstBeautyAncestor;
+
+  static bool isHadronOfFlavour(int pdgCode, int flavour)
+  {
+    const int pdgAbs = std::abs(pdgCode);
+    return pdgAbs / 100 == flavour || pdgAbs / 1000 == flavour; // o2-linter: disable=magic-number (PDG code digits, as in RecoDecay)
+  }
+
+  /// Resolve the first-mother chain of every particle once, without recursion
+  void buildAncestors()
+  {
+    const auto nParticles = static_cast<int64_t>(size());
+    mDepth.assign(nParticles, -1);
+    mFirstCharmAncestor.assign(nParticles, -1);
+    mFirstBeautyAncestor.assign(nParticles, -1);
+    std::vector<uint8_t> onStack(nParticles, 0);
+    std::vector<int64_t> stack;
+    for (int64_t start = 0; start < nParticles; ++start) {
+      if (mDepth[start] >= 0) {
+        continue;
+      }
+      stack.push_back(start);
+      onStack[start] = 1;
+      while (!stack.empty()) {
+        const int64_t row = stack.back();
+        int64_t rowMother = -1;
+        if (mMotherOffsets[row + 1] > mMotherOffsets[row]) {
+          rowMother = mMotherIds[mMotherOffsets[row]] - mOffset;
+        }
+        // particles without a valid mother and mother loops end the chain
+        if (rowMother < 0 || rowMother >= nParticles || onStack[rowMother]) {
+          mDepth[row] = 0;
+        } else if (mDepth[rowMother] < 0) {
+          stack.push_back(rowMother);
+          onStack[rowMother] = 1;
+          continue;
+        } else {
+          const int idMother = static_cast<int>(rowMother + mOffset);
+          mDepth[row] = mDepth[rowMother] + 1;
+          mFirstCharmAncestor[row] = isHadronOfFlavour(mPdgCode[rowMother], PDG_t::kCharm) ? idMother : mFirstCharmAncestor[rowMother];
+          mFirstBeautyAncestor[row] = isHadronOfFlavour(mPdgCode[rowMother], PDG_t::kBottom) ? idMother : mFirstBeautyAncestor[rowMother];
+        }
+        onStack[row] = 0;
+        stack.pop_back();
+      }
+    }
+  }
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_MCANCESTRYINDEX_H_
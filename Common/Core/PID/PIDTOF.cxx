@@ -25,10 +25,15 @@
 #include <TGraph.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace o2::pid::tof
 {
@@ -52,6 +57,71 @@ void TOFResoParamsV3::setResolutionParametrizationRun2(std::unordered_map<std::s
   for (int i = 0; i < 13; i++) {
     setParameter(i, pars.at(paramNames[i]));
   }
+  compileResolution();
+}
+
+void TOFResoParamsV3::compileResolution()
+{
+  mResoGridCellOk.clear(); // Lookups fall back to the TF2 until the grid is validated
+  for (int i = 0; i < 9; i++) {
+    if (!mResolution[i]) {
+      LOG(info) << "Resolution function for " << particleNames[i] << " not defined, not compiling the resolution grid";
+      return;
+    }
+  }
+  const double logPMin = std::log(mResoGridPMin);
+  const double dLogP = (std::log(mResoGridPMax) - logPMin) / mResoGridNP;
+  const double dEta = 2. * mResoGridEtaMax / mResoGridNEta;
+  mResoGridLogPMin = logPMin;
+  mResoGridInvDLogP = 1. / dLogP;
+  mResoGridInvDEta = 1. / dEta;
+  auto momentumAt = [&](const double u) { return std::exp(logPMin + u * dLogP); };
+  auto etaAt = [&](const double v) { return -mResoGridEtaMax + v * dEta; };
+
+  mResoGridNodes.resize(static_cast<std::size_t>(mResoGridNP + 1) * (mResoGridNEta + 1) * 9);
+  float* node = mResoGridNodes.data();
+  for (int iP = 0; iP <= mResoGridNP; iP++) {
+    const double p = momentumAt(iP);
+    for (int iEta = 0; iEta <= mResoGridNEta; iEta++) {
+      const double eta = etaAt(iEta);
+      for (int pid = 0; pid < 9; pid++) {
+        *node++ = mResolution[pid]->Eval(p, eta);
+      }
+    }
+  }
+
+  // Each cell is checked against the TF2 at its centre and at the middle of its four edges
+  constexpr std::array<std::array<float, 2>, 5> checkPoints{{{0.5f, 0.5f}, {0.f, 0.5f}, {1.f, 0.5f}, {0.5f, 0.f}, {0.5f, 1.f}}};
+  std::vector<uint16_t> cellOk(static_cast<std::size_t>(mResoGridNP) * mResoGridNEta, 0);
+  std::array<int, 9> nCellsOk{0};
+  for (int iP = 0; iP < mResoGridNP; iP++) {
+    for (int iEta = 0; iEta < mResoGridNEta; iEta++) {
+      ResolutionCell cell;
+      cell.iP = iP;
+      cell.iEta = iEta;
+      cell.index = iP * mResoGridNEta + iEta;
+      for (int pid = 0; pid < 9; pid++) {
+        bool ok = true;
+        for (const auto& [fP, fEta] : checkPoints) {
+          cell.fP = fP;
+          cell.fEta = fEta;
+          const double reference = mResolution[pid]->Eval(momentumAt(iP + fP), etaAt(iEta + fEta));
+          if (!(std::abs(interpolateResolution(cell, pid) - reference) <= mResoGridTolerance * std::abs(reference))) {
+            ok = false;
+            break;
+          }
+        }
+        if (ok) {
+          cellOk[cell.index] |= (1u << pid);
+          nCellsOk[pid]++;
+        }
+      }
+    }
+  }
+  mResoGridCellOk = std::move(cellOk);
+  for (int i = 0; i < 9; i++) {
+    LOG(info) << "Compiled resolution grid for " << particleNames[i] << ": " << nCellsOk[i] << "/" << mResoGridNP * mResoGridNEta << " cells within a relative tolerance of " << mResoGridTolerance << ", the others use the TF2";
+  }
 }
 
 // Time shift for post calibration to realign as a function of eta
@@ -66,23 +136,28 @@ void TOFResoParamsV3::setTimeShiftParameters(std::unordered_map<std::string, flo
   if (nPoints <= 0) {
     LOG(fatal) << "TOFResoParamsV3 shift: time must be positive";
   }
-  TGraph graph;
+  auto graph = std::make_shared<TGraph>();
   for (int i = 0; i < nPoints; ++i) {
-    graph.AddPoint(pars.at(Form("TimeShift.eta%i", i)), pars.at(Form("TimeShift.cor%i", i)));
+    graph->AddPoint(pars.at(Form("TimeShift.eta%i", i)), pars.at(Form("TimeShift.cor%i", i)));
   }
-  setTimeShiftParameters(&graph, positive);
+  setTimeShiftParameters(graph.get(), positive);
+  mTimeShiftGraphs[positive] = std::move(graph);
 }
 void TOFResoParamsV3::setTimeShiftParameters(std::string const& filename, std::string const& objname, const bool positive)
 {
   TFile f(filename.c_str(), "READ");
   if (f.IsOpen()) {
+    TGraph* graph = nullptr;
+    f.GetObject(objname.c_str(), graph);
+    f.Close();
     if (positive) {
-      f.GetObject(objname.c_str(), gPosEtaTimeCorr);
+      gPosEtaTimeCorr = graph;
     } else {
-      f.GetObject(objname.c_str(), gNegEtaTimeCorr);
+      gNegEtaTimeCorr = graph;
     }
-    f.Close();
+    mTimeShiftGraphs[positive].reset(graph);
   }
+  compileTimeShift(positive);
   LOG(info) << "Set the Time Shift parameters from file " << filename << " and object " << objname << " for " << (positive ? "positive" : "negative");
 }
 void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
@@ -96,20 +171,61 @@ void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
   } else {
     gNegEtaTimeCorr = g;
   }
+  if (mTimeShiftGraphs[positive].get() != g) {
+    mTimeShiftGraphs[positive].reset(); // g is owned by the caller, drop a graph owned from a previous setting
+  }
+  compileTimeShift(positive);
   LOG(info) << "Set the Time Shift parameters from object " << g->GetName() << " " << g->GetTitle() << " for " << (positive ? "positive" : "negative");
 }
-float TOFResoParamsV3::getTimeShift(float eta, int16_t sign) const
+void TOFResoParamsV3::compileTimeShift(const bool positive)
 {
-  if (sign > 0) {
-    if (!gPosEtaTimeCorr) {
-      return 0.f;
+  const TGraph* g = positive ? gPosEtaTimeCorr : gNegEtaTimeCorr;
+  auto& knotsEta = mTimeShiftEta[positive];
+  auto& knotsValue = mTimeShiftValue[positive];
+  knotsEta.clear();
+  knotsValue.clear();
+  if (!g || g->GetN() < 2) {
+    return;
+  }
+  const double* x = g->GetX();
+  for (int i = 1; i < g->GetN(); ++i) {
+    if (!(x[i] > x[i - 1])) {
+      LOG(info) << "Time shift graph " << g->GetName() << " is not sorted in eta, evaluating it with TGraph::Eval";
+      return;
     }
-    return gPosEtaTimeCorr->Eval(eta);
   }
-  if (!gNegEtaTimeCorr) {
+  knotsEta.assign(x, x + g->GetN());
+  knotsValue.assign(g->GetY(), g->GetY() + g->GetN());
+}
+float TOFResoParamsV3::getTimeShift(float eta, int16_t sign) const
+{
+  const TGraph* g = sign > 0 ? gPosEtaTimeCorr : gNegEtaTimeCorr;
+  if (!g) {
     return 0.f;
   }
-  return gNegEtaTimeCorr->Eval(eta);
+  const auto& x = mTimeShiftEta[sign > 0];
+  const auto& y = mTimeShiftValue[sign > 0];
+  if (x.empty()) {
+    return g->Eval(eta);
+  }
+  // Same linear interpolation, and extrapolation from the first or last two points, as TGraph::Eval
+  if (std::isnan(eta)) {
+    return y[0];
+  }
+  const std::size_t n = x.size();
+  std::size_t up = std::lower_bound(x.begin(), x.end(), static_cast<double>(eta)) - x.begin();
+  if (up < n && x[up] == eta) {
+    return y[up];
+  }
+  std::size_t low = up - 1;
+  if (up == 0) {
+    low = 0;
+    up = 1;
+  } else if (up == n) {
+    low = n - 2;
+    up = n - 1;
+  }
+  return y[up] + (eta - x[up]) * (y[low] - y[up]) / (x[low] - x[up]);
 }
 
 } // namespace o2::pid::tof
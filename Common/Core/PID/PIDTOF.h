@@ -34,6 +34,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -283,6 +284,7 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
       }
       LOG(info) << "Resolution function for " << particleNames[i] << " is " << mResolution[i]->GetName() << " with formula " << mResolution[i]->GetFormula()->GetExpFormula();
     }
+    compileResolution();
   }
 
   void setResolutionParametrizationRun2(std::unordered_map<std::string, float> const& pars);
@@ -290,9 +292,35 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   template <o2::track::PID::ID pid>
   float getResolution(const float p, const float eta) const
   {
+    return getResolution(pid, p, eta);
+  }
+
+  /// Gets the tracking resolution for the species pid, from the compiled grid where it reproduces the parametrization and from the TF2 elsewhere
+  float getResolution(const o2::track::PID::ID pid, const float p, const float eta) const
+  {
+    ResolutionCell cell;
+    if (findResolutionCell(p, eta, cell) && (mResoGridCellOk[cell.index] & (1u << pid))) {
+      return interpolateResolution(cell, pid);
+    }
     return mResolution[pid]->Eval(p, eta);
   }
 
+  /// Gets the tracking resolution of several species for one track, finding the grid cell only once.
+  /// Each value is the same as getResolution(pid, p, eta)
+  /// \param resolutions output, only the species with their bit set in pidMask are filled
+  /// \param pidMask bit mask of the species to compute (bit i for o2::track::PID::ID i)
+  void getResolutions(const float p, const float eta, std::array<float, 9>& resolutions, const uint16_t pidMask = 0x1ff) const
+  {
+    ResolutionCell cell;
+    const uint16_t cellOk = findResolutionCell(p, eta, cell) ? mResoGridCellOk[cell.index] : 0;
+    for (o2::track::PID::ID pid = 0; pid < 9; pid++) {
+      if (!(pidMask & (1u << pid))) {
+        continue;
+      }
+      resolutions[pid] = (cellOk & (1u << pid)) ? interpolateResolution(cell, pid) : mResolution[pid]->Eval(p, eta);
+    }
+  }
+
   void printResolution() const
   {
     // Print a summary
@@ -320,6 +348,58 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   float mInvEtaWidth = 9999.f;
   std::vector<float> mContent;
   std::array<TF2*, 9> mResolution{nullptr};
+
+  // Resolution functions compiled into a grid uniform in log(p) and eta, bilinearly interpolated
+  static constexpr int mResoGridNP = 384;            // Number of cells in log(p)
+  static constexpr int mResoGridNEta = 96;           // Number of cells in eta
+  static constexpr float mResoGridPMin = 0.1f;       // Lower momentum edge of the grid, below the TF2 is evaluated
+  static constexpr float mResoGridPMax = 20.f;       // Upper momentum edge of the grid, above the TF2 is evaluated
+  static constexpr float mResoGridEtaMax = 1.f;      // The grid covers |eta| < mResoGridEtaMax
+  static constexpr double mResoGridTolerance = 1e-3; // Max. relative deviation from the TF2 for a cell to be used
+  float mResoGridLogPMin = 0.f;
+  float mResoGridInvDLogP = 0.f;
+  float mResoGridInvDEta = 0.f;
+  std::vector<float> mResoGridNodes;     // Node values, indexed as [iP][iEta][pid]
+  std::vector<uint16_t> mResoGridCellOk; // Per cell, bit pid is set if the interpolation reproduces the TF2 of that species
+
+  struct ResolutionCell {
+    int iP = 0;
+    int iEta = 0;
+    int index = 0;
+    float fP = 0.f;
+    float fEta = 0.f;
+  };
+
+  /// Tabulates the resolution functions on the grid and flags the cells where the interpolation is within mResoGridTolerance
+  void compileResolution();
+
+  bool findResolutionCell(const float p, const float eta, ResolutionCell& cell) const
+  {
+    if (mResoGridCellOk.empty() || !(p > 0.f)) {
+      return false;
+    }
+    const float u = (std::log(p) - mResoGridLogPMin) * mResoGridInvDLogP;
+    const float v = (eta + mResoGridEtaMax) * mResoGridInvDEta;
+    if (!(u >= 0.f && u < mResoGridNP && v >= 0.f && v < mResoGridNEta)) {
+      return false;
+    }
+    cell.iP = static_cast<int>(u);
+    cell.iEta = static_cast<int>(v);
+    cell.index = cell.iP * mResoGridNEta + cell.iEta;
+    cell.fP = u - cell.iP;
+    cell.fEta = v - cell.iEta;
+    return true;
+  }
+
+  float interpolateResolution(const ResolutionCell& cell, const int pid) const
+  {
+    const int nodesPerP = (mResoGridNEta + 1) * 9;
+    const float* n0 = &mResoGridNodes[(cell.iP * (mResoGridNEta + 1) + cell.iEta) * 9 + pid];
+    const float* n1 = n0 + nodesPerP;
+    const float r0 = n0[0] + cell.fEta * (n0[9] - n0[0]);
+    const float r1 = n1[0] + cell.fEta * (n1[9] - n1[0]);
+    return r0 + cell.fP * (r1 - r0);
+  }
   static constexpr std::array<const char*, 9> mDefaultResoParams{"14.3*TMath::Power((TMath::Max(x-0.319,0.1))*(1-0.4235*y*y),-0.8467)",
                                                                  "14.3*TMath::Power((TMath::Max(x-0.319,0.1))*(1-0.4235*y*y),-0.8467)",
                                                                  "14.3*TMath::Power((TMath::Max(x-0.319,0.1))*(1-0.4235*y*y),-0.8467)",
@@ -334,6 +414,17 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   // Time shift for post calibration
   TGraph* gPosEtaTimeCorr = nullptr; /// Time shift correction for positive tracks
   TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
+
+  // Owner of the time shift graphs built from the parameter map or read from file, [0] for negative and [1] for positive tracks.
+  // Empty when the graph was passed by the caller, who keeps ownership
+  std::array<std::shared_ptr<TGraph>, 2> mTimeShiftGraphs;
+
+  // Knots of the time shift graphs, [0] for negative and [1] for positive tracks. Empty if the graph is evaluated directly
+  std::array<std::vector<double>, 2> mTimeShiftEta;
+  std::array<std::vector<double>, 2> mTimeShiftValue;
+
+  /// Copies the knots of the time shift graph, evaluated with the same linear interpolation as TGraph::Eval
+  void compileTimeShift(const bool positive);
 };
 
 /// \brief Class to handle the the TOF detector response for the TOF beta measurement
@@ -490,7 +581,23 @@ class ExpTimes
     if (mom <= 0) {
       return -999.f;
     }
-    const float reso = parameters.template getResolution<id>(mom, etaTrack);
+    return GetExpectedSigmaFromTrackingResolution(parameters, track, tofSignal, collisionTimeRes, parameters.template getResolution<id>(mom, etaTrack));
+  }
+
+  /// Gets the expected resolution of the t-texp-t0, for a tracking resolution already evaluated
+  /// (e.g. for all species at once with TOFResoParamsV3::getResolutions)
+  /// \param parameters Detector response parameters
+  /// \param track Track of interest
+  /// \param tofSignal TOF signal of the track of interest
+  /// \param collisionTimeRes Collision time resolution of the track of interest
+  /// \param reso Tracking resolution of the track for this species, as parameters.getResolution<id>(p, eta)
+  template <typename ParamType>
+  static float GetExpectedSigmaFromTrackingResolution(const ParamType& parameters, const TrackType& track, const float tofSignal, const float collisionTimeRes, const float reso)
+  {
+    const float& mom = track.p();
+    if (mom <= 0) {
+      return -999.f;
+    }
     if (reso > 0) {
       return std::sqrt(reso * reso + parameters[4] * parameters[4] + collisionTimeRes * collisionTimeRes);
     }
@@ -520,6 +627,16 @@ class ExpTimes
     return GetExpectedSigma(parameters, track, track.tofSignal(), track.tofEvTimeErr());
   }
 
+  /// Gets the expected resolution of the t-texp-t0, for a tracking resolution already evaluated
+  /// \param parameters Detector response parameters
+  /// \param track Track of interest
+  /// \param reso Tracking resolution of the track for this species, as parameters.getResolution<id>(p, eta)
+  template <typename ParamType>
+  static float GetExpectedSigmaFromTrackingResolution(const ParamType& parameters, const TrackType& track, const float reso)
+  {
+    return GetExpectedSigmaFromTrackingResolution(parameters, track, track.tofSignal(), track.tofEvTimeErr(), reso);
+  }
+
   /// Gets the expected resolution of the time measurement, uses the expected time and no event time resolution
   /// \param parameters Parameters to use to compute the expected resolution
   /// \param track Track of interest
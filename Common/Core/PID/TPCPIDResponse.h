@@ -25,6 +25,8 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace o2::pid::tpc
@@ -90,6 +92,14 @@ class Response
   /// Gets the deviation to the expected signal
   template <typename TrackType>
   float GetSignalDelta(const TrackType& trk, const o2::track::PID::ID id) const;
+  /// Gets expected signal, expected resolution and number of sigmas of several TPC tracks for all the species in idMask (bit id for o2::track::PID::ID id).
+  /// Inputs have nTracks entries, outputs are indexed as [id * nTracks + iTrack]. Invalid values are set to -999 as in the single species getters
+  void GetNumberOfSigmas(const std::size_t nTracks, const float* tpcInnerParam, const float* tgl, const float* signed1Pt, const float* tpcNClsFound, const long* multTPC, const float* tpcSignal,
+                         const uint16_t idMask, float* expSignal, float* expSigma, float* nSigma) const;
+  /// Same as above for one track, with the signal to compare to explicitly provided
+  template <typename TrackType>
+  void GetNumberOfSigmasAtMultiplicity(const long multTPC, const TrackType& trk, const float tpcSignal, const uint16_t idMask,
+                                       std::array<float, o2::track::PID::NIDs>& expSignal, std::array<float, o2::track::PID::NIDs>& expSigma, std::array<float, o2::track::PID::NIDs>& nSigma) const;
 
   /// Gets relative dEdx resolution contribution due to relative pt resolution
   float GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const;
@@ -101,6 +111,21 @@ class Response
   template <typename TrackType>
   float sigmaFromSignal(float expectedSignal, const long multTPC, const TrackType& track, const o2::track::PID::ID id) const;
 
+  /// Bethe-Bloch of the mass hypothesis, without the MIP and charge factors. Shared by the expected signal and resolution of a track
+  float betheBloch(const float p, const o2::track::PID::ID id) const
+  {
+    return o2::common::BetheBlochAleph(p / o2::track::pid_constants::sMasses[id], mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]);
+  }
+  float chargeFactor(const o2::track::PID::ID id) const { return std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor); }
+  float expectedSignal(const float bethe, const float charge) const
+  {
+    const float signal = mMIP * bethe * charge;
+    return signal >= 0.f ? signal : -999.f;
+  }
+  /// Expected resolution, bethe and charge are only used by the full parametrization
+  float expectedSigma(const float expectedSignal, const float bethe, const float charge, const float p, const float tgl, const float signed1Pt, const float nClsFound, const long multTPC, const o2::track::PID::ID id) const;
+  float relativeResolutiondEdx(const float p, const float mass, const float dEdx, const float charge, const float resol) const;
+
   std::array<float, 5> mBetheBlochParams = {0.03209809958934784, 19.9768009185791, 2.5266601063857674e-16, 2.7212300300598145, 6.080920219421387};
   std::array<float, 2> mResolutionParamsDefault = {0.07, 0.0};
   std::vector<double> mResolutionParams = {5.43799e-7, 0.053044, 0.667584, 0.0142667, 0.00235175, 1.22482, 2.3501e-7, 0.031585};
@@ -121,8 +146,7 @@ inline float Response::GetExpectedSignal(const TrackType& track, const o2::track
   if (!track.hasTPC()) {
     return -999.f;
   }
-  const float bethe = mMIP * o2::common::BetheBlochAleph(track.tpcInnerParam() / o2::track::pid_constants::sMasses[id], mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
-  return bethe >= 0.f ? bethe : -999.f;
+  return expectedSignal(betheBloch(track.tpcInnerParam(), id), chargeFactor(id));
 }
 
 /// Gets the expected resolution of the measurement
@@ -145,22 +169,33 @@ inline float Response::GetExpectedSigmaAtMultiplicity(const long multTPC, const
 
 template <typename TrackType>
 inline float Response::sigmaFromSignal(float expectedSignal, const long multTPC, const TrackType& track, const o2::track::PID::ID id) const
+{
+  if (mUseDefaultResolutionParam) {
+    return expectedSigma(expectedSignal, 0.f, 0.f, track.tpcInnerParam(), track.tgl(), track.signed1Pt(), track.tpcNClsFound(), multTPC, id);
+  }
+  return expectedSigma(expectedSignal, betheBloch(track.tpcInnerParam(), id), chargeFactor(id), track.tpcInnerParam(), track.tgl(), track.signed1Pt(), track.tpcNClsFound(), multTPC, id);
+}
+
+inline float Response::expectedSigma(const float expectedSignal, const float bethe, const float charge, const float p, const float tgl, const float signed1Pt, const float nClsFound, const long multTPC, const o2::track::PID::ID id) const
 {
   float resolution = 0.f;
   if (mUseDefaultResolutionParam) {
-    const float reso = expectedSignal * mResolutionParamsDefault[0] * (static_cast<float>(track.tpcNClsFound()) > 0 ? std::sqrt(1. + mResolutionParamsDefault[1] / static_cast<float>(track.tpcNClsFound())) : 1.f);
+    const float reso = expectedSignal * mResolutionParamsDefault[0] * (nClsFound > 0 ? std::sqrt(1. + mResolutionParamsDefault[1] / nClsFound) : 1.f);
     reso >= 0.f ? resolution = reso : resolution = -999.f;
   } else {
-    const double ncl = nClNorm / track.tpcNClsFound();
-    const double p = track.tpcInnerParam();
-    const double mass = o2::track::pid_constants::sMasses[id];
-    const double bg = p / mass;
-    const double dEdx = o2::common::BetheBlochAleph(static_cast<float>(bg), mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
-    const double relReso = GetRelativeResolutiondEdx(p, mass, o2::track::pid_constants::sCharges[id], mResolutionParams[3]);
+    const float mass = o2::track::pid_constants::sMasses[id];
+    const float dEdxFloat = bethe * charge;
+    const double ncl = nClNorm / nClsFound;
+    const double dEdx = dEdxFloat;
+    const double relReso = relativeResolutiondEdx(p, mass, dEdxFloat, charge, mResolutionParams[3]);
 
-    const std::vector<double> values{1.f / dEdx, track.tgl(), std::sqrt(ncl), relReso, track.signed1Pt(), multTPC / mMultNormalization};
+    const double invdEdx = 1.f / dEdx;
+    const double tglD = tgl;
+    const double sqrtNcl = std::sqrt(ncl);
+    const double signed1PtD = signed1Pt;
+    const double mult = multTPC / mMultNormalization;
 
-    const float reso = sqrt(pow(mResolutionParams[0], 2) * values[0] + pow(mResolutionParams[1], 2) * (values[2] * mResolutionParams[5]) * pow(values[0] / sqrt(1 + pow(values[1], 2)), mResolutionParams[2]) + values[2] * pow(values[3], 2) + pow(mResolutionParams[4] * values[4], 2) + pow(values[5] * mResolutionParams[6], 2) + pow(values[5] * (values[0] / sqrt(1 + pow(values[1], 2))) * mResolutionParams[7], 2)) * dEdx * mMIP;
+    const float reso = sqrt(pow(mResolutionParams[0], 2) * invdEdx + pow(mResolutionParams[1], 2) * (sqrtNcl * mResolutionParams[5]) * pow(invdEdx / sqrt(1 + pow(tglD, 2)), mResolutionParams[2]) + sqrtNcl * pow(relReso, 2) + pow(mResolutionParams[4] * signed1PtD, 2) + pow(mult * mResolutionParams[6], 2) + pow(mult * (invdEdx / sqrt(1 + pow(tglD, 2))) * mResolutionParams[7], 2)) * dEdx * mMIP;
     reso >= 0.f ? resolution = reso : resolution = -999.f;
   }
   return resolution;
@@ -212,14 +247,57 @@ inline float Response::GetSignalDelta(const TrackType& trk, const o2::track::PID
   return trk.tpcSignal() - signal;
 }
 
+template <typename TrackType>
+inline void Response::GetNumberOfSigmasAtMultiplicity(const long multTPC, const TrackType& trk, const float tpcSignal, const uint16_t idMask,
+                                                      std::array<float, o2::track::PID::NIDs>& expSignal, std::array<float, o2::track::PID::NIDs>& expSigma, std::array<float, o2::track::PID::NIDs>& nSigma) const
+{
+  const float p = trk.tpcInnerParam();
+  const float tgl = trk.tgl();
+  const float signed1Pt = trk.signed1Pt();
+  const float nClsFound = trk.tpcNClsFound();
+  GetNumberOfSigmas(1, &p, &tgl, &signed1Pt, &nClsFound, &multTPC, &tpcSignal, idMask, expSignal.data(), expSigma.data(), nSigma.data());
+}
+
+/// The charge factors are computed once per call and the Bethe-Bloch once per track and species, then shared by the expected signal and resolution
+inline void Response::GetNumberOfSigmas(const std::size_t nTracks, const float* tpcInnerParam, const float* tgl, const float* signed1Pt, const float* tpcNClsFound, const long* multTPC, const float* tpcSignal,
+                                        const uint16_t idMask, float* expSignal, float* expSigma, float* nSigma) const
+{
+  for (o2::track::PID::ID id = 0; id < o2::track::PID::NIDs; id++) {
+    if (!(idMask & (1u << id))) {
+      continue;
+    }
+    const float charge = chargeFactor(id);
+    float* signalOut = expSignal + id * nTracks;
+    float* sigmaOut = expSigma + id * nTracks;
+    float* nSigmaOut = nSigma + id * nTracks;
+    for (std::size_t i = 0; i < nTracks; i++) {
+      const float bethe = betheBloch(tpcInnerParam[i], id);
+      const float signal = expectedSignal(bethe, charge);
+      signalOut[i] = signal;
+      if (signal < 0.f) {
+        sigmaOut[i] = -999.f;
+        nSigmaOut[i] = -999.f;
+        continue;
+      }
+      const float sigma = expectedSigma(signal, bethe, charge, tpcInnerParam[i], tgl[i], signed1Pt[i], tpcNClsFound[i], multTPC[i], id);
+      sigmaOut[i] = sigma;
+      nSigmaOut[i] = sigma < 0.f ? -999.f : (tpcSignal[i] - signal) / sigma;
+    }
+  }
+}
+
 //// Gets relative dEdx resolution contribution due relative pt resolution
 inline float Response::GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const
 {
-  const float bg = p / mass;
-  const float dEdx = o2::common::BetheBlochAleph(bg, mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(charge, mChargeFactor);
+  const float dEdx = o2::common::BetheBlochAleph(p / mass, mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(charge, mChargeFactor);
+  return relativeResolutiondEdx(p, mass, dEdx, std::pow(charge, mChargeFactor), resol);
+}
+
+inline float Response::relativeResolutiondEdx(const float p, const float mass, const float dEdx, const float charge, const float resol) const
+{
   const float deltaP = resol * std::sqrt(dEdx);
   const float bgDelta = p * (1 + deltaP) / mass;
-  const float dEdx2 = o2::common::BetheBlochAleph(bgDelta, mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(charge, mChargeFactor);
+  const float dEdx2 = o2::common::BetheBlochAleph(bgDelta, mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * charge;
   const float deltaRel = std::abs(dEdx2 - dEdx) / dEdx;
   return deltaRel;
 }
@@ -39,6 +39,9 @@
 /// - calculation of kinematic quantities
 /// - calculation of topological properties of secondary vertices
 /// - Monte Carlo matching of decays at track and particle level
+///
+/// The Monte Carlo matching functions accept an o2::common::core::McAncestryIndex (Common/Core/McAncestryIndex.h)
+/// in place of the MC particle table, so that repeated mother and daughter walks run on flat arrays.
 
 struct RecoDecay {
   // mapping of charm-hadron origin type
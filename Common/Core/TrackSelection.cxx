@@ -18,11 +18,14 @@
 #include <Framework/DataTypes.h>
 #include <Framework/Logger.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 bool TrackSelection::FulfillsITSHitRequirements(uint8_t itsClusterMap) const
 {
@@ -37,6 +40,68 @@ bool TrackSelection::FulfillsITSHitRequirements(uint8_t itsClusterMap) const
   return true;
 }
 
+void TrackSelection::TrackColumns::resize(std::size_t nTracks)
+{
+  trackType.resize(nTracks);
+  pt.resize(nTracks);
+  eta.resize(nTracks);
+  tpcNClsFound.resize(nTracks);
+  tpcNClsCrossedRows.resize(nTracks);
+  tpcCrossedRowsOverFindableCls.resize(nTracks);
+  tpcChi2NCl.resize(nTracks);
+  tpcRefit.resize(nTracks);
+  itsNCls.resize(nTracks);
+  itsChi2NCl.resize(nTracks);
+  itsRefit.resize(nTracks);
+  itsClusterMap.resize(nTracks);
+  goldenChi2.resize(nTracks);
+  absDcaXY.resize(nTracks);
+  absDcaZ.resize(nTracks);
+  tpcFractionSharedCls.resize(nTracks);
+}
+
+void TrackSelection::IsSelectedMask(const TrackColumns& columns, std::vector<uint16_t>& masks) const
+{
+  const std::size_t nTracks = columns.size();
+  masks.assign(nTracks, 0);
+
+  auto setFlag = [&](const TrackCuts& cut, auto isSelected) {
+    const uint16_t flag = 1u << static_cast<int>(cut);
+    for (std::size_t i = 0; i < nTracks; i++) {
+      masks[i] |= isSelected(i) ? flag : 0;
+    }
+  };
+
+  const uint8_t trackType = static_cast<uint8_t>(mTrackType);
+  setFlag(TrackCuts::kTrackType, [&](std::size_t i) { return columns.trackType[i] == trackType; });
+  setFlag(TrackCuts::kPtRange, [&](std::size_t i) { return columns.pt[i] >= mMinPt && columns.pt[i] <= mMaxPt; });
+  setFlag(TrackCuts::kEtaRange, [&](std::size_t i) { return columns.eta[i] >= mMinEta && columns.eta[i] <= mMaxEta; });
+  setFlag(TrackCuts::kTPCNCls, [&](std::size_t i) { return columns.tpcNClsFound[i] >= mMinNClustersTPC; });
+  setFlag(TrackCuts::kTPCCrossedRows, [&](std::size_t i) { return columns.tpcNClsCrossedRows[i] >= mMinNCrossedRowsTPC; });
+  setFlag(TrackCuts::kTPCCrossedRowsOverNCls, [&](std::size_t i) { return columns.tpcCrossedRowsOverFindableCls[i] >= mMinNCrossedRowsOverFindableClustersTPC; });
+  setFlag(TrackCuts::kTPCChi2NDF, [&](std::size_t i) { return columns.tpcChi2NCl[i] <= mMaxChi2PerClusterTPC; });
+  setFlag(TrackCuts::kTPCRefit, [&](std::size_t i) { return !mRequireTPCRefit || columns.tpcRefit[i]; });
+  setFlag(TrackCuts::kITSNCls, [&](std::size_t i) { return columns.itsNCls[i] >= mMinNClustersITS; });
+  setFlag(TrackCuts::kITSChi2NDF, [&](std::size_t i) { return columns.itsChi2NCl[i] <= mMaxChi2PerClusterITS; });
+  setFlag(TrackCuts::kITSRefit, [&](std::size_t i) { return !mRequireITSRefit || columns.itsRefit[i]; });
+
+  // the ITS hit requirements only depend on the 8 bit cluster map: tabulate them once
+  std::array<uint8_t, 256> itsHitsSelected{};
+  for (int itsClusterMap = 0; itsClusterMap < 256; itsClusterMap++) {
+    itsHitsSelected[itsClusterMap] = FulfillsITSHitRequirements(static_cast<uint8_t>(itsClusterMap));
+  }
+  setFlag(TrackCuts::kITSHits, [&](std::size_t i) { return itsHitsSelected[columns.itsClusterMap[i]] != 0; });
+
+  setFlag(TrackCuts::kGoldenChi2, [&](std::size_t i) { return !mRequireGoldenChi2 || columns.goldenChi2[i]; });
+  if (mMaxDcaXYPtDep) {
+    setFlag(TrackCuts::kDCAxy, [&](std::size_t i) { return columns.absDcaXY[i] <= mMaxDcaXYPtDep(columns.pt[i]); });
+  } else {
+    setFlag(TrackCuts::kDCAxy, [&](std::size_t i) { return columns.absDcaXY[i] <= mMaxDcaXY; });
+  }
+  setFlag(TrackCuts::kDCAz, [&](std::size_t i) { return columns.absDcaZ[i] <= mMaxDcaZ; });
+  setFlag(TrackCuts::kTPCFracSharedCls, [&](std::size_t i) { return columns.tpcFractionSharedCls[i] <= mMaxTPCFractionSharedCls; });
+}
+
 const std::string TrackSelection::mCutNames[static_cast<int>(TrackSelection::TrackCuts::kNCuts)] = {"TrackType", "PtRange", "EtaRange", "TPCNCls", "TPCCrossedRows", "TPCCrossedRowsOverNCls", "TPCChi2NDF", "TPCRefit", "ITSNCls", "ITSChi2NDF", "ITSRefit", "ITSHits", "GoldenChi2", "DCAxy", "DCAz", "TPCFracSharedCls"};
 
 void TrackSelection::SetTrackType(o2::aod::track::TrackTypeEnum trackType)
@@ -21,6 +21,7 @@
 #include <Rtypes.h>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <set>
@@ -70,6 +71,61 @@ class TrackSelection
 
   static const std::string mCutNames[static_cast<int>(TrackCuts::kNCuts)];
 
+  // Mask with the flags of all cuts set: IsSelected(track) is equivalent to IsSelectedMask(track) == kAllCutsMask
+  static constexpr uint16_t kAllCutsMask = (1u << static_cast<int>(TrackCuts::kNCuts)) - 1;
+
+  // Columns entering the cuts, read once per track table. Derived quantities (pt, eta, crossed rows over findable
+  // clusters, refit and golden chi2 flags, ITS cluster map, |DCA|) are computed here only once, so that any number
+  // of selections can be evaluated on them with IsSelectedMask(const TrackColumns&, ...)
+  struct TrackColumns {
+    std::vector<uint8_t> trackType;
+    std::vector<float> pt;
+    std::vector<float> eta;
+    std::vector<int16_t> tpcNClsFound;
+    std::vector<int16_t> tpcNClsCrossedRows;
+    std::vector<float> tpcCrossedRowsOverFindableCls;
+    std::vector<float> tpcChi2NCl;
+    std::vector<uint8_t> tpcRefit; // TPC refit flag for Run 2 tracks, TPC presence otherwise
+    std::vector<uint8_t> itsNCls;
+    std::vector<float> itsChi2NCl;
+    std::vector<uint8_t> itsRefit; // ITS refit flag for Run 2 tracks, ITS presence otherwise
+    std::vector<uint8_t> itsClusterMap;
+    std::vector<uint8_t> goldenChi2; // golden chi2 flag for Run 2 tracks, always set otherwise
+    std::vector<float> absDcaXY;
+    std::vector<float> absDcaZ;
+    std::vector<float> tpcFractionSharedCls;
+
+    std::size_t size() const { return pt.size(); }
+    void resize(std::size_t nTracks);
+
+    template <typename T>
+    void fill(T const& tracks)
+    {
+      resize(tracks.size());
+      std::size_t i = 0;
+      for (const auto& track : tracks) {
+        const bool isRun2 = track.trackType() == o2::aod::track::Run2Track || track.trackType() == o2::aod::track::Run2Tracklet;
+        trackType[i] = track.trackType();
+        pt[i] = track.pt();
+        eta[i] = track.eta();
+        tpcNClsFound[i] = track.tpcNClsFound();
+        tpcNClsCrossedRows[i] = track.tpcNClsCrossedRows();
+        tpcCrossedRowsOverFindableCls[i] = track.tpcCrossedRowsOverFindableCls();
+        tpcChi2NCl[i] = track.tpcChi2NCl();
+        tpcRefit[i] = isRun2 ? ((track.flags() & o2::aod::track::TPCrefit) != 0) : track.hasTPC();
+        itsNCls[i] = track.itsNCls();
+        itsChi2NCl[i] = track.itsChi2NCl();
+        itsRefit[i] = isRun2 ? ((track.flags() & o2::aod::track::ITSrefit) != 0) : track.hasITS();
+        itsClusterMap[i] = track.itsClusterMap();
+        goldenChi2[i] = isRun2 ? ((track.flags() & o2::aod::track::GoldenChi2) != 0) : true;
+        absDcaXY[i] = std::fabs(track.dcaXY());
+        absDcaZ[i] = std::fabs(track.dcaZ());
+        tpcFractionSharedCls[i] = track.tpcFractionSharedCls();
+        i++;
+      }
+    }
+  };
+
   // Temporary function to check if track passes selection criteria. To be replaced by framework filters.
   template <typename T>
   bool IsSelected(T const& track) const
@@ -157,6 +213,10 @@ class TrackSelection
     return flag;
   }
 
+  // Columnar version of IsSelectedMask: masks[i] is set to the flags of the i-th track of the columns.
+  // Each cut is applied to all tracks in turn, so that the loops stay free of per-track dispatch
+  void IsSelectedMask(const TrackColumns& columns, std::vector<uint16_t>& masks) const;
+
   // Temporary function to check if track passes a given selection criteria. To be replaced by framework filters.
   template <typename T>
   bool IsSelected(T const& track, const TrackCuts& cut) const
@@ -401,6 +401,9 @@ struct tofEventTime {
     if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 1) {
       int lastCollisionId = -1;                                                                                                                 // Last collision ID analysed
       for (auto const& t : tracks) {                                                                                                            // Loop on collisions
+        if (t.has_collision() && t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
+          continue;
+        }
         if (!t.has_collision() || collisions.size() == 0 || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisionsFT0>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
@@ -409,9 +412,6 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
         /// Create new table for the tracks in a collision
         lastCollisionId = t.collisionId(); /// Cache last collision ID
 
@@ -423,6 +423,21 @@ struct tofEventTime {
         float t0AC[2] = {.0f, 999.f};                                                                                             // Value and error of T0A or T0C or T0AC
         float t0TOF[2] = {static_cast<float_t>(evTimeMakerTOF.mEventTime), static_cast<float_t>(evTimeMakerTOF.mEventTimeError)}; // Value and error of TOF
 
+        // The FT0 term of the weighted mean is the same for all the tracks of the collision
+        const bool hasFT0 = collision.has_foundFT0(); // T0 measurement is available
+        uint8_t flagsFT0 = 0;
+        float weightFT0 = 0.f;
+        float weightedTimeFT0 = 0.f;
+        if (hasFT0) {
+          if (collision.t0ACValid()) {
+            t0AC[0] = collision.t0AC() * 1000.f;
+            t0AC[1] = collision.t0resolution() * 1000.f;
+            flagsFT0 = o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
+          }
+          weightFT0 = 1.f / (t0AC[1] * t0AC[1]);
+          weightedTimeFT0 = t0AC[0] * weightFT0;
+        }
+
         uint8_t flags = 0;
         int nGoodTracksForTOF = 0;
         float eventTime = 0.f;
@@ -448,17 +463,10 @@ struct tofEventTime {
             sumOfWeights += weight;
           }
 
-          if (collision.has_foundFT0()) { // T0 measurement is available
-            // const auto& ft0 = collision.foundFT0();
-            if (collision.t0ACValid()) {
-              t0AC[0] = collision.t0AC() * 1000.f;
-              t0AC[1] = collision.t0resolution() * 1000.f;
-              flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
-            }
-
-            weight = 1.f / (t0AC[1] * t0AC[1]);
-            eventTime += t0AC[0] * weight;
-            sumOfWeights += weight;
+          if (hasFT0) {
+            flags |= flagsFT0;
+            eventTime += weightedTimeFT0;
+            sumOfWeights += weightFT0;
           }
 
           if (sumOfWeights < kWeightDiamond) { // avoiding sumOfWeights = 0 or worse that kDiamond
@@ -477,6 +485,9 @@ struct tofEventTime {
     } else if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 0) {
       int lastCollisionId = -1;                                                                                                              // Last collision ID analysed
       for (auto const& t : tracks) {                                                                                                         // Loop on collisions
+        if (t.has_collision() && t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
+          continue;
+        }
         if (!t.has_collision() || collisions.size() == 0 || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisions>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
@@ -485,9 +496,6 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
         /// Create new table for the tracks in a collision
         lastCollisionId = t.collisionId(); /// Cache last collision ID
 
@@ -622,6 +630,7 @@ struct tofPidMerge {
   // Running variables
   std::vector<int> mEnabledParticles;     // Vector of enabled PID hypotheses to loop on when making tables
   std::vector<int> mEnabledParticlesFull; // Vector of enabled PID hypotheses to loop on when making full tables
+  uint16_t mResolutionPidMask = 0;        // Bit mask of the PID hypotheses enabled in the standard or full tables
   void init(o2::framework::InitContext& initContext)
   {
     LOG(debug) << "Initializing the TOF PID Merge task";
@@ -633,6 +642,7 @@ struct tofPidMerge {
       o2::common::core::enableFlagIfTableRequired(initContext, "pidTOF" + particleNames[i], f);
       if (f == 1) {
         mEnabledParticles.push_back(i);
+        mResolutionPidMask |= 1u << i;
       }
 
       // Then checking full tables
@@ -640,6 +650,7 @@ struct tofPidMerge {
       o2::common::core::enableFlagIfTableRequired(initContext, "pidTOFFull" + particleNames[i], f);
       if (f == 1) {
         mEnabledParticlesFull.push_back(i);
+        mResolutionPidMask |= 1u << i;
       }
     }
     if (mEnabledParticlesFull.size() == 0 && mEnabledParticles.size() == 0) {
@@ -906,6 +917,7 @@ struct tofPidMerge {
 
     float resolution = 1.f; // Last resolution assigned
     float nsigma = 0;
+    std::array<float, nSpecies> trackingResolutions{}; // Tracking resolution of the enabled species for the current track
     for (auto const& trk : tracks) {                        // Loop on all tracks
       if (!trk.has_collision() || collisions.size() == 0) { // Track was not assigned, cannot compute NSigma (no event time) -> filling with empty table
         for (auto const& pidId : mEnabledParticles) {
@@ -916,51 +928,54 @@ struct tofPidMerge {
         }
         continue;
       }
+      if (trk.p() > 0) { // Tracking resolution of all enabled species with a single lookup of the resolution grid
+        tofResponse->parameters.getResolutions(trk.p(), trk.eta(), trackingResolutions, mResolutionPidMask);
+      }
 
       for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
         switch (pidId) {
           case kIdxEl: {
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk, responseEl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxEl]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDEl);
             break;
           }
           case kIdxMu: {
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk, responseMu.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxMu]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDMu);
             break;
           }
           case kIdxPi: {
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk, responsePi.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPi]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPi);
             break;
           }
           case kIdxKa: {
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk, responseKa.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxKa]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDKa);
             break;
           }
           case kIdxPr: {
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk, responsePr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPr]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPr);
             break;
           }
           case kIdxDe: {
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk, responseDe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxDe]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDDe);
             break;
           }
           case kIdxTr: {
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk, responseTr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxTr]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDTr);
             break;
           }
           case kIdxHe: {
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk, responseHe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxHe]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDHe);
             break;
           }
           case kIdxAl: {
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk, responseAl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxAl]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDAl);
             break;
           }
@@ -975,55 +990,55 @@ struct tofPidMerge {
       for (auto const& pidId : mEnabledParticlesFull) { // Loop on enabled particle hypotheses with full tables
         switch (pidId) {
           case kIdxEl: {
-            resolution = responseEl.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseEl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxEl]);
             nsigma = responseEl.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullEl(resolution, nsigma);
             break;
           }
           case kIdxMu: {
-            resolution = responseMu.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseMu.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxMu]);
             nsigma = responseMu.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullMu(resolution, nsigma);
             break;
           }
           case kIdxPi: {
-            resolution = responsePi.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
+            resolution = responsePi.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPi]);
+            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullPi(resolution, nsigma);
             break;
           }
           case kIdxKa: {
-            resolution = responseKa.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseKa.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxKa]);
             nsigma = responseKa.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullKa(resolution, nsigma);
             break;
           }
           case kIdxPr: {
-            resolution = responsePr.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responsePr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPr]);
             nsigma = responsePr.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullPr(resolution, nsigma);
             break;
           }
           case kIdxDe: {
-            resolution = responseDe.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseDe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxDe]);
             nsigma = responseDe.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullDe(resolution, nsigma);
             break;
           }
           case kIdxTr: {
-            resolution = responseTr.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseTr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxTr]);
             nsigma = responseTr.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullTr(resolution, nsigma);
             break;
           }
           case kIdxHe: {
-            resolution = responseHe.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseHe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxHe]);
             nsigma = responseHe.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullHe(resolution, nsigma);
             break;
           }
           case kIdxAl: {
-            resolution = responseAl.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseAl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxAl]);
             nsigma = responseAl.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullAl(resolution, nsigma);
             break;
@@ -1068,6 +1083,7 @@ struct tofPidMerge {
 
     float resolution = 1.f; // Last resolution assigned
     float nsigma = 0;
+    std::array<float, nSpecies> trackingResolutions{}; // Tracking resolution of the enabled species for the current track
     for (auto const& trk : tracks) {                        // Loop on all tracks
       if (!trk.has_collision() || collisions.size() == 0) { // Track was not assigned, cannot compute NSigma (no event time) -> filling with empty table
         for (auto const& pidId : mEnabledParticles) {
@@ -1078,51 +1094,54 @@ struct tofPidMerge {
         }
         continue;
       }
+      if (trk.p() > 0) { // Tracking resolution of all enabled species with a single lookup of the resolution grid
+        tofResponse->parameters.getResolutions(trk.p(), trk.eta(), trackingResolutions, mResolutionPidMask);
+      }
 
       for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
         switch (pidId) {
           case kIdxEl: {
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk, responseEl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxEl]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDEl);
             break;
           }
           case kIdxMu: {
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk, responseMu.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxMu]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDMu);
             break;
           }
           case kIdxPi: {
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk, responsePi.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPi]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPi);
             break;
           }
           case kIdxKa: {
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk, responseKa.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxKa]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDKa);
             break;
           }
           case kIdxPr: {
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk, responsePr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPr]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPr);
             break;
           }
           case kIdxDe: {
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk, responseDe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxDe]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDDe);
             break;
           }
           case kIdxTr: {
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk, responseTr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxTr]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDTr);
             break;
           }
           case kIdxHe: {
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk, responseHe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxHe]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDHe);
             break;
           }
           case kIdxAl: {
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk);
+            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk, responseAl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxAl]));
             aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDAl);
             break;
           }
@@ -1137,55 +1156,55 @@ struct tofPidMerge {
       for (auto const& pidId : mEnabledParticlesFull) { // Loop on enabled particle hypotheses with full tables
         switch (pidId) {
           case kIdxEl: {
-            resolution = responseEl.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseEl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxEl]);
             nsigma = responseEl.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullEl(resolution, nsigma);
             break;
           }
           case kIdxMu: {
-            resolution = responseMu.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseMu.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxMu]);
             nsigma = responseMu.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullMu(resolution, nsigma);
             break;
           }
           case kIdxPi: {
-            resolution = responsePi.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
+            resolution = responsePi.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPi]);
+            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullPi(resolution, nsigma);
             break;
           }
           case kIdxKa: {
-            resolution = responseKa.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseKa.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxKa]);
             nsigma = responseKa.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullKa(resolution, nsigma);
             break;
           }
           case kIdxPr: {
-            resolution = responsePr.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responsePr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxPr]);
             nsigma = responsePr.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullPr(resolution, nsigma);
             break;
           }
           case kIdxDe: {
-            resolution = responseDe.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseDe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxDe]);
             nsigma = responseDe.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullDe(resolution, nsigma);
             break;
           }
           case kIdxTr: {
-            resolution = responseTr.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseTr.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxTr]);
             nsigma = responseTr.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullTr(resolution, nsigma);
             break;
           }
           case kIdxHe: {
-            resolution = responseHe.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseHe.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxHe]);
             nsigma = responseHe.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullHe(resolution, nsigma);
             break;
           }
           case kIdxAl: {
-            resolution = responseAl.GetExpectedSigma(tofResponse->parameters, trk);
+            resolution = responseAl.GetExpectedSigmaFromTrackingResolution(tofResponse->parameters, trk, trackingResolutions[kIdxAl]);
             nsigma = responseAl.GetSeparation(tofResponse->parameters, trk, resolution);
             tablePIDFullAl(resolution, nsigma);
             break;
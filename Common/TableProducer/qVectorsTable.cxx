@@ -43,11 +43,11 @@
 #include <Framework/RunningWorkflowInfo.h>
 #include <Framework/runDataProcessing.h>
 
-#include <TComplex.h>
 #include <TH3.h>
 #include <TProfile3D.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
@@ -184,6 +184,59 @@ struct QVectorsTable {
 
   std::vector<TH3F*> corrsQvecSp{};
   std::vector<TH3F*> corrsQvecEse{};
+
+  /// Recentering, twist and rescaling constants of one harmonic, copied once per run from the
+  /// TH3 of the CCDB (x: centrality bin, y: constant, z: detector) for the lookups in correctQVec.
+  struct QvecCorrTable {
+    static constexpr int NConstants = 6;
+    int nCentBins = 0;           // including under- and overflow bins
+    std::vector<float> values{}; // [centrality bin][constant][detector]
+
+    void fill(TH3F const* hist)
+    {
+      nCentBins = hist->GetNbinsX() + 2;
+      values.resize(nCentBins * NConstants * kNDetectors);
+      for (int iCent = 0; iCent < nCentBins; iCent++) {
+        for (int iConst = 0; iConst < NConstants; iConst++) {
+          for (int iDet = 0; iDet < kNDetectors; iDet++) {
+            values[(iCent * NConstants + iConst) * kNDetectors + iDet] = hist->GetBinContent(iCent, iConst + 1, iDet + 1);
+          }
+        }
+      }
+    }
+
+    /// Same value as TH3::GetBinContent(centBin, constant, det + 1), constant counted from 1
+    float get(int centBin, int constant, int det) const
+    {
+      centBin = std::clamp(centBin, 0, nCentBins - 1);
+      return values[(centBin * NConstants + constant - 1) * kNDetectors + det];
+    }
+  };
+  std::vector<QvecCorrTable> corrTablesQvecSp{};
+  std::vector<QvecCorrTable> corrTablesQvecEse{};
+
+  // Gain-equalised FIT amplitudes of the current collision, read once for all harmonics.
+  struct FITChannels {
+    std::vector<int> channels{};
+    std::vector<float> ampls{};    // raw amplitudes, for the QA
+    std::vector<float> amplsCor{}; // amplitudes divided by the relative gain
+
+    void clear()
+    {
+      channels.clear();
+      ampls.clear();
+      amplsCor.clear();
+    }
+    void add(int chId, float ampl, float amplCor)
+    {
+      channels.push_back(chId);
+      ampls.push_back(ampl);
+      amplsCor.push_back(amplCor);
+    }
+  };
+  FITChannels channelsFT0A;
+  FITChannels channelsFT0C;
+  FITChannels channelsFV0A;
   std::vector<TProfile3D*> shiftProfileSp{};
   std::vector<TProfile3D*> shiftProfileEse{};
 
@@ -292,6 +345,9 @@ struct QVectorsTable {
       LOGF(fatal, "Could not get the alignment parameters for FV0.");
     }
 
+    // The channel angles depend on the offsets: tabulate cos(n*phi) and sin(n*phi) for this run.
+    helperEP.BuildHarmonicTables(cfgnMods.value, ft0geom, fv0geom);
+
     corrsQvecSp.clear();
     for (std::size_t i = 0; i < cfgnMods->size(); i++) {
       int ind = cfgnMods->at(i);
@@ -310,6 +366,10 @@ struct QVectorsTable {
       }
       corrsQvecSp.push_back(modeCorrQvecSp);
     }
+    corrTablesQvecSp.resize(corrsQvecSp.size());
+    for (std::size_t i = 0; i < corrsQvecSp.size(); i++) {
+      corrTablesQvecSp[i].fill(corrsQvecSp[i]);
+    }
 
     if (cfgProduceRedQVecs) {
       corrsQvecEse.clear();
@@ -330,6 +390,10 @@ struct QVectorsTable {
         }
         corrsQvecEse.push_back(modeCorrQvecEse);
       }
+      corrTablesQvecEse.resize(corrsQvecEse.size());
+      for (std::size_t i = 0; i < corrsQvecEse.size(); i++) {
+        corrTablesQvecEse[i].fill(corrsQvecEse[i]);
+      }
     }
 
     if (cfgShiftCorr) {
@@ -471,28 +535,29 @@ struct QVectorsTable {
   /// \param centrality is the collision centrality
   /// \param qVecRe is the vector with the real part of the q-vector for each detector and correction step
   /// \param qVecIm is the vector with the imaginary part of the q-vector for each detector and correction step
-  /// \param histsCorrs is the vector with the histograms with the correction constants for each detector and correction step
+  /// \param corrs is the table with the correction constants for each detector and correction step
   /// \param nMode is the modulation of interest
-  void correctQVec(float centrality, std::vector<float>& qVecRe, std::vector<float>& qVecIm, TH3F* histsCorrs, std::vector<TProfile3D*>& shiftProfile, int nMode)
+  void correctQVec(float centrality, std::vector<float>& qVecRe, std::vector<float>& qVecIm, QvecCorrTable const& corrs, std::vector<TProfile3D*>& shiftProfile, int nMode)
   {
     int nCorrections = static_cast<int>(kNCorrections);
     if (centrality < cfgMaxCentrality) {
+      const int centBin = static_cast<int>(centrality) + 1;
       for (auto i{0u}; i < kTPCAll + 1; i++) {
         int idxDet = i * kNCorrections;
         helperEP.DoRecenter(qVecRe[idxDet + kRecenter], qVecIm[idxDet + kRecenter],
-                            histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 2, i + 1));
+                            corrs.get(centBin, 1, i), corrs.get(centBin, 2, i));
 
         helperEP.DoRecenter(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist],
-                            histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 2, i + 1));
+                            corrs.get(centBin, 1, i), corrs.get(centBin, 2, i));
         helperEP.DoTwist(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist],
-                         histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 3, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 4, i + 1));
+                         corrs.get(centBin, 3, i), corrs.get(centBin, 4, i));
 
         helperEP.DoRecenter(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                            histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 2, i + 1));
+                            corrs.get(centBin, 1, i), corrs.get(centBin, 2, i));
         helperEP.DoTwist(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                         histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 3, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 4, i + 1));
+                         corrs.get(centBin, 3, i), corrs.get(centBin, 4, i));
         helperEP.DoRescale(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                           histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 5, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 6, i + 1));
+                           corrs.get(centBin, 5, i), corrs.get(centBin, 6, i));
       }
       if (cfgShiftCorr) {
         auto deltaPsiFT0C = 0.0;
@@ -577,8 +642,55 @@ struct QVectorsTable {
     }
   }
 
+  /// Function to read the FIT amplitudes of the collision once for all harmonics
+  /// \param coll is the collision object
+  template <typename CollType>
+  void readFITChannels(const CollType& coll)
+  {
+    channelsFT0A.clear();
+    channelsFT0C.clear();
+    channelsFV0A.clear();
+    if (!coll.has_foundFT0() || !(useDetector["QvectorFT0As"] || useDetector["QvectorFT0Cs"] || useDetector["QvectorFT0Ms"])) {
+      return;
+    }
+    auto ft0 = coll.foundFT0();
+    if (useDetector["QvectorFT0As"]) {
+      for (std::size_t iChA = 0; iChA < ft0.channelA().size(); iChA++) {
+        float ampl = ft0.amplitudeA()[iChA];
+        int ft0AchId = ft0.channelA()[iChA];
+        channelsFT0A.add(ft0AchId, ampl, ampl / ft0RelGainConst[ft0AchId]);
+      }
+    }
+    if (useDetector["QvectorFT0Cs"]) {
+      for (std::size_t iChC = 0; iChC < ft0.channelC().size(); iChC++) {
+        float ampl = ft0.amplitudeC()[iChC];
+        int ft0CchId = ft0.channelC()[iChC] + 96;
+        channelsFT0C.add(ft0CchId, ampl, ampl / ft0RelGainConst[ft0CchId]);
+      }
+    }
+    if (coll.has_foundFV0() && useDetector["QvectorFV0As"]) {
+      auto fv0 = coll.foundFV0();
+      for (std::size_t iCh = 0; iCh < fv0.channel().size(); iCh++) {
+        float ampl = fv0.amplitude()[iCh];
+        int fv0AchId = fv0.channel()[iCh];
+        channelsFV0A.add(fv0AchId, ampl, ampl / fv0RelGainConst[fv0AchId]);
+      }
+    }
+  }
+
+  /// Function to fill the amplitude QA histograms of one FIT detector
+  template <typename THistRaw, typename THistCor>
+  void fillFITQA(FITChannels const& fit, THistRaw histRaw, THistCor histCor)
+  {
+    for (std::size_t iCh = 0; iCh < fit.channels.size(); iCh++) {
+      histosQA.fill(histRaw, fit.ampls[iCh], fit.channels[iCh]);
+      histosQA.fill(histCor, fit.amplsCor[iCh], fit.channels[iCh]);
+    }
+  }
+
   /// Function to calculate the un-normalized q-vectors
   /// \param nMode is the harmonic number of the q-vector
+  /// \param iHarm is the position of the harmonic in cfgnMods
   /// \param coll is the collision object
   /// \param tracks are the tracks associated to the collision
   /// \param qVecRe is the vector with the real part of the q-vector for each detector
@@ -588,7 +700,7 @@ struct QVectorsTable {
   /// \param trkTPCNegLabel is the vector with the number of TPC tracks with negative eta
   /// \param trkTPCAllLabel is the vector with the number of TPC tracks with any eta
   template <typename Nmode, typename CollType, typename TrackType>
-  void calcQVec(const Nmode nMode, const CollType& coll, const TrackType& tracks, std::vector<float>& qVecRe, std::vector<float>& qVecIm, std::vector<float>& qVecAmp, std::vector<int>& trkTPCPosLabel, std::vector<int>& trkTPCNegLabel, std::vector<int>& trkTPCAllLabel)
+  void calcQVec(const Nmode nMode, std::size_t iHarm, const CollType& coll, const TrackType& tracks, std::vector<float>& qVecRe, std::vector<float>& qVecIm, std::vector<float>& qVecAmp, std::vector<int>& trkTPCPosLabel, std::vector<int>& trkTPCNegLabel, std::vector<int>& trkTPCAllLabel)
   {
     float qVectFT0A[2] = {-999., -999.};
     float qVectFT0C[2] = {-999., -999.};
@@ -598,73 +710,49 @@ struct QVectorsTable {
     float qVectTPCNeg[2] = {0., 0.}; // Always computed
     float qVectTPCAll[2] = {0., 0.}; // Always computed
 
-    TComplex qVecDet(0);
-    TComplex qVecFT0M(0);
+    double qVecDet[2] = {0., 0.};
+    double qVecFT0M[2] = {0., 0.};
     float sumAmplFT0A = 0.;
     float sumAmplFT0C = 0.;
     float sumAmplFT0M = 0.;
     float sumAmplFV0A = 0.;
 
     if (coll.has_foundFT0() && (useDetector["QvectorFT0As"] || useDetector["QvectorFT0Cs"] || useDetector["QvectorFT0Ms"])) {
-      auto ft0 = coll.foundFT0();
-
       if (useDetector["QvectorFT0As"]) {
-        for (std::size_t iChA = 0; iChA < ft0.channelA().size(); iChA++) {
-          float ampl = ft0.amplitudeA()[iChA];
-          int ft0AchId = ft0.channelA()[iChA];
-
-          histosQA.fill(HIST("FT0Amp"), ampl, ft0AchId);
-          histosQA.fill(HIST("FT0AmpCor"), ampl / ft0RelGainConst[ft0AchId], ft0AchId);
-
-          helperEP.SumQvectors(0, ft0AchId, ampl / ft0RelGainConst[ft0AchId], nMode, qVecDet, sumAmplFT0A, ft0geom, fv0geom);
-          helperEP.SumQvectors(0, ft0AchId, ampl / ft0RelGainConst[ft0AchId], nMode, qVecFT0M, sumAmplFT0M, ft0geom, fv0geom);
-        }
+        fillFITQA(channelsFT0A, HIST("FT0Amp"), HIST("FT0AmpCor"));
+        helperEP.SumQvectors(0, channelsFT0A.channels, channelsFT0A.amplsCor, iHarm, qVecDet[0], qVecDet[1], sumAmplFT0A);
+        helperEP.SumQvectors(0, channelsFT0A.channels, channelsFT0A.amplsCor, iHarm, qVecFT0M[0], qVecFT0M[1], sumAmplFT0M);
         if (sumAmplFT0A > minAmplitude) {
-          qVectFT0A[0] = qVecDet.Re();
-          qVectFT0A[1] = qVecDet.Im();
+          qVectFT0A[0] = qVecDet[0];
+          qVectFT0A[1] = qVecDet[1];
         }
       }
 
       if (useDetector["QvectorFT0Cs"]) {
-        qVecDet = TComplex(0., 0.);
-        for (std::size_t iChC = 0; iChC < ft0.channelC().size(); iChC++) {
-          float ampl = ft0.amplitudeC()[iChC];
-          int ft0CchId = ft0.channelC()[iChC] + 96;
-
-          histosQA.fill(HIST("FT0Amp"), ampl, ft0CchId);
-          histosQA.fill(HIST("FT0AmpCor"), ampl / ft0RelGainConst[ft0CchId], ft0CchId);
-
-          helperEP.SumQvectors(0, ft0CchId, ampl / ft0RelGainConst[ft0CchId], nMode, qVecDet, sumAmplFT0C, ft0geom, fv0geom);
-          helperEP.SumQvectors(0, ft0CchId, ampl / ft0RelGainConst[ft0CchId], nMode, qVecFT0M, sumAmplFT0M, ft0geom, fv0geom);
-        }
+        qVecDet[0] = qVecDet[1] = 0.;
+        fillFITQA(channelsFT0C, HIST("FT0Amp"), HIST("FT0AmpCor"));
+        helperEP.SumQvectors(0, channelsFT0C.channels, channelsFT0C.amplsCor, iHarm, qVecDet[0], qVecDet[1], sumAmplFT0C);
+        helperEP.SumQvectors(0, channelsFT0C.channels, channelsFT0C.amplsCor, iHarm, qVecFT0M[0], qVecFT0M[1], sumAmplFT0M);
 
         if (sumAmplFT0C > minAmplitude) {
-          qVectFT0C[0] = qVecDet.Re();
-          qVectFT0C[1] = qVecDet.Im();
+          qVectFT0C[0] = qVecDet[0];
+          qVectFT0C[1] = qVecDet[1];
         }
         if (sumAmplFT0M > minAmplitude && useDetector["QvectorFT0Ms"]) {
-          qVectFT0M[0] = qVecFT0M.Re();
-          qVectFT0M[1] = qVecFT0M.Im();
+          qVectFT0M[0] = qVecFT0M[0];
+          qVectFT0M[1] = qVecFT0M[1];
         }
       }
 
-      qVecDet = TComplex(0., 0.);
+      qVecDet[0] = qVecDet[1] = 0.;
       sumAmplFV0A = 0;
       if (coll.has_foundFV0() && useDetector["QvectorFV0As"]) {
-        auto fv0 = coll.foundFV0();
-
-        for (std::size_t iCh = 0; iCh < fv0.channel().size(); iCh++) {
-          float ampl = fv0.amplitude()[iCh];
-          int fv0AchId = fv0.channel()[iCh];
-          histosQA.fill(HIST("FV0Amp"), ampl, fv0AchId);
-          histosQA.fill(HIST("FV0AmpCor"), ampl / fv0RelGainConst[fv0AchId], fv0AchId);
-
-          helperEP.SumQvectors(1, fv0AchId, ampl / fv0RelGainConst[fv0AchId], nMode, qVecDet, sumAmplFV0A, ft0geom, fv0geom);
-        }
+        fillFITQA(channelsFV0A, HIST("FV0Amp"), HIST("FV0AmpCor"));
+        helperEP.SumQvectors(1, channelsFV0A.channels, channelsFV0A.amplsCor, iHarm, qVecDet[0], qVecDet[1], sumAmplFV0A);
 
         if (sumAmplFV0A > minAmplitude) {
-          qVectFV0A[0] = qVecDet.Re();
-          qVectFV0A[1] = qVecDet.Im();
+          qVectFV0A[0] = qVecDet[0];
+          qVectFV0A[1] = qVecDet[1];
         }
       }
     }
@@ -786,19 +874,20 @@ struct QVectorsTable {
       isCalibrated = false;
     }
 
+    readFITChannels(coll);
     for (std::size_t id = 0; id < cfgnMods->size(); id++) {
       int nMode = cfgnMods->at(id);
 
       // Raw Q-vectors, no multiplicity normalization and no corrections
       std::vector<float> qVecReRaw{};
       std::vector<float> qVecImRaw{};
-      calcQVec(nMode, coll, tracks, qVecReRaw, qVecImRaw, qVecAmp, trkTPCPosLabel, trkTPCNegLabel, trkTPCAllLabel);
+      calcQVec(nMode, id, coll, tracks, qVecReRaw, qVecImRaw, qVecAmp, trkTPCPosLabel, trkTPCNegLabel, trkTPCAllLabel);
 
       // Scalar Product Q-vectors, normalization by multiplicity/amplitude
       std::vector<float> nModeQVecReSp{};
       std::vector<float> nModeQVecImSp{};
       normalizeQVec(nModeQVecReSp, nModeQVecImSp, qVecReRaw, qVecImRaw, qVecAmp, MultNorms::kScalarProd);
-      correctQVec(cent, nModeQVecReSp, nModeQVecImSp, corrsQvecSp[id], shiftProfileSp, nMode);
+      correctQVec(cent, nModeQVecReSp, nModeQVecImSp, corrTablesQvecSp[id], shiftProfileSp, nMode);
       // Add to summary vector
       qVecReSp.insert(qVecReSp.end(), nModeQVecReSp.begin(), nModeQVecReSp.end());
       qVecImSp.insert(qVecImSp.end(), nModeQVecImSp.begin(), nModeQVecImSp.end());
@@ -828,7 +917,7 @@ struct QVectorsTable {
         std::vector<float> nModeQVecReEse{};
         std::vector<float> nModeQVecImEse{};
         normalizeQVec(nModeQVecReEse, nModeQVecImEse, qVecReRaw, qVecImRaw, qVecAmp, MultNorms::kEsE);
-        correctQVec(cent, nModeQVecReEse, nModeQVecImEse, corrsQvecEse[id], shiftProfileEse, nMode);
+        correctQVec(cent, nModeQVecReEse, nModeQVecImEse, corrTablesQvecEse[id], shiftProfileEse, nMode);
         // Add to summary vector
         qVecReEse.insert(qVecReEse.end(), nModeQVecReEse.begin(), nModeQVecReEse.end());
         qVecImEse.insert(qVecImEse.end(), nModeQVecImEse.begin(), nModeQVecImEse.end());
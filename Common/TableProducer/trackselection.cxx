@@ -31,7 +31,9 @@
 #include <Framework/InitContext.h>
 #include <Framework/runDataProcessing.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -65,6 +67,16 @@ struct TrackSelectionTask {
   TrackSelection filtBit4;
   TrackSelection filtBit5;
 
+  // Per-track columns and selection masks of each track selection, refilled for every table
+  TrackSelection::TrackColumns trackColumns;
+  std::vector<o2::aod::track::TrackSelectionFlags::flagtype> maskGlobal;
+  std::vector<o2::aod::track::TrackSelectionFlags::flagtype> maskSDD;
+  std::vector<o2::aod::track::TrackSelectionFlags::flagtype> maskFB1;
+  std::vector<o2::aod::track::TrackSelectionFlags::flagtype> maskFB2;
+  std::vector<o2::aod::track::TrackSelectionFlags::flagtype> maskFB3;
+  std::vector<o2::aod::track::TrackSelectionFlags::flagtype> maskFB4;
+  std::vector<o2::aod::track::TrackSelectionFlags::flagtype> maskFB5;
+
   void init(InitContext& initContext)
   {
     // Check which tables are used
@@ -155,60 +167,36 @@ struct TrackSelectionTask {
     if (produceTable == 0 && produceFBextendedTable == 0) {
       return;
     }
-    if (isRun3) {
-      for (const auto& track : tracks) {
-
-        if (produceTable == 1) {
-          filterTable((uint8_t)0,
-                      globalTracks.IsSelectedMask(track),
-                      filtBit1.IsSelected(track),
-                      filtBit2.IsSelected(track),
-                      filtBit3.IsSelected(track),
-                      filtBit4.IsSelected(track),
-                      filtBit5.IsSelected(track));
-        }
-        if (produceFBextendedTable == 1) {
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = globalTracks.IsSelectedMask(track);
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB1 = filtBit1.IsSelectedMask(track);
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB2 = filtBit2.IsSelectedMask(track);
-          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB3 = filtBit3.IsSelectedMask(track); // only temporarily commented, will be used
-          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB4 = filtBit4.IsSelectedMask(track);
-          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB5 = filtBit5.IsSelectedMask(track);
-
-          filterTableDetail(o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTrackType),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kPtRange),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kEtaRange),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTPCNCls),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTPCCrossedRows),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTPCCrossedRowsOverNCls),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTPCChi2NDF),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTPCRefit),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kITSNCls),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kITSChi2NDF),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kITSRefit),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kITSHits),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kGoldenChi2),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kDCAxy),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kDCAz),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagFB1, o2::aod::track::TrackSelectionFlags::kITSHits),
-                            o2::aod::track::TrackSelectionFlags::checkFlag(trackflagFB2, o2::aod::track::TrackSelectionFlags::kITSHits));
-        }
+
+    // Read the track columns once and evaluate every selection on them
+    trackColumns.fill(tracks);
+    globalTracks.IsSelectedMask(trackColumns, maskGlobal);
+    if (produceTable == 1) {
+      if (!isRun3) {
+        globalTracksSDD.IsSelectedMask(trackColumns, maskSDD);
       }
-      return;
+      filtBit3.IsSelectedMask(trackColumns, maskFB3);
+      filtBit4.IsSelectedMask(trackColumns, maskFB4);
+      filtBit5.IsSelectedMask(trackColumns, maskFB5);
+    }
+    if (produceTable == 1 || (isRun3 && produceFBextendedTable == 1)) {
+      filtBit1.IsSelectedMask(trackColumns, maskFB1);
+      filtBit2.IsSelectedMask(trackColumns, maskFB2);
     }
 
-    for (const auto& track : tracks) {
-      o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = globalTracks.IsSelectedMask(track);
+    const std::size_t nTracks = trackColumns.size();
+    for (std::size_t i = 0; i < nTracks; i++) {
       if (produceTable == 1) {
-        filterTable((uint8_t)globalTracksSDD.IsSelected(track),
-                    globalTracks.IsSelectedMask(track),
-                    filtBit1.IsSelected(track),
-                    filtBit2.IsSelected(track),
-                    filtBit3.IsSelected(track),
-                    filtBit4.IsSelected(track),
-                    filtBit5.IsSelected(track));
+        filterTable((uint8_t)(!isRun3 && maskSDD[i] == TrackSelection::kAllCutsMask),
+                    maskGlobal[i],
+                    maskFB1[i] == TrackSelection::kAllCutsMask,
+                    maskFB2[i] == TrackSelection::kAllCutsMask,
+                    maskFB3[i] == TrackSelection::kAllCutsMask,
+                    maskFB4[i] == TrackSelection::kAllCutsMask,
+                    maskFB5[i] == TrackSelection::kAllCutsMask);
       }
       if (produceFBextendedTable == 1) {
+        const o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = maskGlobal[i];
         filterTableDetail(o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTrackType),
                           o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kPtRange),
                           o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kEtaRange),
@@ -224,8 +212,8 @@ struct TrackSelectionTask {
                           o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kGoldenChi2),
                           o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kDCAxy),
                           o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kDCAz),
-                          0,
-                          0);
+                          isRun3 && o2::aod::track::TrackSelectionFlags::checkFlag(maskFB1[i], o2::aod::track::TrackSelectionFlags::kITSHits),
+                          isRun3 && o2::aod::track::TrackSelectionFlags::checkFlag(maskFB2[i], o2::aod::track::TrackSelectionFlags::kITSHits));
       }
     }
   }
@@ -36,6 +36,7 @@
 #include <TProfile.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -343,6 +344,88 @@ struct standardConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<bool> embedINELgtZEROselection{"embedINELgtZEROselection", false, {"Option to do percentile 100.5 if not INELgtZERO"}};
 };
 
+// flat copy of a 1D calibration histogram, compiled once per run
+// per-collision lookups then no longer touch ROOT objects and the
+// tables can be shared freely with in-task modules
+// N.B.: bin finding and interpolation reproduce TAxis::FindFixBin
+//       and TH1::Interpolate exactly, including under/overflow
+struct CalibrationTable {
+  int nBins = 0;
+  bool uniform = false;
+  double xMin = 0.0;
+  double xMax = 0.0;
+  double valueAtZero = 0.0;   // Interpolate(0.0), reference for vertex-Z equalisation
+  std::vector<double> edges;   // nBins+1 bin edges
+  std::vector<double> centers; // nBins+2, ROOT bin numbering
+  std::vector<double> values;  // nBins+2, ROOT bin numbering (0: underflow, nBins+1: overflow)
+
+  void clear()
+  {
+    nBins = 0;
+    uniform = false;
+    edges.clear();
+    centers.clear();
+    values.clear();
+  }
+
+  bool isCompiled() const { return nBins > 0; }
+
+  void compile(const TH1* histogram)
+  {
+    clear();
+    if (histogram == nullptr || histogram->GetNbinsX() < 1) {
+      return;
+    }
+    const TAxis* axis = histogram->GetXaxis();
+    nBins = histogram->GetNbinsX();
+    uniform = (axis->GetXbins()->GetSize() == 0);
+    xMin = axis->GetXmin();
+    xMax = axis->GetXmax();
+    edges.resize(nBins + 1);
+    centers.resize(nBins + 2);
+    values.resize(nBins + 2);
+    for (int iBin = 0; iBin <= nBins + 1; iBin++) {
+      if (iBin >= 1) {
+        edges[iBin - 1] = axis->GetBinLowEdge(iBin);
+      }
+      centers[iBin] = axis->GetBinCenter(iBin);
+      values[iBin] = histogram->GetBinContent(iBin);
+    }
+    valueAtZero = interpolate(0.0);
+  }
+
+  int findBin(double x) const
+  {
+    if (x < xMin) {
+      return 0;
+    }
+    if (!(x < xMax)) {
+      return nBins + 1;
+    }
+    if (uniform) {
+      return 1 + static_cast<int>(nBins * (x - xMin) / (xMax - xMin));
+    }
+    return static_cast<int>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+  }
+
+  double binContent(double x) const { return values[findBin(x)]; }
+
+  double interpolate(double x) const
+  {
+    if (x <= centers[1]) {
+      return values[1];
+    }
+    if (x >= centers[nBins]) {
+      return values[nBins];
+    }
+    int bin = findBin(x);
+    if (x <= centers[bin]) {
+      bin--;
+    }
+    return values[bin] + (x - centers[bin]) * ((values[bin + 1] - values[bin]) / (centers[bin + 1] - centers[bin]));
+  }
+};
+
 class MultModule
 {
  public:
@@ -377,6 +460,19 @@ class MultModule
   TProfile* hVtxZNMFTTracks;    // non-legacy, added August/2025
   TProfile* hVtxZNGlobalTracks; // non-legacy, added August/2025
 
+  // compiled copies of the vtx-z profiles, used in the per-collision loop
+  CalibrationTable tVtxZFV0A;
+  CalibrationTable tVtxZFT0A;
+  CalibrationTable tVtxZFT0C;
+  CalibrationTable tVtxZFDDA;
+  CalibrationTable tVtxZFDDC;
+  CalibrationTable tVtxZNTracks;
+  CalibrationTable tVtxZNMFTTracks;
+  CalibrationTable tVtxZNGlobalTracks;
+
+  // reusable per-timeframe buffer for centrality columns
+  std::vector<float> mPercentileBuffer;
+
   // declaration of structs here
   // (N.B.: will be invisible to the outside, create your own copies)
   o2::common::multiplicity::standardConfigurables internalOpts;
@@ -421,6 +517,7 @@ class MultModule
     std::string name = "";
     bool mCalibrationStored = false;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationTable mCalibTable; // compiled mhMultSelCalib
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
     explicit CalibrationInfo(std::string name)
@@ -688,6 +785,14 @@ class MultModule
           hVtxZNTracks = static_cast<TProfile*>(lCalibObjects->FindObject("hVtxZNTracksPV"));
           hVtxZNMFTTracks = static_cast<TProfile*>(lCalibObjects->FindObject("hVtxZMFT"));
           hVtxZNGlobalTracks = static_cast<TProfile*>(lCalibObjects->FindObject("hVtxZNGlobals"));
+          tVtxZFV0A.compile(hVtxZFV0A);
+          tVtxZFT0A.compile(hVtxZFT0A);
+          tVtxZFT0C.compile(hVtxZFT0C);
+          tVtxZFDDA.compile(hVtxZFDDA);
+          tVtxZFDDC.compile(hVtxZFDDC);
+          tVtxZNTracks.compile(hVtxZNTracks);
+          tVtxZNMFTTracks.compile(hVtxZNMFTTracks);
+          tVtxZNGlobalTracks.compile(hVtxZNGlobalTracks);
           lCalibLoaded = true;
           // Capture error
           if (!hVtxZFV0A || !hVtxZFT0A || !hVtxZFT0C || !hVtxZFDDA || !hVtxZFDDC || !hVtxZNTracks) {
@@ -795,7 +900,7 @@ class MultModule
     // vertex-Z equalized signals
     if (internalOpts.mEnabledTables[kFV0MultZeqs]) {
       if (mults.multFV0A > -1.0f && std::fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-        mults.multFV0AZeq = hVtxZFV0A->Interpolate(0.0) * mults.multFV0A / hVtxZFV0A->Interpolate(collision.posZ());
+        mults.multFV0AZeq = tVtxZFV0A.valueAtZero * mults.multFV0A / tVtxZFV0A.interpolate(collision.posZ());
       } else {
         mults.multFV0AZeq = 0.0f;
       }
@@ -803,12 +908,12 @@ class MultModule
     }
     if (internalOpts.mEnabledTables[kFT0MultZeqs]) {
       if (mults.multFT0A > -1.0f && std::fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-        mults.multFT0AZeq = hVtxZFT0A->Interpolate(0.0) * mults.multFT0A / hVtxZFT0A->Interpolate(collision.posZ());
+        mults.multFT0AZeq = tVtxZFT0A.valueAtZero * mults.multFT0A / tVtxZFT0A.interpolate(collision.posZ());
       } else {
         mults.multFT0AZeq = 0.0f;
       }
       if (mults.multFT0C > -1.0f && std::fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-        mults.multFT0CZeq = hVtxZFT0C->Interpolate(0.0) * mults.multFT0C / hVtxZFT0C->Interpolate(collision.posZ());
+        mults.multFT0CZeq = tVtxZFT0C.valueAtZero * mults.multFT0C / tVtxZFT0C.interpolate(collision.posZ());
       } else {
         mults.multFT0CZeq = 0.0f;
       }
@@ -816,12 +921,12 @@ class MultModule
     }
     if (internalOpts.mEnabledTables[kFDDMultZeqs]) {
       if (mults.multFDDA > -1.0f && std::fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-        mults.multFDDAZeq = hVtxZFDDA->Interpolate(0.0) * mults.multFDDA / hVtxZFDDA->Interpolate(collision.posZ());
+        mults.multFDDAZeq = tVtxZFDDA.valueAtZero * mults.multFDDA / tVtxZFDDA.interpolate(collision.posZ());
       } else {
         mults.multFDDAZeq = 0.0f;
       }
       if (mults.multFDDC > -1.0f && std::fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-        mults.multFDDCZeq = hVtxZFDDC->Interpolate(0.0) * mults.multFDDC / hVtxZFDDC->Interpolate(collision.posZ());
+        mults.multFDDCZeq = tVtxZFDDC.valueAtZero * mults.multFDDC / tVtxZFDDC.interpolate(collision.posZ());
       } else {
         mults.multFDDCZeq = 0.0f;
       }
@@ -899,10 +1004,10 @@ class MultModule
 
       cursors.multsGlobal(mults.multGlobalTracks, mults.multNbrContribsEta08GlobalTrackWoDCA, mults.multNbrContribsEta10GlobalTrackWoDCA, mults.multNbrContribsEta05GlobalTrackWoDCA);
 
-      if (!hVtxZNGlobalTracks || std::fabs(collision.posZ()) > 15.0f) {
+      if (!tVtxZNGlobalTracks.isCompiled() || std::fabs(collision.posZ()) > 15.0f) {
         mults.multGlobalTracksZeq = mults.multGlobalTracks; // if no equalization available, don't do it
       } else {
-        mults.multGlobalTracksZeq = hVtxZNGlobalTracks->Interpolate(0.0) * mults.multGlobalTracks / hVtxZNGlobalTracks->Interpolate(collision.posZ());
+        mults.multGlobalTracksZeq = tVtxZNGlobalTracks.valueAtZero * mults.multGlobalTracks / tVtxZNGlobalTracks.interpolate(collision.posZ());
       }
 
       // provide vertex-Z equalized Nglobals (or non-equalized if missing or beyond range)
@@ -936,7 +1041,7 @@ class MultModule
     }
     if (internalOpts.mEnabledTables[kPVMultZeqs]) {
       if (std::fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-        mults.multNContribsZeq = hVtxZNTracks->Interpolate(0.0) * mults.multNContribs / hVtxZNTracks->Interpolate(collision.posZ());
+        mults.multNContribsZeq = tVtxZNTracks.valueAtZero * mults.multNContribs / tVtxZNTracks.interpolate(collision.posZ());
       } else {
         mults.multNContribsZeq = 0.0f;
       }
@@ -1029,10 +1134,10 @@ class MultModule
     mults[collision.globalIndex()].multMFTTracks = nTracks;
 
     // vertex-Z equalized MFT
-    if (!hVtxZNMFTTracks || std::fabs(collision.posZ()) > 15.0f) {
+    if (!tVtxZNMFTTracks.isCompiled() || std::fabs(collision.posZ()) > 15.0f) {
       mults[collision.globalIndex()].multMFTTracksZeq = mults[collision.globalIndex()].multMFTTracks; // if no equalization available, don't do it
     } else {
-      mults[collision.globalIndex()].multMFTTracksZeq = hVtxZNMFTTracks->Interpolate(0.0) * mults[collision.globalIndex()].multMFTTracks / hVtxZNMFTTracks->Interpolate(collision.posZ());
+      mults[collision.globalIndex()].multMFTTracksZeq = tVtxZNMFTTracks.valueAtZero * mults[collision.globalIndex()].multMFTTracks / tVtxZNMFTTracks.interpolate(collision.posZ());
     }
 
     // provide vertex-Z equalized Nglobals (or non-equalized if missing or beyond range)
@@ -1251,6 +1356,7 @@ class MultModule
             }
             estimator.mCalibrationStored = true;
             estimator.isSane();
+            estimator.mCalibTable.compile(estimator.mhMultSelCalib);
           } else {
             LOGF(info, "Calibration information from %s for run %d not available, will fill this estimator with invalid values and continue (no crash).", estimator.name.c_str(), bc.runNumber());
           }
@@ -1308,68 +1414,94 @@ class MultModule
       const auto& firstbc = bcs.begin();
       ConfigureCentralityRun3(ccdb, metadataInfo, firstbc);
 
+      auto scaleMC = [](float x, const float pars[6]) {
+        float core = ((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4];
+        if (core < 0.0f) {
+          return 0.0f; // this should be marked as low multiplicity and not mapped, core^pars[5] would be NaN
+        }
+        return std::pow(((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4], 1.0f / pars[5]);
+      };
+
       /************************************************************
-       * @brief Populates a table with data based on the given calibration information and multiplicity.
+       * @brief Converts a multiplicity into a percentile using the compiled calibration table.
        *
-       * @param table The table to populate.
        * @param estimator The calibration information.
        * @param multiplicity The multiplicity value.
+       * @param isInelGt0 Whether the event is INEL>0.
        *************************************************************/
 
-      auto populateTable = [&](auto& table, struct CalibrationInfo& estimator, float multiplicity, bool isInelGt0) {
-        const bool assignOutOfRange = internalOpts.embedINELgtZEROselection && !isInelGt0;
-        auto scaleMC = [](float x, const float pars[6]) {
-          float core = ((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4];
-          if (core < 0.0f) {
-            return 0.0f; // this should be marked as low multiplicity and not mapped, core^pars[5] would be NaN
-          }
-          return std::pow(((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4], 1.0f / pars[5]);
-        };
-
-        float percentile = 105.0f;
+      auto getPercentile = [&](const struct CalibrationInfo& estimator, float multiplicity, bool isInelGt0) {
+        if (!estimator.mCalibrationStored) {
+          return 105.0f;
+        }
+        if (internalOpts.embedINELgtZEROselection && !isInelGt0) {
+          return 100.5f;
+        }
         float scaledMultiplicity = multiplicity;
-        if (estimator.mCalibrationStored) {
-          if (estimator.mMCScale != nullptr) {
-            scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
-            LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
-          }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
-          if (assignOutOfRange)
-            percentile = 100.5f;
+        if (estimator.mMCScale != nullptr) {
+          scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
         }
-        LOGF(debug, "%s centrality/multiplicity percentile = %.0f for a zvtx eq %s value %.0f", estimator.name.c_str(), percentile, estimator.name.c_str(), scaledMultiplicity);
+        return static_cast<float>(estimator.mCalibTable.binContent(scaledMultiplicity));
+      };
+
+      /************************************************************
+       * @brief Populates a table with data based on the given calibration information and multiplicity.
+       *
+       * @param table The table to populate.
+       * @param estimator The calibration information.
+       * @param multiplicity The multiplicity value.
+       *************************************************************/
+
+      auto populateTable = [&](auto& table, const struct CalibrationInfo& estimator, float multiplicity, bool isInelGt0) {
+        float percentile = getPercentile(estimator, multiplicity, isInelGt0);
+        LOGF(debug, "%s centrality/multiplicity percentile = %.0f for a zvtx eq %s value %.0f", estimator.name.c_str(), percentile, estimator.name.c_str(), multiplicity);
         table(percentile);
         return percentile;
       };
 
-      // populate centralities per event
-      for (size_t iEv = 0; iEv < mults.size(); iEv++) {
-        bool isInelGt0 = (mults[iEv].multNContribsEta1 > 0);
-        if (internalOpts.mEnabledTables[kCentFV0As])
-          populateTable(cursors.centFV0A, fv0aInfo, mults[iEv].multFV0AZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Ms])
-          populateTable(cursors.centFT0M, ft0mInfo, mults[iEv].multFT0AZeq + mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Ms])
-          populateTable(cursors.centFT0MAnchorCol, ft0mColInfo, mults[iEv].multFT0AZeq + mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Ms])
-          populateTable(cursors.centFT0MAnchorBC, ft0mBcInfo, mults[iEv].multFT0AZeq + mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0As])
-          populateTable(cursors.centFT0A, ft0aInfo, mults[iEv].multFT0AZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Cs])
-          populateTable(cursors.centFT0C, ft0cInfo, mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0CVariant1s])
-          populateTable(cursors.centFT0CVariant1, ft0cVariant1Info, mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0CVariant2s])
-          populateTable(cursors.centFT0CVariant2, ft0cVariant2Info, mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFDDMs])
-          populateTable(cursors.centFDDM, fddmInfo, mults[iEv].multFDDAZeq + mults[iEv].multFDDCZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentNTPVs])
-          populateTable(cursors.centNTPV, ntpvInfo, mults[iEv].multNContribs, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentNGlobals])
-          populateTable(cursors.centNGlobals, nGlobalInfo, mults[iEv].multGlobalTracksZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentMFTs])
-          populateTable(cursors.centMFTs, mftInfo, mults[iEv].multMFTTracksZeq, isInelGt0);
-      }
+      /************************************************************
+       * @brief Populates a full centrality column in one pass over the collision buffer.
+       *
+       * @param table The table to populate.
+       * @param estimator The calibration information.
+       * @param getMultiplicity Extracts the estimator multiplicity from a buffer entry.
+       *************************************************************/
+
+      auto populateColumn = [&](auto& table, const struct CalibrationInfo& estimator, auto getMultiplicity) {
+        mPercentileBuffer.resize(mults.size());
+        for (size_t iEv = 0; iEv < mults.size(); iEv++) {
+          mPercentileBuffer[iEv] = getPercentile(estimator, getMultiplicity(mults[iEv]), mults[iEv].multNContribsEta1 > 0);
+        }
+        for (const auto& percentile : mPercentileBuffer) {
+          table(percentile);
+        }
+      };
+
+      // populate centralities per event, one estimator at a time
+      if (internalOpts.mEnabledTables[kCentFV0As])
+        populateColumn(cursors.centFV0A, fv0aInfo, [](const auto& m) { return m.multFV0AZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Ms])
+        populateColumn(cursors.centFT0M, ft0mInfo, [](const auto& m) { return m.multFT0AZeq + m.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Ms])
+        populateColumn(cursors.centFT0MAnchorCol, ft0mColInfo, [](const auto& m) { return m.multFT0AZeq + m.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Ms])
+        populateColumn(cursors.centFT0MAnchorBC, ft0mBcInfo, [](const auto& m) { return m.multFT0AZeq + m.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0As])
+        populateColumn(cursors.centFT0A, ft0aInfo, [](const auto& m) { return m.multFT0AZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Cs])
+        populateColumn(cursors.centFT0C, ft0cInfo, [](const auto& m) { return m.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0CVariant1s])
+        populateColumn(cursors.centFT0CVariant1, ft0cVariant1Info, [](const auto& m) { return m.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0CVariant2s])
+        populateColumn(cursors.centFT0CVariant2, ft0cVariant2Info, [](const auto& m) { return m.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFDDMs])
+        populateColumn(cursors.centFDDM, fddmInfo, [](const auto& m) { return m.multFDDAZeq + m.multFDDCZeq; });
+      if (internalOpts.mEnabledTables[kCentNTPVs])
+        populateColumn(cursors.centNTPV, ntpvInfo, [](const auto& m) { return static_cast<float>(m.multNContribs); });
+      if (internalOpts.mEnabledTables[kCentNGlobals])
+        populateColumn(cursors.centNGlobals, nGlobalInfo, [](const auto& m) { return m.multGlobalTracksZeq; });
+      if (internalOpts.mEnabledTables[kCentMFTs])
+        populateColumn(cursors.centMFTs, mftInfo, [](const auto& m) { return m.multMFTTracksZeq; });
 
       // populate centralities per BC
       for (size_t ibc = 0; ibc < static_cast<size_t>(bcs.size()); ibc++) {
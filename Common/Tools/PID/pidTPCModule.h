@@ -46,6 +46,7 @@
 #include <TRandom.h>
 #include <TString.h>
 
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -624,7 +625,7 @@ class pidTPCModule
 
   //__________________________________________________
   template <typename T, typename NSF, typename NST>
-  void makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const int64_t multTPC, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size)
+  void makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const float expSignal, const float expSigmaAtMultiplicity, const float nSigmaAtMultiplicity, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size)
   {
     if (flagFull != 1 && flagTiny != 1) {
       return;
@@ -645,9 +646,8 @@ class pidTPCModule
         return;
       }
     }
-    auto expSignal = response->GetExpectedSignal(trk, pid);
-    auto expSigma = trk.has_collision() ? response->GetExpectedSigmaAtMultiplicity(multTPC, trk, pid) : 0.07 * expSignal; // use default sigma value of 7% if no collision information to estimate resolution
-    if (expSignal < 0. || expSigma < 0.) {                                                                                // skip if expected signal invalid
+    auto expSigma = trk.has_collision() ? expSigmaAtMultiplicity : 0.07 * expSignal; // use default sigma value of 7% if no collision information to estimate resolution
+    if (expSignal < 0. || expSigma < 0.) {                                           // skip if expected signal invalid
       if (flagFull)
         tableFull(-999.f, -999.f);
       if (flagTiny)
@@ -680,7 +680,7 @@ class pidTPCModule
         LOGF(fatal, "Network output dimensions incompatible!");
       }
     } else {
-      nSigma = response->GetNumberOfSigmaMCTunedAtMultiplicity(multTPC, trk, pid, tpcSignal);
+      nSigma = nSigmaAtMultiplicity;
     }
     if (flagFull)
       tableFull(expSigma, nSigma);
@@ -756,6 +756,19 @@ class pidTPCModule
       network_prediction = createNetworkPrediction(ccdb, cols, pidmults, tracks, bcs, tracksForNet_size);
     }
 
+    // Species for which the expected signal and nSigma are needed
+    uint16_t pidMask = 0;
+    const std::array<int, o2::track::PID::NIDs> pidFlagsFull{pidTPCopts.pidFullEl, pidTPCopts.pidFullMu, pidTPCopts.pidFullPi, pidTPCopts.pidFullKa, pidTPCopts.pidFullPr, pidTPCopts.pidFullDe, pidTPCopts.pidFullTr, pidTPCopts.pidFullHe, pidTPCopts.pidFullAl};
+    const std::array<int, o2::track::PID::NIDs> pidFlagsTiny{pidTPCopts.pidTinyEl, pidTPCopts.pidTinyMu, pidTPCopts.pidTinyPi, pidTPCopts.pidTinyKa, pidTPCopts.pidTinyPr, pidTPCopts.pidTinyDe, pidTPCopts.pidTinyTr, pidTPCopts.pidTinyHe, pidTPCopts.pidTinyAl};
+    for (o2::track::PID::ID pid = 0; pid < o2::track::PID::NIDs; pid++) {
+      if (pidFlagsFull[pid] == 1 || pidFlagsTiny[pid] == 1) {
+        pidMask |= (1u << pid);
+      }
+    }
+    std::array<float, o2::track::PID::NIDs> expSignals{};
+    std::array<float, o2::track::PID::NIDs> expSigmas{};
+    std::array<float, o2::track::PID::NIDs> nSigmas{};
+
     uint64_t count_tracks = 0;
 
     //_______________________________________
@@ -950,8 +963,13 @@ class pidTPCModule
         }
       }
 
-      auto makePidTablesDefault = [&trk, &tpcSignalToEvaluatePID, &multTPC, &network_prediction, &count_tracks, &tracksForNet_size, this](const int flagFull, auto& tableFull, const int flagTiny, auto& tableTiny, const o2::track::PID::ID pid) {
-        this->makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, tpcSignalToEvaluatePID, trk, multTPC, network_prediction, count_tracks, tracksForNet_size);
+      // All the enabled mass hypotheses at once, sharing the Bethe-Bloch evaluation between expected signal and resolution
+      if (trk.hasTPC()) {
+        response->GetNumberOfSigmasAtMultiplicity(multTPC, trk, tpcSignalToEvaluatePID, pidMask, expSignals, expSigmas, nSigmas);
+      }
+
+      auto makePidTablesDefault = [&trk, &tpcSignalToEvaluatePID, &expSignals, &expSigmas, &nSigmas, &network_prediction, &count_tracks, &tracksForNet_size, this](const int flagFull, auto& tableFull, const int flagTiny, auto& tableTiny, const o2::track::PID::ID pid) {
+        this->makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, tpcSignalToEvaluatePID, trk, expSignals[pid], expSigmas[pid], nSigmas[pid], network_prediction, count_tracks, tracksForNet_size);
       };
 
       makePidTablesDefault(pidTPCopts.pidFullEl, products.tablePIDFullEl, pidTPCopts.pidTinyEl, products.tablePIDTinyEl, o2::track::PID::Electron);
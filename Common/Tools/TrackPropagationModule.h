@@ -39,11 +39,17 @@
 #include <TH1.h>
 #include <TH2.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 //__________________________________________
 // track propagation module
@@ -73,6 +79,9 @@ struct TrackPropagationProducts : o2::framework::ProducesGroup {
 struct TrackPropagationConfigurables : o2::framework::ConfigurableGroup {
   std::string prefix = "trackPropagation";
   o2::framework::Configurable<float> minPropagationRadius{"minPropagationDistance", o2::constants::geom::XTPCInnerRef + 0.1, "Only tracks which are at a smaller radius will be propagated, defaults to TPC inner wall"};
+  o2::framework::Configurable<int> nPropagationThreads{"nPropagationThreads", 1, "number of threads propagating the tracks to the vertex"};
+  o2::framework::Configurable<int> nTracksPerBatch{"nTracksPerBatch", 4096, "number of tracks prepared, propagated and written together"};
+  o2::framework::Configurable<int> nTracksPerChunk{"nTracksPerChunk", 64, "number of tracks a propagation thread takes at a time"};
   // for TrackTuner only (MC smearing)
   o2::framework::Configurable<bool> useTrackTuner{"useTrackTuner", false, "Apply track tuner corrections to MC"};
   o2::framework::Configurable<bool> useTrkPid{"useTrkPid", false, "use pid in tracking"};
@@ -101,11 +110,6 @@ class TrackPropagationModule
   std::shared_ptr<TH1> trackTunedTracks;
 
   // Running variables
-  std::array<float, 2> mDcaInfo{};
-  o2::dataformats::DCA mDcaInfoCov;
-  o2::dataformats::VertexBase mVtx;
-  o2::track::TrackParametrization<float> mTrackPar;
-  o2::track::TrackParametrizationWithError<float> mTrackParCov;
   bool autoDetectDcaCalib = false; // track tuner setting
 
   template <typename TConfigurableGroup, typename TInitContext, typename THistoRegistry>
@@ -254,112 +258,205 @@ class TrackPropagationModule
       cursors.tunertable.reserve(tracks.size());
     }
 
-    for (const auto& track : tracks) {
-      if (fillTracksCov) {
-        if (fillTracksDCA || fillTracksDCACov) {
-          mDcaInfoCov.set(999, 999, 999, 999, 999);
-        }
-        setTrackParCov(track, mTrackParCov);
-        if (cGroup.useTrkPid.value) {
-          mTrackParCov.setPID(track.pidForTracking());
-        }
-      } else {
-        if (fillTracksDCA) {
-          mDcaInfo[0] = 999;
-          mDcaInfo[1] = 999;
-        }
-        setTrackPar(track, mTrackPar);
-        if (cGroup.useTrkPid.value) {
-          mTrackPar.setPID(track.pidForTracking());
-        }
+    // Tracks are processed in batches: each batch is prepared serially (parameters, PID, TrackTuner),
+    // propagated to the vertex, possibly on several threads, and written to the tables serially in
+    // the input order. The propagation of each track is the same call as in the single-track loop,
+    // so the output does not depend on the batch size or on the number of threads.
+    const int64_t nTracks = tracks.size();
+    const int64_t batchSize = std::max(1, cGroup.nTracksPerBatch.value);
+    for (int64_t firstTrack = 0; firstTrack < nTracks; firstTrack += batchSize) {
+      const std::size_t nInBatch = static_cast<std::size_t>(std::min(batchSize, nTracks - firstTrack));
+      resizeBatch(nInBatch);
+      for (std::size_t iTrack = 0; iTrack < nInBatch; iTrack++) {
+        prepareTrack<isMc>(cGroup, trackTunerObj, ccdbLoader, collisions, tracks.rawIteratorAt(firstTrack + iTrack), iTrack);
       }
-      // auto trackParCov = getTrackParCov(track);
-      o2::aod::track::TrackTypeEnum trackType = (o2::aod::track::TrackTypeEnum)track.trackType();
-      // std::array<float, 3> trackPxPyPz;
-      // std::array<float, 3> trackPxPyPzTuned = {0.0, 0.0, 0.0};
-      double q2OverPtNew = -9999.;
-      // Only propagate tracks which have passed the innermost wall of the TPC (e.g. skipping loopers etc). Others fill unpropagated.
-      if (track.trackType() == o2::aod::track::TrackIU && track.x() < cGroup.minPropagationRadius.value) {
-        if (fillTracksCov) {
-          if constexpr (isMc) { // checking MC and fillCovMat block begins
-            // bool hasMcParticle = track.has_mcParticle();
-            if (cGroup.useTrackTuner.value) {
-              trackTunedTracks->Fill(1); // all tracks
-              bool hasMcParticle = track.has_mcParticle();
-              if (hasMcParticle) {
-                auto mcParticle = track.mcParticle();
-                trackTunerObj.tuneTrackParams(mcParticle, mTrackParCov, matCorr, &mDcaInfoCov, trackTunedTracks);
-                q2OverPtNew = mTrackParCov.getQ2Pt();
-              }
-            }
-          } // MC and fillCovMat block ends
-        }
-        bool isPropagationOK = true;
-
-        if (track.has_collision()) {
-          auto const& collision = collisions.rawIteratorAt(track.collisionId());
-          if (fillTracksCov) {
-            mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-            mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
-        } else {
-          if (fillTracksCov) {
-            mVtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
-            mVtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
+      propagateBatch(cGroup, nInBatch);
+      for (std::size_t iTrack = 0; iTrack < nInBatch; iTrack++) {
+        fillTrack<isMc>(cGroup, tracks.rawIteratorAt(firstTrack + iTrack), iTrack, cursors, registry);
+      }
+    }
+  }
+
+ private:
+  enum propagationStatus : uint8_t {
+    kNotPropagated = 0,
+    kPropagationOK,
+    kPropagationFailed
+  };
+
+  // one entry per track of the batch being processed
+  std::vector<o2::track::TrackParametrization<float>> mBatchTrackPar;
+  std::vector<o2::track::TrackParametrizationWithError<float>> mBatchTrackParCov;
+  std::vector<std::array<float, 2>> mBatchDcaInfo;
+  std::vector<o2::dataformats::DCA> mBatchDcaInfoCov;
+  std::vector<o2::dataformats::VertexBase> mBatchVtx;
+  std::vector<double> mBatchQ2OverPtNew;
+  std::vector<uint8_t> mBatchToPropagate;
+  std::vector<uint8_t> mBatchStatus;
+
+  void resizeBatch(std::size_t nInBatch)
+  {
+    if (fillTracksCov) {
+      mBatchTrackParCov.resize(nInBatch);
+      mBatchDcaInfoCov.resize(nInBatch);
+    } else {
+      mBatchTrackPar.resize(nInBatch);
+      mBatchDcaInfo.resize(nInBatch);
+    }
+    mBatchVtx.resize(nInBatch);
+    mBatchQ2OverPtNew.resize(nInBatch);
+    mBatchToPropagate.resize(nInBatch);
+    mBatchStatus.resize(nInBatch);
+  }
+
+  /// copy the track parameters, apply the TrackTuner and choose the vertex the track is propagated to
+  template <bool isMc, typename TConfigurableGroup, typename TCCDBLoader, typename TCollisions, typename TTrack>
+  void prepareTrack(TConfigurableGroup const& cGroup, TrackTuner& trackTunerObj, TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTrack const& track, std::size_t iTrack)
+  {
+    if (fillTracksCov) {
+      auto& trackParCov = mBatchTrackParCov[iTrack];
+      if (fillTracksDCA || fillTracksDCACov) {
+        mBatchDcaInfoCov[iTrack].set(999, 999, 999, 999, 999);
+      }
+      setTrackParCov(track, trackParCov);
+      if (cGroup.useTrkPid.value) {
+        trackParCov.setPID(track.pidForTracking());
+      }
+    } else {
+      auto& trackPar = mBatchTrackPar[iTrack];
+      if (fillTracksDCA) {
+        mBatchDcaInfo[iTrack][0] = 999;
+        mBatchDcaInfo[iTrack][1] = 999;
+      }
+      setTrackPar(track, trackPar);
+      if (cGroup.useTrkPid.value) {
+        trackPar.setPID(track.pidForTracking());
+      }
+    }
+    mBatchQ2OverPtNew[iTrack] = -9999.;
+    mBatchStatus[iTrack] = kNotPropagated;
+    // Only propagate tracks which have passed the innermost wall of the TPC (e.g. skipping loopers etc). Others fill unpropagated.
+    mBatchToPropagate[iTrack] = track.trackType() == o2::aod::track::TrackIU && track.x() < cGroup.minPropagationRadius.value;
+    if (!mBatchToPropagate[iTrack]) {
+      return;
+    }
+    if (fillTracksCov) {
+      if constexpr (isMc) { // checking MC and fillCovMat block begins
+        if (cGroup.useTrackTuner.value) {
+          trackTunedTracks->Fill(1); // all tracks
+          bool hasMcParticle = track.has_mcParticle();
+          if (hasMcParticle) {
+            auto mcParticle = track.mcParticle();
+            trackTunerObj.tuneTrackParams(mcParticle, mBatchTrackParCov[iTrack], matCorr, &mBatchDcaInfoCov[iTrack], trackTunedTracks);
+            mBatchQ2OverPtNew[iTrack] = mBatchTrackParCov[iTrack].getQ2Pt();
           }
         }
-        if (isPropagationOK) {
-          trackType = o2::aod::track::Track;
+      } // MC and fillCovMat block ends
+    }
+    auto& vtx = mBatchVtx[iTrack];
+    if (track.has_collision()) {
+      auto const& collision = collisions.rawIteratorAt(track.collisionId());
+      vtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+      vtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+    } else {
+      vtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
+      vtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
+    }
+  }
+
+  /// propagate one prepared track to its vertex; only touches the entries of this track
+  void propagateTrack(std::size_t iTrack)
+  {
+    bool isPropagationOK;
+    if (fillTracksCov) {
+      isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mBatchVtx[iTrack], mBatchTrackParCov[iTrack], 2.f, matCorr, &mBatchDcaInfoCov[iTrack]);
+    } else {
+      isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mBatchVtx[iTrack].getXYZ(), mBatchTrackPar[iTrack], 2.f, matCorr, &mBatchDcaInfo[iTrack]);
+    }
+    mBatchStatus[iTrack] = isPropagationOK ? kPropagationOK : kPropagationFailed;
+  }
+
+  /// propagate the tracks of the batch which need it, on cGroup.nPropagationThreads threads
+  template <typename TConfigurableGroup>
+  void propagateBatch(TConfigurableGroup const& cGroup, std::size_t nInBatch)
+  {
+    const std::size_t chunkSize = std::max(1, cGroup.nTracksPerChunk.value);
+    const std::size_t nChunks = (nInBatch + chunkSize - 1) / chunkSize;
+    const std::size_t nThreads = std::max<std::size_t>(1, std::min<std::size_t>(std::max(1, cGroup.nPropagationThreads.value), nChunks));
+
+    std::atomic<std::size_t> nextChunk{0};
+    auto propagateChunks = [&]() {
+      for (std::size_t iChunk = nextChunk++; iChunk < nChunks; iChunk = nextChunk++) {
+        const std::size_t lastTrack = std::min(nInBatch, (iChunk + 1) * chunkSize);
+        for (std::size_t iTrack = iChunk * chunkSize; iTrack < lastTrack; iTrack++) {
+          if (mBatchToPropagate[iTrack]) {
+            propagateTrack(iTrack);
+          }
         }
-        // filling some QA histograms for track tuner test purpose
-        if (fillTracksCov) {
-          if constexpr (isMc) { // checking MC and fillCovMat block begins
-            if (track.has_mcParticle() && isPropagationOK) {
-              auto mcParticle1 = track.mcParticle();
-              // && abs(mcParticle1.pdgCode())==211
-              if (mcParticle1.isPhysicalPrimary()) {
-                registry.fill(HIST("hDCAxyVsPtRec"), mDcaInfoCov.getY(), mTrackParCov.getPt());
-                registry.fill(HIST("hDCAxyVsPtMC"), mDcaInfoCov.getY(), mcParticle1.pt());
-                registry.fill(HIST("hDCAzVsPtRec"), mDcaInfoCov.getZ(), mTrackParCov.getPt());
-                registry.fill(HIST("hDCAzVsPtMC"), mDcaInfoCov.getZ(), mcParticle1.pt());
-              }
-            }
-          } // MC and fillCovMat block ends
+      }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t iThread = 1; iThread < nThreads; iThread++) {
+      threads.emplace_back(propagateChunks);
+    }
+    propagateChunks();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  /// fill the QA histograms and the output tables for one track of the batch
+  template <bool isMc, typename TConfigurableGroup, typename TTrack, typename TOutputGroup, typename THistoRegistry>
+  void fillTrack(TConfigurableGroup const& cGroup, TTrack const& track, std::size_t iTrack, TOutputGroup& cursors, THistoRegistry& registry)
+  {
+    o2::aod::track::TrackTypeEnum trackType = (o2::aod::track::TrackTypeEnum)track.trackType();
+    const bool isPropagationOK = mBatchStatus[iTrack] == kPropagationOK;
+    if (isPropagationOK) {
+      trackType = o2::aod::track::Track;
+    }
+    // filling some QA histograms for track tuner test purpose
+    if (fillTracksCov && mBatchStatus[iTrack] != kNotPropagated) {
+      if constexpr (isMc) { // checking MC and fillCovMat block begins
+        if (track.has_mcParticle() && isPropagationOK) {
+          auto mcParticle1 = track.mcParticle();
+          // && abs(mcParticle1.pdgCode())==211
+          if (mcParticle1.isPhysicalPrimary()) {
+            registry.fill(HIST("hDCAxyVsPtRec"), mBatchDcaInfoCov[iTrack].getY(), mBatchTrackParCov[iTrack].getPt());
+            registry.fill(HIST("hDCAxyVsPtMC"), mBatchDcaInfoCov[iTrack].getY(), mcParticle1.pt());
+            registry.fill(HIST("hDCAzVsPtRec"), mBatchDcaInfoCov[iTrack].getZ(), mBatchTrackParCov[iTrack].getPt());
+            registry.fill(HIST("hDCAzVsPtMC"), mBatchDcaInfoCov[iTrack].getZ(), mcParticle1.pt());
+          }
         }
+      } // MC and fillCovMat block ends
+    }
+    // Filling modified Q/Pt values at IU/production point by track tuner in track tuner table
+    if (cGroup.useTrackTuner.value && cGroup.fillTrackTunerTable.value) {
+      cursors.tunertable(mBatchQ2OverPtNew[iTrack]);
+    }
+    if (fillTracksCov) {
+      auto const& trackParCov = mBatchTrackParCov[iTrack];
+      auto const& dcaInfoCov = mBatchDcaInfoCov[iTrack];
+      cursors.tracksParPropagated(track.collisionId(), trackType, trackParCov.getX(), trackParCov.getAlpha(), trackParCov.getY(), trackParCov.getZ(), trackParCov.getSnp(), trackParCov.getTgl(), trackParCov.getQ2Pt());
+      cursors.tracksParExtensionPropagated(trackParCov.getPt(), trackParCov.getP(), trackParCov.getEta(), trackParCov.getPhi());
+      // TODO do we keep the rho as 0? Also the sigma's are duplicated information
+      cursors.tracksParCovPropagated(std::sqrt(trackParCov.getSigmaY2()), std::sqrt(trackParCov.getSigmaZ2()), std::sqrt(trackParCov.getSigmaSnp2()),
+                                     std::sqrt(trackParCov.getSigmaTgl2()), std::sqrt(trackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+      cursors.tracksParCovExtensionPropagated(trackParCov.getSigmaY2(), trackParCov.getSigmaZY(), trackParCov.getSigmaZ2(), trackParCov.getSigmaSnpY(),
+                                              trackParCov.getSigmaSnpZ(), trackParCov.getSigmaSnp2(), trackParCov.getSigmaTglY(), trackParCov.getSigmaTglZ(), trackParCov.getSigmaTglSnp(),
+                                              trackParCov.getSigmaTgl2(), trackParCov.getSigma1PtY(), trackParCov.getSigma1PtZ(), trackParCov.getSigma1PtSnp(), trackParCov.getSigma1PtTgl(),
+                                              trackParCov.getSigma1Pt2());
+      if (fillTracksDCA) {
+        cursors.tracksDCA(dcaInfoCov.getY(), dcaInfoCov.getZ());
       }
-      // Filling modified Q/Pt values at IU/production point by track tuner in track tuner table
-      if (cGroup.useTrackTuner.value && cGroup.fillTrackTunerTable.value) {
-        cursors.tunertable(q2OverPtNew);
+      if (fillTracksDCACov) {
+        cursors.tracksDCACov(dcaInfoCov.getSigmaY2(), dcaInfoCov.getSigmaZ2());
       }
-      // LOG(info) <<  " trackPropagation (this value filled in tuner table)--> "  << q2OverPtNew;
-      if (fillTracksCov) {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackParCov.getX(), mTrackParCov.getAlpha(), mTrackParCov.getY(), mTrackParCov.getZ(), mTrackParCov.getSnp(), mTrackParCov.getTgl(), mTrackParCov.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackParCov.getPt(), mTrackParCov.getP(), mTrackParCov.getEta(), mTrackParCov.getPhi());
-        // TODO do we keep the rho as 0? Also the sigma's are duplicated information
-        cursors.tracksParCovPropagated(std::sqrt(mTrackParCov.getSigmaY2()), std::sqrt(mTrackParCov.getSigmaZ2()), std::sqrt(mTrackParCov.getSigmaSnp2()),
-                                       std::sqrt(mTrackParCov.getSigmaTgl2()), std::sqrt(mTrackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-        cursors.tracksParCovExtensionPropagated(mTrackParCov.getSigmaY2(), mTrackParCov.getSigmaZY(), mTrackParCov.getSigmaZ2(), mTrackParCov.getSigmaSnpY(),
-                                                mTrackParCov.getSigmaSnpZ(), mTrackParCov.getSigmaSnp2(), mTrackParCov.getSigmaTglY(), mTrackParCov.getSigmaTglZ(), mTrackParCov.getSigmaTglSnp(),
-                                                mTrackParCov.getSigmaTgl2(), mTrackParCov.getSigma1PtY(), mTrackParCov.getSigma1PtZ(), mTrackParCov.getSigma1PtSnp(), mTrackParCov.getSigma1PtTgl(),
-                                                mTrackParCov.getSigma1Pt2());
-        if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfoCov.getY(), mDcaInfoCov.getZ());
-        }
-        if (fillTracksDCACov) {
-          cursors.tracksDCACov(mDcaInfoCov.getSigmaY2(), mDcaInfoCov.getSigmaZ2());
-        }
-      } else {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackPar.getX(), mTrackPar.getAlpha(), mTrackPar.getY(), mTrackPar.getZ(), mTrackPar.getSnp(), mTrackPar.getTgl(), mTrackPar.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackPar.getPt(), mTrackPar.getP(), mTrackPar.getEta(), mTrackPar.getPhi());
-        if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfo[0], mDcaInfo[1]);
-        }
+    } else {
+      auto const& trackPar = mBatchTrackPar[iTrack];
+      cursors.tracksParPropagated(track.collisionId(), trackType, trackPar.getX(), trackPar.getAlpha(), trackPar.getY(), trackPar.getZ(), trackPar.getSnp(), trackPar.getTgl(), trackPar.getQ2Pt());
+      cursors.tracksParExtensionPropagated(trackPar.getPt(), trackPar.getP(), trackPar.getEta(), trackPar.getPhi());
+      if (fillTracksDCA) {
+        cursors.tracksDCA(mBatchDcaInfo[iTrack][0], mBatchDcaInfo[iTrack][1]);
       }
     }
   }
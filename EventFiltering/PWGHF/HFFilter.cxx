@@ -263,6 +263,7 @@ struct HfFilter { // Main struct for HF triggers
 
   // helper object
   HfFilterHelper helper;
+  HfTrackCacheThisCollision trackCache; // tracks of the current collision at the PV, shared by all trigger loops
 
   HistogramRegistry registry{"registry"};
 
@@ -483,6 +484,9 @@ struct HfFilter { // Main struct for HF triggers
                aod::V0PhotonsKF const& photons,
                aod::V0Legs const&)
   {
+    trackCache.reset();
+    helper.resetTpcPostCalibCache(tracks.size());
+
     for (const auto& collision : collisions) {
 
       // all processed collisions
@@ -642,6 +646,7 @@ struct HfFilter { // Main struct for HF triggers
 
         auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
         auto tracksWithItsPid = soa::Attach<BigTracksPID, aod::pidits::ITSNSigmaPr, aod::pidits::ITSNSigmaDe>(tracks);
+        trackCache.fill(helper, tracks, trackIdsThisCollision, collision, noMatCorr);
         for (const auto& trackId : trackIdsThisCollision) { // start loop over tracks
           auto track = tracksWithItsPid.rawIteratorAt(trackId.trackId());
 
@@ -649,17 +654,14 @@ struct HfFilter { // Main struct for HF triggers
             continue;
           }
 
-          auto trackParThird = getTrackParCov(track);
-          std::array<float, 2> dcaThird{track.dcaXY(), track.dcaZ()};
-          std::array<float, 3> pVecThird = track.pVector();
-          if (track.collisionId() != thisCollId) {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParThird, 2.f, noMatCorr, &dcaThird);
-            getPxPyPz(trackParThird, pVecThird);
-          }
+          const auto slotThird = trackCache.slot(track.globalIndex());
+          const auto& trackParThird = trackCache.trackParCov(slotThird);
+          const auto& dcaThird = trackCache.dca(slotThird);
+          const auto& pVecThird = trackCache.pVec(slotThird);
 
           // Beauty with D0
           if (!keepEvent[kBeauty3P] && isD0BeautyTagged) {
-            int16_t isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty3P>(track, trackParThird, dcaThird);
+            int16_t isTrackSelected = trackCache.selection(slotThird, kTrackForBeauty3P);
             if (TESTBIT(isTrackSelected, kForBeauty) && ((TESTBIT(selD0InMass, 0) && track.sign() < 0) || (TESTBIT(selD0InMass, 1) && track.sign() > 0))) { // D0 pi-/K- and D0bar pi+/K+
               auto massCandD0Pi = RecoDecay::m(std::array{pVec2Prong, pVecThird}, std::array{massD0, massPi});
               auto massCandD0K = RecoDecay::m(std::array{pVec2Prong, pVecThird}, std::array{massD0, massKa});
@@ -771,15 +773,12 @@ struct HfFilter { // Main struct for HF triggers
                   if (track.globalIndex() == trackB.globalIndex()) {
                     continue;
                   }
-                  auto trackParFourth = getTrackParCov(trackB);
-                  std::array<float, 2> dcaFourth{trackB.dcaXY(), trackB.dcaZ()};
-                  std::array<float, 3> pVecFourth = trackB.pVector();
-                  if (trackB.collisionId() != thisCollId) {
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-                    getPxPyPz(trackParFourth, pVecFourth);
-                  }
+                  const auto slotFourth = trackCache.slot(trackB.globalIndex());
+                  const auto& trackParFourth = trackCache.trackParCov(slotFourth);
+                  const auto& dcaFourth = trackCache.dca(slotFourth);
+                  const auto& pVecFourth = trackCache.pVec(slotFourth);
 
-                  auto isTrackFourthSelected = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty3P>(trackB, trackParFourth, dcaFourth);
+                  auto isTrackFourthSelected = trackCache.selection(slotFourth, kTrackForBeauty3P);
                   if (track.sign() * trackB.sign() < 0 && TESTBIT(isTrackFourthSelected, kForBeauty)) {
                     auto massCandB0 = RecoDecay::m(std::array{pVecBeauty3Prong, pVecFourth}, std::array{massDStar, massPi});
                     auto pVecBeauty4Prong = RecoDecay::pVec(pVec2Prong, pVecThird, pVecFourth);
@@ -886,7 +885,7 @@ struct HfFilter { // Main struct for HF triggers
 
           // Beauty with JPsi
           if (preselJPsiToMuMu) {
-            if (!TESTBIT(helper.isSelectedTrackForSoftPionOrBeauty<kBtoJPsiKa>(track, trackParThird, dcaThird), kForBeauty)) { // same for all channels
+            if (!TESTBIT(trackCache.selection(slotThird, kTrackForBeautyToJPsi), kForBeauty)) { // same for all channels
               continue;
             }
             std::array<float, 3> pVecPosVtx{}, pVecNegVtx{}, pVecThirdVtx{}, pVecFourthVtx{};
@@ -923,14 +922,9 @@ struct HfFilter { // Main struct for HF triggers
                 if (trackFourth.globalIndex() == track.globalIndex() || trackFourth.globalIndex() == trackPos.globalIndex() || trackFourth.globalIndex() == trackNeg.globalIndex() || trackFourth.sign() * track.sign() > 0) {
                   continue;
                 }
-                auto trackParFourth = getTrackParCov(trackFourth);
-                std::array<float, 2> dcaFourth{trackFourth.dcaXY(), trackFourth.dcaZ()};
-                std::array<float, 3> pVecFourth = trackFourth.pVector();
-                if (trackFourth.collisionId() != thisCollId) {
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-                  getPxPyPz(trackParFourth, pVecFourth);
-                }
-                if (!TESTBIT(helper.isSelectedTrackForSoftPionOrBeauty<kBtoJPsiKa>(trackFourth, trackParFourth, dcaFourth), kForBeauty)) { // same for all channels
+                const auto slotFourth = trackCache.slot(trackFourth.globalIndex());
+                const auto& trackParFourth = trackCache.trackParCov(slotFourth);
+                if (!TESTBIT(trackCache.selection(slotFourth, kTrackForBeautyToJPsi), kForBeauty)) { // same for all channels
                   continue;
                 }
                 int nVtxB{0};
@@ -1027,21 +1021,17 @@ struct HfFilter { // Main struct for HF triggers
             if (!keepEvent[kV0Charm2P] && TESTBIT(selV0, kK0S)) {
 
               // we first look for a D*+
+              trackCache.fill(helper, tracks, trackIdsThisCollision, collision, noMatCorr);
               for (const auto& trackBachelorId : trackIdsThisCollision) { // start loop over tracks
                 auto trackBachelor = tracks.rawIteratorAt(trackBachelorId.trackId());
                 if (trackBachelor.globalIndex() == trackPos.globalIndex() || trackBachelor.globalIndex() == trackNeg.globalIndex() || trackBachelor.globalIndex() == v0.posTrackId() || trackBachelor.globalIndex() == v0.negTrackId()) {
                   continue;
                 }
 
-                auto trackParBachelor = getTrackPar(trackBachelor);
-                std::array<float, 2> dcaBachelor{trackBachelor.dcaXY(), trackBachelor.dcaZ()};
-                std::array<float, 3> pVecBachelor = trackBachelor.pVector();
-                if (trackBachelor.collisionId() != thisCollId) {
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParBachelor, 2.f, noMatCorr, &dcaBachelor);
-                  getPxPyPz(trackParBachelor, pVecBachelor);
-                }
+                const auto slotBachelor = trackCache.slot(trackBachelor.globalIndex());
+                const auto& pVecBachelor = trackCache.pVec(slotBachelor);
 
-                auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kV0Charm2P>(trackBachelor, trackParBachelor, dcaBachelor);
+                auto isTrackSelected = trackCache.selection(slotBachelor, kTrackForV0Charm2P);
                 if (TESTBIT(isTrackSelected, kSoftPion) && ((TESTBIT(selD0InMass, 0) && trackBachelor.sign() > 0) || (TESTBIT(selD0InMass, 1) && trackBachelor.sign() < 0))) {
                   std::array<float, 2> massDausD0{massPi, massKa};
                   auto massD0dau = massD0Cand;
@@ -1125,6 +1115,7 @@ struct HfFilter { // Main struct for HF triggers
 
         // 2-prong (D0 or D*) with proton for Lc resonances and ThetaC (3100)
         if (!keepEvent[kPrCharm2P] && isD0SignalTagged && (TESTBIT(selD0InMass, 0) || TESTBIT(selD0InMass, 1))) {
+          trackCache.fill(helper, tracks, trackIdsThisCollision, collision, noMatCorr);
           for (const auto& trackProtonId : trackIdsThisCollision) { // start loop over tracks selecting only protons
             auto trackProton = tracks.rawIteratorAt(trackProtonId.trackId());
             auto trackParBachelorProton = getTrackPar(trackProton);
@@ -1148,14 +1139,9 @@ struct HfFilter { // Main struct for HF triggers
                   if (trackBachelor.globalIndex() == trackPos.globalIndex() || trackBachelor.globalIndex() == trackNeg.globalIndex() || trackBachelor.globalIndex() == trackProton.globalIndex()) {
                     continue;
                   }
-                  auto trackParBachelor = getTrackPar(trackBachelor);
-                  std::array<float, 2> dcaBachelor{trackBachelor.dcaXY(), trackBachelor.dcaZ()};
-                  std::array<float, 3> pVecBachelor = trackBachelor.pVector();
-                  if (trackBachelor.collisionId() != thisCollId) {
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParBachelor, 2.f, noMatCorr, &dcaBachelor);
-                    getPxPyPz(trackParBachelor, pVecBachelor);
-                  }
-                  auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kPrCharm2P>(trackBachelor, trackParBachelor, dcaBachelor);
+                  const auto slotBachelor = trackCache.slot(trackBachelor.globalIndex());
+                  const auto& pVecBachelor = trackCache.pVec(slotBachelor);
+                  auto isTrackSelected = trackCache.selection(slotBachelor, kTrackForPrCharm2P);
                   if (TESTBIT(isTrackSelected, kSoftPion) && ((TESTBIT(selD0InMass, 0) && trackBachelor.sign() > 0) || (TESTBIT(selD0InMass, 1) && trackBachelor.sign() < 0))) {
                     if (pt2Prong < cutsPtDeltaMassCharmReso->get(3u, 12u)) {
                       continue;
@@ -1430,6 +1416,7 @@ struct HfFilter { // Main struct for HF triggers
 
         auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
         auto tracksWithItsPid = soa::Attach<BigTracksPID, aod::pidits::ITSNSigmaPr, aod::pidits::ITSNSigmaDe>(tracks);
+        trackCache.fill(helper, tracks, trackIdsThisCollision, collision, noMatCorr);
 
         for (const auto& trackId : trackIdsThisCollision) { // start loop over track indices as associated to this collision in HF code
           auto track = tracksWithItsPid.rawIteratorAt(trackId.trackId());
@@ -1437,18 +1424,15 @@ struct HfFilter { // Main struct for HF triggers
             continue;
           }
 
-          auto trackParFourth = getTrackParCov(track);
-          std::array<float, 2> dcaFourth{track.dcaXY(), track.dcaZ()};
-          std::array<float, 3> pVecFourth = track.pVector();
-          if (track.collisionId() != thisCollId) {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-            getPxPyPz(trackParFourth, pVecFourth);
-          }
+          const auto slotFourth = trackCache.slot(track.globalIndex());
+          const auto& trackParFourth = trackCache.trackParCov(slotFourth);
+          const auto& dcaFourth = trackCache.dca(slotFourth);
+          const auto& pVecFourth = trackCache.pVec(slotFourth);
 
           int charmParticleID[kNBeautyParticles - 3] = {o2::constants::physics::Pdg::kDPlus, o2::constants::physics::Pdg::kDS, o2::constants::physics::Pdg::kLambdaCPlus, o2::constants::physics::Pdg::kXiCPlus};
 
           float massCharmHypos[kNBeautyParticles - 3] = {massDPlus, massDs, massLc, massXic};
-          auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty4P>(track, trackParFourth, dcaFourth);
+          auto isTrackSelected = trackCache.selection(slotFourth, kTrackForBeauty4P);
           if (track.sign() * sign3Prong < 0 && TESTBIT(isTrackSelected, kForBeauty)) {
             for (int iHypo{0}; iHypo < kNBeautyParticles - 3 && !keepEvent[kBeauty4P]; ++iHypo) {
               if (isBeautyTagged[iHypo] && (TESTBIT(is3ProngInMass[iHypo], 0) || TESTBIT(is3ProngInMass[iHypo], 1))) {
@@ -1590,16 +1574,10 @@ struct HfFilter { // Main struct for HF triggers
               int chargeSc = std::accumulate(chargesSc.begin(), chargesSc.end(), 0); // SIGNED electric charge of SigmaC candidate
 
               // select soft pion candidates
-              auto trackParSoftPi = getTrackPar(trackSoftPi);
-              std::array<float, 2> dcaSoftPi{trackSoftPi.dcaXY(), trackSoftPi.dcaZ()};
-              std::array<float, 3> pVecSoftPi = trackSoftPi.pVector();
-              if (trackSoftPi.collisionId() != thisCollId) {
-                // This is a track reassociated to this PV by the track-to-collision-associator
-                // Let's propagate this track to it, and calculate dcaXY, dcaZ
-                o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParSoftPi, 2.f, noMatCorr, &dcaSoftPi);
-                getPxPyPz(trackParSoftPi, pVecSoftPi);
-              }
-              int16_t isSoftPionSelected = helper.isSelectedTrackForSoftPionOrBeauty<kSigmaCPPK>(trackSoftPi, trackParSoftPi, dcaSoftPi);
+              // tracks reassociated to this PV are already propagated to it in the track cache
+              const auto slotSoftPi = trackCache.slot(globalIndexSoftPi);
+              const auto& pVecSoftPi = trackCache.pVec(slotSoftPi);
+              int16_t isSoftPionSelected = trackCache.selection(slotSoftPi, kTrackForSigmaCPPK);
               if (TESTBIT(isSoftPionSelected, kSoftPionForSigmaC) /*&& (TESTBIT(is3Prong[2], 0) || TESTBIT(is3Prong[2], 1))*/) {
 
                 // check the mass of the SigmaC++ candidate
@@ -1803,16 +1781,10 @@ struct HfFilter { // Main struct for HF triggers
                 }
 
                 // select soft pion candidates
-                auto trackParSoftPi = getTrackPar(trackSoftPi);
-                std::array<float, 2> dcaSoftPi{trackSoftPi.dcaXY(), trackSoftPi.dcaZ()};
-                std::array<float, 3> pVecSoftPi = trackSoftPi.pVector();
-                if (trackSoftPi.collisionId() != thisCollId) {
-                  // This is a track reassociated to this PV by the track-to-collision-associator
-                  // Let's propagate this track to it, and calculate dcaXY, dcaZ
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParSoftPi, 2.f, noMatCorr, &dcaSoftPi);
-                  getPxPyPz(trackParSoftPi, pVecSoftPi);
-                }
-                int16_t isSoftPionSelected = helper.isSelectedTrackForSoftPionOrBeauty<kSigmaC0K0>(trackSoftPi, trackParSoftPi, dcaSoftPi);
+                // tracks reassociated to this PV are already propagated to it in the track cache
+                const auto slotSoftPi = trackCache.slot(globalIndexSoftPi);
+                const auto& pVecSoftPi = trackCache.pVec(slotSoftPi);
+                int16_t isSoftPionSelected = trackCache.selection(slotSoftPi, kTrackForSigmaC0K0);
                 if (TESTBIT(isSoftPionSelected, kSoftPionForSigmaC) /*&& (TESTBIT(is3Prong[2], 0) || TESTBIT(is3Prong[2], 1))*/) {
 
                   // check the mass of the SigmaC0 candidate
@@ -1927,6 +1899,7 @@ struct HfFilter { // Main struct for HF triggers
           }
 
           auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
+          trackCache.fill(helper, tracks, trackIdsThisCollision, collision, noMatCorr);
           for (const auto& trackId : trackIdsThisCollision) { // start loop over tracks (first bachelor)
             auto track = tracks.rawIteratorAt(trackId.trackId());
 
@@ -1935,13 +1908,10 @@ struct HfFilter { // Main struct for HF triggers
               continue;
             }
 
-            auto trackParBachelor = getTrackParCov(track);
-            std::array<float, 2> dcaInfoBach;
-            if (track.collisionId() != thisCollId) {
-              o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParBachelor, 2.f, noMatCorr, &dcaInfoBach);
-            }
+            const auto slotBachelor = trackCache.slot(track.globalIndex());
+            const auto& trackParBachelor = trackCache.trackParCov(slotBachelor);
 
-            auto isSelBachelor = helper.isSelectedBachelorForCharmBaryon(track, dcaInfoBach);
+            auto isSelBachelor = trackCache.selection(slotBachelor, kTrackForCharmBaryon);
             if (isSelBachelor == kRejected) {
               continue;
             }
@@ -1979,13 +1949,10 @@ struct HfFilter { // Main struct for HF triggers
                   continue;
                 }
 
-                auto trackParBachelorSecond = getTrackParCov(trackSecond);
-                std::array<float, 2> dcaInfoBachSecond;
-                if (trackSecond.collisionId() != thisCollId) {
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParBachelorSecond, 2.f, noMatCorr, &dcaInfoBachSecond);
-                }
+                const auto slotBachelorSecond = trackCache.slot(trackSecond.globalIndex());
+                const auto& trackParBachelorSecond = trackCache.trackParCov(slotBachelorSecond);
 
-                auto isSelBachelorSecond = helper.isSelectedBachelorForCharmBaryon(trackSecond, dcaInfoBachSecond);
+                auto isSelBachelorSecond = trackCache.selection(slotBachelorSecond, kTrackForCharmBaryon);
                 if (!TESTBIT(isSelBachelorSecond, kPionForCharmBaryon)) {
                   continue;
                 }
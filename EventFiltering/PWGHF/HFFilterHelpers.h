@@ -58,6 +58,7 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <string>
 #include <tuple>
@@ -738,6 +739,7 @@ class HfFilterHelper
   // PID
   void setValuesBB(o2::ccdb::CcdbApi& ccdbApi, aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::array<std::string, 8>& ccdbPaths);
   void setTpcRecalibMaps(o2::framework::Service<o2::ccdb::BasicCCDBManager> const& ccdb, aod::BCsWithTimestamps::iterator const& bunchCrossing, const std::string& ccdbPath);
+  void resetTpcPostCalibCache(std::size_t nTracks);
 
  private:
   // selections
@@ -866,11 +868,113 @@ class HfFilterHelper
   int mTpcPidCalibrationOption{0};                          // Option for TPC PID calibration (0 -> AO2D, 1 -> postcalibrations, 2 -> alternative bethe bloch parametrisation)
   std::array<TH3F*, 8> mHistMapPiPrKaDe{};                  // Map for TPC PID postcalibrations for pions, kaon, protons and deuterons
   std::array<std::vector<double>, 8> mBetheBlochPiKaPrDe{}; // Bethe-Bloch parametrisations for pions, antipions, kaons, antikaons, protons, antiprotons, deuterons, antideuterons in TPC
+  std::vector<std::array<float, 3>> mTpcPostCalibNSigma{};  // Per-TF cache of TPC postcalibrated Nsigma (pions, kaons, protons), indexed by track global index
   // Ds cuts from track-index-skim-creator
   std::vector<double> mPtBinsPreselDsToKKPi{};           // pT bins for pre-selections for Ds from track-index-skim-creator
   o2::framework::LabeledArray<double> mPreselDsToKKPi{}; // pre-selections for Ds from track-index-skim-creator
 };
 
+enum HfTrackRole {
+  kTrackForBeauty3P = 0,
+  kTrackForBeauty4P,
+  kTrackForBeautyToJPsi,
+  kTrackForV0Charm2P,
+  kTrackForPrCharm2P,
+  kTrackForSigmaCPPK,
+  kTrackForSigmaC0K0,
+  kTrackForCharmBaryon,
+  kNTrackRoles
+};
+
+/// Tracks associated to a collision, with their kinematics at the primary vertex and the single-track
+/// selections of each trigger role. It is filled once per collision and read by all the trigger loops.
+class HfTrackCacheThisCollision
+{
+ public:
+  /// Invalidates the cache, to be called at the beginning of each TF
+  void reset()
+  {
+    clear();
+    mCollisionId = -1;
+  }
+
+  /// Fills the cache with the tracks associated to a collision, if not already done for this collision
+  /// \param helper is the HF filter helper with the single-track selections
+  /// \param tracks is the track table
+  /// \param trackIds are the track indices associated to the collision
+  /// \param collision is the collision
+  /// \param matCorr is the material correction used for the propagation of reassociated tracks
+  template <typename TTracks, typename TTrackIds, typename TCollision>
+  void fill(HfFilterHelper& helper, TTracks const& tracks, TTrackIds const& trackIds, TCollision const& collision, o2::base::Propagator::MatCorrType matCorr)
+  {
+    if (mCollisionId == collision.globalIndex()) {
+      return;
+    }
+    clear();
+    mCollisionId = collision.globalIndex();
+    if (mSlotOfTrack.size() < static_cast<std::size_t>(tracks.size())) {
+      mSlotOfTrack.resize(tracks.size(), -1);
+    }
+
+    for (const auto& trackId : trackIds) {
+      auto track = tracks.rawIteratorAt(trackId.trackId());
+      auto trackParCov = getTrackParCov(track);
+      std::array<float, 2> dca{track.dcaXY(), track.dcaZ()};
+      std::array<float, 3> pVec = track.pVector();
+      if (track.collisionId() != mCollisionId) {
+        // track reassociated to this PV by the track-to-collision-associator
+        o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParCov, 2.f, matCorr, &dca);
+        getPxPyPz(trackParCov, pVec);
+      }
+
+      std::array<int16_t, kNTrackRoles> selection{};
+      selection[kTrackForBeauty3P] = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty3P>(track, trackParCov, dca);
+      selection[kTrackForBeauty4P] = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty4P>(track, trackParCov, dca);
+      selection[kTrackForBeautyToJPsi] = helper.isSelectedTrackForSoftPionOrBeauty<kBtoJPsiKa>(track, trackParCov, dca); // same for all channels
+      selection[kTrackForV0Charm2P] = helper.isSelectedTrackForSoftPionOrBeauty<kV0Charm2P>(track, trackParCov, dca);
+      selection[kTrackForPrCharm2P] = helper.isSelectedTrackForSoftPionOrBeauty<kPrCharm2P>(track, trackParCov, dca);
+      selection[kTrackForSigmaCPPK] = helper.isSelectedTrackForSoftPionOrBeauty<kSigmaCPPK>(track, trackParCov, dca);
+      selection[kTrackForSigmaC0K0] = helper.isSelectedTrackForSoftPionOrBeauty<kSigmaC0K0>(track, trackParCov, dca);
+      selection[kTrackForCharmBaryon] = helper.isSelectedBachelorForCharmBaryon(track, dca);
+
+      mSlotOfTrack[track.globalIndex()] = static_cast<int>(mGlobalIndex.size());
+      mGlobalIndex.push_back(track.globalIndex());
+      mTrackParCov.push_back(trackParCov);
+      mDca.push_back(dca);
+      mPVec.push_back(pVec);
+      mSelection.push_back(selection);
+    }
+  }
+
+  /// \return the position in the cache of a track, given its global index
+  int slot(int64_t globalIndex) const { return mSlotOfTrack[globalIndex]; }
+  o2::track::TrackParCov const& trackParCov(int slot) const { return mTrackParCov[slot]; }
+  std::array<float, 2> const& dca(int slot) const { return mDca[slot]; }
+  std::array<float, 3> const& pVec(int slot) const { return mPVec[slot]; }
+  int16_t selection(int slot, HfTrackRole role) const { return mSelection[slot][role]; }
+
+ private:
+  void clear()
+  {
+    for (const auto& globalIndex : mGlobalIndex) {
+      mSlotOfTrack[globalIndex] = -1;
+    }
+    mGlobalIndex.clear();
+    mTrackParCov.clear();
+    mDca.clear();
+    mPVec.clear();
+    mSelection.clear();
+  }
+
+  int64_t mCollisionId{-1};                                  // collision for which the cache is filled
+  std::vector<int> mSlotOfTrack{};                           // position in the cache of each track of the TF (-1 if not associated)
+  std::vector<int64_t> mGlobalIndex{};                       // global index of the cached tracks
+  std::vector<o2::track::TrackParCov> mTrackParCov{};        // track parameters at the primary vertex
+  std::vector<std::array<float, 2>> mDca{};                  // dcaXY and dcaZ with respect to the primary vertex
+  std::vector<std::array<float, 3>> mPVec{};                 // momentum at the primary vertex
+  std::vector<std::array<int16_t, kNTrackRoles>> mSelection; // single-track selection flags for each trigger role
+};
+
 /// Selection of high-pt 2-prong candidates
 /// \param pt is the pt of the 2-prong candidate
 template <typename T>
@@ -2683,20 +2787,46 @@ inline float HfFilterHelper::getTPCPostCalib(const T& track, const int& pidSpeci
   float tpcPin = track.tpcInnerParam();
   float eta = track.eta();
   float tpcNSigma{-999.};
+  int iSpecies{0};
 
   if (pidSpecies == kPi) {
     tpcNSigma = track.tpcNSigmaPi();
+    iSpecies = 0;
   } else if (pidSpecies == kKa) {
     tpcNSigma = track.tpcNSigmaKa();
+    iSpecies = 1;
   } else if (pidSpecies == kPr) {
     tpcNSigma = track.tpcNSigmaPr();
+    iSpecies = 2;
   } else {
     LOG(fatal) << "Wrong PID Species be selected, please check!";
   }
 
+  // the postcalibration does not depend on the collision, so it is computed once per track in the TF
+  auto globalIndex = static_cast<std::size_t>(track.globalIndex());
+  if (globalIndex < mTpcPostCalibNSigma.size()) {
+    auto& cachedNSigma = mTpcPostCalibNSigma[globalIndex][iSpecies];
+    if (std::isnan(cachedNSigma)) {
+      cachedNSigma = getTPCPostCalib(tpcPin, tpcNCls, eta, tpcNSigma, pidSpecies);
+    }
+    return cachedNSigma;
+  }
+
   return getTPCPostCalib(tpcPin, tpcNCls, eta, tpcNSigma, pidSpecies);
 }
 
+/// reset the per-TF cache of TPC postcalibrated nsigma values
+/// \param nTracks is the number of tracks in the TF
+inline void HfFilterHelper::resetTpcPostCalibCache(std::size_t nTracks)
+{
+  if (mTpcPidCalibrationOption != 1) {
+    mTpcPostCalibNSigma.clear();
+    return;
+  }
+  constexpr float NotComputed = std::numeric_limits<float>::quiet_NaN();
+  mTpcPostCalibNSigma.assign(nTracks, {NotComputed, NotComputed, NotComputed});
+}
+
 /// Finds pT bin in an array.
 /// \param bins  array of pT bins
 /// \param value  pT
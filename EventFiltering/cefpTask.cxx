@@ -39,7 +39,10 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cmath>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
@@ -217,6 +220,23 @@ static const float defaultDownscaling[128][1]{
   {1.f},
   {1.f}}; /// Max number of columns for triggers is 128 (extendible)
 
+/// Reads nBits (<= 64) bits of an Arrow bitmap starting at bit position bitOffset, packed in a 64-bit word
+uint64_t readBitmapWord(const uint8_t* bitmap, int64_t bitOffset, int64_t nBits)
+{
+  const uint8_t* bytes{bitmap + (bitOffset >> 3)};
+  const int shift{static_cast<int>(bitOffset & 7)};
+  const int64_t nBytes{(shift + nBits + 7) >> 3};
+  uint64_t word{0ull};
+  for (int64_t iByte{0}; iByte < nBytes && iByte < 8; ++iByte) {
+    word |= static_cast<uint64_t>(bytes[iByte]) << (8 * iByte);
+  }
+  word >>= shift;
+  if (shift && nBytes > 8) {
+    word |= static_cast<uint64_t>(bytes[8]) << (64 - shift);
+  }
+  return nBits < 64 ? word & (BIT(nBits) - 1) : word;
+}
+
 #define FILTER_CONFIGURABLE(_TYPE_)                                                                                                                                                                                  \
   Configurable<LabeledArray<float>> cfg##_TYPE_                                                                                                                                                                      \
   {                                                                                                                                                                                                                  \
@@ -226,6 +246,20 @@ static const float defaultDownscaling[128][1]{
 
 struct centralEventFilterTask {
 
+  /// Trigger channel (a column of a filter table) with its position in the trigger words and its downscaling threshold
+  struct TriggerChannel {
+    std::string column;
+    int bitIndex{0};           // global bit index, i.e. bin - 2 of the scaler histograms
+    bool alwaysAccept{true};   // downscaling >= 1
+    uint64_t threshold{0ull};  // event accepted if the 64-bit random number is below threshold
+    uint64_t nTriggered{0ull}; // per-TF counters, flushed into the scaler histograms
+    uint64_t nSelected{0ull};
+  };
+  struct TriggerTable {
+    std::string name;
+    std::vector<TriggerChannel> channels;
+  };
+
   HistogramRegistry scalers{"scalers", {}, OutputObjHandlingPolicy::AnalysisObject, true, true};
   Produces<aod::CefpDecisions> tags;
 
@@ -285,6 +319,22 @@ struct centralEventFilterTask {
     if (cfgDisableDownscalings.value) {
       LOG(info) << "Downscalings are disabled for all channels.";
     }
+
+    // Precompute the trigger bit and the integer downscaling threshold of each channel
+    for (auto& table : mDownscaling) {
+      auto& triggerTable{mTriggerTables.emplace_back()};
+      triggerTable.name = table.first;
+      for (auto& column : table.second) {
+        auto& channel{triggerTable.channels.emplace_back()};
+        channel.column = column.first;
+        channel.bitIndex = mScalers->GetXaxis()->FindBin(column.first.data()) - 2;
+        double downscaling{cfgDisableDownscalings.value ? 1. : column.second};
+        channel.alwaysAccept = downscaling >= 1.;
+        channel.threshold = channel.alwaysAccept ? ~0ull : static_cast<uint64_t>(std::ldexp(std::max(downscaling, 0.), 64));
+      }
+    }
+    mNChannels = nCols;
+    mCovarianceCounts.assign(nCols * nCols, 0ull);
   }
 
   void run(ProcessingContext& pc)
@@ -328,15 +378,15 @@ struct centralEventFilterTask {
 
     int64_t nEvents{collTabPtr->num_rows()};
     std::vector<std::array<uint64_t, 2>> outTrigger, outDecision;
-    for (auto& tableName : mDownscaling) {
-      if (!pc.inputs().isValid(tableName.first)) {
-        LOG(fatal) << tableName.first << " table is not valid.";
+    for (auto& triggerTable : mTriggerTables) {
+      if (!pc.inputs().isValid(triggerTable.name)) {
+        LOG(fatal) << triggerTable.name << " table is not valid.";
       }
-      auto tableConsumer = pc.inputs().get<TableConsumer>(tableName.first);
+      auto tableConsumer = pc.inputs().get<TableConsumer>(triggerTable.name);
       auto tablePtr{tableConsumer->asArrowTable()};
       int64_t nRows{tablePtr->num_rows()};
       if (nEvents != nRows) {
-        LOGF(fatal, "Inconsistent number of rows in the trigger table %s: %lld but it should be %lld", tableName.first.data(), nRows, nEvents);
+        LOGF(fatal, "Inconsistent number of rows in the trigger table %s: %lld but it should be %lld", triggerTable.name.data(), nRows, nEvents);
       }
 
       if (outDecision.size() == 0) {
@@ -344,63 +394,74 @@ struct centralEventFilterTask {
         outTrigger.resize(nEvents, {0ull, 0ull});
       }
 
-      auto schema{tablePtr->schema()};
-      for (auto& colName : tableName.second) {
-        uint64_t bin{static_cast<uint64_t>(mScalers->GetXaxis()->FindBin(colName.first.data()))};
-        double binCenter{mScalers->GetXaxis()->GetBinCenter(bin)};
-        uint64_t decisionBin{(bin - 2) / 64};
-        uint64_t triggerBit{BIT((bin - 2) % 64)};
-        auto column{tablePtr->GetColumnByName(colName.first)};
-        double downscaling{cfgDisableDownscalings.value ? 1. : colName.second};
-        if (column) {
-          int entry = 0;
-          for (int64_t iC{0}; iC < column->num_chunks(); ++iC) {
-            auto chunk{column->chunk(iC)};
-            auto boolArray = std::static_pointer_cast<arrow::BooleanArray>(chunk);
-            for (int64_t iS{startCollision}; iS < chunk->length(); ++iS) {
-              if (boolArray->Value(iS)) {
-                mScalers->Fill(binCenter);
-                outTrigger[entry][decisionBin] |= triggerBit;
-                if (mUniformGenerator(mGeneratorEngine) < downscaling) {
-                  mFiltered->Fill(binCenter);
-                  outDecision[entry][decisionBin] |= triggerBit;
-                }
+      for (auto& channel : triggerTable.channels) {
+        uint64_t decisionBin{static_cast<uint64_t>(channel.bitIndex) / 64};
+        uint64_t triggerBit{BIT(channel.bitIndex % 64)};
+        auto column{tablePtr->GetColumnByName(channel.column)};
+        if (!column) {
+          continue;
+        }
+        int64_t entry{0};
+        for (int64_t iC{0}; iC < column->num_chunks(); ++iC) {
+          auto boolArray = std::static_pointer_cast<arrow::BooleanArray>(column->chunk(iC));
+          const uint8_t* bitmap{boolArray->values()->data()};
+          const int64_t offset{boolArray->offset()};
+          // scan the packed boolean column 64 events at a time, visiting only the fired ones
+          for (int64_t iS{startCollision}; iS < boolArray->length(); iS += 64) {
+            uint64_t firedWord{readBitmapWord(bitmap, offset + iS, std::min<int64_t>(64, boolArray->length() - iS))};
+            channel.nTriggered += std::popcount(firedWord);
+            while (firedWord) {
+              const int64_t iEvent{entry + iS + std::countr_zero(firedWord)};
+              firedWord &= firedWord - 1;
+              outTrigger[iEvent][decisionBin] |= triggerBit;
+              if (channel.alwaysAccept || mGeneratorEngine() < channel.threshold) {
+                outDecision[iEvent][decisionBin] |= triggerBit;
+                ++channel.nSelected;
               }
-              entry++;
             }
           }
+          entry += boolArray->length();
         }
       }
     }
+    for (auto& triggerTable : mTriggerTables) {
+      for (auto& channel : triggerTable.channels) {
+        mScalers->AddBinContent(channel.bitIndex + 2, channel.nTriggered);
+        mFiltered->AddBinContent(channel.bitIndex + 2, channel.nSelected);
+        channel.nTriggered = channel.nSelected = 0ull;
+      }
+    }
     mScalers->SetBinContent(1, mScalers->GetBinContent(1) + nEvents - startCollision);
     mFiltered->SetBinContent(1, mFiltered->GetBinContent(1) + nEvents - startCollision);
 
+    uint64_t nTriggered{0ull}, nSelected{0ull};
     for (uint64_t iE{0}; iE < outTrigger.size(); ++iE) {
       const auto& triggerWord{outTrigger[iE]};
-      bool triggered{false}, selected{false};
+      // covariance: loop only over the pairs of fired bits, x <= y
       for (uint64_t iD{0}; iD < triggerWord.size(); ++iD) {
-        for (int iB{0}; iB < 64; ++iB) {
-          if (!(triggerWord[iD] & BIT(iB))) {
-            continue;
-          }
-          uint64_t xIndex{iD * 64 + iB};
-          for (uint64_t jD{0}; jD < triggerWord.size(); ++jD) {
-            for (int jB{0}; jB < 64; ++jB) {
-              uint64_t yIndex{jD * 64 + jB};
-              if (xIndex <= yIndex && triggerWord[jD] & BIT(jB)) {
-                mCovariance->Fill(iD * 64 + iB, jD * 64 + jB);
-              }
+        for (uint64_t xWord{triggerWord[iD]}; xWord; xWord &= xWord - 1) {
+          const int xIndex{static_cast<int>(iD * 64) + std::countr_zero(xWord)};
+          for (uint64_t jD{iD}; jD < triggerWord.size(); ++jD) {
+            uint64_t yWord{jD == iD ? xWord : triggerWord[jD]}; // bits below xIndex already cleared in xWord
+            for (; yWord; yWord &= yWord - 1) {
+              const int yIndex{static_cast<int>(jD * 64) + std::countr_zero(yWord)};
+              ++mCovarianceCounts[xIndex * mNChannels + yIndex];
             }
           }
         }
-        triggered = triggered || triggerWord[iD];
-        selected = selected || outDecision[iE][iD];
-      }
-      if (triggered) {
-        mScalers->Fill(mScalers->GetNbinsX() - 1);
       }
-      if (selected) {
-        mFiltered->Fill(mFiltered->GetNbinsX() - 1);
+      nTriggered += (triggerWord[0] | triggerWord[1]) != 0ull;
+      nSelected += (outDecision[iE][0] | outDecision[iE][1]) != 0ull;
+    }
+    mScalers->AddBinContent(mScalers->GetNbinsX(), nTriggered);
+    mFiltered->AddBinContent(mFiltered->GetNbinsX(), nSelected);
+    for (int xIndex{0}; xIndex < mNChannels; ++xIndex) {
+      for (int yIndex{xIndex}; yIndex < mNChannels; ++yIndex) {
+        auto& counts{mCovarianceCounts[xIndex * mNChannels + yIndex]};
+        if (counts) {
+          mCovariance->AddBinContent(mCovariance->GetBin(xIndex + 1, yIndex + 1), counts);
+          counts = 0ull;
+        }
       }
     }
 
@@ -428,7 +489,9 @@ struct centralEventFilterTask {
   }
 
   std::mt19937_64 mGeneratorEngine;
-  std::uniform_real_distribution<double> mUniformGenerator = std::uniform_real_distribution<double>(0., 1.);
+  std::vector<TriggerTable> mTriggerTables; // trigger channels grouped by filter table
+  int mNChannels{0};                        // total number of trigger channels
+  std::vector<uint64_t> mCovarianceCounts;  // per-TF selection covariance counts, flushed into mCovariance
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfg)
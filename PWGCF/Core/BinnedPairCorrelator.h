@@ -0,0 +1,385 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGCF_CORE_BINNEDPAIRCORRELATOR_H_
+#define PWGCF_CORE_BINNEDPAIRCORRELATOR_H_
+
+#include <CommonConstants/MathConstants.h>
+#include <Framework/Logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+// Two-particle delta eta - delta phi correlations from binned single-particle distributions
+//
+// Triggers and associated particles of one event are binned per pT bin into fine (eta, phi) grids. The pair distribution of each
+// (pT,trig, pT,assoc) cell is the discrete cross-correlation of the two grids: along phi (periodic) it is computed as a product in
+// Fourier space, along eta as a direct sum over the occupied rows. The cost is independent of the number of pairs, which pays off in
+// high-multiplicity events. Only pair weights which factorise (w_trig * w_assoc, e.g. efficiency x NUA) are supported.
+//
+// The grids are finer than the delta eta / delta phi output axes by an integer oversampling factor k. A pair with fine index
+// difference d has its true difference within (d-1, d+1) fine bins, so for k >= 2 it lies entirely inside one output bin unless d
+// falls on an output bin edge, in which case it is split equally between the two neighbours.
+//
+// Self-pairs (same particle as trigger and associated) are subtracted. If pT ordering (pT,assoc < pT,trig) is requested, cells with
+// overlapping trigger and associated pT bins are filled with the exact pair loop.
+
+class BinnedPairCorrelator
+{
+ public:
+  void init(double etaMax, std::vector<double> const& ptTriggerEdges, std::vector<double> const& ptAssocEdges,
+            int nDeltaEta, double deltaEtaMin, double deltaEtaMax, int nDeltaPhi, double deltaPhiMin, double deltaPhiMax, int oversampling);
+
+  void addTrigger(int64_t index, float eta, float phi, float pt, float weight) { add(mTriggers, mPtTriggerEdges, index, eta, phi, pt, weight); }
+  void addAssociated(int64_t index, float eta, float phi, float pt, float weight) { add(mAssociated, mPtAssocEdges, index, eta, phi, pt, weight); }
+
+  // Calls fill(deltaEta, ptAssoc, ptTrig, deltaPhi, weight) for all non-empty output bins (values at bin centres), or for each pair in
+  // cells filled with the exact pair loop. Resets the particles of this event afterwards.
+  template <typename F>
+  void correlate(bool ptOrder, F&& fill);
+
+ protected:
+  struct Particle {
+    int64_t index; // global index, to identify self-pairs
+    int ptBin;
+    int etaBin;
+    int phiBin;
+    float eta;
+    float phi;
+    float pt;
+    float weight;
+  };
+
+  void add(std::vector<Particle>& particles, std::vector<double> const& ptEdges, int64_t index, float eta, float phi, float pt, float weight);
+  void transform(std::vector<Particle> const& particles, int nPtBins, std::vector<std::vector<std::complex<double>>>& grids, std::vector<std::vector<int>>& rows);
+  void fft(const std::complex<double>* in, std::complex<double>* out, int n, int stride, int twiddleStride, bool inverse);
+
+  int mOversampling = 2;
+  int mNEta = 0;                       // fine eta bins of the single-particle grids
+  int mNPhi = 0;                       // fine phi bins of the single-particle grids (periodic)
+  float mEtaMin = 0;                   // lower edge of the eta grid
+  float mEtaWidth = 0;                 // fine eta bin width
+  float mPhiWidth = 0;                 // fine phi bin width
+  int mDeltaEtaOffset = 0;             // lower edge of the delta eta axis in units of fine bins
+  int mDeltaPhiOffset = 0;             // lower edge of the delta phi axis in units of fine bins
+  int mNDeltaEta = 0;                  // output delta eta bins
+  int mNDeltaPhi = 0;                  // output delta phi bins
+  std::vector<double> mDeltaEtaCenters; // output bin centres
+  std::vector<double> mDeltaPhiCenters;
+  std::vector<double> mPtTriggerEdges;
+  std::vector<double> mPtAssocEdges;
+
+  std::vector<std::complex<double>> mTwiddles; // exp(-2 pi i j / mNPhi)
+  std::vector<std::complex<double>> mScratch;  // fft butterflies
+  std::vector<std::complex<double>> mRow;      // fft output row
+
+  // per event
+  std::vector<Particle> mTriggers;
+  std::vector<Particle> mAssociated;
+  std::vector<std::vector<std::complex<double>>> mTriggerGrids; // [pt bin][eta * mNPhi + k], phi transformed
+  std::vector<std::vector<std::complex<double>>> mAssocGrids;
+  std::vector<std::vector<int>> mTriggerRows; // occupied eta rows per pt bin
+  std::vector<std::vector<int>> mAssocRows;
+  std::vector<std::complex<double>> mSpectrum; // [delta eta fine][k]
+  std::vector<char> mSpectrumUsed;             // [delta eta fine]
+  std::vector<double> mOutput;                 // [delta eta][delta phi]
+};
+
+inline void BinnedPairCorrelator::init(double etaMax, std::vector<double> const& ptTriggerEdges, std::vector<double> const& ptAssocEdges,
+                                       int nDeltaEta, double deltaEtaMin, double deltaEtaMax, int nDeltaPhi, double deltaPhiMin, double deltaPhiMax, int oversampling)
+{
+  if (oversampling < 1) {
+    LOGF(fatal, "BinnedPairCorrelator: oversampling has to be >= 1 (%d)", oversampling);
+  }
+  if (std::abs(deltaPhiMax - deltaPhiMin - o2::constants::math::TwoPI) > 1e-5) {
+    LOGF(fatal, "BinnedPairCorrelator: the delta phi axis has to span 2 pi (%f, %f)", deltaPhiMin, deltaPhiMax);
+  }
+
+  mOversampling = oversampling;
+  mNDeltaEta = nDeltaEta;
+  mNDeltaPhi = nDeltaPhi;
+  mPtTriggerEdges = ptTriggerEdges;
+  mPtAssocEdges = ptAssocEdges;
+
+  mEtaWidth = (deltaEtaMax - deltaEtaMin) / nDeltaEta / oversampling;
+  mEtaMin = -etaMax;
+  mNEta = static_cast<int>(std::ceil(2 * etaMax / mEtaWidth - 1e-6));
+  mNPhi = nDeltaPhi * oversampling;
+  mPhiWidth = o2::constants::math::TwoPI / mNPhi;
+
+  // output bin edges have to be multiples of the fine bin width
+  mDeltaEtaOffset = static_cast<int>(std::lround(deltaEtaMin / mEtaWidth));
+  mDeltaPhiOffset = static_cast<int>(std::lround(deltaPhiMin / mPhiWidth));
+  if (std::abs(deltaEtaMin / mEtaWidth - mDeltaEtaOffset) > 1e-3 || std::abs(deltaPhiMin / mPhiWidth - mDeltaPhiOffset) > 1e-3) {
+    LOGF(fatal, "BinnedPairCorrelator: lower edges of delta eta (%f) and delta phi (%f) axes are not multiples of the fine bin widths (%f, %f)", deltaEtaMin, deltaPhiMin, mEtaWidth, mPhiWidth);
+  }
+
+  mDeltaEtaCenters.resize(nDeltaEta);
+  for (int i = 0; i < nDeltaEta; i++) {
+    mDeltaEtaCenters[i] = deltaEtaMin + (i + 0.5) * (deltaEtaMax - deltaEtaMin) / nDeltaEta;
+  }
+  mDeltaPhiCenters.resize(nDeltaPhi);
+  for (int i = 0; i < nDeltaPhi; i++) {
+    mDeltaPhiCenters[i] = deltaPhiMin + (i + 0.5) * (deltaPhiMax - deltaPhiMin) / nDeltaPhi;
+  }
+
+  mTwiddles.resize(mNPhi);
+  for (int j = 0; j < mNPhi; j++) {
+    mTwiddles[j] = std::polar(1.0, -2.0 * M_PI * j / mNPhi); // double precision, the float constant would leave noise in empty bins
+  }
+  mScratch.resize(mNPhi);
+  mRow.resize(mNPhi);
+
+  mTriggerGrids.assign(mPtTriggerEdges.size() - 1, std::vector<std::complex<double>>(mNEta * mNPhi));
+  mAssocGrids.assign(mPtAssocEdges.size() - 1, std::vector<std::complex<double>>(mNEta * mNPhi));
+  mTriggerRows.assign(mPtTriggerEdges.size() - 1, {});
+  mAssocRows.assign(mPtAssocEdges.size() - 1, {});
+  mSpectrum.assign((2 * mNEta - 1) * mNPhi, 0);
+  mSpectrumUsed.assign(2 * mNEta - 1, 0);
+  mOutput.assign(mNDeltaEta * mNDeltaPhi, 0);
+
+  LOGF(info, "BinnedPairCorrelator: (eta, phi) grids of %d x %d bins, %d pT,trig x %d pT,assoc bins", mNEta, mNPhi, static_cast<int>(mTriggerGrids.size()), static_cast<int>(mAssocGrids.size()));
+}
+
+inline void BinnedPairCorrelator::add(std::vector<Particle>& particles, std::vector<double> const& ptEdges, int64_t index, float eta, float phi, float pt, float weight)
+{
+  // particles outside of the pT axis would not be filled into the pair histogram either
+  auto it = std::upper_bound(ptEdges.begin(), ptEdges.end(), pt);
+  if (it == ptEdges.begin() || it == ptEdges.end()) {
+    return;
+  }
+  int etaBin = static_cast<int>(std::floor((eta - mEtaMin) / mEtaWidth));
+  if (etaBin < 0 || etaBin >= mNEta) {
+    return;
+  }
+  int phiBin = static_cast<int>(std::floor(phi / mPhiWidth)) % mNPhi;
+  if (phiBin < 0) {
+    phiBin += mNPhi;
+  }
+  particles.push_back({index, static_cast<int>(std::distance(ptEdges.begin(), it)) - 1, etaBin, phiBin, eta, phi, pt, weight});
+}
+
+inline void BinnedPairCorrelator::fft(const std::complex<double>* in, std::complex<double>* out, int n, int stride, int twiddleStride, bool inverse)
+{
+  // mixed-radix decimation in time: out[k] = sum_j in[j * stride] exp(-+ 2 pi i j k / n), with n * twiddleStride = mNPhi
+  if (n == 1) {
+    out[0] = in[0];
+    return;
+  }
+  int p = 2;
+  while (n % p != 0) {
+    p++;
+  }
+  const int m = n / p;
+  for (int r = 0; r < p; r++) {
+    fft(in + r * stride, out + r * m, m, stride * p, twiddleStride * p, inverse);
+  }
+  for (int k = 0; k < m; k++) {
+    for (int r = 0; r < p; r++) {
+      mScratch[r] = out[r * m + k];
+    }
+    for (int q = 0; q < p; q++) {
+      std::complex<double> sum = mScratch[0];
+      for (int r = 1; r < p; r++) {
+        const auto& w = mTwiddles[(static_cast<int64_t>(r) * (k + q * m) * twiddleStride) % mNPhi];
+        sum += (inverse ? std::conj(w) : w) * mScratch[r];
+      }
+      out[k + q * m] = sum;
+    }
+  }
+}
+
+inline void BinnedPairCorrelator::transform(std::vector<Particle> const& particles, int nPtBins, std::vector<std::vector<std::complex<double>>>& grids, std::vector<std::vector<int>>& rows)
+{
+  for (int i = 0; i < nPtBins; i++) {
+    rows[i].clear();
+  }
+  for (const auto& particle : particles) {
+    auto& grid = grids[particle.ptBin];
+    auto* row = &grid[particle.etaBin * mNPhi];
+    if (std::find(rows[particle.ptBin].begin(), rows[particle.ptBin].end(), particle.etaBin) == rows[particle.ptBin].end()) {
+      rows[particle.ptBin].push_back(particle.etaBin);
+      std::fill(row, row + mNPhi, 0);
+    }
+    row[particle.phiBin] += particle.weight;
+  }
+  for (int i = 0; i < nPtBins; i++) {
+    for (auto eta : rows[i]) {
+      auto* row = &grids[i][eta * mNPhi];
+      fft(row, mRow.data(), mNPhi, 1, 1, false);
+      std::copy(mRow.begin(), mRow.end(), row);
+    }
+  }
+}
+
+template <typename F>
+void BinnedPairCorrelator::correlate(bool ptOrder, F&& fill)
+{
+  const int nPtTrigger = mPtTriggerEdges.size() - 1;
+  const int nPtAssoc = mPtAssocEdges.size() - 1;
+
+  // self-pairs are found by index
+  auto byIndex = [](const Particle& a, const Particle& b) { return a.index < b.index; };
+  std::sort(mTriggers.begin(), mTriggers.end(), byIndex);
+  std::sort(mAssociated.begin(), mAssociated.end(), byIndex);
+
+  transform(mTriggers, nPtTrigger, mTriggerGrids, mTriggerRows);
+  transform(mAssociated, nPtAssoc, mAssocGrids, mAssocRows);
+
+  for (int i = 0; i < nPtTrigger; i++) {
+    if (mTriggerRows[i].empty()) {
+      continue;
+    }
+    const double ptTrig = 0.5 * (mPtTriggerEdges[i] + mPtTriggerEdges[i + 1]);
+
+    for (int j = 0; j < nPtAssoc; j++) {
+      if (mAssocRows[j].empty()) {
+        continue;
+      }
+      const double ptAssoc = 0.5 * (mPtAssocEdges[j] + mPtAssocEdges[j + 1]);
+
+      if (ptOrder) {
+        if (mPtAssocEdges[j] >= mPtTriggerEdges[i + 1]) {
+          continue; // pT,assoc >= pT,trig for all pairs
+        }
+        if (mPtAssocEdges[j + 1] > mPtTriggerEdges[i]) {
+          // overlapping pT bins, ordering has to be decided pair by pair
+          for (const auto& trigger : mTriggers) {
+            if (trigger.ptBin != i) {
+              continue;
+            }
+            for (const auto& associated : mAssociated) {
+              if (associated.ptBin != j || associated.index == trigger.index || associated.pt >= trigger.pt) {
+                continue;
+              }
+              float deltaPhi = trigger.phi - associated.phi;
+              if (deltaPhi < -o2::constants::math::PIHalf) {
+                deltaPhi += o2::constants::math::TwoPI;
+              } else if (deltaPhi >= 3 * o2::constants::math::PIHalf) {
+                deltaPhi -= o2::constants::math::TwoPI;
+              }
+              fill(trigger.eta - associated.eta, associated.pt, trigger.pt, deltaPhi, trigger.weight * associated.weight);
+            }
+          }
+          continue;
+        }
+      }
+
+      // cross-power spectrum per delta eta row, then back to delta phi
+      std::fill(mSpectrumUsed.begin(), mSpectrumUsed.end(), 0);
+      for (auto eta1 : mTriggerRows[i]) {
+        const auto* row1 = &mTriggerGrids[i][eta1 * mNPhi];
+        for (auto eta2 : mAssocRows[j]) {
+          const auto* row2 = &mAssocGrids[j][eta2 * mNPhi];
+          const int dEta = eta1 - eta2 + mNEta - 1;
+          auto* spectrum = &mSpectrum[dEta * mNPhi];
+          if (!mSpectrumUsed[dEta]) {
+            mSpectrumUsed[dEta] = 1;
+            std::fill(spectrum, spectrum + mNPhi, 0);
+          }
+          for (int k = 0; k < mNPhi; k++) {
+            spectrum[k] += row1[k] * std::conj(row2[k]);
+          }
+        }
+      }
+
+      // self-pairs only contribute to delta eta = delta phi = 0
+      double selfWeight = 0;
+      if (!ptOrder) {
+        auto it = mAssociated.begin();
+        for (const auto& trigger : mTriggers) {
+          it = std::lower_bound(it, mAssociated.end(), trigger, byIndex);
+          if (it == mAssociated.end()) {
+            break;
+          }
+          if (it->index == trigger.index && trigger.ptBin == i && it->ptBin == j) {
+            selfWeight += static_cast<double>(trigger.weight) * it->weight;
+          }
+        }
+      }
+
+      // numerical noise of the transforms scales with the total pair weight of the cell
+      double cellWeight = 0;
+      for (int dEta = 0; dEta < 2 * mNEta - 1; dEta++) {
+        if (mSpectrumUsed[dEta]) {
+          cellWeight += std::abs(mSpectrum[dEta * mNPhi]);
+        }
+      }
+      const double epsilon = 1e-9 * std::max(1.0, cellWeight);
+
+      for (int dEta = 0; dEta < 2 * mNEta - 1; dEta++) {
+        if (!mSpectrumUsed[dEta]) {
+          continue;
+        }
+        fft(&mSpectrum[dEta * mNPhi], mRow.data(), mNPhi, 1, 1, true);
+        if (dEta == mNEta - 1) {
+          mRow[0] -= selfWeight * mNPhi;
+        }
+
+        // fine delta eta bin -> output bin(s)
+        const int uEta = dEta - (mNEta - 1) - mDeltaEtaOffset;
+        int etaBins[2] = {-1, -1};
+        double etaFractions[2] = {1, 0};
+        if (uEta % mOversampling == 0) {
+          etaBins[0] = uEta / mOversampling - 1;
+          etaBins[1] = uEta / mOversampling;
+          etaFractions[0] = etaFractions[1] = 0.5;
+        } else {
+          etaBins[0] = (uEta >= 0) ? uEta / mOversampling : -1;
+        }
+
+        for (int dPhi = 0; dPhi < mNPhi; dPhi++) {
+          const double value = mRow[dPhi].real() / mNPhi;
+          if (std::abs(value) < epsilon) {
+            continue;
+          }
+          const int uPhi = ((dPhi - mDeltaPhiOffset) % mNPhi + mNPhi) % mNPhi;
+          int phiBins[2] = {uPhi / mOversampling, -1};
+          double phiFractions[2] = {1, 0};
+          if (uPhi % mOversampling == 0) {
+            phiBins[0] = (uPhi / mOversampling - 1 + mNDeltaPhi) % mNDeltaPhi;
+            phiBins[1] = uPhi / mOversampling;
+            phiFractions[0] = phiFractions[1] = 0.5;
+          }
+          for (int a = 0; a < 2; a++) {
+            if (etaBins[a] < 0 || etaBins[a] >= mNDeltaEta || etaFractions[a] == 0) {
+              continue;
+            }
+            for (int b = 0; b < 2; b++) {
+              if (phiBins[b] < 0 || phiFractions[b] == 0) {
+                continue;
+              }
+              mOutput[etaBins[a] * mNDeltaPhi + phiBins[b]] += etaFractions[a] * phiFractions[b] * value;
+            }
+          }
+        }
+      }
+
+      for (int a = 0; a < mNDeltaEta; a++) {
+        for (int b = 0; b < mNDeltaPhi; b++) {
+          auto& value = mOutput[a * mNDeltaPhi + b];
+          if (std::abs(value) > epsilon) {
+            fill(mDeltaEtaCenters[a], ptAssoc, ptTrig, mDeltaPhiCenters[b], value);
+          }
+          value = 0;
+        }
+      }
+    }
+  }
+
+  mTriggers.clear();
+  mAssociated.clear();
+}
+
+#endif // PWGCF_CORE_BINNEDPAIRCORRELATOR_H_
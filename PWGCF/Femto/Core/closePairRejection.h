@@ -26,6 +26,7 @@
 #include <Framework/HistogramSpec.h>
 #include <Framework/Logger.h>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
@@ -175,6 +176,15 @@ auto makeCprHistSpecMap(const T& confCpr)
   };
 };
 
+// combine the kinematic ranges of two rejections (see CloseTrackRejection::getRequiredKinematicMax)
+inline float combineRequiredKinematicMax(float kinematicMax1, float kinematicMax2)
+{
+  if (kinematicMax1 < 0.f || kinematicMax2 < 0.f) {
+    return -1.f;
+  }
+  return std::max(kinematicMax1, kinematicMax2);
+}
+
 template <auto& prefix>
 class CloseTrackRejection
 {
@@ -383,6 +393,23 @@ class CloseTrackRejection
 
   [[nodiscard]] bool isActivated() const { return mIsActivated; }
 
+  // largest kinematic value (kstar/Q3) up to which every pair has to be passed to compute() and fill()
+  // 0 means pairs are only needed for the rejection itself, a negative value means all pairs are needed
+  [[nodiscard]] float getRequiredKinematicMax() const
+  {
+    if (!mIsActivated) {
+      return 0.f;
+    }
+    // the random track order is drawn for every computed pair, so skipping pairs would change the sequence
+    if (mRandomizeTracks) {
+      return -1.f;
+    }
+    if (!mPlotAverage && !mPlotAllRadii && !mPlotAngularCorrelation) {
+      return 0.f;
+    }
+    return mKinematicMax > 0.f ? mKinematicMax : -1.f;
+  }
+
  private:
   std::optional<float> phistar(float magfield, float radius, float signedPt, float phi)
   {
@@ -453,6 +480,7 @@ class ClosePairRejectionTrackTrack
   }
   [[nodiscard]] bool isClosePair() const { return mCtr.isClosePair(); }
   void fill(float kstar) { mCtr.fill(kstar); }
+  [[nodiscard]] float getRequiredKinematicMax() const { return mCtr.getRequiredKinematicMax(); }
 
  private:
   CloseTrackRejection<prefix> mCtr;
@@ -535,6 +563,8 @@ class ClosePairRejectionTrackV0 // can also be used for any particle type that h
 
   void fill(float kstar) { mCtr.fill(kstar); }
 
+  [[nodiscard]] float getRequiredKinematicMax() const { return mCtr.getRequiredKinematicMax(); }
+
  private:
   CloseTrackRejection<prefixTrackV0> mCtr;
 };
@@ -584,6 +614,11 @@ class ClosePairRejectionTrackCascade
     mCtrV0Daughter.fill(kstar);
   }
 
+  [[nodiscard]] float getRequiredKinematicMax() const
+  {
+    return combineRequiredKinematicMax(mCtrBachelor.getRequiredKinematicMax(), mCtrV0Daughter.getRequiredKinematicMax());
+  }
+
  private:
   CloseTrackRejection<prefixBachelor> mCtrBachelor;
   CloseTrackRejection<prefixV0Daughter> mCtrV0Daughter;
@@ -104,6 +104,13 @@ class CloseTripletRejectionTrackTrackTrack
     mCtrTrack13.fill(q3);
   }
 
+  // largest Q3 up to which every triplet has to be passed to the rejection, negative if all triplets are needed
+  [[nodiscard]] float getRequiredKinematicMax() const
+  {
+    return closepairrejection::combineRequiredKinematicMax(mCtrTrack12.getRequiredKinematicMax(),
+                                                           closepairrejection::combineRequiredKinematicMax(mCtrTrack23.getRequiredKinematicMax(), mCtrTrack13.getRequiredKinematicMax()));
+  }
+
  private:
   closepairrejection::ClosePairRejectionTrackTrack<prefixTrack1Track2> mCtrTrack12;
   closepairrejection::ClosePairRejectionTrackTrack<prefixTrack2Track3> mCtrTrack23;
@@ -156,6 +163,13 @@ class CloseTripletRejectionTrackTrackV0
     mCtrTrack2V0.fill(q3);
   }
 
+  // largest Q3 up to which every triplet has to be passed to the rejection, negative if all triplets are needed
+  [[nodiscard]] float getRequiredKinematicMax() const
+  {
+    return closepairrejection::combineRequiredKinematicMax(mCtrTrack12.getRequiredKinematicMax(),
+                                                           closepairrejection::combineRequiredKinematicMax(mCtrTrack1V0.getRequiredKinematicMax(), mCtrTrack2V0.getRequiredKinematicMax()));
+  }
+
  private:
   closepairrejection::ClosePairRejectionTrackTrack<prefixTrack1Track2> mCtrTrack12;
   closepairrejection::ClosePairRejectionTrackV0<prefixTrack1V0> mCtrTrack1V0;
@@ -214,6 +228,13 @@ class CloseTripletRejectionTrackTrackCascade
     mCtrTrack2Cascade.fill(q3);
   }
 
+  // largest Q3 up to which every triplet has to be passed to the rejection, negative if all triplets are needed
+  [[nodiscard]] float getRequiredKinematicMax() const
+  {
+    return closepairrejection::combineRequiredKinematicMax(mCtrTrack12.getRequiredKinematicMax(),
+                                                           closepairrejection::combineRequiredKinematicMax(mCtrTrack1Cascade.getRequiredKinematicMax(), mCtrTrack2Cascade.getRequiredKinematicMax()));
+  }
+
  private:
   closepairrejection::ClosePairRejectionTrackTrack<prefixTrack1Track2> mCtrTrack12;
   closepairrejection::ClosePairRejectionTrackCascade<prefixTrack1Bachelor, prefixTrack1V0Daughter> mCtrTrack1Cascade;
@@ -80,6 +80,7 @@ enum TripletHist {
   kMeMixingWindowEffective,                                      // mixing window size, counting event triplets with particle triplets
   kMeNpart1VsNpart2VsNpart3,                                     // unique particles 1,2,3 in each mixed event
   kMeVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3, // correlation of event properties in each mixing bin (super heavy! use with caution)
+  kTripletPruning,                                               // triplets evaluated and triplets skipped by the pairwise Q3 bound
 
   kTripletHistogramLast
 };
@@ -178,6 +179,7 @@ constexpr std::array<histmanager::HistInfo<TripletHist>, kTripletHistogramLast>
       {kMeMixingWindowEffective, o2::framework::HistType::kTH1F, "hMeMixingWindowEffective", "Effective Mixing Window; Effective Mixing Window; Entries"},
       {kMeNpart1VsNpart2VsNpart3, o2::framework::HistType::kTHnSparseF, "hMeNpart1VsNpart2VsNpart3", "# unique particle 1 vs # unique particle 2 vs # unique particle 3 in each mixing bin; # particle 1; # particle 2; # particle 3;"},
       {kMeVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3, o2::framework::HistType::kTHnSparseF, "hVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3", "Mixing bins; V_{z,1} (cm); mult_{1}; cent_{1} (%); V_{z,2} (cm); mult_{2}; cent_{2} (%); V_{z,3} (cm); mult_{3}; cent_{3} (%);"},
+      {kTripletPruning, o2::framework::HistType::kTH1F, "hTripletPruning", "Triplet enumeration; 0: evaluated, 1: pruned by pairwise Q_{3} bound; Triplets"},
     }};
 
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
@@ -203,6 +205,7 @@ constexpr std::array<histmanager::HistInfo<TripletHist>, kTripletHistogramLast>
     {kMeMixingWindowRaw, {(confMixing).particleBinning}},                                                                                     \
     {kMeMixingWindowEffective, {(confMixing).particleBinning}},                                                                               \
     {kMeNpart1VsNpart2VsNpart3, {(confMixing).particleBinning, (confMixing).particleBinning, (confMixing).particleBinning}},                  \
+    {kTripletPruning, {o2::framework::AxisSpec{2, -0.5, 1.5}}},                                                                               \
     {kMeVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3, {(confMixing).vtxBins, (confMixing).multBins, (confMixing).centBins, (confMixing).vtxBins, (confMixing).multBins, (confMixing).centBins, (confMixing).vtxBins, (confMixing).multBins, (confMixing).centBins}},
 
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
@@ -438,6 +441,27 @@ class TripletHistManager
   }
 
   float getQ3() const { return mQ3; }
+  float getQ3Max() const { return mQ3Max; }
+
+  // four vector of a particle as it enters Q3 when placed at position 1, 2 or 3 of the triplet
+  template <int position, typename T>
+  ROOT::Math::PxPyPzEVector getFourVector(T const& particle) const
+  {
+    static_assert(position >= 1 && position <= 3, "Triplet position has to be 1, 2 or 3");
+    if constexpr (position == 1) {
+      return ROOT::Math::PxPyPzEVector(ROOT::Math::PtEtaPhiMVector(mAbsCharge1 * particle.pt(), particle.eta(), particle.phi(), mPdgMass1));
+    } else if constexpr (position == 2) {
+      return ROOT::Math::PxPyPzEVector(ROOT::Math::PtEtaPhiMVector(mAbsCharge2 * particle.pt(), particle.eta(), particle.phi(), mPdgMass2));
+    } else {
+      return ROOT::Math::PxPyPzEVector(ROOT::Math::PtEtaPhiMVector(mAbsCharge3 * particle.pt(), particle.eta(), particle.phi(), mPdgMass3));
+    }
+  }
+
+  // contribution of a single pair to Q3^2, each of the three terms is non-negative
+  double getPairQ3Term(ROOT::Math::PxPyPzEVector const& vi, ROOT::Math::PxPyPzEVector const& vj) const
+  {
+    return -getqij(vi, vj).M2();
+  }
 
   template <typename T1, typename T2, typename T3>
   void trackParticlesPerEvent(T1 const& particle1, T2 const& particle2, T3 const& particle3)
@@ -493,8 +517,16 @@ class TripletHistManager
     }
   }
 
+  void fillTripletPruningQa(uint64_t nEvaluated, uint64_t nPruned)
+  {
+    if (mPairCorrelationQa) {
+      mHistogramRegistry->fill(HIST(prefix) + HIST(QaDir) + HIST(getHistName(kTripletPruning, HistTable)), 0., static_cast<double>(nEvaluated));
+      mHistogramRegistry->fill(HIST(prefix) + HIST(QaDir) + HIST(getHistName(kTripletPruning, HistTable)), 1., static_cast<double>(nPruned));
+    }
+  }
+
  private:
-  ROOT::Math::PxPyPzEVector getqij(ROOT::Math::PxPyPzEVector const& vi, ROOT::Math::PxPyPzEVector const& vj)
+  ROOT::Math::PxPyPzEVector getqij(ROOT::Math::PxPyPzEVector const& vi, ROOT::Math::PxPyPzEVector const& vj) const
   {
     auto trackSum = vi + vj;
     auto trackDifference = vi - vj;
@@ -591,6 +623,7 @@ class TripletHistManager
     std::string dir = std::string(prefix) + std::string(QaDir);
     if (mPairCorrelationQa) {
       mHistogramRegistry->add(dir + getHistNameV2(kSeNpart1VsNpart2VsNpart3, HistTable), getHistDesc(kSeNpart1VsNpart2VsNpart3, HistTable), getHistType(kSeNpart1VsNpart2VsNpart3, HistTable), {Specs.at(kSeNpart1VsNpart2VsNpart3)});
+      mHistogramRegistry->add(dir + getHistNameV2(kTripletPruning, HistTable), getHistDesc(kTripletPruning, HistTable), getHistType(kTripletPruning, HistTable), {Specs.at(kTripletPruning)});
     }
   }
 
@@ -601,6 +634,7 @@ class TripletHistManager
       mHistogramRegistry->add(dir + getHistNameV2(kMeMixingWindowRaw, HistTable), getHistDesc(kMeMixingWindowRaw, HistTable), getHistType(kMeMixingWindowRaw, HistTable), {Specs.at(kMeMixingWindowRaw)});
       mHistogramRegistry->add(dir + getHistNameV2(kMeMixingWindowEffective, HistTable), getHistDesc(kMeMixingWindowEffective, HistTable), getHistType(kMeMixingWindowEffective, HistTable), {Specs.at(kMeMixingWindowEffective)});
       mHistogramRegistry->add(dir + getHistNameV2(kMeNpart1VsNpart2VsNpart3, HistTable), getHistDesc(kMeNpart1VsNpart2VsNpart3, HistTable), getHistType(kMeNpart1VsNpart2VsNpart3, HistTable), {Specs.at(kMeNpart1VsNpart2VsNpart3)});
+      mHistogramRegistry->add(dir + getHistNameV2(kTripletPruning, HistTable), getHistDesc(kTripletPruning, HistTable), getHistType(kTripletPruning, HistTable), {Specs.at(kTripletPruning)});
     }
     if (mEventMixingQa) {
       mHistogramRegistry->add(dir + getHistNameV2(kMeVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3, HistTable), getHistDesc(kMeVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3, HistTable), getHistType(kMeVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3, HistTable), {Specs.at(kMeVtz1VsMult1VsCent1VsVtz2VsMult2VsCent2VsVtz3VsMult3VsCent3)});
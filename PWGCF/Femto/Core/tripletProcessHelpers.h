@@ -22,8 +22,15 @@
 #include <Framework/ASoAHelpers.h>
 #include <Framework/Logger.h>
 
+#include <Math/Vector4D.h> // IWYU pragma: keep (do not replace with Math/Vector4Dfwd.h)
+#include <Math/Vector4Dfwd.h>
+
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
 namespace o2::analysis::femto::tripletprocesshelpers
 {
@@ -34,6 +41,197 @@ enum TripletOrder : uint8_t {
   kOrder321, // reverse: swap 1&3
 };
 
+// Q3^2 = -(q12^2 + q23^2 + q31^2) is a sum of three non-negative pair terms, so a pair whose term alone exceeds the squared Q3 limit
+// cannot be part of any triplet passing the triplet cuts. Such pairs are dropped before a third particle is considered and the
+// remaining triplets are visited in the same order as with the corresponding soa::combinations policy.
+// Pruning is only enabled if the close triplet rejection does not need to see triplets above the Q3 limit either.
+
+// relative margin on the squared bound, covers the rounding of Q3 to float in the triplet hist manager
+constexpr double Q3PruningMargin = 1e-5;
+
+// indices (ascending) of the partners of each particle whose pair term stays below the bound
+using PairAdjacency = std::vector<std::vector<int>>;
+
+struct TripletCounts {
+  uint64_t evaluated = 0;
+  uint64_t pruned = 0;
+};
+
+// squared Q3 bound used to prune pairs, negative if all triplets have to be evaluated
+template <typename T1, typename T2>
+double getQ3PruningBound(T1 const& TripletHistManager, T2 const& CtrManager)
+{
+  const float q3Max = TripletHistManager.getQ3Max();
+  const float ctrKinematicMax = CtrManager.getRequiredKinematicMax();
+  if (!(q3Max > 0.f) || ctrKinematicMax < 0.f) {
+    return -1.;
+  }
+  const double bound = std::max(q3Max, ctrKinematicMax);
+  return bound * bound * (1. + Q3PruningMargin);
+}
+
+// copy the rows of a slice so they can be accessed by index
+template <typename T>
+auto collectParticles(T const& Slice)
+{
+  std::vector<std::decay_t<decltype(Slice.begin())>> particles;
+  particles.reserve(Slice.size());
+  for (auto const& particle : Slice) {
+    particles.push_back(particle);
+  }
+  return particles;
+}
+
+// positions select mass and charge of the particles, particles of the same species always share them
+template <int positionA, int positionB, typename T1, typename T2, typename T3>
+void buildPairAdjacency(PairAdjacency& adjacency,
+                        T1 const& ParticlesA,
+                        T2 const& ParticlesB,
+                        T3 const& TripletHistManager,
+                        double boundSquared,
+                        bool upperOnly)
+{
+  std::vector<ROOT::Math::PxPyPzEVector> vectorsB;
+  vectorsB.reserve(ParticlesB.size());
+  for (auto const& particle : ParticlesB) {
+    vectorsB.push_back(TripletHistManager.template getFourVector<positionB>(particle));
+  }
+  adjacency.resize(ParticlesA.size());
+  for (std::size_t a = 0; a < ParticlesA.size(); a++) {
+    auto& partners = adjacency[a];
+    partners.clear();
+    const auto vectorA = TripletHistManager.template getFourVector<positionA>(ParticlesA[a]);
+    for (std::size_t b = upperOnly ? a + 1 : 0; b < vectorsB.size(); b++) {
+      // keep pairs where the term cannot be computed, they are decided by the full Q3
+      if (!(TripletHistManager.getPairQ3Term(vectorA, vectorsB[b]) > boundSquared)) {
+        partners.push_back(static_cast<int>(b));
+      }
+    }
+  }
+}
+
+// call visit for every index contained in both sorted ranges
+template <typename T>
+void forEachCommonIndex(std::vector<int>::const_iterator first1,
+                        std::vector<int>::const_iterator last1,
+                        std::vector<int>::const_iterator first2,
+                        std::vector<int>::const_iterator last2,
+                        T&& visit)
+{
+  while (first1 != last1 && first2 != last2) {
+    if (*first1 < *first2) {
+      ++first1;
+    } else if (*first2 < *first1) {
+      ++first2;
+    } else {
+      visit(*first1);
+      ++first1;
+      ++first2;
+    }
+  }
+}
+
+// visit i < j < k of one particle list, adjacency is built with upperOnly
+template <typename T>
+TripletCounts forEachIdenticalTriplet(int n, PairAdjacency const& adjacency, bool prune, T&& visit)
+{
+  TripletCounts counts;
+  const uint64_t nTotal = n > 2 ? static_cast<uint64_t>(n) * (n - 1) * (n - 2) / 6 : 0;
+  if (!prune) {
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        for (int k = j + 1; k < n; k++) {
+          visit(i, j, k);
+        }
+      }
+    }
+    counts.evaluated = nTotal;
+    return counts;
+  }
+  for (int i = 0; i < n; i++) {
+    auto const& partnersI = adjacency[i];
+    for (auto it = partnersI.cbegin(); it != partnersI.cend(); ++it) {
+      const int j = *it;
+      auto const& partnersJ = adjacency[j];
+      forEachCommonIndex(it + 1, partnersI.cend(), partnersJ.cbegin(), partnersJ.cend(), [&](int k) {
+        visit(i, j, k);
+        ++counts.evaluated;
+      });
+    }
+  }
+  counts.pruned = nTotal - counts.evaluated;
+  return counts;
+}
+
+// visit i < j of the first list for every k of the second list, k being the outer loop
+// adjacency11 is built with upperOnly, adjacency31 maps particles of the second list to partners in the first
+template <typename T>
+TripletCounts forEachTripletOfTwoIdentical(int n1, int n3, PairAdjacency const& adjacency11, PairAdjacency const& adjacency31, bool prune, T&& visit)
+{
+  TripletCounts counts;
+  const uint64_t nTotal = n1 > 1 ? static_cast<uint64_t>(n3) * n1 * (n1 - 1) / 2 : 0;
+  if (!prune) {
+    for (int k = 0; k < n3; k++) {
+      for (int i = 0; i < n1; i++) {
+        for (int j = i + 1; j < n1; j++) {
+          visit(i, j, k);
+        }
+      }
+    }
+    counts.evaluated = nTotal;
+    return counts;
+  }
+  for (int k = 0; k < n3; k++) {
+    auto const& partnersK = adjacency31[k];
+    for (auto it = partnersK.cbegin(); it != partnersK.cend(); ++it) {
+      const int i = *it;
+      auto const& partnersI = adjacency11[i];
+      forEachCommonIndex(it + 1, partnersK.cend(), partnersI.cbegin(), partnersI.cend(), [&](int j) {
+        visit(i, j, k);
+        ++counts.evaluated;
+      });
+    }
+  }
+  counts.pruned = nTotal - counts.evaluated;
+  return counts;
+}
+
+// visit all i, j, k of three particle lists
+template <typename T>
+TripletCounts forEachTripletOfDifferent(int n1, int n2, int n3,
+                                        PairAdjacency const& adjacency12,
+                                        PairAdjacency const& adjacency13,
+                                        PairAdjacency const& adjacency23,
+                                        bool prune,
+                                        T&& visit)
+{
+  TripletCounts counts;
+  const uint64_t nTotal = static_cast<uint64_t>(n1) * n2 * n3;
+  if (!prune) {
+    for (int i = 0; i < n1; i++) {
+      for (int j = 0; j < n2; j++) {
+        for (int k = 0; k < n3; k++) {
+          visit(i, j, k);
+        }
+      }
+    }
+    counts.evaluated = nTotal;
+    return counts;
+  }
+  for (int i = 0; i < n1; i++) {
+    auto const& partnersI = adjacency13[i];
+    for (const int j : adjacency12[i]) {
+      auto const& partnersJ = adjacency23[j];
+      forEachCommonIndex(partnersI.cbegin(), partnersI.cend(), partnersJ.cbegin(), partnersJ.cend(), [&](int k) {
+        visit(i, j, k);
+        ++counts.evaluated;
+      });
+    }
+  }
+  counts.pruned = nTotal - counts.evaluated;
+  return counts;
+}
+
 // process same event for identical 3 particles
 template <modes::Mode mode,
           typename T1,
@@ -58,17 +256,29 @@ void processSameEvent(T1 const& SliceParticle,
     ParticleHistManager.template fill<mode>(part, TrackTable);
   }
 
-  for (auto const& [p1, p2, p3] : o2::soa::combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(SliceParticle, SliceParticle, SliceParticle))) {
+  // all three particles are of the same species, so the triplet order does not change the pair terms
+  auto particles = collectParticles(SliceParticle);
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  PairAdjacency adjacency;
+  if (prune) {
+    buildPairAdjacency<1, 2>(adjacency, particles, particles, TripletHistManager, q3BoundSquared, true);
+  }
+
+  auto counts = forEachIdenticalTriplet(static_cast<int>(particles.size()), adjacency, prune, [&](int i, int j, int k) {
+    auto const& p1 = particles[i];
+    auto const& p2 = particles[j];
+    auto const& p3 = particles[k];
 
     // check if triplet is clean
     if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable)) {
-      continue;
+      return;
     }
 
     // check if triplet is close
     CtrManager.setTriplet(p1, p2, p3, TrackTable);
     if (CtrManager.isCloseTriplet()) {
-      continue;
+      return;
     }
 
     // Randomize pair order if enabled
@@ -98,8 +308,9 @@ void processSameEvent(T1 const& SliceParticle,
       TripletHistManager.template fill<mode>();
       TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
     }
-  }
+  });
 
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
   TripletHistManager.fillMixingQaSe();
 }
 
@@ -127,43 +338,56 @@ void processSameEvent(T1 const& SliceParticle1, // 1&2 have same species
     ParticleHistManager3.template fill<mode>(part, TrackTable);
   }
 
-  for (auto const& p3 : SliceParticle3) {
-    for (auto const& [p1, p2] : o2::soa::combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(SliceParticle1, SliceParticle1))) {
+  auto particles1 = collectParticles(SliceParticle1);
+  auto particles3 = collectParticles(SliceParticle3);
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  PairAdjacency adjacency11;
+  PairAdjacency adjacency31;
+  if (prune) {
+    buildPairAdjacency<1, 2>(adjacency11, particles1, particles1, TripletHistManager, q3BoundSquared, true);
+    buildPairAdjacency<3, 1>(adjacency31, particles3, particles1, TripletHistManager, q3BoundSquared, false);
+  }
 
-      // check if triplet is clean
-      if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable)) {
-        continue;
-      }
+  auto counts = forEachTripletOfTwoIdentical(static_cast<int>(particles1.size()), static_cast<int>(particles3.size()), adjacency11, adjacency31, prune, [&](int i, int j, int k) {
+    auto const& p1 = particles1[i];
+    auto const& p2 = particles1[j];
+    auto const& p3 = particles3[k];
 
-      // check if triplet is close
-      CtrManager.setTriplet(p1, p2, p3, TrackTable);
-      if (CtrManager.isCloseTriplet()) {
-        continue;
-      }
+    // check if triplet is clean
+    if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable)) {
+      return;
+    }
 
-      // Randomize triplet order if enabled
-      // only kOrder123 and kOrder213 are meaningful here since particle 1 & 2 are the same species
-      switch (tripletOrder) {
-        case kOrder213:
-          TripletHistManager.setTriplet(p2, p1, p3, Collision);
-          break;
-        case kOrder123:
-        default:
-          TripletHistManager.setTriplet(p1, p2, p3, Collision);
-          break;
-      }
+    // check if triplet is close
+    CtrManager.setTriplet(p1, p2, p3, TrackTable);
+    if (CtrManager.isCloseTriplet()) {
+      return;
+    }
 
-      // fill deta-dphi histograms with q3 cutoff
-      CtrManager.fill(TripletHistManager.getQ3());
+    // Randomize triplet order if enabled
+    // only kOrder123 and kOrder213 are meaningful here since particle 1 & 2 are the same species
+    switch (tripletOrder) {
+      case kOrder213:
+        TripletHistManager.setTriplet(p2, p1, p3, Collision);
+        break;
+      case kOrder123:
+      default:
+        TripletHistManager.setTriplet(p1, p2, p3, Collision);
+        break;
+    }
 
-      // if triplet cuts are configured check them before filling
-      if (TripletHistManager.checkTripletCuts()) {
-        TripletHistManager.template fill<mode>();
-        TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
-      }
+    // fill deta-dphi histograms with q3 cutoff
+    CtrManager.fill(TripletHistManager.getQ3());
+
+    // if triplet cuts are configured check them before filling
+    if (TripletHistManager.checkTripletCuts()) {
+      TripletHistManager.template fill<mode>();
+      TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
     }
-  }
+  });
 
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
   TripletHistManager.fillMixingQaSe();
 }
 
@@ -204,17 +428,34 @@ void processSameEvent(T1 const& SliceParticle1,
     ParticleHistManager3.template fill<mode>(part, TrackTable);
   }
 
-  for (auto const& [p1, p2, p3] : o2::soa::combinations(o2::soa::CombinationsFullIndexPolicy(SliceParticle1, SliceParticle2, SliceParticle3))) {
+  auto particles1 = collectParticles(SliceParticle1);
+  auto particles2 = collectParticles(SliceParticle2);
+  auto particles3 = collectParticles(SliceParticle3);
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  PairAdjacency adjacency12;
+  PairAdjacency adjacency13;
+  PairAdjacency adjacency23;
+  if (prune) {
+    buildPairAdjacency<1, 2>(adjacency12, particles1, particles2, TripletHistManager, q3BoundSquared, false);
+    buildPairAdjacency<1, 3>(adjacency13, particles1, particles3, TripletHistManager, q3BoundSquared, false);
+    buildPairAdjacency<2, 3>(adjacency23, particles2, particles3, TripletHistManager, q3BoundSquared, false);
+  }
+
+  auto counts = forEachTripletOfDifferent(static_cast<int>(particles1.size()), static_cast<int>(particles2.size()), static_cast<int>(particles3.size()), adjacency12, adjacency13, adjacency23, prune, [&](int i, int j, int k) {
+    auto const& p1 = particles1[i];
+    auto const& p2 = particles2[j];
+    auto const& p3 = particles3[k];
 
     // check if triplet is clean
     if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable)) {
-      continue;
+      return;
     }
 
     // check if triplet is close
     CtrManager.setTriplet(p1, p2, p3, TrackTable);
     if (CtrManager.isCloseTriplet()) {
-      continue;
+      return;
     }
 
     TripletHistManager.setTriplet(p1, p2, p3, Collision);
@@ -227,8 +468,9 @@ void processSameEvent(T1 const& SliceParticle1,
       TripletHistManager.template fill<mode>();
       TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
     }
-  }
+  });
 
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
   TripletHistManager.fillMixingQaSe();
 }
 
@@ -269,21 +511,32 @@ void processSameEvent(T1 const& SliceParticle,
     ParticleHistManager.template fill<mode>(part, TrackTable, Collision, mcParticles, mcMothers, mcPartonicMothers);
   }
 
-  for (auto const& [p1, p2, p3] : o2::soa::combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(SliceParticle, SliceParticle, SliceParticle))) {
+  auto particles = collectParticles(SliceParticle);
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  PairAdjacency adjacency;
+  if (prune) {
+    buildPairAdjacency<1, 2>(adjacency, particles, particles, TripletHistManager, q3BoundSquared, true);
+  }
+
+  auto counts = forEachIdenticalTriplet(static_cast<int>(particles.size()), adjacency, prune, [&](int i, int j, int k) {
+    auto const& p1 = particles[i];
+    auto const& p2 = particles[j];
+    auto const& p3 = particles[k];
     // check if all three particles are clean
     if (!Cleaner.isClean(p1, mcParticles, mcMothers, mcPartonicMothers) ||
         !Cleaner.isClean(p2, mcParticles, mcMothers, mcPartonicMothers) ||
         !Cleaner.isClean(p3, mcParticles, mcMothers, mcPartonicMothers)) {
-      continue;
+      return;
     }
     // check if triplet is clean
     if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable, mcParticles, mcPartonicMothers)) {
-      continue;
+      return;
     }
     // check if triplet is close
     CtrManager.setTriplet(p1, p2, p3, TrackTable);
     if (CtrManager.isCloseTriplet()) {
-      continue;
+      return;
     }
     // Randomize triplet order if enabled
     switch (tripletOrder) {
@@ -310,8 +563,9 @@ void processSameEvent(T1 const& SliceParticle,
       TripletHistManager.template fill<mode>();
       TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
     }
-  }
+  });
 
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
   TripletHistManager.fillMixingQaSe();
 }
 
@@ -351,44 +605,57 @@ void processSameEvent(T1 const& SliceParticle1,
     ParticleHistManager3.template fill<mode>(part, TrackTable, Collision, mcParticles, mcMothers, mcPartonicMothers);
   }
 
-  for (auto const& p3 : SliceParticle3) {
-    for (auto const& [p1, p2] : o2::soa::combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(SliceParticle1, SliceParticle1))) {
-      // check if all three particles are clean
-      if (!Cleaner1.isClean(p1, mcParticles, mcMothers, mcPartonicMothers) ||
-          !Cleaner1.isClean(p2, mcParticles, mcMothers, mcPartonicMothers) ||
-          !Cleaner3.isClean(p3, mcParticles, mcMothers, mcPartonicMothers)) {
-        continue;
-      }
-      // check if triplet is clean
-      if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable, mcParticles, mcPartonicMothers)) {
-        continue;
-      }
-      // check if triplet is close
-      CtrManager.setTriplet(p1, p2, p3, TrackTable);
-      if (CtrManager.isCloseTriplet()) {
-        continue;
-      }
-      // Randomize triplet order if enabled
-      // only kOrder123 and kOrder213 are meaningful here since particle 1 & 2 are the same species
-      switch (tripletOrder) {
-        case kOrder213:
-          TripletHistManager.setTripletMc(p2, p1, p3, mcParticles, Collision, mcCollisions);
-          break;
-        case kOrder123:
-        default:
-          TripletHistManager.setTripletMc(p1, p2, p3, mcParticles, Collision, mcCollisions);
-          break;
-      }
-      // fill deta-dphi histograms with q3 cutoff
-      CtrManager.fill(TripletHistManager.getQ3());
-      // if triplet cuts are configured check them before filling
-      if (TripletHistManager.checkTripletCuts()) {
-        TripletHistManager.template fill<mode>();
-        TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
-      }
-    }
+  auto particles1 = collectParticles(SliceParticle1);
+  auto particles3 = collectParticles(SliceParticle3);
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  PairAdjacency adjacency11;
+  PairAdjacency adjacency31;
+  if (prune) {
+    buildPairAdjacency<1, 2>(adjacency11, particles1, particles1, TripletHistManager, q3BoundSquared, true);
+    buildPairAdjacency<3, 1>(adjacency31, particles3, particles1, TripletHistManager, q3BoundSquared, false);
   }
 
+  auto counts = forEachTripletOfTwoIdentical(static_cast<int>(particles1.size()), static_cast<int>(particles3.size()), adjacency11, adjacency31, prune, [&](int i, int j, int k) {
+    auto const& p1 = particles1[i];
+    auto const& p2 = particles1[j];
+    auto const& p3 = particles3[k];
+    // check if all three particles are clean
+    if (!Cleaner1.isClean(p1, mcParticles, mcMothers, mcPartonicMothers) ||
+        !Cleaner1.isClean(p2, mcParticles, mcMothers, mcPartonicMothers) ||
+        !Cleaner3.isClean(p3, mcParticles, mcMothers, mcPartonicMothers)) {
+      return;
+    }
+    // check if triplet is clean
+    if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable, mcParticles, mcPartonicMothers)) {
+      return;
+    }
+    // check if triplet is close
+    CtrManager.setTriplet(p1, p2, p3, TrackTable);
+    if (CtrManager.isCloseTriplet()) {
+      return;
+    }
+    // Randomize triplet order if enabled
+    // only kOrder123 and kOrder213 are meaningful here since particle 1 & 2 are the same species
+    switch (tripletOrder) {
+      case kOrder213:
+        TripletHistManager.setTripletMc(p2, p1, p3, mcParticles, Collision, mcCollisions);
+        break;
+      case kOrder123:
+      default:
+        TripletHistManager.setTripletMc(p1, p2, p3, mcParticles, Collision, mcCollisions);
+        break;
+    }
+    // fill deta-dphi histograms with q3 cutoff
+    CtrManager.fill(TripletHistManager.getQ3());
+    // if triplet cuts are configured check them before filling
+    if (TripletHistManager.checkTripletCuts()) {
+      TripletHistManager.template fill<mode>();
+      TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
+    }
+  });
+
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
   TripletHistManager.fillMixingQaSe();
 }
 
@@ -453,21 +720,38 @@ void processSameEvent(T1 const& SliceParticle1,
     ParticleHistManager3.template fill<mode>(part, TrackTable, Collision, mcParticles, mcMothers, mcPartonicMothers);
   }
 
-  for (auto const& [p1, p2, p3] : o2::soa::combinations(o2::soa::CombinationsFullIndexPolicy(SliceParticle1, SliceParticle2, SliceParticle3))) {
+  auto particles1 = collectParticles(SliceParticle1);
+  auto particles2 = collectParticles(SliceParticle2);
+  auto particles3 = collectParticles(SliceParticle3);
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  PairAdjacency adjacency12;
+  PairAdjacency adjacency13;
+  PairAdjacency adjacency23;
+  if (prune) {
+    buildPairAdjacency<1, 2>(adjacency12, particles1, particles2, TripletHistManager, q3BoundSquared, false);
+    buildPairAdjacency<1, 3>(adjacency13, particles1, particles3, TripletHistManager, q3BoundSquared, false);
+    buildPairAdjacency<2, 3>(adjacency23, particles2, particles3, TripletHistManager, q3BoundSquared, false);
+  }
+
+  auto counts = forEachTripletOfDifferent(static_cast<int>(particles1.size()), static_cast<int>(particles2.size()), static_cast<int>(particles3.size()), adjacency12, adjacency13, adjacency23, prune, [&](int i, int j, int k) {
+    auto const& p1 = particles1[i];
+    auto const& p2 = particles2[j];
+    auto const& p3 = particles3[k];
     // check if all three particles are clean
     if (!Cleaner1.isClean(p1, mcParticles, mcMothers, mcPartonicMothers) ||
         !Cleaner2.isClean(p2, mcParticles, mcMothers, mcPartonicMothers) ||
         !Cleaner3.isClean(p3, mcParticles, mcMothers, mcPartonicMothers)) {
-      continue;
+      return;
     }
     // check if triplet is clean
     if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable, mcParticles, mcPartonicMothers)) {
-      continue;
+      return;
     }
     // check if triplet is close
     CtrManager.setTriplet(p1, p2, p3, TrackTable);
     if (CtrManager.isCloseTriplet()) {
-      continue;
+      return;
     }
     TripletHistManager.setTripletMc(p1, p2, p3, mcParticles, Collision, mcCollisions);
     // fill deta-dphi histograms with q3 cutoff
@@ -477,8 +761,9 @@ void processSameEvent(T1 const& SliceParticle1,
       TripletHistManager.template fill<mode>();
       TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
     }
-  }
+  });
 
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
   TripletHistManager.fillMixingQaSe();
 }
 
@@ -518,6 +803,16 @@ void processMixedEvent(T1 const& Collisions,
   std::optional<decltype(Partition1->sliceByCached(o2::aod::femtobase::stored::fColId, 0, cache))> sliceParticle1;
   std::optional<decltype(Partition2->sliceByCached(o2::aod::femtobase::stored::fColId, 0, cache))> sliceParticle2;
 
+  // the pair bounds between particle 1 and 2 only change together with the sub-window and are reused for every collision3
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  decltype(collectParticles(*sliceParticle1)) particles1;
+  decltype(collectParticles(*sliceParticle2)) particles2;
+  PairAdjacency adjacency12;
+  PairAdjacency adjacency13;
+  PairAdjacency adjacency23;
+  TripletCounts counts;
+
   for (auto const& [collision1, collision2, collision3] : o2::soa::selfCombinations(policy, depth, -1, Collisions, Collisions, Collisions)) {
 
     // outer window
@@ -530,12 +825,17 @@ void processMixedEvent(T1 const& Collisions,
       lastCollisionIndex1 = collision1.globalIndex();
       lastCollisionIndex2 = -1; // force sliceParticle2 to refresh below
       sliceParticle1.emplace(Partition1->sliceByCached(o2::aod::femtobase::stored::fColId, collision1.globalIndex(), cache));
+      particles1 = collectParticles(*sliceParticle1);
     }
 
     // inner sub-window
     if (collision2.globalIndex() != lastCollisionIndex2) {
       lastCollisionIndex2 = collision2.globalIndex();
       sliceParticle2.emplace(Partition2->sliceByCached(o2::aod::femtobase::stored::fColId, collision2.globalIndex(), cache));
+      particles2 = collectParticles(*sliceParticle2);
+      if (prune) {
+        buildPairAdjacency<1, 2>(adjacency12, particles1, particles2, TripletHistManager, q3BoundSquared, false);
+      }
     }
 
     ++windowSizeRaw;
@@ -561,15 +861,24 @@ void processMixedEvent(T1 const& Collisions,
     bool hasValidTriplet = false;
     TripletHistManager.fillMixingQaMe(collision1, collision2, collision3);
 
-    for (auto const& [p1, p2, p3] : o2::soa::combinations(o2::soa::CombinationsFullIndexPolicy(*sliceParticle1, *sliceParticle2, sliceParticle3))) {
+    auto particles3 = collectParticles(sliceParticle3);
+    if (prune) {
+      buildPairAdjacency<1, 3>(adjacency13, particles1, particles3, TripletHistManager, q3BoundSquared, false);
+      buildPairAdjacency<2, 3>(adjacency23, particles2, particles3, TripletHistManager, q3BoundSquared, false);
+    }
+
+    auto countsEvent = forEachTripletOfDifferent(static_cast<int>(particles1.size()), static_cast<int>(particles2.size()), static_cast<int>(particles3.size()), adjacency12, adjacency13, adjacency23, prune, [&](int i, int j, int k) {
+      auto const& p1 = particles1[i];
+      auto const& p2 = particles2[j];
+      auto const& p3 = particles3[k];
       // pair cleaning
       if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable)) {
-        continue;
+        return;
       }
       // Close pair rejection
       CtrManager.setTriplet(p1, p2, p3, TrackTable);
       if (CtrManager.isCloseTriplet()) {
-        continue;
+        return;
       }
 
       TripletHistManager.setTriplet(p1, p2, p3, collision1, collision2, collision3);
@@ -580,7 +889,9 @@ void processMixedEvent(T1 const& Collisions,
         TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
         TripletHistManager.template fill<mode>();
       }
-    }
+    });
+    counts.evaluated += countsEvent.evaluated;
+    counts.pruned += countsEvent.pruned;
 
     if (hasValidTriplet) {
       ++windowSizeEffective;
@@ -593,6 +904,7 @@ void processMixedEvent(T1 const& Collisions,
   if (windowSizeRaw > 0) {
     TripletHistManager.fillMixingQaMePerMixingBin(windowSizeRaw, windowSizeEffective);
   }
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
 }
 
 // process mixed event in mc
@@ -646,6 +958,16 @@ void processMixedEvent(T1 const& Collisions,
   std::optional<decltype(Partition1->sliceByCached(o2::aod::femtobase::stored::fColId, 0, cache))> sliceParticle1;
   std::optional<decltype(Partition2->sliceByCached(o2::aod::femtobase::stored::fColId, 0, cache))> sliceParticle2;
 
+  // the pair bounds between particle 1 and 2 only change together with the sub-window and are reused for every collision3
+  const double q3BoundSquared = getQ3PruningBound(TripletHistManager, CtrManager);
+  const bool prune = q3BoundSquared >= 0.;
+  decltype(collectParticles(*sliceParticle1)) particles1;
+  decltype(collectParticles(*sliceParticle2)) particles2;
+  PairAdjacency adjacency12;
+  PairAdjacency adjacency13;
+  PairAdjacency adjacency23;
+  TripletCounts counts;
+
   for (auto const& [collision1, collision2, collision3] : o2::soa::selfCombinations(policy, depth, -1, Collisions, Collisions, Collisions)) {
 
     // outer window
@@ -658,12 +980,17 @@ void processMixedEvent(T1 const& Collisions,
       lastCollisionIndex1 = collision1.globalIndex();
       lastCollisionIndex2 = -1; // force sliceParticle2 to refresh below
       sliceParticle1.emplace(Partition1->sliceByCached(o2::aod::femtobase::stored::fColId, collision1.globalIndex(), cache));
+      particles1 = collectParticles(*sliceParticle1);
     }
 
     // inner sub-window
     if (collision2.globalIndex() != lastCollisionIndex2) {
       lastCollisionIndex2 = collision2.globalIndex();
       sliceParticle2.emplace(Partition2->sliceByCached(o2::aod::femtobase::stored::fColId, collision2.globalIndex(), cache));
+      particles2 = collectParticles(*sliceParticle2);
+      if (prune) {
+        buildPairAdjacency<1, 2>(adjacency12, particles1, particles2, TripletHistManager, q3BoundSquared, false);
+      }
     }
 
     ++windowSizeRaw;
@@ -689,21 +1016,30 @@ void processMixedEvent(T1 const& Collisions,
     bool hasValidTriplet = false;
     TripletHistManager.fillMixingQaMe(collision1, collision2, collision3);
 
-    for (auto const& [p1, p2, p3] : o2::soa::combinations(o2::soa::CombinationsFullIndexPolicy(*sliceParticle1, *sliceParticle2, sliceParticle3))) {
+    auto particles3 = collectParticles(sliceParticle3);
+    if (prune) {
+      buildPairAdjacency<1, 3>(adjacency13, particles1, particles3, TripletHistManager, q3BoundSquared, false);
+      buildPairAdjacency<2, 3>(adjacency23, particles2, particles3, TripletHistManager, q3BoundSquared, false);
+    }
+
+    auto countsEvent = forEachTripletOfDifferent(static_cast<int>(particles1.size()), static_cast<int>(particles2.size()), static_cast<int>(particles3.size()), adjacency12, adjacency13, adjacency23, prune, [&](int i, int j, int k) {
+      auto const& p1 = particles1[i];
+      auto const& p2 = particles2[j];
+      auto const& p3 = particles3[k];
       // particle cleaning
       if (!Cleaner1.isClean(p1, mcParticles, mcMothers, mcPartonicMothers) ||
           !Cleaner2.isClean(p2, mcParticles, mcMothers, mcPartonicMothers) ||
           !Cleaner3.isClean(p3, mcParticles, mcMothers, mcPartonicMothers)) {
-        continue;
+        return;
       }
       // pair cleaning
       if (!TcManager.isCleanTriplet(p1, p2, p3, TrackTable, mcParticles, mcPartonicMothers)) {
-        continue;
+        return;
       }
       // Close pair rejection
       CtrManager.setTriplet(p1, p2, p3, TrackTable);
       if (CtrManager.isCloseTriplet()) {
-        continue;
+        return;
       }
 
       TripletHistManager.setTripletMc(p1, p2, p3, mcParticles, collision1, collision2, collision3, mcCollisions);
@@ -714,7 +1050,9 @@ void processMixedEvent(T1 const& Collisions,
         TripletHistManager.trackParticlesPerEvent(p1, p2, p3);
         TripletHistManager.template fill<mode>();
       }
-    }
+    });
+    counts.evaluated += countsEvent.evaluated;
+    counts.pruned += countsEvent.pruned;
 
     if (hasValidTriplet) {
       ++windowSizeEffective;
@@ -727,6 +1065,7 @@ void processMixedEvent(T1 const& Collisions,
   if (windowSizeRaw > 0) {
     TripletHistManager.fillMixingQaMePerMixingBin(windowSizeRaw, windowSizeEffective);
   }
+  TripletHistManager.fillTripletPruningQa(counts.evaluated, counts.pruned);
 }
 
 } // namespace o2::analysis::femto::tripletprocesshelpers
@@ -285,6 +285,7 @@ struct FlowTask {
   // define global variables
   GFW* fGFW = new GFW();
   std::vector<GFW::CorrConfig> corrconfigs;
+  std::vector<std::vector<int>> corrconfigHandles; // FlowContainer handles per corrconfig (one per pT bin if pT-differential)
   GFWCorrConfigs gfwConfigs;
   std::vector<GFW::CorrConfig> corrconfigsPtVn;
   TAxis* fPtAxis;
@@ -652,6 +653,17 @@ struct FlowTask {
         }
       }
     }
+    // resolve the FlowContainer bins of all correlators once
+    for (const auto& corrconf : corrconfigs) {
+      std::vector<int> handles;
+      if (!corrconf.pTDif) {
+        handles.push_back(fFC->GetCorrelatorHandle(corrconf.Head.c_str()));
+      } else {
+        for (auto i = 1; i <= fPtAxis->GetNbins(); i++)
+          handles.push_back(fFC->GetCorrelatorHandle(Form("%s_pt_%i", corrconf.Head.c_str(), i)));
+      }
+      corrconfigHandles.push_back(handles);
+    }
 
     gfwConfigs.SetCorrs(cfgUserPtVnCorrConfig->GetCorrs());
     gfwConfigs.SetHeads(cfgUserPtVnCorrConfig->GetHeads());
@@ -835,8 +847,9 @@ struct FlowTask {
   }
 
   template <DataType dt>
-  void fillFC(const GFW::CorrConfig& corrconf, const double& cent, const double& rndm)
+  void fillFC(const GFW::CorrConfig& corrconf, const std::vector<int>& handles)
   {
+    // correlators are buffered per event and flushed into the FlowContainer by the caller
     double dnx, val;
     dnx = fGFW->Calculate(corrconf, 0, kTRUE).real();
     if (!corrconf.pTDif) {
@@ -844,7 +857,7 @@ struct FlowTask {
         return;
       val = fGFW->Calculate(corrconf, 0, kFALSE).real() / dnx;
       if (std::fabs(val) < 1) {
-        (dt == kGen) ? fFCgen->FillProfile(corrconf.Head.c_str(), cent, val, dnx, rndm) : fFC->FillProfile(corrconf.Head.c_str(), cent, val, dnx, rndm);
+        (dt == kGen) ? fFCgen->FillEventBuffer(handles[0], val, dnx) : fFC->FillEventBuffer(handles[0], val, dnx);
       }
       return;
     }
@@ -854,7 +867,7 @@ struct FlowTask {
         continue;
       val = fGFW->Calculate(corrconf, i - 1, kFALSE).real() / dnx;
       if (std::fabs(val) < 1) {
-        (dt == kGen) ? fFCgen->FillProfile(Form("%s_pt_%i", corrconf.Head.c_str(), i), cent, val, dnx, rndm) : fFC->FillProfile(Form("%s_pt_%i", corrconf.Head.c_str(), i), cent, val, dnx, rndm);
+        (dt == kGen) ? fFCgen->FillEventBuffer(handles[i - 1], val, dnx) : fFC->FillEventBuffer(handles[i - 1], val, dnx);
       }
     }
     return;
@@ -1505,8 +1518,9 @@ struct FlowTask {
 
     // Filling Flow Container
     for (uint l_ind = 0; l_ind < corrconfigs.size(); l_ind++) {
-      fillFC<kReco>(corrconfigs.at(l_ind), independent, lRandom);
+      fillFC<kReco>(corrconfigs.at(l_ind), corrconfigHandles.at(l_ind));
     }
+    fFC->FlushEventBuffer(independent, lRandom);
     // Filling pt Container
     fillPtContainers<kReco>(independent, lRandom);
   }
@@ -1590,8 +1604,9 @@ struct FlowTask {
 
     // Filling Flow Container
     for (uint l_ind = 0; l_ind < corrconfigs.size(); l_ind++) {
-      fillFC<kGen>(corrconfigs.at(l_ind), independent, lRandom);
+      fillFC<kGen>(corrconfigs.at(l_ind), corrconfigHandles.at(l_ind));
     }
+    fFCgen->FlushEventBuffer(independent, lRandom);
     // Filling pt Container
     fillPtContainers<kGen>(independent, lRandom);
   }
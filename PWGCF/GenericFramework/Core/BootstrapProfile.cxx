@@ -15,6 +15,7 @@
 #include <TH1.h>
 #include <TList.h>
 #include <TMath.h>
+#include <TObject.h>
 #include <TProfile.h>
 #include <TString.h>
 
@@ -27,7 +28,10 @@ BootstrapProfile::BootstrapProfile() : TProfile(),
                                        fNSubs(0),
                                        fMultiRebin(0),
                                        fMultiRebinEdges(0),
-                                       fPresetWeights(0) {}
+                                       fPresetWeights(0),
+                                       fEvStats{0., 0., 0., 0.},
+                                       fEvNFills(0),
+                                       fEvHasWeights(kFALSE) {}
 BootstrapProfile::~BootstrapProfile()
 {
   delete fListOfEntries;
@@ -38,14 +42,20 @@ BootstrapProfile::BootstrapProfile(const char* name, const char* title, Int_t nb
                                                                                                                fNSubs(0),
                                                                                                                fMultiRebin(0),
                                                                                                                fMultiRebinEdges(0),
-                                                                                                               fPresetWeights(0) {}
+                                                                                                               fPresetWeights(0),
+                                                                                                               fEvStats{0., 0., 0., 0.},
+                                                                                                               fEvNFills(0),
+                                                                                                               fEvHasWeights(kFALSE) {}
 BootstrapProfile::BootstrapProfile(const char* name, const char* title, Int_t nbinsx, Double_t xlow, Double_t xup) : TProfile(name, title, nbinsx, xlow, xup),
                                                                                                                      fListOfEntries(0),
                                                                                                                      fProfInitialized(kFALSE),
                                                                                                                      fNSubs(0),
                                                                                                                      fMultiRebin(0),
                                                                                                                      fMultiRebinEdges(0),
-                                                                                                                     fPresetWeights(0) {}
+                                                                                                                     fPresetWeights(0),
+                                                                                                                     fEvStats{0., 0., 0., 0.},
+                                                                                                                     fEvNFills(0),
+                                                                                                                     fEvHasWeights(kFALSE) {}
 void BootstrapProfile::InitializeSubsamples(Int_t nSub)
 {
   if (nSub < 1) {
@@ -56,6 +66,7 @@ void BootstrapProfile::InitializeSubsamples(Int_t nSub)
     delete fListOfEntries;
   fListOfEntries = new TList();
   fListOfEntries->SetOwner(kTRUE);
+  fSubProfiles.clear();
   TProfile* dummyPF = reinterpret_cast<TProfile*>(this);
   for (Int_t i = 0; i < nSub; i++) {
     fListOfEntries->Add(reinterpret_cast<TProfile*>(dummyPF->Clone(Form("%s_Subpf%i", dummyPF->GetName(), i))));
@@ -71,12 +82,100 @@ void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const
   Int_t targetInd = rn * fNSubs;
   if (targetInd >= fNSubs)
     targetInd = 0;
-  reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+  getSubProfile(targetInd)->Fill(xv, yv, w);
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w)
 {
   TProfile::Fill(xv, yv, w);
 }
+TProfile* BootstrapProfile::getSubProfile(Int_t ind)
+{
+  // TList::At is a linear walk, keep a flat copy of the subprofile pointers
+  if (static_cast<Int_t>(fSubProfiles.size()) != fListOfEntries->GetEntries()) {
+    fSubProfiles.clear();
+    for (TObject* obj : *fListOfEntries)
+      fSubProfiles.push_back(reinterpret_cast<TProfile*>(obj));
+  }
+  return fSubProfiles[ind];
+}
+void BootstrapProfile::FillEventBuffer(const Double_t& xv, const Double_t& yv, const Double_t& w)
+{
+  Int_t bin = fXaxis.FindBin(xv);
+  if (static_cast<Int_t>(fEvSumW.size()) <= bin) {
+    Int_t nSlots = fXaxis.GetNbins() + 2;
+    fEvSumWY.resize(nSlots, 0.);
+    fEvSumWY2.resize(nSlots, 0.);
+    fEvSumW.resize(nSlots, 0.);
+    fEvSumW2.resize(nSlots, 0.);
+    fEvNFillsPerBin.resize(nSlots, 0);
+  }
+  if (!fEvNFillsPerBin[bin]++)
+    fEvBins.push_back(bin);
+  fEvSumWY[bin] += w * yv;
+  fEvSumWY2[bin] += w * yv * yv;
+  fEvSumW[bin] += w;
+  fEvSumW2[bin] += w * w;
+  fEvNFills++;
+  if (w != 1.)
+    fEvHasWeights = kTRUE;
+  if (bin == 0 || bin > fXaxis.GetNbins())
+    return;
+  fEvStats[0] += w;
+  fEvStats[1] += w * w;
+  fEvStats[2] += w * xv;
+  fEvStats[3] += w * xv * xv;
+}
+void BootstrapProfile::FlushEventBuffer(const Double_t& rn)
+{
+  if (!fEvNFills)
+    return;
+  addEventBuffer(reinterpret_cast<TProfile*>(this));
+  if (fNSubs) {
+    Int_t targetInd = rn * fNSubs;
+    if (targetInd >= fNSubs)
+      targetInd = 0;
+    addEventBuffer(getSubProfile(targetInd));
+  }
+  for (const auto& bin : fEvBins) {
+    fEvSumWY[bin] = 0.;
+    fEvSumWY2[bin] = 0.;
+    fEvSumW[bin] = 0.;
+    fEvSumW2[bin] = 0.;
+    fEvNFillsPerBin[bin] = 0;
+  }
+  fEvBins.clear();
+  for (auto& stat : fEvStats)
+    stat = 0.;
+  fEvNFills = 0;
+  fEvHasWeights = kFALSE;
+}
+void BootstrapProfile::addEventBuffer(TProfile* tpf)
+{
+  // Same bookkeeping as one TProfile::Fill(x, y, w) per buffered entry, with the sums pre-accumulated.
+  // Like TProfile::Fill, switch on the bin sums of w^2 at the first weight != 1
+  if (fEvHasWeights && !tpf->GetBinSumw2()->GetSize() && !tpf->TestBit(TH1::kIsNotW))
+    tpf->Sumw2();
+  Double_t stats[6];
+  tpf->GetStats(stats);
+  Double_t* sumWY = tpf->GetArray();
+  Double_t* sumWY2 = tpf->GetSumw2()->GetArray();
+  for (const auto& bin : fEvBins) {
+    sumWY[bin] += fEvSumWY[bin];
+    if (sumWY2)
+      sumWY2[bin] += fEvSumWY2[bin];
+    if (tpf->GetBinSumw2()->GetSize())
+      tpf->GetBinSumw2()->GetArray()[bin] += fEvSumW2[bin];
+    tpf->SetBinEntries(bin, tpf->GetBinEntries(bin) + fEvSumW[bin]);
+    if (bin == 0 || bin > tpf->GetNbinsX())
+      continue;
+    stats[4] += fEvSumWY[bin];
+    stats[5] += fEvSumWY2[bin];
+  }
+  for (Int_t i = 0; i < 4; i++)
+    stats[i] += fEvStats[i];
+  tpf->PutStats(stats);
+  tpf->SetEntries(tpf->GetEntries() + fEvNFills);
+}
 void BootstrapProfile::RebinMulti(Int_t nbins)
 {
   this->RebinX(nbins);
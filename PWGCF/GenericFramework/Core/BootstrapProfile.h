@@ -24,6 +24,8 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <vector>
+
 class BootstrapProfile : public TProfile
 {
  public:
@@ -36,6 +38,9 @@ class BootstrapProfile : public TProfile
   void InitializeSubsamples(Int_t nSub);
   void FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn);
   void FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w);
+  // Per-event buffered filling: accumulate the fills of an event, then flush them into the main and subsample profiles in one go
+  void FillEventBuffer(const Double_t& xv, const Double_t& yv, const Double_t& w);
+  void FlushEventBuffer(const Double_t& rn);
   Long64_t Merge(TCollection* collist);
   void RebinMulti(Int_t nbins);
   void RebinMulti(Int_t nbins, Double_t* binedges);
@@ -61,6 +66,18 @@ class BootstrapProfile : public TProfile
   Int_t fMultiRebin;                //! externaly set runtime, no need to store
   Double_t* fMultiRebinEdges;       //! externaly set runtime, no need to store
   BootstrapProfile* fPresetWeights; //! BootstrapProfile whose weights we should copy
+  std::vector<TProfile*> fSubProfiles; //! cached pointers to the entries of fListOfEntries
+  std::vector<Double_t> fEvSumWY;      //! per-event buffer, sum of w*y per bin
+  std::vector<Double_t> fEvSumWY2;     //! per-event buffer, sum of w*y^2 per bin
+  std::vector<Double_t> fEvSumW;       //! per-event buffer, sum of w per bin
+  std::vector<Double_t> fEvSumW2;      //! per-event buffer, sum of w^2 per bin
+  std::vector<Int_t> fEvNFillsPerBin;  //! per-event buffer, number of fills per bin
+  std::vector<Int_t> fEvBins;          //! bins filled in the current event
+  Double_t fEvStats[4];                //! per-event buffer, in-range sum of w, w^2, w*x, w*x^2
+  Long64_t fEvNFills;                  //! per-event buffer, total number of fills
+  Bool_t fEvHasWeights;                //! per-event buffer, some entry was filled with w != 1
+  TProfile* getSubProfile(Int_t ind);
+  void addEventBuffer(TProfile* tpf);
   void ResetBin(TProfile* tpf, Int_t nbin)
   {
     tpf->SetBinEntries(nbin, 0);
@@ -156,6 +156,15 @@ void FlowContainer::SetXAxis()
   }
 }
 int FlowContainer::FillProfile(const char* hname, double multi, double corr, double w, double rn)
+{
+  if (!fProf)
+    return -1;
+  int yin = GetCorrelatorHandle(hname);
+  if (yin < 0)
+    return -1;
+  return FillProfile(yin, multi, corr, w, rn);
+};
+int FlowContainer::GetCorrelatorHandle(const char* hname)
 {
   if (!fProf)
     return -1;
@@ -164,13 +173,91 @@ int FlowContainer::FillProfile(const char* hname, double multi, double corr, dou
     printf("Could not find bin %s\n", hname);
     return -1;
   }
-  fProf->Fill(multi, yin, corr, w);
+  return yin;
+};
+int FlowContainer::FillProfile(int handle, double multi, double corr, double w, double rn)
+{
+  if (!fProf || handle < 1)
+    return -1;
+  fProf->Fill(multi, handle, corr, w);
   if (fNRandom) {
     double rnind = rn * fNRandom;
-    dynamic_cast<TProfile2D*>(fProfRand->At(static_cast<int>(rnind)))->Fill(multi, yin, corr, w);
+    static_cast<TProfile2D*>(fProfRand->At(static_cast<int>(rnind)))->Fill(multi, handle, corr, w);
   }
   return 0;
 };
+void FlowContainer::FillEventBuffer(int handle, double corr, double w)
+{
+  if (!fProf || handle < 1)
+    return;
+  if (static_cast<int>(fEvSumW.size()) <= handle) {
+    int nSlots = fProf->GetNbinsY() + 1;
+    fEvSumWY.resize(nSlots, 0.);
+    fEvSumWY2.resize(nSlots, 0.);
+    fEvSumW.resize(nSlots, 0.);
+    fEvSumW2.resize(nSlots, 0.);
+    fEvNFills.resize(nSlots, 0);
+  }
+  if (!fEvNFills[handle])
+    fEvHandles.push_back(handle);
+  fEvSumWY[handle] += w * corr;
+  fEvSumWY2[handle] += w * corr * corr;
+  fEvSumW[handle] += w;
+  fEvSumW2[handle] += w * w;
+  fEvNFills[handle]++;
+};
+void FlowContainer::FlushEventBuffer(double multi, double rn)
+{
+  if (!fProf || fEvHandles.empty())
+    return;
+  int binx = fProf->GetXaxis()->FindBin(multi);
+  AddEventBuffer(fProf, binx, multi);
+  if (fNRandom) {
+    double rnind = rn * fNRandom;
+    AddEventBuffer(static_cast<TProfile2D*>(fProfRand->At(static_cast<int>(rnind))), binx, multi);
+  }
+  for (const auto& handle : fEvHandles) {
+    fEvSumWY[handle] = 0.;
+    fEvSumWY2[handle] = 0.;
+    fEvSumW[handle] = 0.;
+    fEvSumW2[handle] = 0.;
+    fEvNFills[handle] = 0;
+  }
+  fEvHandles.clear();
+};
+void FlowContainer::AddEventBuffer(TProfile2D* prof, int binx, double multi)
+{
+  // Same bookkeeping as one TProfile2D::Fill(multi, handle, y, w) per buffered entry, with the sums pre-accumulated
+  double stats[9];
+  prof->GetStats(stats);
+  bool inRange = (binx > 0 && binx <= prof->GetNbinsX());
+  double* sumWY = prof->GetArray();
+  double* sumWY2 = prof->GetSumw2()->GetArray();
+  Long64_t nFills = 0;
+  for (const auto& handle : fEvHandles) {
+    int bin = prof->GetBin(binx, handle);
+    sumWY[bin] += fEvSumWY[handle];
+    if (sumWY2)
+      sumWY2[bin] += fEvSumWY2[handle];
+    if (prof->GetBinSumw2()->GetSize())
+      prof->GetBinSumw2()->GetArray()[bin] += fEvSumW2[handle];
+    prof->SetBinEntries(bin, prof->GetBinEntries(bin) + fEvSumW[handle]);
+    nFills += fEvNFills[handle];
+    if (!inRange)
+      continue;
+    stats[0] += fEvSumW[handle];
+    stats[1] += fEvSumW2[handle];
+    stats[2] += fEvSumW[handle] * multi;
+    stats[3] += fEvSumW[handle] * multi * multi;
+    stats[4] += fEvSumW[handle] * handle;
+    stats[5] += fEvSumW[handle] * handle * handle;
+    stats[6] += fEvSumW[handle] * multi * handle;
+    stats[7] += fEvSumWY[handle];
+    stats[8] += fEvSumWY2[handle];
+  }
+  prof->PutStats(stats);
+  prof->SetEntries(prof->GetEntries() + nFills);
+};
 void FlowContainer::OverrideProfileErrors(TProfile2D* inpf)
 {
   int nBinsX = fProf->GetNbinsX();
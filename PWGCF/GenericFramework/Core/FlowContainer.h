@@ -31,6 +31,8 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <vector>
+
 class FlowContainer : public TNamed
 {
  public:
@@ -53,6 +55,12 @@ class FlowContainer : public TNamed
   int GetNMultiBins() { return fProf->GetNbinsX(); }
   double GetMultiAtBin(int bin) { return fProf->GetXaxis()->GetBinCenter(bin); }
   int FillProfile(const char* hname, double multi, double y, double w, double rn);
+  // Handle-based filling: resolve the correlator name once (e.g. in init) and fill by handle
+  int GetCorrelatorHandle(const char* hname);
+  int FillProfile(int handle, double multi, double y, double w, double rn);
+  // Per-event buffered filling: accumulate all correlators of an event, then flush them in one go
+  void FillEventBuffer(int handle, double y, double w);
+  void FlushEventBuffer(double multi, double rn);
   TProfile2D* GetProfile() { return fProf; }
   void OverrideProfileErrors(TProfile2D* inpf);
   void ReadAndMerge(const char* infile);
@@ -165,6 +173,13 @@ class FlowContainer : public TNamed
   double* fbinsPt;       //! Do not store; stored in fXAxis
   bool fPropagateErrors; //! do not store
   TProfile* GetRefFlowProfile(const char* order, double m1 = -1, double m2 = -1);
+  void AddEventBuffer(TProfile2D* prof, int binx, double multi);
+  std::vector<double> fEvSumWY;  //! per-event buffer, sum of w*y per correlator
+  std::vector<double> fEvSumWY2; //! per-event buffer, sum of w*y^2 per correlator
+  std::vector<double> fEvSumW;   //! per-event buffer, sum of w per correlator
+  std::vector<double> fEvSumW2;  //! per-event buffer, sum of w^2 per correlator
+  std::vector<int> fEvNFills;    //! per-event buffer, number of fills per correlator
+  std::vector<int> fEvHandles;   //! correlators filled in the current event
   ClassDef(FlowContainer, 2);
 };
 
@@ -161,10 +161,9 @@ double GFWWeights::getNUA(double phi, double eta, double vz)
 {
   if (!fAccInt)
     createNUA();
-  int xind = fAccInt->GetXaxis()->FindBin(phi);
-  int etaind = fAccInt->GetYaxis()->FindBin(eta);
-  int vzind = fAccInt->GetZaxis()->FindBin(vz);
-  double weight = fAccInt->GetBinContent(xind, etaind, vzind);
+  if (!fAccIntMap.isValid())
+    fAccIntMap.compile(fAccInt);
+  double weight = fAccIntMap.getBinContent(phi, eta, vz);
   if (weight != 0)
     return 1. / weight;
   return 1;
@@ -173,10 +172,9 @@ double GFWWeights::getNUE(double pt, double eta, double vz)
 {
   if (!fEffInt)
     createNUE();
-  int xind = fEffInt->GetXaxis()->FindBin(pt);
-  int etaind = fEffInt->GetYaxis()->FindBin(eta);
-  int vzind = fEffInt->GetZaxis()->FindBin(vz);
-  double weight = fEffInt->GetBinContent(xind, etaind, vzind);
+  if (!fEffIntMap.isValid())
+    fEffIntMap.compile(fEffInt);
+  double weight = fEffIntMap.getBinContent(pt, eta, vz);
   if (weight != 0)
     return 1. / weight;
   return 1;
@@ -232,6 +230,7 @@ void GFWWeights::createNUA(bool IntegrateOverCentAndPt)
   if (IntegrateOverCentAndPt) {
     if (fAccInt)
       delete fAccInt;
+    fAccIntMap.reset();
     fAccInt = reinterpret_cast<TH3D*>(fW_data->At(0)->Clone("IntegratedAcceptance"));
     fAccInt->Sumw2();
     for (int etai = 1; etai <= fAccInt->GetNbinsY(); etai++) {
@@ -292,6 +291,7 @@ void GFWWeights::createNUE(bool IntegrateOverCentrality)
     den->RebinY(2);
     num->RebinZ(5);
     den->RebinZ(5);
+    fEffIntMap.reset();
     fEffInt = reinterpret_cast<TH3D*>(num->Clone("Efficiency_Integrated"));
     fEffInt->Divide(den);
     return;
@@ -378,6 +378,8 @@ void GFWWeights::overwriteNUA()
   delete trash;
   fW_data->Add(reinterpret_cast<TH3D*>(fAccInt->Clone(ts.Data())));
   delete fAccInt;
+  fAccInt = 0;
+  fAccIntMap.reset();
 }
 Long64_t GFWWeights::Merge(TCollection* collist)
 {
@@ -16,6 +16,8 @@
 #ifndef PWGCF_GENERICFRAMEWORK_CORE_GFWWEIGHTS_H_
 #define PWGCF_GENERICFRAMEWORK_CORE_GFWWEIGHTS_H_
 
+#include "Common/Core/CorrectionMap.h"
+
 #include <TCollection.h>
 #include <TH1.h>
 #include <TH3.h>
@@ -70,6 +72,8 @@ class GFWWeights : public TNamed
   TH3D* fEffInt;   //!
   TH1D* fIntEff;   //!
   TH3D* fAccInt;   //!
+  o2::common::core::CorrectionMap fEffIntMap; //! compiled fEffInt used by getNUE
+  o2::common::core::CorrectionMap fAccIntMap; //! compiled fAccInt used by getNUA
   int fNbinsPt;    //! do not store
   double* fbinsPt; //! do not store
   void addArray(TObjArray* targ, TObjArray* sour);
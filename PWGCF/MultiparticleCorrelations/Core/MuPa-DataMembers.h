@@ -16,6 +16,9 @@
 #ifndef PWGCF_MULTIPARTICLECORRELATIONS_CORE_MUPA_DATAMEMBERS_H_
 #define PWGCF_MULTIPARTICLECORRELATIONS_CORE_MUPA_DATAMEMBERS_H_
 
+#include <array>
+#include <complex>
+#include <map>
 #include <vector>
 
 // General remarks:
@@ -315,6 +318,11 @@ struct Qvector {
                                                                                                     // therefore no need for "[gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1]", etc.
   std::vector<std::vector<std::vector<std::vector<float>>>> fmab;                                   //! multiplicities vs kine in 2 eta separated intervals
                                                                                                     // [-eta or +eta][eqvectorKine_N][global binNo][eta separation]
+
+  // memoized correlator engine (see engineCorrelator(...)):
+  std::vector<const std::vector<std::vector<std::complex<double>>>*> fEngineLanes;                  //! Q-vectors [harmonic][weight power] for which correlators are evaluated in one sweep, e.g. one lane per kine bin
+  std::vector<std::vector<std::complex<double>>> fEngineQvector;                                    //! std::complex copy of integrated Q-vector fQvector, used as a single lane in integrated analysis
+  std::map<std::array<int, gMaxCorrelator + 1>, std::vector<std::complex<double>>> fEngineCache;    //! memoized sub-correlators in all lanes, key = { order, sorted harmonics }. Flushed each time lanes are set
 } qv;                                                                                               // "qv" is a common label for objects in this struct
 
 // *) Multiparticle correlations (standard, isotropic, same harmonic):
@@ -419,6 +427,7 @@ struct Test0 {
   bool fCalculate3DTest0 = false;                                                     // calculate or not 2D Test0
   TProfile3D* fTest0Pro3D[gMaxCorrelator][gMaxIndex][eAsFunctionOf3D_N] = {{{NULL}}}; //! [order][index][0=cent vs pt vs eta, ..., see enum eAsFunctionOf3D]
   TString* fTest0Labels[gMaxCorrelator][gMaxIndex] = {{NULL}};                        // all labels: k-p'th order is stored in k-1'th index. So yes, I also store 1-p
+  std::vector<int> fTest0Harmonics[gMaxCorrelator][gMaxIndex];                       //! harmonics extracted only once from fTest0Labels, see test0Harmonics(...)
   bool fCalculateTest0AsFunctionOf[eAsFunctionOf_N] = {false};                        //! [0=integrated,1=vs. multiplicity,2=vs. centrality,3=pT,4=eta,5=vs. occupancy, ...]
   bool fCalculate2DTest0AsFunctionOf[eAsFunctionOf2D_N] = {false};                    //! [0=integrated,1=vs. multiplicity,2=vs. centrality,3=pT,4=eta,5=vs. occupancy, ...]
   bool fCalculate3DTest0AsFunctionOf[eAsFunctionOf3D_N] = {false};                    //! [0=integrated,1=vs. multiplicity,2=vs. centrality,3=pT,4=eta,5=vs. occupancy, ...]
@@ -17,6 +17,10 @@
 #define PWGCF_MULTIPARTICLECORRELATIONS_CORE_MUPA_MEMBERFUNCTIONS_H_
 
 // ...
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -12311,7 +12315,7 @@ void calculateTest0()
 {
   // Calculate Test0.
 
-  // a) Flush 'n' fill the generic Q-vectors;
+  // a) Flush 'n' fill the generic Q-vectors, and pass them to correlator engine;
   // b) Calculate correlations;
   // c) Flush the generic Q-vectors.
 
@@ -12327,11 +12331,20 @@ void calculateTest0()
       qv.fQ[h][wp] = qv.fQvector[h][wp];
     }
   }
+  qv.fEngineQvector.resize(gMaxHarmonic * gMaxCorrelator + 1, std::vector<std::complex<double>>(gMaxCorrelator + 1));
+  for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) // weight power
+    {
+      qv.fEngineQvector[h][wp] = std::complex<double>(qv.fQvector[h][wp].Re(), qv.fQvector[h][wp].Im());
+    }
+  }
+  setEngineLanes({&qv.fEngineQvector}); // integrated analysis => only one lane
 
   // b) Calculate correlations:
   double correlation = 0.; // still has to be divided with 'weight' later, to get average correlation
   double weight = 0.;
-  int n[gMaxCorrelator] = {0}; // array holding harmonics
+  int n[gMaxCorrelator] = {0};     // array holding harmonics
+  int zeros[gMaxCorrelator] = {0}; // harmonics of event weight
 
   for (int mo = 0; mo < gMaxCorrelator; mo++) {
     for (int mi = 0; mi < gMaxIndex; mi++) {
@@ -12349,130 +12362,18 @@ void calculateTest0()
       } // if(!t0_afTest0Labels[mo][mi])
 
       if (t0.fTest0Labels[mo][mi]) {
-        // Extract harmonics from TString, FS is " ":
-        for (int h = 0; h <= mo; h++) {
-          TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
-          if (!oa) {
-            LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
-          }
-          n[h] = TString(oa->At(h)->GetName()).Atoi();
-          delete oa; // yes, otherwise it's a memory leak
-        }
+        // Harmonics, extracted from TString only once:
+        const std::vector<int>& cachedHarmonics = test0Harmonics(mo, mi);
+        std::copy(cachedHarmonics.begin(), cachedHarmonics.end(), n);
 
-        int nSelectedTracksBareMinimum = -1; // TBI 20260602 : I need this below somewhat artificially to silent o2_linter : Avoid magic numbers in expressions
-        switch (mo + 1)                      // which order? yes, mo+1
-        {
-          case 1:
-            nSelectedTracksBareMinimum = 1;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = one(n[0]).Re();
-            weight = one(0).Re();
-            break;
-
-          case 2:
-            nSelectedTracksBareMinimum = 2;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = two(n[0], n[1]).Re();
-            weight = two(0, 0).Re();
-            break;
-
-          case 3:
-            nSelectedTracksBareMinimum = 3;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = three(n[0], n[1], n[2]).Re();
-            weight = three(0, 0, 0).Re();
-            break;
-
-          case 4:
-            nSelectedTracksBareMinimum = 4;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = four(n[0], n[1], n[2], n[3]).Re();
-            weight = four(0, 0, 0, 0).Re();
-            break;
-
-          case 5:
-            nSelectedTracksBareMinimum = 5;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = five(n[0], n[1], n[2], n[3], n[4]).Re();
-            weight = five(0, 0, 0, 0, 0).Re();
-            break;
-
-          case 6:
-            nSelectedTracksBareMinimum = 6;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = six(n[0], n[1], n[2], n[3], n[4], n[5]).Re();
-            weight = six(0, 0, 0, 0, 0, 0).Re();
-            break;
-
-          case 7:
-            nSelectedTracksBareMinimum = 7;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = seven(n[0], n[1], n[2], n[3], n[4], n[5], n[6]).Re();
-            weight = seven(0, 0, 0, 0, 0, 0, 0).Re();
-            break;
-
-          case 8:
-            nSelectedTracksBareMinimum = 8;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = eight(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]).Re();
-            weight = eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
-
-          case 9:
-            nSelectedTracksBareMinimum = 9;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = nine(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8]).Re();
-            weight = nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
-
-          case 10:
-            nSelectedTracksBareMinimum = 10;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = ten(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9]).Re();
-            weight = ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
-
-          case 11:
-            nSelectedTracksBareMinimum = 11;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = eleven(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10]).Re();
-            weight = eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
-
-          case 12:
-            nSelectedTracksBareMinimum = 12;
-            if (ebye.fSelectedTracks < nSelectedTracksBareMinimum) {
-              return;
-            }
-            correlation = twelve(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]).Re();
-            weight = twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
+        // Bare minimum number of particles for this correlator:
+        if (ebye.fSelectedTracks < mo + 1) { // yes, mo+1
+          return;
+        }
 
-          default:
-            LOGF(fatal, "\033[1;31m%s at line %d : Not supported yet: t0.fTest0Labels[mo][mi]->Data() = %s\033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
-        } // switch(mo+1)
+        // Memoized recursion, all sub-correlators (incl. the ones needed for weights) are calculated only once per event:
+        correlation = engineCorrelator(mo + 1, n)[0].real();
+        weight = engineCorrelator(mo + 1, zeros)[0].real();
 
         // Insanity check on weight:
         if (!(weight > 0.)) {
@@ -12879,6 +12780,49 @@ void calculateKineTest0Ndim(EnqvectorKine kineVarChoice, int Ndim)
 
   } // switch (Ndim)
 
+  // *) Evaluate all requested correlators in all kine bins in one sweep:
+  //    Each kine bin which survives the cuts below is one lane of the memoized correlator engine, so that the recursion over sub-correlators is
+  //    walked through only once for all bins, and harmonics are extracted from labels only once. Results are then looked up in the loop over bins below.
+  std::vector<int> lane(nBins > 0 ? nBins : 0, -1); // lane of the engine for each global bin, -1 if this bin is skipped
+  std::vector<const std::vector<std::vector<std::complex<double>>>*> lanes;
+  for (int b = 0; b < nBins; b++) {
+    if (0 == qv.fqvectorEntries[kineVarChoice][b]) {
+      continue;
+    }
+    if (qv.fqvectorEntries[kineVarChoice][b] < ec.fdEventCuts[eMultiplicity][eMin] || qv.fqvectorEntries[kineVarChoice][b] > ec.fdEventCuts[eMultiplicity][eMax] || std::abs(qv.fqvectorEntries[kineVarChoice][b] - ec.fdEventCuts[eMultiplicity][eMax]) < tc.fFloatingPointPrecision) {
+      continue;
+    }
+    lane[b] = static_cast<int>(lanes.size());
+    lanes.push_back(&qv.fqvector[kineVarChoice][b]);
+  }
+  setEngineLanes(lanes);
+
+  std::vector<double> engineCorrelation[gMaxCorrelator][gMaxIndex]; // [order][index][lane]
+  std::vector<double> engineWeight[gMaxCorrelator];                 // [order][lane]
+  int zeros[gMaxCorrelator] = {0};                                  // harmonics of event weight
+  if (!lanes.empty()) {
+    for (int mo = 0; mo < gMaxCorrelator; mo++) {
+      for (int mi = 0; mi < gMaxIndex; mi++) {
+        if (!t0.fTest0Labels[mo][mi]) {
+          continue;
+        }
+        const std::vector<int>& cachedHarmonics = test0Harmonics(mo, mi);
+        const std::vector<std::complex<double>>& c = engineCorrelator(mo + 1, cachedHarmonics.data());
+        engineCorrelation[mo][mi].resize(c.size());
+        for (std::size_t l = 0; l < c.size(); l++) {
+          engineCorrelation[mo][mi][l] = c[l].real();
+        }
+        if (engineWeight[mo].empty()) {
+          const std::vector<std::complex<double>>& w = engineCorrelator(mo + 1, zeros);
+          engineWeight[mo].resize(w.size());
+          for (std::size_t l = 0; l < w.size(); l++) {
+            engineWeight[mo][l] = w[l].real();
+          }
+        }
+      } // for (int mi = 0; mi < gMaxIndex; mi++)
+    } // for (int mo = 0; mo < gMaxCorrelator; mo++)
+  } // if (!lanes.empty())
+
   // *) Uniform loop over linearized global bins for all kine variables:
   for (int b = 0; b < nBins; b++) { // yes, "< nBins", not "<= nBins", because b runs over all regular bins + 2 (therefore, including underflow and overflow already)
 
@@ -12910,12 +12854,9 @@ void calculateKineTest0Ndim(EnqvectorKine kineVarChoice, int Ndim)
       continue;
     }
 
-    // *) Re-initialize Q-vector to be q-vector in this bin:
-    // After that, I can call all standard Q-vector functions again:
-    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {
-        qv.fQ[h][wp] = TComplex(qv.fqvector[kineVarChoice][b][h][wp].real(), qv.fqvector[kineVarChoice][b][h][wp].imag()); // TBI 20250601 check if there is a simpler way to initialize ROOT TComplex with C++ type 'complex'
-      }
+    // *) Q-vectors in this bin were already consumed by the correlator engine above, so no need to re-initialize the generic Q-vector here:
+    if (lane[b] < 0) {
+      LOGF(fatal, "\033[1;31m%s at line %d : bin b = %d was not passed to the correlator engine \033[0m", __FUNCTION__, __LINE__, b);
     }
 
     // TBI 20250702 Do I need to do some separate insanity check for the case when Q is identically 0?
@@ -12935,86 +12876,17 @@ void calculateKineTest0Ndim(EnqvectorKine kineVarChoice, int Ndim)
       for (int mi = 0; mi < gMaxIndex; mi++) {
         // TBI 20240221 I do not have to loop each time all the way up to gMaxCorrelator and gMaxIndex, but nevermind now, it's not a big efficiency loss.
         if (t0.fTest0Labels[mo][mi]) {
-          // Extract harmonics from TString, FS is " ":
-          for (int h = 0; h <= mo; h++) {
-            // cout<<Form("h = %d, t0.fTest0Labels[%d][%d] = ",h,mo,mi)<<t0.fTest0Labels[mo][mi]->Data()<<endl;
-            TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
-            if (!oa) {
-              LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
-            }
-            n[h] = TString(oa->At(h)->GetName()).Atoi();
-            delete oa; // yes, otherwise it's a memory leak
-          }
+          // Harmonics, extracted from TString only once:
+          const std::vector<int>& cachedHarmonics = test0Harmonics(mo, mi);
+          std::copy(cachedHarmonics.begin(), cachedHarmonics.end(), n);
 
           if (qv.fqvectorEntries[kineVarChoice][b] < mo + 1) {
             continue;
           }
 
-          switch (mo + 1) // which order? yes, mo+1
-          {
-            case 1:
-              correlation = one(n[0]).Re();
-              weight = one(0).Re();
-              break;
-
-            case 2:
-              correlation = two(n[0], n[1]).Re();
-              weight = two(0, 0).Re();
-              break;
-
-            case 3:
-              correlation = three(n[0], n[1], n[2]).Re();
-              weight = three(0, 0, 0).Re();
-              break;
-
-            case 4:
-              correlation = four(n[0], n[1], n[2], n[3]).Re();
-              weight = four(0, 0, 0, 0).Re();
-              break;
-
-            case 5:
-              correlation = five(n[0], n[1], n[2], n[3], n[4]).Re();
-              weight = five(0, 0, 0, 0, 0).Re();
-              break;
-
-            case 6:
-              correlation = six(n[0], n[1], n[2], n[3], n[4], n[5]).Re();
-              weight = six(0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 7:
-              correlation = seven(n[0], n[1], n[2], n[3], n[4], n[5], n[6]).Re();
-              weight = seven(0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 8:
-              correlation = eight(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]).Re();
-              weight = eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 9:
-              correlation = nine(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8]).Re();
-              weight = nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 10:
-              correlation = ten(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9]).Re();
-              weight = ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 11:
-              correlation = eleven(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10]).Re();
-              weight = eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 12:
-              correlation = twelve(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]).Re();
-              weight = twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            default:
-              LOGF(fatal, "\033[1;31m%s at line %d : not supported yet: %s \n\n\033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
-          } // switch(mo+1)
+          // Already calculated in one sweep over all kine bins with the correlator engine, just look them up:
+          correlation = engineCorrelation[mo][mi][lane[b]];
+          weight = engineWeight[mo][lane[b]];
 
           // *) e-b-e sanity check:
           if (nl.fCalculateKineCustomNestedLoops) {
@@ -13068,7 +12940,7 @@ void calculateKineTest0Ndim(EnqvectorKine kineVarChoice, int Ndim)
             LOGF(info, "\n\033[1;33m b = %d \033[0m\n", b);
             LOGF(info, "\n\033[1;33m kineVarChoice = %d \033[0m\n", static_cast<int>(kineVarChoice));
             LOGF(info, "\n\033[1;33m event weight = %e \033[0m\n", weight);
-            LOGF(info, "\n\033[1;33m sum of particle weights = %e \033[0m\n", one(0).Re());
+            LOGF(info, "\n\033[1;33m sum of particle weights = %e \033[0m\n", qv.fqvector[kineVarChoice][b][0][1].real());
             LOGF(info, "\n\033[1;33m correlation = %f \033[0m\n", correlation);
 
             switch (Ndim) {
@@ -14273,6 +14145,168 @@ TComplex recursion(int n, int* harmonic, int mult = 1, int iSkip = 0)
 
 //============================================================
 
+std::complex<double> engineQ(int lane, int n, int wp)
+{
+  // Q-vector Q(n,wp) in the lane 'lane' of the memoized correlator engine, using the fact that Q{-n,p} = Q{n,p}^*.
+
+  if (n >= 0) {
+    return (*qv.fEngineLanes[lane])[n][wp];
+  }
+  return std::conj((*qv.fEngineLanes[lane])[-n][wp]);
+
+} // std::complex<double> engineQ(int lane, int n, int wp)
+
+//============================================================
+
+void setEngineLanes(const std::vector<const std::vector<std::vector<std::complex<double>>>*>& lanes)
+{
+  // Set the Q-vectors on which the memoized correlator engine operates, one lane per set of Q-vectors (e.g. one lane per kine bin).
+  // Since memoized values are valid only for the current Q-vectors, cache is flushed here, therefore call this function each time Q-vectors change.
+
+  qv.fEngineLanes = lanes;
+  qv.fEngineCache.clear();
+
+} // void setEngineLanes(const std::vector<const std::vector<std::vector<std::complex<double>>>*>& lanes)
+
+//============================================================
+
+const std::vector<std::complex<double>>& engineCorrelator(const std::array<int, gMaxCorrelator + 1>& key)
+{
+  // Memoized recursion for generic multi-particle correlators, evaluated in all lanes of the engine at once.
+  // 'key' is the canonical label: key[0] is the order k, key[1], ..., key[k] are the harmonics in ascending order, the rest is 0.
+
+  // Remarks:
+  // 0. Let S = {n1, ..., nk} be harmonics of the k-p correlator N<S> (i.e. not yet divided by the event weight). Pick particle 1, and sum over all
+  //    subsets T of S \ {n1} of particles which are 'glued' to particle 1, i.e. which coincide with it:
+  //      N<S> = sum_T (-1)^|T| |T|! Q(n1 + sum(T), |T|+1) N<S \ {n1} \ T> , with N<{}> = 1 .
+  // 1. N<S> does not depend on the ordering of harmonics in S, so the canonical (sorted) label is used as a key => each sub-correlator is calculated only once per event,
+  //    and it's shared among all requested correlators (e.g. weights <0 0 ... 0> are shared among all correlators of lower order).
+  // 2. Subsets T are enumerated as multisets, i.e. for repeated harmonics I take into account only how many copies are in T, and multiply with the binomial coefficient.
+  //    For instance, the event weight for k-p correlator needs only k terms, instead of 2^(k-1).
+  // 3. Cache is flushed in setEngineLanes(...).
+
+  auto it = qv.fEngineCache.find(key);
+  if (it != qv.fEngineCache.end()) {
+    return it->second;
+  }
+
+  const int nLanes = static_cast<int>(qv.fEngineLanes.size());
+  const int order = key[0];
+  std::vector<std::complex<double>> result(nLanes, std::complex<double>(0., 0.));
+
+  if (0 == order) {
+    std::fill(result.begin(), result.end(), std::complex<double>(1., 0.));
+    return qv.fEngineCache.emplace(key, std::move(result)).first->second;
+  }
+
+  // *) Distinct harmonics (and their multiplicities) among the remaining particles S \ {n1}:
+  int value[gMaxCorrelator] = {0};
+  int count[gMaxCorrelator] = {0};
+  int nDistinct = 0;
+  for (int p = 2; p <= order; p++) {
+    if (nDistinct > 0 && value[nDistinct - 1] == key[p]) {
+      count[nDistinct - 1]++;
+    } else {
+      value[nDistinct] = key[p];
+      count[nDistinct] = 1;
+      nDistinct++;
+    }
+  }
+
+  // *) Loop over all sub-multisets T, as an odometer over the number of copies taken[d] of each distinct harmonic:
+  static const double kFactorial[gMaxCorrelator] = {1., 1., 2., 6., 24., 120., 720., 5040., 40320., 362880., 3628800., 39916800.};
+  int taken[gMaxCorrelator] = {0};
+  while (true) {
+    int sizeT = 0;
+    int harmonicSum = key[1];
+    double multiplicity = 1.;
+    std::array<int, gMaxCorrelator + 1> subKey = {0};
+    for (int d = 0; d < nDistinct; d++) {
+      sizeT += taken[d];
+      harmonicSum += taken[d] * value[d];
+      multiplicity *= kFactorial[count[d]] / (kFactorial[taken[d]] * kFactorial[count[d] - taken[d]]);
+      for (int c = taken[d]; c < count[d]; c++) {
+        subKey[++subKey[0]] = value[d]; // remains sorted, since value[d] is sorted
+      }
+    }
+    const double coefficient = (sizeT % 2 == 0 ? 1. : -1.) * kFactorial[sizeT] * multiplicity;
+    const std::vector<std::complex<double>>& sub = engineCorrelator(subKey); // std::map does not invalidate references on insertion
+    for (int l = 0; l < nLanes; l++) {
+      result[l] += coefficient * engineQ(l, harmonicSum, sizeT + 1) * sub[l];
+    }
+
+    // advance the odometer:
+    int d = 0;
+    while (d < nDistinct && taken[d] == count[d]) {
+      taken[d] = 0;
+      d++;
+    }
+    if (d == nDistinct) {
+      break;
+    }
+    taken[d]++;
+  }
+
+  return qv.fEngineCache.emplace(key, std::move(result)).first->second;
+
+} // const std::vector<std::complex<double>>& engineCorrelator(const std::array<int, gMaxCorrelator + 1>& key)
+
+//============================================================
+
+const std::vector<std::complex<double>>& engineCorrelator(int order, const int* harmonic)
+{
+  // Generic order-particle correlator N<exp[i(n1*phi1+...+nk*phik)]> (not yet divided by the event weight) from the memoized engine, in all lanes at once.
+  // Event weight is obtained by calling this function with all harmonics set to 0.
+
+  if (order < 0 || order > gMaxCorrelator) {
+    LOGF(fatal, "\033[1;31m%s at line %d : order = %d is not supported \033[0m", __FUNCTION__, __LINE__, order);
+  }
+
+  std::array<int, gMaxCorrelator + 1> key = {0};
+  key[0] = order;
+  int sumAbs = 0;
+  for (int p = 0; p < order; p++) {
+    key[p + 1] = harmonic[p];
+    sumAbs += std::abs(harmonic[p]);
+  }
+  if (sumAbs > gMaxHarmonic * gMaxCorrelator) {
+    LOGF(fatal, "\033[1;31m%s at line %d : sum of absolute values of harmonics = %d is bigger than gMaxHarmonic * gMaxCorrelator = %d \033[0m", __FUNCTION__, __LINE__, sumAbs, gMaxHarmonic * gMaxCorrelator);
+  }
+  std::sort(key.begin() + 1, key.begin() + 1 + order);
+
+  return engineCorrelator(key);
+
+} // const std::vector<std::complex<double>>& engineCorrelator(int order, const int* harmonic)
+
+//============================================================
+
+const std::vector<int>& test0Harmonics(int mo, int mi)
+{
+  // Harmonics of Test0 correlator [mo][mi]. They are extracted from the label (FS is " ") only the first time, and then cached in t0.fTest0Harmonics.
+
+  std::vector<int>& harmonics = t0.fTest0Harmonics[mo][mi];
+  if (!harmonics.empty()) {
+    return harmonics;
+  }
+
+  if (!t0.fTest0Labels[mo][mi]) {
+    LOGF(fatal, "\033[1;31m%s at line %d : t0.fTest0Labels[%d][%d] is NULL \033[0m", __FUNCTION__, __LINE__, mo, mi);
+  }
+  TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
+  if (!oa || oa->GetEntries() < mo + 1) {
+    LOGF(fatal, "\033[1;31m%s at line %d : label %s has less than %d harmonics \033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data(), mo + 1);
+  }
+  for (int h = 0; h <= mo; h++) {
+    harmonics.push_back(TString(oa->At(h)->GetName()).Atoi());
+  }
+  delete oa; // yes, otherwise it's a memory leak
+
+  return harmonics;
+
+} // const std::vector<int>& test0Harmonics(int mo, int mi)
+
+//============================================================
+
 void resetQ()
 {
   // Reset the components of generic Q-vectors. Use it whenever you call the
@@ -13,6 +13,7 @@
 /// \brief task for the correlation calculations with CF-filtered tracks for O2 analysis
 /// \author Jan Fiete Grosse-Oetringhaus <jan.fiete.grosse-oetringhaus@cern.ch>, Jasper Parkkila <jasper.parkkila@cern.ch>
 
+#include "PWGCF/Core/BinnedPairCorrelator.h"
 #include "PWGCF/Core/CorrelationContainer.h"
 #include "PWGCF/Core/PairCuts.h"
 #include "PWGCF/DataModel/CorrelationsDerived.h"
@@ -102,6 +103,8 @@ struct CorrelationTask {
 
   O2_DEFINE_CONFIGURABLE(cfgTwoTrackCut, float, -1, "Two track cut: -1 = off; >0 otherwise distance value (suggested: 0.02)");
   O2_DEFINE_CONFIGURABLE(cfgTwoTrackCutMinRadius, float, 0.8f, "Two track cut: radius in m from which two track cuts are applied");
+  O2_DEFINE_CONFIGURABLE(cfgBinnedPairs, bool, false, "Fill track-track pairs by cross-correlating binned single-particle (eta, phi) distributions per event instead of the pair loop. Requires fixed-width delta eta / delta phi axes, not compatible with pair cuts, pair charge selection and mass axis");
+  O2_DEFINE_CONFIGURABLE(cfgBinnedPairsOversampling, int, 2, "Single-particle grid bins per delta eta / delta phi bin for cfgBinnedPairs");
   O2_DEFINE_CONFIGURABLE(cfgLocalEfficiency, int, 0, "0 = OFF and 1 = ON for local efficiency");
   O2_DEFINE_CONFIGURABLE(cfgDropStepRECO, bool, false, "choice to drop step RECO if efficiency correction is used")
   O2_DEFINE_CONFIGURABLE(cfgCentBinsForMC, int, 0, "0 = OFF and 1 = ON for data like multiplicity/centrality bins for MC steps");
@@ -184,6 +187,7 @@ struct CorrelationTask {
 
   HistogramRegistry registry{"registry"};
   PairCuts mPairCuts;
+  BinnedPairCorrelator mBinnedPairs;
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
 
@@ -264,6 +268,20 @@ struct CorrelationTask {
       mPairCuts.SetTwoTrackCuts(cfgTwoTrackCut, cfgTwoTrackCutMinRadius);
     }
 
+    if (cfgBinnedPairs) {
+      if (cfgMassAxis != 0 || cfg.mPairCuts || cfgTwoTrackCut > 0 || cfgPairCharge != 0) {
+        LOGF(fatal, "cfgBinnedPairs can not be used together with cfgMassAxis, cfgPairCut, cfgTwoTrackCut or cfgPairCharge.");
+      }
+      const AxisSpec deltaEta(axisDeltaEta);
+      const AxisSpec deltaPhi(axisDeltaPhi);
+      if (!deltaEta.nBins.has_value() || !deltaPhi.nBins.has_value()) {
+        LOGF(fatal, "cfgBinnedPairs requires fixed-width delta eta and delta phi axes.");
+      }
+      mBinnedPairs.init(cfgCutEta, getBinEdges(AxisSpec(axisPtTrigger)), getBinEdges(AxisSpec(axisPtAssoc)),
+                        deltaEta.getNbins(), deltaEta.binEdges.front(), deltaEta.binEdges.back(),
+                        deltaPhi.getNbins(), deltaPhi.binEdges.front(), deltaPhi.binEdges.back(), cfgBinnedPairsOversampling);
+    }
+
     // --- OBJECT INIT ---
 
     if (!cfgMultCutFormula.value.empty()) {
@@ -578,6 +596,18 @@ struct CorrelationTask {
       }
     }
 
+    // Plain track-track correlations can be filled from binned single-particle distributions instead of the pair loop below
+    if constexpr (step >= CorrelationContainer::kCFStepReconstructed && std::is_same<TTracks1, TTracks2>::value &&
+                  std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value &&
+                  !std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value &&
+                  !std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value &&
+                  !std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value) {
+      if (cfgBinnedPairs) {
+        fillCorrelationsBinned<step>(target, tracks1, tracks2, multiplicity, posZ, eventWeight);
+        return;
+      }
+    }
+
     for (const auto& track1 : tracks1) {
       // LOGF(info, "Track %f | %f | %f  %d %d", track1.eta(), track1.phi(), track1.pt(), track1.isGlobalTrack(), track1.isGlobalTrackSDD());
 
@@ -832,6 +862,63 @@ struct CorrelationTask {
     }
   }
 
+  // Binned version of fillCorrelations for track-track correlations (cfgBinnedPairs), the pair weight factorises into trigger and associated weight
+  template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks1, typename TTracks2>
+  void fillCorrelationsBinned(TTarget target, TTracks1& tracks1, TTracks2& tracks2, float multiplicity, float posZ, float eventWeight)
+  {
+    for (const auto& track1 : tracks1) {
+      if (cfgTriggerCharge != 0 && cfgTriggerCharge * track1.sign() < 0) {
+        continue;
+      }
+
+      float triggerWeight = eventWeight;
+      if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+        if (cfg.mEfficiencyTrigger) {
+          triggerWeight *= getEfficiencyCorrection(cfg.mEfficiencyTrigger, track1.eta(), track1.pt(), multiplicity, posZ);
+        }
+      }
+
+      target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, triggerWeight);
+      mBinnedPairs.addTrigger(track1.globalIndex(), track1.eta(), track1.phi(), track1.pt(), triggerWeight);
+    }
+
+    for (const auto& track2 : tracks2) {
+      if (cfgAssociatedCharge != 0) {
+        if (cfgAssociatedCharge * track2.sign() < 0) {
+          continue;
+        }
+      } else if (track2.sign() == 0) {
+        continue;
+      }
+
+      float associatedWeight = 1.0f;
+      if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+        if (cfg.mEfficiencyAssociated) {
+          associatedWeight = efficiencyAssociatedCache[track2.filteredIndex()];
+        }
+      }
+
+      mBinnedPairs.addAssociated(track2.globalIndex(), track2.eta(), track2.phi(), track2.pt(), associatedWeight);
+    }
+
+    // last param is the weight
+    mBinnedPairs.correlate(cfgPtOrder != 0, [&](float deltaEta, float ptAssoc, float ptTrig, float deltaPhi, float weight) {
+      target->getPairHist()->Fill(step, deltaEta, ptAssoc, ptTrig, multiplicity, deltaPhi, posZ, weight);
+    });
+  }
+
+  static std::vector<double> getBinEdges(const AxisSpec& axis)
+  {
+    if (!axis.nBins.has_value()) {
+      return axis.binEdges;
+    }
+    std::vector<double> edges(axis.getNbins() + 1);
+    for (int i = 0; i <= axis.getNbins(); i++) {
+      edges[i] = axis.binEdges.front() + i * (axis.binEdges.back() - axis.binEdges.front()) / axis.getNbins();
+    }
+    return edges;
+  }
+
   void loadEfficiency(uint64_t timestamp)
   {
     if (cfg.efficiencyLoaded) {
@@ -105,6 +105,18 @@ class MCSignal : public TNamed
   {
     return fNAncestorDirectProngs;
   }
+  const MCProng& GetProng(int i) const
+  {
+    return fProngs[i];
+  }
+  int8_t GetCommonAncestorIdx(int i) const
+  {
+    return fCommonAncestorIdxs[i];
+  }
+  bool GetExcludeCommonAncestor() const
+  {
+    return fExcludeCommonAncestor;
+  }
 
   template <typename... T>
   bool CheckSignal(bool checkSources, const T&... args)
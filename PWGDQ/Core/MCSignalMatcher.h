@@ -0,0 +1,341 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Contact: iarsene@cern.ch, i.c.arsene@fys.uio.no
+//
+/* Evaluation of a set of MC signals in one pass
+
+The matcher is compiled from the list of MCSignal objects configured in a task. Identical prong definitions
+are merged, so that each of them is tested only once per MC particle. For every particle passed to Match(),
+the first-mother history is walked once and stored (global index, PDG code, source flags and number of daughters
+of each generation). The per-prong decisions are cached for the particle, so a particle used in many pairs is
+evaluated only once. Match() returns a bit map with bit i set if signal i matches, with the same decision as
+MCSignal::CheckSignal(). The bit map has the width of the McDecision columns, so at most 32 signals are accepted. Signals with prongs checked in time (towards daughters) are delegated to CheckSignal().
+
+Example usage:
+
+  MCSignalMatcher matcher(fRecMCSignals);
+  ...
+  matcher.ResetCache(); // once per time frame, before the particle indices change
+  for (auto& [t1, t2] : combinations(tracks, tracks)) {
+    uint32_t mcDecision = matcher.Match(true, t1.reducedMCTrack(), t2.reducedMCTrack());
+  }
+*/
+#ifndef PWGDQ_CORE_MCSIGNALMATCHER_H_
+#define PWGDQ_CORE_MCSIGNALMATCHER_H_
+
+#include "PWGDQ/Core/MCProng.h"
+#include "PWGDQ/Core/MCSignal.h"
+
+#include <Framework/Logger.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class MCSignalMatcher
+{
+ public:
+  // maximum number of signals, one bit each in the uint32_t McDecision of the pair tables
+  static constexpr std::size_t kMaxSignals = 32;
+
+  MCSignalMatcher() = default;
+  explicit MCSignalMatcher(const std::vector<MCSignal*>& signals)
+  {
+    Compile(signals);
+  }
+
+  void Compile(const std::vector<MCSignal*>& signals)
+  {
+    if (signals.size() > kMaxSignals) {
+      LOG(fatal) << "MCSignalMatcher: at most " << kMaxSignals << " signals can be combined, " << signals.size() << " were given";
+    }
+    fSignals.clear();
+    fUniqueProngs.clear();
+    fNRows = kMinHistoryRows;
+    for (auto* sig : signals) {
+      CompiledSignal compiled;
+      compiled.signal = sig;
+      compiled.nProngs = sig->GetNProngs();
+      bool ancestorOnFirstProng = false;
+      bool ancestorOnOtherProngs = false;
+      for (int i = 0; i < sig->GetNProngs(); i++) {
+        const MCProng& prong = sig->GetProng(i);
+        if (prong.fCheckGenerationsInTime) {
+          compiled.generic = true;
+        }
+        fNRows = std::max(fNRows, prong.fNGenerations);
+        compiled.prongs.push_back(FindOrAddProng(prong));
+        // the common ancestor is only checked if its generation is reached in the prong history
+        int ancestorGeneration = sig->GetCommonAncestorIdx(i);
+        if (ancestorGeneration >= prong.fNGenerations) {
+          ancestorGeneration = -1;
+        }
+        compiled.ancestorGenerations.push_back(ancestorGeneration);
+        if (ancestorGeneration >= 0) {
+          (i == 0 ? ancestorOnFirstProng : ancestorOnOtherProngs) = true;
+        }
+      }
+      // without an ancestor on the first prong, CheckSignal() compares to the label of a previous call
+      if (compiled.nProngs > 1 && !ancestorOnFirstProng && ancestorOnOtherProngs) {
+        compiled.generic = true;
+      }
+      fSignals.push_back(compiled);
+    }
+    ResetCache();
+  }
+
+  // Forget the particles evaluated so far; needed whenever the global indices may refer to another table
+  void ResetCache()
+  {
+    fEntries.clear();
+    fNEntries = 0;
+    fChainLength.clear();
+    fChainIds.clear();
+    fChainNDaughters.clear();
+    fChainFlags.clear();
+    fProngDecisions.clear();
+  }
+
+  int GetNSignals() const
+  {
+    return fSignals.size();
+  }
+  int GetNUniqueProngs() const
+  {
+    return fUniqueProngs.size();
+  }
+
+  // Bit map of the signals matched by the given tuple of MC particles, bit i corresponding to signal i
+  template <typename... T>
+  uint32_t Match(bool checkSources, const T&... tracks)
+  {
+    constexpr unsigned int nTracks = sizeof...(T);
+    const std::array<int, nTracks> entries = {GetEntry(tracks)...};
+    uint32_t decision = 0;
+    for (std::size_t isig = 0; isig < fSignals.size(); isig++) {
+      const CompiledSignal& sig = fSignals[isig];
+      if (sig.nProngs != nTracks) {
+        continue;
+      }
+      bool matched = false;
+      if (sig.generic) {
+        matched = sig.signal->CheckSignal(checkSources, tracks...);
+      } else {
+        matched = MatchCompiled(sig, checkSources, entries.data());
+      }
+      if (matched) {
+        decision |= (static_cast<uint32_t>(1) << isig);
+      }
+    }
+    return decision;
+  }
+
+ private:
+  enum ProngDecision : uint8_t {
+    kPDGMatched = 0x1,
+    kSourcesMatched = 0x2,
+    kHistoryMatched = 0x4
+  };
+  enum RowFlags : uint8_t {
+    kHasDaughters = static_cast<uint8_t>(1) << MCProng::kNSources
+  };
+  static constexpr int kMinHistoryRows = 12; // particle and the 11 mothers searched for fPDGInHistory in MCSignal::CheckProng()
+
+  struct CompiledSignal {
+    MCSignal* signal = nullptr;
+    unsigned int nProngs = 0;
+    bool generic = false;                 // evaluated with MCSignal::CheckSignal()
+    std::vector<int> prongs;              // index in fUniqueProngs
+    std::vector<int> ancestorGenerations; // generation of the common ancestor in each prong, -1 if not checked
+  };
+
+  std::vector<CompiledSignal> fSignals;
+  std::vector<const MCProng*> fUniqueProngs;
+  int fNRows = kMinHistoryRows; // generations stored for each particle
+
+  // cache of evaluated particles; the history of entry e is stored in rows [e * fNRows, (e + 1) * fNRows)
+  std::unordered_map<int64_t, int> fEntries; // global index -> entry
+  int fNEntries = 0;
+  std::vector<int> fChainLength;
+  std::vector<int64_t> fChainIds;
+  std::vector<int> fChainNDaughters;
+  std::vector<uint8_t> fChainFlags;     // bit s set if the particle fulfills source s (MCProng::Source), plus kHasDaughters
+  std::vector<int> fChainPDG;           // only needed while the entry is evaluated
+  std::vector<uint8_t> fProngDecisions; // ProngDecision bits of entry e and unique prong u at e * fUniqueProngs.size() + u
+
+  static bool SameProng(const MCProng& a, const MCProng& b)
+  {
+    return a.fNGenerations == b.fNGenerations && a.fPDGcodes == b.fPDGcodes && a.fCheckBothCharges == b.fCheckBothCharges &&
+           a.fExcludePDG == b.fExcludePDG && a.fSourceBits == b.fSourceBits && a.fExcludeSource == b.fExcludeSource &&
+           a.fUseANDonSourceBitMap == b.fUseANDonSourceBitMap && a.fCheckGenerationsInTime == b.fCheckGenerationsInTime &&
+           a.fPDGInHistory == b.fPDGInHistory && a.fExcludePDGInHistory == b.fExcludePDGInHistory;
+  }
+
+  int FindOrAddProng(const MCProng& prong)
+  {
+    for (std::size_t u = 0; u < fUniqueProngs.size(); u++) {
+      if (SameProng(*fUniqueProngs[u], prong)) {
+        return u;
+      }
+    }
+    fUniqueProngs.push_back(&prong);
+    return fUniqueProngs.size() - 1;
+  }
+
+  template <typename T>
+  int GetEntry(const T& track)
+  {
+    using P = typename T::parent_t;
+    auto [it, inserted] = fEntries.try_emplace(track.globalIndex(), fNEntries);
+    if (!inserted) {
+      return it->second;
+    }
+    const int entry = fNEntries++;
+    const std::size_t first = static_cast<std::size_t>(entry) * fNRows;
+    fChainLength.push_back(0);
+    fChainIds.resize(first + fNRows, -1);
+    fChainNDaughters.resize(first + fNRows, 0);
+    fChainFlags.resize(first + fNRows, 0);
+    fChainPDG.assign(fNRows, 0);
+
+    // walk the first-mother history once
+    auto currentMCParticle = track;
+    int nRows = 0;
+    while (true) {
+      const std::size_t row = first + nRows;
+      fChainIds[row] = currentMCParticle.globalIndex();
+      fChainPDG[nRows] = currentMCParticle.pdgCode();
+      uint8_t flags = 0;
+      flags |= currentMCParticle.isPhysicalPrimary() ? (1 << MCProng::kPhysicalPrimary) : 0;
+      flags |= !currentMCParticle.producedByGenerator() ? (1 << MCProng::kProducedInTransport) : 0;
+      flags |= currentMCParticle.producedByGenerator() ? (1 << MCProng::kProducedByGenerator) : 0;
+      flags |= currentMCParticle.fromBackgroundEvent() ? (1 << MCProng::kFromBackgroundEvent) : 0;
+      flags |= (currentMCParticle.getHepMCStatusCode() == 11) ? (1 << MCProng::kHEPMCFinalState) : 0;
+      flags |= (currentMCParticle.getGenStatusCode() == 23) ? (1 << MCProng::kIsPowhegDYMuon) : 0;
+      if (currentMCParticle.has_daughters()) {
+        flags |= kHasDaughters;
+        fChainNDaughters[row] = currentMCParticle.daughtersIds()[1] - currentMCParticle.daughtersIds()[0] + 1;
+      }
+      fChainFlags[row] = flags;
+      nRows++;
+      if (nRows == fNRows || !currentMCParticle.has_mothers()) {
+        break;
+      }
+      currentMCParticle = currentMCParticle.template mothers_first_as<P>();
+    }
+    fChainLength[entry] = nRows;
+
+    for (auto const* prong : fUniqueProngs) {
+      fProngDecisions.push_back(prong->fCheckGenerationsInTime ? 0 : EvaluateProng(*prong, first, nRows));
+    }
+    return entry;
+  }
+
+  // Same decisions as MCSignal::CheckProng() for a prong checked back in time, split into the PDG, source and history parts
+  uint8_t EvaluateProng(const MCProng& prong, std::size_t first, int nRows) const
+  {
+    // every generation but the last one must have a mother
+    if (nRows < prong.fNGenerations) {
+      return 0;
+    }
+    for (int j = 0; j < prong.fNGenerations; j++) {
+      if (!prong.TestPDG(j, fChainPDG[j])) {
+        return 0;
+      }
+    }
+    uint8_t decision = kPDGMatched;
+
+    bool sourcesMatched = true;
+    for (int j = 0; j < prong.fNGenerations && sourcesMatched; j++) {
+      if (!prong.fSourceBits[j]) {
+        continue;
+      }
+      uint64_t sourcesDecision = 0;
+      for (int s = 0; s < MCProng::kNSources; s++) {
+        const uint64_t bit = static_cast<uint64_t>(1) << s;
+        const bool fulfilled = fChainFlags[first + j] & bit;
+        // same comparison as in MCSignal::CheckProng()
+        if ((prong.fSourceBits[j] & bit) && (prong.fExcludeSource[j] & bit) != fulfilled) {
+          sourcesDecision |= bit;
+        }
+      }
+      if (!sourcesDecision || (prong.fUseANDonSourceBitMap[j] && sourcesDecision != prong.fSourceBits[j])) {
+        sourcesMatched = false;
+      }
+    }
+    if (sourcesMatched) {
+      decision |= kSourcesMatched;
+    }
+
+    // mothers searched for the PDG codes required (or excluded) in the history
+    const int lastMother = std::min(nRows - 1, kMinHistoryRows - 1);
+    for (std::size_t k = 0; k < prong.fPDGInHistory.size(); k++) {
+      const bool exclude = prong.fExcludePDGInHistory[k];
+      bool found = false;
+      for (int r = 1; r <= lastMother; r++) {
+        const bool compared = prong.ComparePDG(fChainPDG[r], prong.fPDGInHistory[k], true, exclude);
+        if (exclude && !compared) {
+          return decision;
+        }
+        if (!exclude && compared) {
+          found = true;
+          break;
+        }
+      }
+      if (!exclude && !found) {
+        return decision;
+      }
+    }
+    return decision | kHistoryMatched;
+  }
+
+  bool MatchCompiled(const CompiledSignal& sig, bool checkSources, const int* entries) const
+  {
+    const std::size_t nUnique = fUniqueProngs.size();
+    const uint8_t required = checkSources ? (kPDGMatched | kSourcesMatched | kHistoryMatched) : (kPDGMatched | kHistoryMatched);
+    for (unsigned int i = 0; i < sig.nProngs; i++) {
+      if ((fProngDecisions[entries[i] * nUnique + sig.prongs[i]] & required) != required) {
+        return false;
+      }
+    }
+    if (sig.nProngs < 2 || sig.ancestorGenerations[0] < 0) {
+      return true;
+    }
+    const std::size_t ancestorRow = static_cast<std::size_t>(entries[0]) * fNRows + sig.ancestorGenerations[0];
+    const int64_t ancestorLabel = fChainIds[ancestorRow];
+    if (fChainFlags[ancestorRow] & kHasDaughters) {
+      const MCSignal* signal = sig.signal;
+      if (signal->GetDecayChannelIsExclusive() && fChainNDaughters[ancestorRow] != signal->GetNAncestorDirectProngs()) {
+        return false;
+      }
+      if (signal->GetDecayChannelIsNotExclusive() && fChainNDaughters[ancestorRow] == signal->GetNAncestorDirectProngs()) {
+        return false;
+      }
+    }
+    const bool excludeCommonAncestor = sig.signal->GetExcludeCommonAncestor();
+    for (unsigned int i = 1; i < sig.nProngs; i++) {
+      if (sig.ancestorGenerations[i] < 0) {
+        continue;
+      }
+      const bool sameAncestor = fChainIds[static_cast<std::size_t>(entries[i]) * fNRows + sig.ancestorGenerations[i]] == ancestorLabel;
+      if (sameAncestor == excludeCommonAncestor) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+#endif // PWGDQ_CORE_MCSIGNALMATCHER_H_
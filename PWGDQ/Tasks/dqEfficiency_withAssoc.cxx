@@ -19,6 +19,7 @@
 #include "PWGDQ/Core/HistogramsLibrary.h"
 #include "PWGDQ/Core/MCSignal.h"
 #include "PWGDQ/Core/MCSignalLibrary.h"
+#include "PWGDQ/Core/MCSignalMatcher.h"
 #include "PWGDQ/Core/MixingHandler.h"
 #include "PWGDQ/Core/MixingLibrary.h"
 #include "PWGDQ/Core/VarManager.h"
@@ -1665,6 +1666,7 @@ struct AnalysisSameEventPairing {
   std::map<int, std::vector<TString>> fTrackMuonHistNames;
   std::map<int, std::vector<TString>> fTrackMuonHistNamesMCmatched;
   std::vector<MCSignal*> fRecMCSignals;
+  MCSignalMatcher fRecMCSignalMatcher; // evaluates all fRecMCSignals at once for a pair
   std::vector<MCSignal*> fEmuRecMCSignals;
   std::vector<MCSignal*> fGenMCSignals;
   std::vector<MCSignal*> fFinalStateMCSignals;
@@ -1751,6 +1753,7 @@ struct AnalysisSameEventPairing {
         fRecMCSignals.push_back(mcIt);
       }
     }
+    fRecMCSignalMatcher.Compile(fRecMCSignals);
 
     // Setting the MC rec signal names for e-mu pairs (independent list; the pair has leg1=electron, leg2=muon)
     TString emuSigNamesStr = fConfigMC.emuRecSignals.value;
@@ -2227,6 +2230,7 @@ struct AnalysisSameEventPairing {
     auto mcDecision = static_cast<uint32_t>(0);
     bool isCorrectAssoc_leg1 = false;
     bool isCorrectAssoc_leg2 = false;
+    fRecMCSignalMatcher.ResetCache();
 
     // estimate reserved size
     int64_t reserveSize = 0;
@@ -2314,15 +2318,10 @@ struct AnalysisSameEventPairing {
           }
 
           // run MC matching for this pair
-          int isig = 0;
           mcDecision = 0;
-          for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
-            if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
-                mcDecision |= (static_cast<uint32_t>(1) << isig);
-              }
-            }
-          } // end loop over MC signals
+          if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+            mcDecision = fRecMCSignalMatcher.Match(true, t1.reducedMCTrack(), t2.reducedMCTrack());
+          }
           if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
             isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
             isCorrectAssoc_leg2 = (t2.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
@@ -2404,15 +2403,10 @@ struct AnalysisSameEventPairing {
           }
 
           // run MC matching for this pair
-          int isig = 0;
           mcDecision = 0;
-          for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
-            if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
-                mcDecision |= (static_cast<uint32_t>(1) << isig);
-              }
-            }
-          } // end loop over MC signals
+          if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+            mcDecision = fRecMCSignalMatcher.Match(true, t1.reducedMCTrack(), t2.reducedMCTrack());
+          }
 
           if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
             isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
@@ -105,6 +105,8 @@ struct Pi0EtaToGammaGamma {
   o2::framework::Configurable<float> cfgAlphaMeson{"cfgAlphaMeson", 0.65, "photon energy asymmetry distribution parameter for specific value cut"};
   o2::framework::Configurable<float> cfgAlphaMesonA{"cfgAlphaMesonA", 0.65, "photon energy asymmetry distribution parameter A for pT dependent cut (A * tanh(B*pT))"};
   o2::framework::Configurable<float> cfgAlphaMesonB{"cfgAlphaMesonB", 1.2, "photon energy asymmetry distribution parameter B for pT dependent cut (A * tanh(B*pT))"};
+  o2::framework::Configurable<float> cfgMinMgg{"cfgMinMgg", -1e+10, "min. pair mass, pairs below are rejected before filling"};
+  o2::framework::Configurable<float> cfgMaxMgg{"cfgMaxMgg", 1e+10, "max. pair mass, pairs above are rejected before filling"};
 
   o2::framework::Configurable<bool> cfgDoPhotonClassPairCut{"cfgDoPhotonClassPairCut", false, "apply photon-class pair selection A x B (leg track composition, PCM-PCM only)"};
 
@@ -290,6 +292,33 @@ struct Pi0EtaToGammaGamma {
 
   std::vector<int> used_photonIds_per_col;                   // <ndf, trackId>
   std::vector<std::pair<int, int>> used_dileptonIds_per_col; // <ndf, trackId>
+
+  // photons of one collision passing the single photon cuts, in the order of the collision slice
+  struct SelectedPhotons {
+    o2::aod::pwgem::photonmeson::utils::pairutil::DiphotonLegs legs;
+    std::vector<int64_t> globalIndex;
+    std::vector<int> position; // position in the collision slice
+    std::vector<float> weight;
+    std::vector<o2::aod::pwgem::photonmeson::utils::pairutil::V0PhotonLegCounts> legCounts;
+
+    void clear()
+    {
+      legs.clear();
+      globalIndex.clear();
+      position.clear();
+      weight.clear();
+      legCounts.clear();
+    }
+  };
+  SelectedPhotons selected_photons1_per_col;
+  SelectedPhotons selected_photons2_per_col;
+  o2::aod::pwgem::photonmeson::utils::pairutil::DiphotonLegs legs1_mix;
+  o2::aod::pwgem::photonmeson::utils::pairutil::DiphotonLegs legs2_mix;
+  o2::aod::pwgem::photonmeson::utils::pairutil::DiphotonLegs legs_pool;
+  std::vector<double> pair_mass;
+  std::vector<double> pair_pt;
+  std::vector<double> pair_rapidity;
+
   std::map<std::pair<int, int>, uint64_t> map_mixed_eventId_to_globalBC;
 
   std::vector<float> zvtx_bin_edges;
@@ -731,6 +760,88 @@ struct Pi0EtaToGammaGamma {
     }
   }
 
+  /// \brief apply the single photon cuts once per photon of the collision and keep the selected ones for the pairing
+  /// \param applyCutWithoutMatching also require the EMCal cut without matched tracks, as for the second photon of a non-EMCal/EMCal pair
+  template <typename TDetectorTag, bool withLegCounts, typename TLegs, o2::soa::is_table TPhotons, typename TMatchedTracks, typename TMatchedSecondaries>
+  void selectPhotons(TPhotons const& photons_per_collision, SelectedPhotons& selected, const bool applyCutWithoutMatching, TMatchedTracks const& matchedTracks, TMatchedSecondaries const& matchedSecondaries)
+  {
+    selected.clear();
+    int position = -1;
+    for (const auto& g : photons_per_collision) {
+      position++;
+      if constexpr (std::is_same_v<TDetectorTag, EMCTag>) {
+        if (applyCutWithoutMatching && !TDetectorTag::applyCut(*this, g)) {
+          continue;
+        }
+        auto matchedTracksPerCluster = matchedTracks.sliceByCached(TDetectorTag::perClusterMT(), g.globalIndex(), cache);
+        auto matchedSecondariesPerCluster = matchedSecondaries.sliceByCached(TDetectorTag::perClusterMS(), g.globalIndex(), cache);
+        if (!TDetectorTag::applyCut(*this, g, matchedTracksPerCluster, matchedSecondariesPerCluster)) {
+          continue;
+        }
+      } else {
+        if (!TDetectorTag::applyCut(*this, g)) {
+          continue;
+        }
+      }
+
+      o2::aod::pwgem::photonmeson::utils::pairutil::V0PhotonLegCounts legCounts{};
+      if constexpr (withLegCounts) {
+        auto pos = g.template posTrack_as<TLegs>();
+        auto neg = g.template negTrack_as<TLegs>();
+        legCounts = o2::aod::pwgem::photonmeson::utils::pairutil::getV0PhotonLegCounts(pos, neg);
+      }
+      float weight = 1.f;
+      if constexpr (requires { g.omegaMBWeight(); }) {
+        weight = g.omegaMBWeight();
+      }
+      selected.legs.add(g.pt(), g.eta(), g.phi(), 0.f, g.e());
+      selected.globalIndex.emplace_back(g.globalIndex());
+      selected.position.emplace_back(position);
+      selected.weight.emplace_back(weight);
+      selected.legCounts.emplace_back(legCounts);
+    }
+  }
+
+  /// \brief fill the kinematics of mixed-event photons, dileptons keep their mass
+  void fillMixingLegs(std::vector<o2::aod::pwgem::photonmeson::utils::EMPhoton> const& photons, o2::aod::pwgem::photonmeson::utils::pairutil::DiphotonLegs& legs, const bool withMass)
+  {
+    legs.clear();
+    for (const auto& g : photons) {
+      legs.add(g.pt(), g.eta(), g.phi(), withMass ? g.mass() : 0.f, g.p());
+    }
+    if (pair_mass.size() < legs.size()) {
+      pair_mass.resize(legs.size());
+      pair_pt.resize(legs.size());
+      pair_rapidity.resize(legs.size());
+    }
+  }
+
+  /// \brief photon energy asymmetry cut of a pair
+  bool isSelectedAlphaMeson(const float e1, const float e2, const double pairPt) const
+  {
+    float alphaMeson = std::fabs(e1 - e2) / (e1 + e2);
+    float alphaCut = 999.f;
+    switch (static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value)) {
+      case AlphaMesonCutOption::Off:
+        break;
+      case AlphaMesonCutOption::SpecificValue:
+        alphaCut = cfgAlphaMeson;
+        break;
+      case AlphaMesonCutOption::PTDependent: {
+        alphaCut = cfgAlphaMesonA * std::tanh(cfgAlphaMesonB * pairPt);
+        break;
+      }
+      default:
+        LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
+    }
+    return !(alphaMeson > alphaCut);
+  }
+
+  bool isInMassWindow(const double mass) const
+  {
+    return !(mass < cfgMinMgg || cfgMaxMgg < mass);
+  }
+
   /// \brief function to run the photon pairing
   /// \tparam TDetectorTag1 tag for TPhotons1 type to select the proper cut function and arguments
   /// \tparam TDetectorTag2 tag for TPhotons2 type to select the proper cut function and arguments
@@ -872,7 +983,7 @@ struct Pi0EtaToGammaGamma {
             ROOT::Math::PtEtaPhiMVector v_ele(ele2.pt(), ele2.eta(), ele2.phi(), o2::constants::physics::MassElectron);
             ROOT::Math::PtEtaPhiMVector v_ee = v_pos + v_ele;
             ROOT::Math::PtEtaPhiMVector veeg = v_gamma + v_pos + v_ele;
-            if (std::fabs(veeg.Rapidity()) > maxY) {
+            if (std::fabs(veeg.Rapidity()) > maxY || !isInMassWindow(veeg.M())) {
               continue;
             }
 
@@ -894,101 +1005,69 @@ struct Pi0EtaToGammaGamma {
         auto photons1_per_collision = photons1.sliceByCached(TDetectorTag1::perCollision(), collision.globalIndex(), cache);
         auto photons2_per_collision = photons2.sliceByCached(TDetectorTag2::perCollision(), collision.globalIndex(), cache);
 
-        for (const auto& [g1, g2] : o2::soa::combinations(TCombinationPolicy(photons1_per_collision, photons2_per_collision))) {
-          if constexpr (std::is_same_v<TDetectorTag1, EMCTag>) {
-            // For the EMCal case we need to get the primary and secondary matched tracks
-            auto matchedTracks1 = matchedTracks.sliceByCached(TDetectorTag1::perClusterMT(), g1.globalIndex(), cache);
-            auto matchedSecondaries1 = matchedSecondaries.sliceByCached(TDetectorTag1::perClusterMS(), g1.globalIndex(), cache);
-
-            if (!TDetectorTag1::applyCut(*this, g1, matchedTracks1, matchedSecondaries1)) {
-              continue;
-            }
-          } else {
-            if (!TDetectorTag1::applyCut(*this, g1) || !TDetectorTag2::applyCut(*this, g2)) {
-              continue;
-            }
+        // single photon cuts once per photon, then the pairs of the selected photons in the order of TCombinationPolicy
+        constexpr bool isPCMPCM = std::is_same_v<TDetectorTag1, PCMTag> && std::is_same_v<TDetectorTag2, PCMTag>;
+        selectPhotons<TDetectorTag1, isPCMPCM, TLegs>(photons1_per_collision, selected_photons1_per_col, false, matchedTracks, matchedSecondaries);
+        selectPhotons<TDetectorTag2, isPCMPCM, TLegs>(photons2_per_collision, selected_photons2_per_col, !std::is_same_v<TDetectorTag1, EMCTag>, matchedTracks, matchedSecondaries);
+        using TPhotonsPerCol1 = std::decay_t<decltype(photons1_per_collision)>;
+        using TPhotonsPerCol2 = std::decay_t<decltype(photons2_per_collision)>;
+        constexpr bool isStrictlyUpper = std::is_same_v<TCombinationPolicy<TPhotonsPerCol1, TPhotonsPerCol2>, o2::soa::CombinationsStrictlyUpperIndexPolicy<TPhotonsPerCol1, TPhotonsPerCol2>>;
+
+        const auto& sel1 = selected_photons1_per_col;
+        const auto& sel2 = selected_photons2_per_col;
+        const std::size_t nSelected2 = sel2.legs.size();
+        if (pair_mass.size() < nSelected2) {
+          pair_mass.resize(nSelected2);
+          pair_pt.resize(nSelected2);
+          pair_rapidity.resize(nSelected2);
+        }
+
+        for (std::size_t i1 = 0; i1 < sel1.legs.size(); i1++) {
+          std::size_t begin2 = 0;
+          if constexpr (isStrictlyUpper) {
+            begin2 = std::upper_bound(sel2.position.begin(), sel2.position.end(), sel1.position[i1]) - sel2.position.begin();
           }
+          o2::aod::pwgem::photonmeson::utils::pairutil::computeDiphotonKinematics(sel1.legs, i1, sel2.legs, begin2, nSelected2, pair_mass.data(), pair_pt.data(), pair_rapidity.data());
 
-          if constexpr (std::is_same_v<TDetectorTag2, EMCTag>) {
-            auto matchedTracks2 = matchedTracks.sliceByCached(TDetectorTag2::perClusterMT(), g2.globalIndex(), cache);
-            auto matchedSecondaries2 = matchedSecondaries.sliceByCached(TDetectorTag2::perClusterMS(), g2.globalIndex(), cache);
-            if (!TDetectorTag2::applyCut(*this, g2, matchedTracks2, matchedSecondaries2)) {
-              continue;
+          for (std::size_t i2 = begin2; i2 < nSelected2; i2++) {
+            const std::size_t ipair = i2 - begin2;
+            if constexpr (isPCMPCM) {
+              if (cfgDoPhotonClassPairCut.value &&
+                  !o2::aod::pwgem::photonmeson::utils::pairutil::isPairPhotonClassSelected(sel1.legCounts[i1], sel2.legCounts[i2], mPhotonClassSelA, mPhotonClassSelB)) {
+                continue;
+              }
             }
-          } else {
-            if (!TDetectorTag2::applyCut(*this, g2)) {
+            if (!isSelectedAlphaMeson(sel1.legs.energy[i1], sel2.legs.energy[i2], pair_pt[ipair])) {
               continue;
             }
-          }
-
-          o2::aod::pwgem::photonmeson::utils::pairutil::V0PhotonLegCounts legCounts1{}, legCounts2{};
-          if constexpr (std::is_same_v<TDetectorTag1, PCMTag> && std::is_same_v<TDetectorTag2, PCMTag>) {
-            auto pos1 = g1.template posTrack_as<TLegs>();
-            auto neg1 = g1.template negTrack_as<TLegs>();
-            auto pos2 = g2.template posTrack_as<TLegs>();
-            auto neg2 = g2.template negTrack_as<TLegs>();
-            legCounts1 = o2::aod::pwgem::photonmeson::utils::pairutil::getV0PhotonLegCounts(pos1, neg1);
-            legCounts2 = o2::aod::pwgem::photonmeson::utils::pairutil::getV0PhotonLegCounts(pos2, neg2);
-            if (cfgDoPhotonClassPairCut.value &&
-                !o2::aod::pwgem::photonmeson::utils::pairutil::isPairPhotonClassSelected(legCounts1, legCounts2, mPhotonClassSelA, mPhotonClassSelB)) {
+            if (std::fabs(pair_rapidity[ipair]) > maxY || !isInMassWindow(pair_mass[ipair])) {
               continue;
             }
-          }
-
-          ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-          if (std::fabs(v12.Rapidity()) > maxY) {
-            continue;
-          }
-
-          float alphaMeson = std::fabs(g1.e() - g2.e()) / (g1.e() + g2.e());
-          float alphaCut = 999.f;
-          switch (static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value)) {
-            case AlphaMesonCutOption::Off:
-              break;
-            case AlphaMesonCutOption::SpecificValue:
-              alphaCut = cfgAlphaMeson;
-              break;
-            case AlphaMesonCutOption::PTDependent: {
-              alphaCut = cfgAlphaMesonA * std::tanh(cfgAlphaMesonB * v12.pt());
-              break;
-            }
-            default:
-              LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
-          }
-          if (alphaMeson > alphaCut) {
-            continue;
-          }
-
-          float wpair = weight;
 
-          if constexpr (requires { g1.omegaMBWeight(); }) {
-            wpair *= g1.omegaMBWeight();
-          }
-          if constexpr (requires { g2.omegaMBWeight(); }) {
-            wpair *= g2.omegaMBWeight();
-          }
+            float wpair = weight;
+            wpair *= sel1.weight[i1];
+            wpair *= sel2.weight[i2];
 
-          fRegistry.fill(HIST("Pair/same/hs"), v12.M(), v12.Pt(), wpair);
+            fRegistry.fill(HIST("Pair/same/hs"), pair_mass[ipair], pair_pt[ipair], wpair);
 
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g1.globalIndex()) == used_photonIds_per_col.end()) {
-            auto emphoton1 = o2::aod::pwgem::photonmeson::utils::EMPhoton(g1.pt(), g1.eta(), g1.phi(), 0);
-            if constexpr (std::is_same_v<TDetectorTag1, PCMTag> && std::is_same_v<TDetectorTag2, PCMTag>) {
-              emphoton1.setLegCounts(legCounts1);
+            if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), sel1.globalIndex[i1]) == used_photonIds_per_col.end()) {
+              auto emphoton1 = o2::aod::pwgem::photonmeson::utils::EMPhoton(sel1.legs.pt[i1], sel1.legs.eta[i1], sel1.legs.phi[i1], 0);
+              if constexpr (isPCMPCM) {
+                emphoton1.setLegCounts(sel1.legCounts[i1]);
+              }
+              emh1->AddTrackToEventPool(key_df_collision, emphoton1);
+              used_photonIds_per_col.emplace_back(sel1.globalIndex[i1]);
             }
-            emh1->AddTrackToEventPool(key_df_collision, emphoton1);
-            used_photonIds_per_col.emplace_back(g1.globalIndex());
-          }
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g2.globalIndex()) == used_photonIds_per_col.end()) {
-            auto emphoton2 = o2::aod::pwgem::photonmeson::utils::EMPhoton(g2.pt(), g2.eta(), g2.phi(), 0);
-            if constexpr (std::is_same_v<TDetectorTag1, PCMTag> && std::is_same_v<TDetectorTag2, PCMTag>) {
-              emphoton2.setLegCounts(legCounts1);
+            if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), sel2.globalIndex[i2]) == used_photonIds_per_col.end()) {
+              auto emphoton2 = o2::aod::pwgem::photonmeson::utils::EMPhoton(sel2.legs.pt[i2], sel2.legs.eta[i2], sel2.legs.phi[i2], 0);
+              if constexpr (isPCMPCM) {
+                emphoton2.setLegCounts(sel1.legCounts[i1]);
+              }
+              emh2->AddTrackToEventPool(key_df_collision, emphoton2);
+              used_photonIds_per_col.emplace_back(sel2.globalIndex[i2]);
             }
-            emh2->AddTrackToEventPool(key_df_collision, emphoton2);
-            used_photonIds_per_col.emplace_back(g2.globalIndex());
+            ndiphoton++;
           }
-          ndiphoton++;
         } // end of pairing loop
       } // end of pairing in same event
 
@@ -1009,6 +1088,10 @@ struct Pi0EtaToGammaGamma {
       auto collisionIds1_in_mixing_pool = emh1->GetCollisionIdsFromEventPool(key_bin);
       auto collisionIds2_in_mixing_pool = emh2->GetCollisionIdsFromEventPool(key_bin);
 
+      constexpr bool isPCMDalitzEE = pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE; // dileptons from emh2 keep their mass
+      fillMixingLegs(selected_photons1_in_this_event, legs1_mix, false);
+      fillMixingLegs(selected_photons2_in_this_event, legs2_mix, isPCMDalitzEE);
+
       if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMPCM || pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPHOSPHOS || pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kEMCEMC) { // same kinds pairing
         for (const auto& mix_dfId_collisionId : collisionIds1_in_mixing_pool) {
           int mix_dfId = mix_dfId_collisionId.first;
@@ -1028,43 +1111,28 @@ struct Pi0EtaToGammaGamma {
           auto photons1_from_event_pool = emh1->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), ngamma = %d | event pool (%d, %d), ngamma = %d", ndf, collision.globalIndex(), selected_photons1_in_this_event.size(), mix_dfId, mix_collisionId, photons1_from_event_pool.size());
 
-          for (const auto& g1 : selected_photons1_in_this_event) {
-            for (const auto& g2 : photons1_from_event_pool) {
+          fillMixingLegs(photons1_from_event_pool, legs_pool, false);
+          for (std::size_t i1 = 0; i1 < legs1_mix.size(); i1++) {
+            o2::aod::pwgem::photonmeson::utils::pairutil::computeDiphotonKinematics(legs1_mix, i1, legs_pool, 0, legs_pool.size(), pair_mass.data(), pair_pt.data(), pair_rapidity.data());
+            for (std::size_t i2 = 0; i2 < legs_pool.size(); i2++) {
               if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMPCM) {
                 if (cfgDoPhotonClassPairCut.value) {
+                  const auto& g1 = selected_photons1_in_this_event[i1];
+                  const auto& g2 = photons1_from_event_pool[i2];
                   if (!g1.hasLegCounts() || !g2.hasLegCounts() ||
                       !o2::aod::pwgem::photonmeson::utils::pairutil::isPairPhotonClassSelected(g1.legCounts(), g2.legCounts(), mPhotonClassSelA, mPhotonClassSelB)) {
                     continue;
                   }
                 }
               }
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
-                continue;
-              }
               // as photon has mass= 0 e = p
-              float alphaMeson = std::fabs(g1.p() - g2.p()) / (g1.p() + g2.p());
-              float alphaCut = 999.f;
-              switch (static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value)) {
-                case AlphaMesonCutOption::Off:
-                  break;
-                case AlphaMesonCutOption::SpecificValue:
-                  alphaCut = cfgAlphaMeson;
-                  break;
-                case AlphaMesonCutOption::PTDependent: {
-                  alphaCut = cfgAlphaMesonA * std::tanh(cfgAlphaMesonB * v12.pt());
-                  break;
-                }
-                default:
-                  LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
+              if (!isSelectedAlphaMeson(legs1_mix.energy[i1], legs_pool.energy[i2], pair_pt[i2])) {
+                continue;
               }
-              if (alphaMeson > alphaCut) {
+              if (std::fabs(pair_rapidity[i2]) > maxY || !isInMassWindow(pair_mass[i2])) {
                 continue;
               }
-
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
+              fRegistry.fill(HIST("Pair/mix/hs"), pair_mass[i2], pair_pt[i2], weight);
             }
           }
         } // end of loop over mixed event pool
@@ -1088,18 +1156,14 @@ struct Pi0EtaToGammaGamma {
           auto photons2_from_event_pool = emh2->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), ngamma = %d | event pool (%d, %d), nll = %d", ndf, collision.globalIndex(), selected_photons1_in_this_event.size(), mix_dfId, mix_collisionId, photons2_from_event_pool.size());
 
-          for (const auto& g1 : selected_photons1_in_this_event) {
-            for (const auto& g2 : photons2_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
-                v2.SetM(g2.mass());
-              }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
+          fillMixingLegs(photons2_from_event_pool, legs_pool, isPCMDalitzEE); //[photon from event1, dilepton from event2]
+          for (std::size_t i1 = 0; i1 < legs1_mix.size(); i1++) {
+            o2::aod::pwgem::photonmeson::utils::pairutil::computeDiphotonKinematics(legs1_mix, i1, legs_pool, 0, legs_pool.size(), pair_mass.data(), pair_pt.data(), pair_rapidity.data());
+            for (std::size_t i2 = 0; i2 < legs_pool.size(); i2++) {
+              if (std::fabs(pair_rapidity[i2]) > maxY || !isInMassWindow(pair_mass[i2])) {
                 continue;
               }
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
+              fRegistry.fill(HIST("Pair/mix/hs"), pair_mass[i2], pair_pt[i2], weight);
             }
           }
         } // end of loop over mixed event pool
@@ -1121,18 +1185,14 @@ struct Pi0EtaToGammaGamma {
           auto photons1_from_event_pool = emh1->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), nll = %d | event pool (%d, %d), ngamma = %d", ndf, collision.globalIndex(), selected_photons2_in_this_event.size(), mix_dfId, mix_collisionId, photons1_from_event_pool.size());
 
-          for (const auto& g1 : selected_photons2_in_this_event) {
-            for (const auto& g2 : photons1_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
-                v1.SetM(g1.mass());
-              }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
+          fillMixingLegs(photons1_from_event_pool, legs_pool, false); //[photon from event2, dilepton from event1]
+          for (std::size_t i1 = 0; i1 < legs2_mix.size(); i1++) {
+            o2::aod::pwgem::photonmeson::utils::pairutil::computeDiphotonKinematics(legs2_mix, i1, legs_pool, 0, legs_pool.size(), pair_mass.data(), pair_pt.data(), pair_rapidity.data());
+            for (std::size_t i2 = 0; i2 < legs_pool.size(); i2++) {
+              if (std::fabs(pair_rapidity[i2]) > maxY || !isInMassWindow(pair_mass[i2])) {
                 continue;
               }
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
+              fRegistry.fill(HIST("Pair/mix/hs"), pair_mass[i2], pair_pt[i2], weight);
             }
           }
         } // end of loop over mixed event pool
@@ -22,6 +22,8 @@
 #include <Framework/Concepts.h>
 
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 namespace o2::aod::pwgem::photonmeson::utils::pairutil
 {
@@ -148,6 +150,73 @@ V0PhotonClassSelection buildV0PhotonClassSelection(TGroup const& g)
   s.maxTOF = g.cfgMaxNLegsTOF.value;
   return s;
 }
+
+// ─── diphoton pairing kernel ──────────────────────────────────────────────
+
+/// \brief photon kinematics in SoA layout, computed once per photon and shared by all the pairs it enters
+struct DiphotonLegs {
+  std::vector<float> pt, eta, phi;
+  std::vector<float> energy; // energy entering the pair asymmetry
+  std::vector<double> px, py, pz, e;
+
+  [[nodiscard]] std::size_t size() const { return px.size(); }
+
+  void clear()
+  {
+    pt.clear();
+    eta.clear();
+    phi.clear();
+    energy.clear();
+    px.clear();
+    py.clear();
+    pz.clear();
+    e.clear();
+  }
+
+  /// components evaluated as for ROOT::Math::PtEtaPhiMVector(pt, eta, phi, mass) with mass >= 0, including its phi range restriction
+  void add(float ptIn, float etaIn, float phiIn, float mass, float energyIn)
+  {
+    pt.push_back(ptIn);
+    eta.push_back(etaIn);
+    phi.push_back(phiIn);
+    energy.push_back(energyIn);
+    double phiD = phiIn;
+    if (phiD <= -M_PI || phiD > M_PI) {
+      phiD = phiD - std::floor(phiD / (2 * M_PI) + .5) * 2 * M_PI;
+    }
+    const double ptD = ptIn;
+    const double p = ptD * std::cosh(static_cast<double>(etaIn));
+    const double e2 = p * p + static_cast<double>(mass) * mass;
+    px.push_back(ptD * std::cos(phiD));
+    py.push_back(ptD * std::sin(phiD));
+    pz.push_back(ptD * std::sinh(static_cast<double>(etaIn)));
+    e.push_back(std::sqrt(e2 > 0 ? e2 : 0));
+  }
+};
+
+/// \brief mass, pT and rapidity of the pairs of photon i of legs1 with photons [begin, end) of legs2, written at [0, end - begin) of the outputs
+/// Mass and pT are evaluated as for the sum of two ROOT::Math::PtEtaPhiMVector, the loop body has no trigonometric calls and no conversions between coordinate systems
+inline void computeDiphotonKinematics(DiphotonLegs const& legs1, const std::size_t i, DiphotonLegs const& legs2, const std::size_t begin, const std::size_t end, double* mass, double* pt, double* rapidity)
+{
+  const double px1 = legs1.px[i];
+  const double py1 = legs1.py[i];
+  const double pz1 = legs1.pz[i];
+  const double e1 = legs1.e[i];
+  const double* px2 = legs2.px.data();
+  const double* py2 = legs2.py.data();
+  const double* pz2 = legs2.pz.data();
+  const double* e2 = legs2.e.data();
+  for (std::size_t j = begin; j < end; j++) {
+    const double px = px1 + px2[j];
+    const double py = py1 + py2[j];
+    const double pz = pz1 + pz2[j];
+    const double e = e1 + e2[j];
+    const double m2 = e * e - px * px - py * py - pz * pz;
+    mass[j - begin] = m2 >= 0 ? std::sqrt(m2) : -std::sqrt(-m2);
+    pt[j - begin] = std::sqrt(px * px + py * py);
+    rapidity[j - begin] = 0.5 * std::log((e + pz) / (e - pz));
+  }
+}
 } // namespace o2::aod::pwgem::photonmeson::utils::pairutil
 
 #endif // PWGEM_PHOTONMESON_UTILS_PAIRUTILITIES_H_
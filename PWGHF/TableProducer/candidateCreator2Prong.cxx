@@ -33,6 +33,7 @@
 #include "PWGHF/Utils/utilsTrkCandHf.h"
 #include "PWGLF/DataModel/mcCentrality.h"
 
+#include "Common/Core/McAncestryIndex.h"
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/ZorroSummary.h"
 #include "Common/Core/trackUtilities.h"
@@ -829,6 +830,7 @@ struct HfCandidateCreator2ProngExpressions {
   Configurable<bool> matchCorrelatedBackground{"matchCorrelatedBackground", false, "Match correlated background candidates"};
 
   HfEventSelectionMc hfEvSelMc; // mc event selection and monitoring
+  o2::common::core::McAncestryIndex mcAncestryIndex; // family tree of the MC particles, used for the matching of reconstructed candidates
 
   using McCollisionsNoCents = soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels>;
   using McCollisionsFT0Cs = soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels, aod::CentFT0Cs>;
@@ -870,6 +872,8 @@ struct HfCandidateCreator2ProngExpressions {
                           BCsInfo const&)
   {
     rowCandidateProng2->bindExternalIndices(&tracks);
+    // the mother and daughter walks of all candidates run on the index instead of the table
+    mcAncestryIndex.build(mcParticles);
 
     int indexRec = -1;
     int8_t sign = 0;
@@ -887,6 +891,7 @@ struct HfCandidateCreator2ProngExpressions {
       flagChannelResonant = 0;
       origin = 0;
       auto arrayDaughters = std::array{candidate.prong0_as<aod::TracksWMc>(), candidate.prong1_as<aod::TracksWMc>()};
+      auto arrayDaughtersMc = mcAncestryIndex.prongs(arrayDaughters);
 
       // Check whether the particle is from background events. If so, reject it.
       if (rejectBackground) {
@@ -917,32 +922,32 @@ struct HfCandidateCreator2ProngExpressions {
           std::array<int, 2> const arrPdgDaughtersMain2Prongs = std::array{finalState[0], finalState[1]};
           if (finalState.size() == 3) { // o2-linter: disable=magic-number (partially reconstructed 3-prong decays)
             if (matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial);
             } else if (matchKinkedDecayTopology && !matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, false>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks);
             } else if (!matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial);
             } else {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, false>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth);
             }
 
             if (indexRec > -1) {
-              auto motherParticle = mcParticles.rawIteratorAt(indexRec);
+              auto motherParticle = mcAncestryIndex.rawIteratorAt(indexRec);
               std::array<int, 3> arrPdgDaughtersMain3Prongs = std::array{finalState[0], finalState[1], finalState[2]};
               flipPdgSign(motherParticle.pdgCode(), +kPi0, arrPdgDaughtersMain3Prongs);
-              if (!RecoDecay::isMatchedMCGen(mcParticles, motherParticle, Pdg::kD0, arrPdgDaughtersMain3Prongs, true, &sign, FinalStateDepth)) {
+              if (!RecoDecay::isMatchedMCGen(mcAncestryIndex, motherParticle, Pdg::kD0, arrPdgDaughtersMain3Prongs, true, &sign, FinalStateDepth)) {
                 indexRec = -1; // Reset indexRec if the generated decay does not match the reconstructed one
               }
             }
           } else if (finalState.size() == 2) { // o2-linter: disable=magic-number (fully reconstructed 2-prong decays)
             if (matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial);
             } else if (matchKinkedDecayTopology && !matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks);
             } else if (!matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial);
             } else {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, false>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth);
             }
           } else {
             LOG(fatal) << "Final state size not supported: " << finalState.size();
@@ -953,11 +958,11 @@ struct HfCandidateCreator2ProngExpressions {
 
             // Flag the resonant decay channel
             std::vector<int> arrResoDaughIndex = {};
-            RecoDecay::getDaughters(mcParticles.rawIteratorAt(indexRec), &arrResoDaughIndex, std::array{0}, ResoDepth);
+            RecoDecay::getDaughters(mcAncestryIndex.rawIteratorAt(indexRec), &arrResoDaughIndex, std::array{0}, ResoDepth);
             std::array<int, NDaughtersResonant> arrPdgDaughters = {};
             if (arrResoDaughIndex.size() == NDaughtersResonant) {
               for (auto iProng = 0u; iProng < arrResoDaughIndex.size(); ++iProng) {
-                auto daughI = mcParticles.rawIteratorAt(arrResoDaughIndex[iProng]);
+                auto daughI = mcAncestryIndex.rawIteratorAt(arrResoDaughIndex[iProng]);
                 arrPdgDaughters[iProng] = daughI.pdgCode();
               }
               flagChannelResonant = getDecayChannelResonant(Pdg::kD0, arrPdgDaughters);
@@ -968,13 +973,13 @@ struct HfCandidateCreator2ProngExpressions {
       } else {
         // D0(bar) → π± K∓
         if (matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks, &nInteractionsWithMaterial);
+          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks, &nInteractionsWithMaterial);
         } else if (matchKinkedDecayTopology && !matchInteractionsWithMaterial) {
-          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks);
+          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks);
         } else if (!matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-          indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
+          indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
         } else {
-          indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign);
+          indexRec = RecoDecay::getMatchedMCRec(mcAncestryIndex, arrayDaughtersMc, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign);
         }
         if (indexRec > -1) {
           flagChannelMain = sign * DecayChannelMain::D0ToPiK;
@@ -983,9 +988,9 @@ struct HfCandidateCreator2ProngExpressions {
         // J/ψ → e+ e−
         if (flagChannelMain == 0) {
           if (matchInteractionsWithMaterial) {
-            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
+            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
           } else {
-            indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true);
+            indexRec = RecoDecay::getMatchedMCRec(mcAncestryIndex, arrayDaughtersMc, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true);
           }
           if (indexRec > -1) {
             flagChannelMain = DecayChannelMain::JpsiToEE;
@@ -995,9 +1000,9 @@ struct HfCandidateCreator2ProngExpressions {
         // J/ψ → μ+ μ−
         if (flagChannelMain == 0) {
           if (matchInteractionsWithMaterial) {
-            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
+            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcAncestryIndex, arrayDaughtersMc, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
           } else {
-            indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true);
+            indexRec = RecoDecay::getMatchedMCRec(mcAncestryIndex, arrayDaughtersMc, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true);
           }
           if (indexRec > -1) {
             flagChannelMain = DecayChannelMain::JpsiToMuMu;
@@ -1007,8 +1012,8 @@ struct HfCandidateCreator2ProngExpressions {
 
       // Check whether the particle is non-prompt (from a b quark).
       if (flagChannelMain != 0) {
-        auto particle = mcParticles.rawIteratorAt(indexRec);
-        origin = RecoDecay::getCharmHadronOrigin(mcParticles, particle, false, &idxBhadMothers);
+        auto particle = mcAncestryIndex.rawIteratorAt(indexRec);
+        origin = RecoDecay::getCharmHadronOrigin(mcAncestryIndex, particle, false, &idxBhadMothers);
       }
       if (origin == RecoDecay::OriginType::NonPrompt) {
         auto bHadMother = mcParticles.rawIteratorAt(idxBhadMothers[0]);
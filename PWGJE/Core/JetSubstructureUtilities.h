@@ -31,6 +31,8 @@
 #include <fastjet/contrib/SoftDrop.hh>
 
 #include <cmath>
+#include <cstddef>
+#include <memory>
 #include <type_traits>
 #include <vector>
 
@@ -74,6 +76,124 @@ fastjet::ClusterSequenceArea jetToPseudoJet(T const& jet, U const& /*tracks*/, V
   return clusterSeq;
 }
 
+/**
+ * Primary declustering history of a reclustered jet
+ *
+ * The constituents are reclustered once (C/A or kT, as set in the reclusterer) and the chain of
+ * splittings obtained by following the harder branch is stored in flat arrays. Soft drop for any
+ * zcut/beta, the groomed jet and the Lund-plane splittings can then be taken from the stored chain
+ * by several observables without reclustering the jet again. The PseudoJets stay valid (with their
+ * constituents) until the next call to recluster.
+ */
+class JetReclusteringHistory
+{
+ public:
+  /**
+   * recluster the constituents and store the primary declustering chain of the hardest jet
+   *
+   * @param constituents constituents of the jet
+   * @param reclusterer jet finder configured for reclustering
+   */
+  void recluster(std::vector<fastjet::PseudoJet>& constituents, JetFinder& reclusterer)
+  {
+    clear();
+    std::vector<fastjet::PseudoJet> jetReclustered;
+    mClusterSeq.reset(new fastjet::ClusterSequenceArea(reclusterer.findJets(constituents, jetReclustered)));
+    if (jetReclustered.empty()) {
+      return;
+    }
+    jetReclustered = sorted_by_pt(jetReclustered);
+    fastjet::PseudoJet daughterSubJet = jetReclustered[0];
+    fastjet::PseudoJet parentSubJet1;
+    fastjet::PseudoJet parentSubJet2;
+    while (daughterSubJet.has_parents(parentSubJet1, parentSubJet2)) {
+      if (parentSubJet1.perp() < parentSubJet2.perp()) {
+        std::swap(parentSubJet1, parentSubJet2);
+      }
+      mMothers.push_back(daughterSubJet);
+      mHarder.push_back(parentSubJet1);
+      mSofter.push_back(parentSubJet2);
+      mZ.push_back(parentSubJet2.perp() / (parentSubJet1.perp() + parentSubJet2.perp()));
+      mTheta.push_back(parentSubJet1.delta_R(parentSubJet2));
+      daughterSubJet = parentSubJet1;
+    }
+    mMothers.push_back(daughterSubJet); // the last branch, which cannot be declustered further
+  }
+
+  void clear()
+  {
+    mMothers.clear();
+    mHarder.clear();
+    mSofter.clear();
+    mZ.clear();
+    mTheta.clear();
+  }
+
+  /// true if a jet was found by the last reclustering
+  bool hasJet() const { return !mMothers.empty(); }
+  /// reclustered jet, before any declustering
+  const fastjet::PseudoJet& jet() const { return mMothers.front(); }
+  /// number of primary splittings
+  std::size_t size() const { return mZ.size(); }
+
+  /// subjet declustered at splitting i (splittings ordered from the first declustering)
+  const fastjet::PseudoJet& mother(std::size_t i) const { return mMothers[i]; }
+  /// harder (higher pt) branch of splitting i, which is declustered at splitting i + 1
+  const fastjet::PseudoJet& harder(std::size_t i) const { return mHarder[i]; }
+  /// softer branch of splitting i
+  const fastjet::PseudoJet& softer(std::size_t i) const { return mSofter[i]; }
+  /// momentum sharing fraction of splitting i, ptSofter / (ptHarder + ptSofter)
+  double z(std::size_t i) const { return mZ[i]; }
+  /// opening angle between the two branches of splitting i
+  double theta(std::size_t i) const { return mTheta[i]; }
+
+  /// soft drop condition z >= zCut * (theta / r0)^beta for splitting i
+  bool passesSoftDrop(std::size_t i, float zCut, float beta, float r0) const
+  {
+    return mZ[i] >= zCut * std::pow(mTheta[i] / r0, beta);
+  }
+
+  /**
+   * first splitting passing the soft drop condition
+   *
+   * @return index of the splitting, size() if none passes
+   */
+  std::size_t softDropSplitting(float zCut, float beta, float r0) const
+  {
+    std::size_t i = 0;
+    while (i < size() && !passesSoftDrop(i, zCut, beta, r0)) {
+      i++;
+    }
+    return i;
+  }
+
+  /// number of splittings passing the soft drop condition
+  int nSoftDrop(float zCut, float beta, float r0) const
+  {
+    int nsd = 0;
+    for (std::size_t i = 0; i < size(); i++) {
+      if (passesSoftDrop(i, zCut, beta, r0)) {
+        nsd++;
+      }
+    }
+    return nsd;
+  }
+
+  /// jet groomed with soft drop (grooming mode: the last branch is kept if no splitting passes)
+  const fastjet::PseudoJet& softDropGroomedJet(float zCut, float beta, float r0) const
+  {
+    return mMothers[softDropSplitting(zCut, beta, r0)];
+  }
+
+ private:
+  std::unique_ptr<fastjet::ClusterSequenceArea> mClusterSeq;
+  std::vector<fastjet::PseudoJet> mMothers; // size() + 1 entries, the last one is the final branch
+  std::vector<fastjet::PseudoJet> mHarder;
+  std::vector<fastjet::PseudoJet> mSofter;
+  std::vector<double> mZ;
+  std::vector<double> mTheta;
+};
+
 /**
  * returns a vector with Nsubjettiness variables
  *
@@ -118,6 +238,43 @@ std::vector<float> getNSubjettiness(T const& jet, U const& tracks, V const& clus
   return result;
 }
 
+/**
+ * returns a vector with Nsubjettiness variables, computed on an existing reclustering of the jet
+ *
+ * @param history reclustering history of the jet
+ * @param jetR jet radius used in the normalisation of the measure
+ * @param nMax returns a vector filled with TauN values upto N (the first entry is the distance between axes in tau2)
+ * @param reclusteringAlgorithm type of reclustering algorithm used to find Nsubjettiness axes
+ * @param doSoftDrop apply SoftDrop, taking the groomed jet from the history
+ * @param zCut minimim momentum sharing fraction needed to satisfy the SoftDrop condition
+ * @param beta angular exponent in the SoftDrop condition (with R0 = 1, as fastjet::contrib::SoftDrop)
+ */
+template <typename M>
+std::vector<float> getNSubjettiness(JetReclusteringHistory const& history, float jetR, std::vector<fastjet::PseudoJet>::size_type nMax, M const& reclusteringAlgorithm, bool doSoftDrop = false, float zCut = 0.1, float beta = 0.0)
+{
+  std::vector<float> result;
+  for (std::vector<fastjet::PseudoJet>::size_type n = 0; n < nMax + 1; n++) {
+    result.push_back(-1.0 * (n + 1));
+  }
+  if (!history.hasJet()) {
+    return result;
+  }
+  const fastjet::PseudoJet& pseudoJet = doSoftDrop ? history.softDropGroomedJet(zCut, beta, 1.0) : history.jet();
+
+  for (std::vector<fastjet::PseudoJet>::size_type n = 1; n <= nMax; n++) {
+    if (pseudoJet.constituents().size() < n) { // Tau_N needs at least N tracks
+      return result;
+    }
+    fastjet::contrib::Nsubjettiness nSub(n, reclusteringAlgorithm, fastjet::contrib::NormalizedMeasure(1.0, jetR));
+    result[n] = nSub.result(pseudoJet);
+    if (n == 2) {
+      std::vector<fastjet::PseudoJet> nSubAxes = nSub.currentAxes(); // gets the two axes used in the 2-subjettiness calculation
+      result[0] = nSubAxes[0].delta_R(nSubAxes[1]);                  // distance between axes for 2-subjettiness
+    }
+  }
+  return result;
+}
+
 }; // namespace jetsubstructureutilities
 
 #endif // PWGJE_CORE_JETSUBSTRUCTUREUTILITIES_H_
@@ -22,6 +22,7 @@
 
 #include "Common/Core/RecoDecay.h"
 
+#include <CommonConstants/MathConstants.h>
 #include <CommonConstants/PhysicsConstants.h>
 #include <Framework/Logger.h>
 
@@ -38,6 +39,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <span>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -198,15 +200,87 @@ int getOriginalHFMotherIndex(const typename T::iterator& hfparticle)
   return -1.0;
 }
 
+/**
+ * Memoizes RecoDecay::getParticleOrigin and getOriginalHFMotherIndex per particle, so that the mother
+ * chains of particles shared by several jets (e.g. jets of different radii) are walked only once.
+ * Entries are indexed by the position of the particle in the table; reset() is O(1) and should be called
+ * whenever the particle table or the collision changes.
+ */
+class HfShowerOriginCache
+{
+ public:
+  template <typename U>
+  void reset(U const& particles)
+  {
+    mOffset = particles.offset();
+    const auto size = static_cast<std::size_t>(particles.size());
+    if (mStamp.size() < size) {
+      mStamp.resize(size, 0);
+      mSlots.resize(size);
+    }
+    mGeneration += 1;
+  }
+
+  template <typename U>
+  int getParticleOrigin(U const& particles, typename U::iterator const& particle, bool searchUpToQuark)
+  {
+    Slot& slot = getSlot(particle.globalIndex());
+    const int flag = searchUpToQuark ? 1 : 0;
+    if (!(slot.known & (KnownOrigin << flag))) {
+      slot.origin[flag] = RecoDecay::getParticleOrigin(particles, particle, searchUpToQuark);
+      slot.known |= KnownOrigin << flag;
+    }
+    return slot.origin[flag];
+  }
+
+  template <typename U>
+  int getOriginalHFMotherIndex(typename U::iterator const& hfparticle)
+  {
+    Slot& slot = getSlot(hfparticle.globalIndex());
+    if (!(slot.known & KnownHfMother)) {
+      slot.hfMother = jettaggingutilities::getOriginalHFMotherIndex<U>(hfparticle);
+      slot.known |= KnownHfMother;
+    }
+    return slot.hfMother;
+  }
+
+ private:
+  static constexpr uint8_t KnownOrigin = 1;   // bits 0 and 1: origin without / with search up to quark
+  static constexpr uint8_t KnownHfMother = 4; // bit 2: original HF mother
+
+  struct Slot {
+    uint8_t known;
+    std::array<int8_t, 2> origin;
+    int hfMother;
+  };
+
+  int64_t mOffset = 0;
+  uint32_t mGeneration = 0;
+  std::vector<uint32_t> mStamp;
+  std::vector<Slot> mSlots;
+
+  Slot& getSlot(int64_t globalIndex)
+  {
+    const auto position = static_cast<std::size_t>(globalIndex - mOffset);
+    Slot& slot = mSlots[position];
+    if (mStamp[position] != mGeneration) {
+      mStamp[position] = mGeneration;
+      slot = {0, {0, 0}, -1};
+    }
+    return slot;
+  }
+};
+
 /**
  * checks if atrack in a reco level jet originates from a HF shower. 0:no HF shower, 1:charm shower, 2:beauty shower. The first track originating from an HF shower can be extracted by reference
  *
  * @param jet
  * @param particles table of generator level particles to be searched through
  * @param hftrack track passed as reference which is then replaced by the first track that originated from an HF shower
+ * @param cache optional memo of the particle origins, see HfShowerOriginCache
  */
 template <typename T, typename U, typename V>
-int jetTrackFromHFShower(T const& jet, U const& /*tracks*/, V const& particles, typename U::iterator& hftrack, bool searchUpToQuark)
+int jetTrackFromHFShower(T const& jet, U const& /*tracks*/, V const& particles, typename U::iterator& hftrack, bool searchUpToQuark, HfShowerOriginCache* cache = nullptr)
 {
 
   bool hasMcParticle = false;
@@ -218,7 +292,7 @@ int jetTrackFromHFShower(T const& jet, U const& /*tracks*/, V const& particles,
     }
     hasMcParticle = true;
     auto const& particle = track.template mcParticle_as<V>();
-    origin = RecoDecay::getParticleOrigin(particles, particle, searchUpToQuark);
+    origin = cache ? cache->getParticleOrigin(particles, particle, searchUpToQuark) : RecoDecay::getParticleOrigin(particles, particle, searchUpToQuark);
     if (origin == RecoDecay::OriginType::Prompt || origin == RecoDecay::OriginType::NonPrompt) { // 1=charm , 2=beauty
       hftrack = track;
       if (origin == RecoDecay::OriginType::Prompt) {
@@ -243,14 +317,15 @@ int jetTrackFromHFShower(T const& jet, U const& /*tracks*/, V const& particles,
  * @param jet
  * @param particles table of generator level particles to be searched through
  * @param hfparticle particle passed as reference which is then replaced by the first track that originated from an HF shower
+ * @param cache optional memo of the particle origins, see HfShowerOriginCache
  */
 template <typename T, typename U>
-int jetParticleFromHFShower(T const& jet, U const& particles, typename U::iterator& hfparticle, bool searchUpToQuark)
+int jetParticleFromHFShower(T const& jet, U const& particles, typename U::iterator& hfparticle, bool searchUpToQuark, HfShowerOriginCache* cache = nullptr)
 {
 
   for (const auto& particle : jet.template tracks_as<U>()) {
     hfparticle = particle; // for init if origin is 1 or 2, the particle is not hfparticle
-    int origin = RecoDecay::getParticleOrigin(particles, particle, searchUpToQuark);
+    int origin = cache ? cache->getParticleOrigin(particles, particle, searchUpToQuark) : RecoDecay::getParticleOrigin(particles, particle, searchUpToQuark);
     if (origin == RecoDecay::OriginType::Prompt || origin == RecoDecay::OriginType::NonPrompt) { // 1=charm , 2=beauty
       hfparticle = particle;
       if (origin == RecoDecay::OriginType::Prompt) {
@@ -270,21 +345,22 @@ int jetParticleFromHFShower(T const& jet, U const& particles, typename U::iterat
  * @param jet
  * @param particles table of generator level particles to be searched through
  * @param dRMax maximum distance in eta-phi of initiating heavy-flavour quark from the jet axis
+ * @param cache optional memo of the particle origins and HF mothers, see HfShowerOriginCache
  */
 
 template <typename T, typename U, typename V>
-int mcdJetFromHFShower(T const& jet, U const& tracks, V const& particles, float dRMax = 0.25, bool searchUpToQuark = false)
+int mcdJetFromHFShower(T const& jet, U const& tracks, V const& particles, float dRMax = 0.25, bool searchUpToQuark = false, HfShowerOriginCache* cache = nullptr)
 {
 
   typename U::iterator hftrack;
-  int origin = jetTrackFromHFShower(jet, tracks, particles, hftrack, searchUpToQuark);
+  int origin = jetTrackFromHFShower(jet, tracks, particles, hftrack, searchUpToQuark, cache);
   if (origin == JetTaggingSpecies::charm || origin == JetTaggingSpecies::beauty) {
     if (!hftrack.has_mcParticle()) {
       return JetTaggingSpecies::none;
     }
     auto const& hfparticle = hftrack.template mcParticle_as<V>();
 
-    int originalHFMotherIndex = getOriginalHFMotherIndex<V>(hfparticle);
+    int originalHFMotherIndex = cache ? cache->getOriginalHFMotherIndex<V>(hfparticle) : getOriginalHFMotherIndex<V>(hfparticle);
     if (originalHFMotherIndex > -1.0) {
 
       if (jetutilities::deltaR(jet, particles.iteratorAt(originalHFMotherIndex)) < dRMax) {
@@ -311,17 +387,18 @@ int mcdJetFromHFShower(T const& jet, U const& tracks, V const& particles, float
  * @param jet
  * @param particles table of generator level particles to be searched through
  * @param dRMax maximum distance in eta-phi of initiating heavy-flavour quark from the jet axis
+ * @param cache optional memo of the particle origins and HF mothers, see HfShowerOriginCache
  */
 
 template <typename T, typename U>
-int mcpJetFromHFShower(T const& jet, U const& particles, float dRMax = 0.25, bool searchUpToQuark = false)
+int mcpJetFromHFShower(T const& jet, U const& particles, float dRMax = 0.25, bool searchUpToQuark = false, HfShowerOriginCache* cache = nullptr)
 {
 
   typename U::iterator hfparticle;
-  int origin = jetParticleFromHFShower(jet, particles, hfparticle, searchUpToQuark);
+  int origin = jetParticleFromHFShower(jet, particles, hfparticle, searchUpToQuark, cache);
   if (origin == JetTaggingSpecies::charm || origin == JetTaggingSpecies::beauty) {
 
-    int originalHFMotherIndex = getOriginalHFMotherIndex<U>(hfparticle);
+    int originalHFMotherIndex = cache ? cache->getOriginalHFMotherIndex<U>(hfparticle) : getOriginalHFMotherIndex<U>(hfparticle);
     if (originalHFMotherIndex > -1.0) {
 
       if (jetutilities::deltaR(jet, particles.iteratorAt(originalHFMotherIndex)) < dRMax) {
@@ -486,6 +563,273 @@ int16_t getJetFlavorHadron(AnyJet const& jet, AllMCParticles const& mcparticles)
   return JetTaggingSpecies::lightflavour; // Light flavor jet
 }
 
+/**
+ * Particles of one MC collision sorted into cells of an eta-phi grid, with phi wrapping around, so that
+ * the particles within a cone around a jet axis can be found without looping over the whole collision.
+ * The cells visited for a cone are chosen conservatively, the exact distance is left to the caller.
+ */
+class EtaPhiGrid
+{
+ public:
+  struct Entry {
+    float eta;
+    float phi;
+    int index; // globalIndex of the particle
+    int kind;  // user defined, e.g. absolute PDG code of the parton or flavour of the hadron
+  };
+
+  static constexpr float DefaultCellSize = 0.2;
+  static constexpr float EtaMax = 6.; // particles beyond are kept in the outermost eta cells
+
+  explicit EtaPhiGrid(float cellSize = DefaultCellSize)
+  {
+    mNEta = std::max(1, static_cast<int>(std::ceil(2 * EtaMax / cellSize)));
+    mNPhi = std::max(1, static_cast<int>(std::ceil(o2::constants::math::TwoPI / cellSize)));
+    mCellEta = 2 * EtaMax / mNEta;
+    mCellPhi = o2::constants::math::TwoPI / mNPhi;
+  }
+
+  void clear()
+  {
+    mPending.clear();
+    mEntries.clear();
+    mCellStart.clear();
+  }
+
+  /// Adds a particle, entries with non-finite coordinates can never be inside a cone and are dropped
+  void add(float eta, float phi, int index, int kind)
+  {
+    if (std::isfinite(eta) && std::isfinite(phi)) {
+      mPending.push_back({eta, phi, index, kind});
+    }
+  }
+
+  /// Sorts the added particles into the cells, must be called before the lookups
+  void build()
+  {
+    mCellStart.assign(mNEta * mNPhi + 1, 0);
+    for (const auto& entry : mPending) {
+      mCellStart[cellIndex(entry.eta, entry.phi) + 1]++;
+    }
+    for (std::size_t i = 1; i < mCellStart.size(); i++) {
+      mCellStart[i] += mCellStart[i - 1];
+    }
+    mEntries.resize(mPending.size());
+    std::vector<int> fill(mCellStart.begin(), mCellStart.end() - 1);
+    for (const auto& entry : mPending) {
+      mEntries[fill[cellIndex(entry.eta, entry.phi)]++] = entry;
+    }
+    mPending.clear();
+  }
+
+  /// Calls f(entry) for all entries in the cells overlapping the cone, until f returns true
+  template <typename F>
+  void forEachInCone(float eta, float phi, float radius, F&& f) const
+  {
+    if (mEntries.empty() || !std::isfinite(eta) || !std::isfinite(phi)) {
+      return;
+    }
+    const double reach = radius + Margin;
+    const int etaLow = etaCell(eta - reach);
+    const int etaHigh = etaCell(eta + reach);
+    const double phiWrapped = RecoDecay::constrainAngle(static_cast<double>(phi), 0.);
+    int phiLow = static_cast<int>(std::floor((phiWrapped - reach) / mCellPhi));
+    int phiHigh = static_cast<int>(std::floor((phiWrapped + reach) / mCellPhi));
+    if (phiHigh - phiLow + 1 >= mNPhi) {
+      phiLow = 0;
+      phiHigh = mNPhi - 1;
+    }
+    for (int iEta = etaLow; iEta <= etaHigh; iEta++) {
+      for (int iPhi = phiLow; iPhi <= phiHigh; iPhi++) {
+        const int cell = iEta * mNPhi + ((iPhi % mNPhi) + mNPhi) % mNPhi;
+        for (int i = mCellStart[cell]; i < mCellStart[cell + 1]; i++) {
+          if (f(mEntries[i])) {
+            return;
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr double Margin = 1e-3; // covers rounding differences with respect to the float distance of the caller
+
+  int mNEta;
+  int mNPhi;
+  double mCellEta;
+  double mCellPhi;
+  std::vector<Entry> mPending;
+  std::vector<Entry> mEntries;
+  std::vector<int> mCellStart;
+
+  int etaCell(double eta) const
+  {
+    return static_cast<int>(std::clamp(std::floor((eta + EtaMax) / mCellEta), 0., mNEta - 1.));
+  }
+  int cellIndex(float eta, float phi) const
+  {
+    const int iPhi = std::min(static_cast<int>(RecoDecay::constrainAngle(static_cast<double>(phi), 0.) / mCellPhi), mNPhi - 1);
+    return etaCell(eta) * mNPhi + iPhi;
+  }
+};
+
+/**
+ * Partons and heavy-flavour hadrons of one MC collision, selected once so that all jets of the collision
+ * (and all jet radii) can be labelled without looping over the full particle table per jet. The labels are
+ * identical to getJetFlavor, getSJetFlavor, getJetFlavorHadron and jetOrigin called with the particles of
+ * the same collision.
+ */
+class JetFlavourIndex
+{
+ public:
+  explicit JetFlavourIndex(float cellSize = EtaPhiGrid::DefaultCellSize) : mPartons(cellSize), mHadrons(cellSize) {}
+
+  /**
+   * Fills the index from the particles of one MC collision.
+   *
+   * @param mcparticles the mc particles of the collision
+   */
+  template <typename AllMCParticles>
+  void build(AllMCParticles const& mcparticles)
+  {
+    mPartons.clear();
+    mHadrons.clear();
+    mOriginPartons = {};
+    mNOriginPartons = 0;
+    for (auto const& mcpart : mcparticles) {
+      int pdgcode = std::abs(mcpart.pdgCode());
+      if (pdgcode == 21 || (pdgcode >= 1 && pdgcode <= 5)) {
+        mPartons.add(mcpart.eta(), mcpart.phi(), mcpart.globalIndex(), pdgcode);
+      }
+      if (isBHadron(pdgcode)) {
+        mHadrons.add(mcpart.eta(), mcpart.phi(), mcpart.globalIndex(), JetTaggingSpecies::beauty);
+      } else if (isCHadron(pdgcode)) {
+        mHadrons.add(mcpart.eta(), mcpart.phi(), mcpart.globalIndex(), JetTaggingSpecies::charm);
+      }
+      if (std::abs(mcpart.getGenStatusCode()) == 23) {
+        // jetOrigin compares the first and the last outgoing parton of the hard process
+        mOriginPartons[mNOriginPartons == 0 ? 0 : 1] = {mcpart.eta(), mcpart.phi(), static_cast<int>(mcpart.globalIndex()), mcpart.pdgCode()};
+        mNOriginPartons++;
+      }
+    }
+    mPartons.build();
+    mHadrons.build();
+  }
+
+  /// same as getJetFlavor(jet, mcparticles)
+  template <typename AnyJet>
+  int16_t getJetFlavor(AnyJet const& jet) const
+  {
+    bool beautyQuark = false;
+    bool charmQuark = false;
+    forEachPartonInJet(jet, [&](int pdgcode) {
+      if (pdgcode == 5) {
+        beautyQuark = true;
+      } else if (pdgcode == 4) {
+        charmQuark = true;
+      }
+      return beautyQuark;
+    });
+    if (beautyQuark) {
+      return JetTaggingSpecies::beauty;
+    }
+    if (charmQuark) {
+      return JetTaggingSpecies::charm;
+    }
+    return JetTaggingSpecies::lightflavour;
+  }
+
+  /// same as getSJetFlavor(jet, mcparticles)
+  template <typename AnyJet>
+  int16_t getSJetFlavor(AnyJet const& jet) const
+  {
+    bool beautyQuark = false;
+    bool charmQuark = false;
+    bool strangeQuark = false;
+    forEachPartonInJet(jet, [&](int pdgcode) {
+      if (pdgcode == 5) {
+        beautyQuark = true;
+      } else if (pdgcode == 4) {
+        charmQuark = true;
+      } else if (pdgcode == 3) {
+        strangeQuark = true;
+      }
+      return beautyQuark;
+    });
+    if (beautyQuark) {
+      return JetTaggingSpecies::beauty;
+    }
+    if (charmQuark) {
+      return JetTaggingSpecies::charm;
+    }
+    if (strangeQuark) {
+      return JetTaggingSpecies::strange;
+    }
+    return JetTaggingSpecies::udg;
+  }
+
+  /// same as getJetFlavorHadron(jet, mcparticles)
+  template <typename AnyJet>
+  int16_t getJetFlavorHadron(AnyJet const& jet) const
+  {
+    bool beautyHadron = false;
+    bool charmHadron = false;
+    const float jetR = jet.r() / 100.f;
+    mHadrons.forEachInCone(jet.eta(), jet.phi(), jetR, [&](EtaPhiGrid::Entry const& hadron) {
+      if (jetutilities::deltaR(jet.eta(), jet.phi(), hadron.eta, hadron.phi) < jetR) {
+        if (hadron.kind == JetTaggingSpecies::beauty) {
+          beautyHadron = true;
+        } else {
+          charmHadron = true;
+        }
+      }
+      return beautyHadron;
+    });
+    if (beautyHadron) {
+      return JetTaggingSpecies::beauty;
+    }
+    if (charmHadron) {
+      return JetTaggingSpecies::charm;
+    }
+    return JetTaggingSpecies::lightflavour;
+  }
+
+  /// same as jetOrigin(jet, mcparticles, dRMax); a missing hard-process parton never matches the jet
+  template <typename T>
+  int jetOrigin(T const& jet, float dRMax = 0.25) const
+  {
+    const float dRMissing = std::numeric_limits<float>::infinity();
+    float dR1 = mNOriginPartons > 0 ? jetutilities::deltaR(jet.eta(), jet.phi(), mOriginPartons[0].eta, mOriginPartons[0].phi) : dRMissing;
+    float dR2 = mNOriginPartons > 1 ? jetutilities::deltaR(jet.eta(), jet.phi(), mOriginPartons[1].eta, mOriginPartons[1].phi) : dRMissing;
+    if (dR1 <= dR2 && dR1 < dRMax) {
+      return mOriginPartons[0].kind;
+    }
+    if (dR2 <= dR1 && dR2 < dRMax) {
+      return mOriginPartons[1].kind;
+    }
+    return 0;
+  }
+
+ private:
+  EtaPhiGrid mPartons;
+  EtaPhiGrid mHadrons;
+  std::array<EtaPhiGrid::Entry, 2> mOriginPartons{};
+  int mNOriginPartons = 0;
+
+  /// calls f(|pdg|) for each parton within the jet radius, until f returns true
+  template <typename AnyJet, typename F>
+  void forEachPartonInJet(AnyJet const& jet, F&& f) const
+  {
+    const float jetR = jet.r() / 100.f;
+    mPartons.forEachInCone(jet.eta(), jet.phi(), jetR, [&](EtaPhiGrid::Entry const& parton) {
+      if (jetutilities::deltaR(jet.eta(), jet.phi(), parton.eta, parton.phi) < jetR) {
+        return f(parton.kind);
+      }
+      return false;
+    });
+  }
+};
+
 /**
  * return acceptance of track about DCA xy and z due to cut for QualityTracks
  */
@@ -648,6 +992,179 @@ float getTrackProbability(T const& fResoFuncjet, U const& track, float minSignIm
   return probTrack;
 }
 
+/**
+ * Cumulative distribution of a resolution function of the signed impact parameter significance,
+ * tabulated once so that track probabilities do not need two numerical integrations per track.
+ * The integral of the function is stored on equidistant nodes between the lower edge and 0 together
+ * with the function values, and evaluated in between with a cubic Hermite interpolation clamped to
+ * the neighbouring nodes, which keeps the table monotone for a non-negative function. For a smooth
+ * function the interpolation error scales with the fourth power of the node spacing.
+ */
+class ResolutionFunctionCdf
+{
+ public:
+  static constexpr int DefaultNodes = 1000;
+
+  ResolutionFunctionCdf() = default;
+  ResolutionFunctionCdf(TF1* fResoFunc, float lowerEdge, int nNodes = DefaultNodes) { compile(fResoFunc, lowerEdge, nNodes); }
+
+  /**
+   * Tabulates the cumulative integral of the function between lowerEdge and 0.
+   *
+   * @param fResoFunc The resolution function, integrated with TF1::Integral between consecutive nodes.
+   * @param lowerEdge Lower edge of the table, i.e. the smallest minSignImpXYSig that can be used in the lookups.
+   * @param nNodes Number of nodes of the table.
+   */
+  void compile(TF1* fResoFunc, float lowerEdge, int nNodes = DefaultNodes)
+  {
+    if (!fResoFunc || lowerEdge >= 0 || nNodes < 2) {
+      LOGF(fatal, "Cannot tabulate resolution function on [%f, 0] with %d nodes", lowerEdge, nNodes);
+    }
+    mLowerEdge = lowerEdge;
+    mStep = -static_cast<double>(lowerEdge) / (nNodes - 1);
+    mCumulative.assign(nNodes, 0.);
+    mDensity.assign(nNodes, 0.);
+    for (int i = 0; i < nNodes; i++) {
+      double x = nodePosition(i);
+      mDensity[i] = fResoFunc->Eval(x);
+      if (i > 0) {
+        mCumulative[i] = mCumulative[i - 1] + fResoFunc->Integral(nodePosition(i - 1), x);
+      }
+    }
+  }
+
+  bool isValid() const { return !mCumulative.empty(); }
+  float getLowerEdge() const { return mLowerEdge; }
+
+  /// Integral of the resolution function between the lower edge of the table and x <= 0
+  double getCumulative(double x) const
+  {
+    double pos = (x - mLowerEdge) / mStep;
+    if (!(pos > 0.)) {
+      return 0.;
+    }
+    int last = static_cast<int>(mCumulative.size()) - 1;
+    if (!(pos < last)) {
+      return mCumulative[last];
+    }
+    int i = static_cast<int>(pos);
+    double t = pos - i;
+    double t2 = t * t;
+    double t3 = t2 * t;
+    double value = (2 * t3 - 3 * t2 + 1) * mCumulative[i] + (t3 - 2 * t2 + t) * mStep * mDensity[i] + (-2 * t3 + 3 * t2) * mCumulative[i + 1] + (t3 - t2) * mStep * mDensity[i + 1];
+    return std::clamp(value, std::min(mCumulative[i], mCumulative[i + 1]), std::max(mCumulative[i], mCumulative[i + 1]));
+  }
+
+  /**
+   * Track probability for a given absolute impact parameter significance, equivalent to
+   * getTrackProbability with the TF1 the table was built from.
+   *
+   * @param signImpXYSig Absolute value of the impact parameter significance in the XY plane.
+   * @param minSignImpXYSig Lower limit of the integration, must not be below the lower edge of the table.
+   */
+  float getProbability(float signImpXYSig, float minSignImpXYSig) const
+  {
+    if (minSignImpXYSig < mLowerEdge) {
+      LOGF(fatal, "minSignImpXYSig = %f is outside of the tabulated resolution function (lower edge %f)", minSignImpXYSig, mLowerEdge);
+    }
+    if (-signImpXYSig < minSignImpXYSig)
+      signImpXYSig = -minSignImpXYSig - 0.01; // same protection as for the TF1 integral
+    double offset = getCumulative(minSignImpXYSig);
+    return (getCumulative(-signImpXYSig) - offset) / (getCumulative(0.) - offset);
+  }
+
+  /// Fills probabilities[i] for signImpXYSig[i], without allocations
+  void getProbabilities(std::span<const float> signImpXYSig, std::span<float> probabilities, float minSignImpXYSig) const
+  {
+    for (std::size_t i = 0; i < probabilities.size(); i++) {
+      probabilities[i] = getProbability(signImpXYSig[i], minSignImpXYSig);
+    }
+  }
+
+  /**
+   * Validation of the table against the TF1 integrals used in getTrackProbability.
+   *
+   * @param fResoFunc The resolution function the table was built from.
+   * @param minSignImpXYSig Lower limit of the integration.
+   * @param nPoints Number of impact parameter significances tested, equidistant between 0 and -minSignImpXYSig.
+   * @return The largest absolute difference of the track probabilities.
+   */
+  double getMaxDeviation(TF1* fResoFunc, float minSignImpXYSig, int nPoints = 10000) const
+  {
+    double norm = fResoFunc->Integral(minSignImpXYSig, 0);
+    double maxDeviation = 0.;
+    for (int i = 0; i < nPoints; i++) {
+      float signImpXYSig = -minSignImpXYSig * i / nPoints;
+      float upper = -signImpXYSig < minSignImpXYSig ? minSignImpXYSig + 0.01f : -signImpXYSig;
+      float reference = fResoFunc->Integral(minSignImpXYSig, upper) / norm;
+      maxDeviation = std::max(maxDeviation, static_cast<double>(std::abs(getProbability(signImpXYSig, minSignImpXYSig) - reference)));
+    }
+    return maxDeviation;
+  }
+
+ private:
+  float mLowerEdge = 0.;
+  double mStep = 1.;
+  std::vector<double> mCumulative; // integral from the lower edge up to each node
+  std::vector<double> mDensity;    // function value at each node
+
+  double nodePosition(int i) const { return mLowerEdge + i * mStep; }
+};
+
+/**
+ * Tabulates a set of resolution functions, e.g. one per pT range.
+ */
+inline std::vector<ResolutionFunctionCdf> setResolutionFunctionCdfs(std::vector<std::unique_ptr<TF1>> const& fResoFuncs, float lowerEdge, int nNodes = ResolutionFunctionCdf::DefaultNodes)
+{
+  std::vector<ResolutionFunctionCdf> cdfs;
+  cdfs.reserve(fResoFuncs.size());
+  for (const auto& fResoFunc : fResoFuncs) {
+    cdfs.emplace_back(fResoFunc.get(), lowerEdge, nNodes);
+  }
+  return cdfs;
+}
+
+/**
+ * Track probability from a tabulated resolution function, see ResolutionFunctionCdf.
+ */
+template <typename U>
+float getTrackProbability(ResolutionFunctionCdf const& cdfResoFuncjet, U const& track, float minSignImpXYSig = -40)
+{
+  return cdfResoFuncjet.getProbability(std::abs(track.dcaXY()) / track.sigmadcaXY(), minSignImpXYSig);
+}
+
+/**
+ * Index of the resolution function to be used for a track in the pT categorised jet probability,
+ * -1 if the track is outside of all pT ranges.
+ */
+inline int getResolutionFunctionPtIndex(float pt)
+{
+  static constexpr std::array<float, 7> PtLowEdges{0.0, 0.5, 1.0, 2.0, 4.0, 6.0, 9.0};
+  for (int i = static_cast<int>(PtLowEdges.size()) - 1; i >= 0; i--) {
+    if (pt >= PtLowEdges[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Combines the product of the probabilities of the positive-sign tracks into the jet probability,
+ * -1 if there are fewer than two such tracks.
+ */
+inline float combineTrackProbabilities(float trackjetProb, int nTracks)
+{
+  if (nTracks < 2)
+    return -1;
+
+  float sumjetProb = 0.;
+  for (int i = 0; i < nTracks; i++) {
+    sumjetProb += (std::pow(-1 * std::log(trackjetProb), i) / TMath::Factorial(i));
+  }
+
+  return trackjetProb * sumjetProb;
+}
+
 /**
  * Computes the jet probability (JP) for a given jet, considering only tracks with a positive geometric
  * sign. JP is calculated using the product of individual track probabilities and the sum of logarithmic
@@ -669,7 +1186,7 @@ float getTrackProbability(T const& fResoFuncjet, U const& track, float minSignIm
 template <typename T, typename U, typename V>
 float getJetProbability(T const& fResoFuncjet, U const& jet, V const& /*tracks*/, float trackDcaXYMax, float trackDcaZMax, float minSignImpXYSig = -10)
 {
-  std::vector<float> jetTracksPt;
+  int nPositiveTracks = 0;
   float trackjetProb = 1.;
 
   for (auto const& track : jet.template tracks_as<V>()) {
@@ -681,28 +1198,18 @@ float getJetProbability(T const& fResoFuncjet, U const& jet, V const& /*tracks*/
     auto geoSign = getGeoSign(jet, track);
     if (geoSign > 0) { // only take positive sign track for JP calculation
       trackjetProb *= probTrack;
-      jetTracksPt.push_back(track.pt());
+      nPositiveTracks++;
     }
   }
 
-  float jetProb = -1.;
-  if (jetTracksPt.size() < 2)
-    return -1;
-
-  float sumjetProb = 0.;
-  for (std::vector<float>::size_type i = 0; i < jetTracksPt.size(); i++) {
-    sumjetProb += (std::pow(-1 * std::log(trackjetProb), static_cast<int>(i)) / TMath::Factorial(i));
-  }
-
-  jetProb = trackjetProb * sumjetProb;
-  return jetProb;
+  return combineTrackProbabilities(trackjetProb, nPositiveTracks);
 }
 
 // overloading for the case of using resolution function for each pt range
 template <typename T, typename U, typename V>
-float getJetProbability(std::vector<std::unique_ptr<T>> const& fResoFuncjets, U const& jet, V const& /*tracks*/, float trackDcaXYMax, float trackDcaZMax, float minSignImpXYSig = -10)
+float getJetProbability(std::vector<T> const& fResoFuncjets, U const& jet, V const& /*tracks*/, float trackDcaXYMax, float trackDcaZMax, float minSignImpXYSig = -10)
 {
-  std::vector<float> jetTracksPt;
+  int nPositiveTracks = 0;
   float trackjetProb = 1.;
 
   for (auto const& track : jet.template tracks_as<V>()) {
@@ -711,40 +1218,19 @@ float getJetProbability(std::vector<std::unique_ptr<T>> const& fResoFuncjets, U
 
     float probTrack = -1;
     // choose the proper resolution function for the track based on its pt.
-    if (track.pt() >= 0.0 && track.pt() < 0.5) {
-      probTrack = getTrackProbability(fResoFuncjets.at(0), track, minSignImpXYSig);
-    } else if (track.pt() >= 0.5 && track.pt() < 1.0) {
-      probTrack = getTrackProbability(fResoFuncjets.at(1), track, minSignImpXYSig);
-    } else if (track.pt() >= 1.0 && track.pt() < 2.0) {
-      probTrack = getTrackProbability(fResoFuncjets.at(2), track, minSignImpXYSig);
-    } else if (track.pt() >= 2.0 && track.pt() < 4.0) {
-      probTrack = getTrackProbability(fResoFuncjets.at(3), track, minSignImpXYSig);
-    } else if (track.pt() >= 4.0 && track.pt() < 6.0) {
-      probTrack = getTrackProbability(fResoFuncjets.at(4), track, minSignImpXYSig);
-    } else if (track.pt() >= 6.0 && track.pt() < 9.0) {
-      probTrack = getTrackProbability(fResoFuncjets.at(5), track, minSignImpXYSig);
-    } else if (track.pt() >= 9.0) {
-      probTrack = getTrackProbability(fResoFuncjets.at(6), track, minSignImpXYSig);
+    int ptIndex = getResolutionFunctionPtIndex(track.pt());
+    if (ptIndex >= 0) {
+      probTrack = getTrackProbability(fResoFuncjets.at(ptIndex), track, minSignImpXYSig);
     }
 
     auto geoSign = getGeoSign(jet, track);
     if (geoSign > 0) { // only take positive sign track for JP calculation
       trackjetProb *= probTrack;
-      jetTracksPt.push_back(track.pt());
+      nPositiveTracks++;
     }
   }
 
-  float jetProb = -1.;
-  if (jetTracksPt.size() < 2)
-    return -1;
-
-  float sumjetProb = 0.;
-  for (std::vector<float>::size_type i = 0; i < jetTracksPt.size(); i++) {
-    sumjetProb += (std::pow(-1 * std::log(trackjetProb), static_cast<int>(i)) / TMath::Factorial(i));
-  }
-
-  jetProb = trackjetProb * sumjetProb;
-  return jetProb;
+  return combineTrackProbabilities(trackjetProb, nPositiveTracks);
 }
 
 // For secaondy vertex method utilites
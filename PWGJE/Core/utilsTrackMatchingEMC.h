@@ -16,102 +16,291 @@
 #ifndef PWGJE_CORE_UTILSTRACKMATCHINGEMC_H_
 #define PWGJE_CORE_UTILSTRACKMATCHINGEMC_H_
 
-#include <TKDTree.h>
-
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
-#include <limits>
 #include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace tmemcutilities
 {
 
+/**
+ * Matches of all clusters in flat (CSR) arrays.
+ *
+ * The matches of cluster i are stored at positions [offsets[i], offsets[i + 1]) of
+ * matchIndexTrack, matchDeltaPhi and matchDeltaEta, ordered by increasing distance.
+ */
 struct MatchResult {
-  std::vector<std::vector<int>> matchIndexTrack;
-  std::vector<std::vector<float>> matchDeltaPhi;
-  std::vector<std::vector<float>> matchDeltaEta;
+  std::vector<int> offsets;
+  std::vector<int> matchIndexTrack;
+  std::vector<float> matchDeltaPhi;
+  std::vector<float> matchDeltaEta;
+
+  void clear()
+  {
+    offsets.clear();
+    matchIndexTrack.clear();
+    matchDeltaPhi.clear();
+    matchDeltaEta.clear();
+  }
+  std::size_t nClusters() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+  int begin(std::size_t iCluster) const { return offsets[iCluster]; }
+  int end(std::size_t iCluster) const { return offsets[iCluster + 1]; }
+  int nMatches(std::size_t iCluster) const { return offsets[iCluster + 1] - offsets[iCluster]; }
 };
 
 /**
- * Match clusters and tracks.
+ * Uniform eta-phi cell grid over a track collection.
+ *
+ * The phi direction is periodic, so that tracks and clusters on both sides of phi = 0 are
+ * neighbours. The grid only preselects candidates, the distance is computed exactly by the caller.
+ * Tracks with non-finite coordinates are not stored and are never matched.
+ */
+class EtaPhiGridIndex
+{
+ public:
+  static constexpr float TwoPi = 2.f * static_cast<float>(M_PI);
+  static constexpr int MaxCellsPerAxis = 1024;
+
+  /**
+   * Build the grid.
+   *
+   * @param phi track collection phi.
+   * @param eta track collection eta.
+   * @param cellSize size of the cells in eta and phi, typically the maximum matching distance.
+   */
+  void build(std::span<const float> phi, std::span<const float> eta, float cellSize)
+  {
+    if (phi.size() != eta.size()) {
+      throw std::invalid_argument("track collection eta and phi sizes don't match. Check the inputs.");
+    }
+    if (!(cellSize > 0.f)) {
+      throw std::invalid_argument("grid cell size must be positive.");
+    }
+    const std::size_t nTracks = eta.size();
+    mPhi.resize(nTracks);
+    mEta.assign(eta.begin(), eta.end());
+    mEtaMin = 0.f;
+    mEtaMax = 0.f;
+    bool first = true;
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      mPhi[iTrack] = wrapPhi(phi[iTrack]);
+      if (!std::isfinite(mEta[iTrack]) || !std::isfinite(mPhi[iTrack])) {
+        continue;
+      }
+      mEtaMin = first ? mEta[iTrack] : std::min(mEtaMin, mEta[iTrack]);
+      mEtaMax = first ? mEta[iTrack] : std::max(mEtaMax, mEta[iTrack]);
+      first = false;
+    }
+    mNEta = std::clamp(static_cast<int>(std::ceil((mEtaMax - mEtaMin) / cellSize)), 1, MaxCellsPerAxis);
+    mEtaCell = std::max((mEtaMax - mEtaMin) / mNEta, cellSize);
+    mNPhi = std::clamp(static_cast<int>(TwoPi / cellSize), 1, MaxCellsPerAxis);
+    mPhiCell = TwoPi / mNPhi;
+
+    // counting sort of the tracks into the cells
+    mCellOffsets.assign(static_cast<std::size_t>(mNEta) * mNPhi + 1, 0);
+    mTrackCell.resize(nTracks);
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      if (!std::isfinite(mEta[iTrack]) || !std::isfinite(mPhi[iTrack])) {
+        mTrackCell[iTrack] = -1;
+        continue;
+      }
+      mTrackCell[iTrack] = etaCell(mEta[iTrack]) * mNPhi + phiCell(mPhi[iTrack]);
+      mCellOffsets[mTrackCell[iTrack] + 1]++;
+    }
+    for (std::size_t iCell = 1; iCell < mCellOffsets.size(); iCell++) {
+      mCellOffsets[iCell] += mCellOffsets[iCell - 1];
+    }
+    mEntries.resize(mCellOffsets.back());
+    std::vector<int> fill(mCellOffsets.begin(), mCellOffsets.end() - 1);
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      if (mTrackCell[iTrack] >= 0) {
+        mEntries[fill[mTrackCell[iTrack]]++] = static_cast<int>(iTrack);
+      }
+    }
+  }
+
+  void clear()
+  {
+    mPhi.clear();
+    mEta.clear();
+    mTrackCell.clear();
+    mCellOffsets.clear();
+    mEntries.clear();
+  }
+
+  std::size_t size() const { return mEta.size(); }
+  bool empty() const { return mEntries.empty(); }
+  /// phi of the track, mapped to [0, 2pi)
+  float phi(int iTrack) const { return mPhi[iTrack]; }
+  float eta(int iTrack) const { return mEta[iTrack]; }
+
+  /**
+   * Call f(iTrack) for every track in the cells overlapping the square of half-size radius
+   * around (eta, phi). Every track within the radius is visited exactly once.
+   */
+  template <typename F>
+  void forEachCandidate(float eta, float phi, float radius, F&& f) const
+  {
+    if (empty() || !std::isfinite(eta) || !std::isfinite(phi)) {
+      return;
+    }
+    // small safety margin, the cell boundaries are computed in single precision
+    const float reach = radius * 1.0001f + 1.e-5f;
+    if (eta + reach < mEtaMin || eta - reach > mEtaMax) {
+      return;
+    }
+    const int etaLow = etaCell(eta - reach);
+    const int etaHigh = etaCell(eta + reach);
+    const float phiWrapped = wrapPhi(phi);
+    int phiLow = static_cast<int>(std::floor((phiWrapped - reach) / mPhiCell));
+    int phiHigh = static_cast<int>(std::floor((phiWrapped + reach) / mPhiCell));
+    if (phiHigh - phiLow + 1 >= mNPhi) {
+      phiLow = 0;
+      phiHigh = mNPhi - 1;
+    }
+    for (int iEta = etaLow; iEta <= etaHigh; iEta++) {
+      for (int iPhi = phiLow; iPhi <= phiHigh; iPhi++) {
+        const int cell = iEta * mNPhi + ((iPhi % mNPhi) + mNPhi) % mNPhi;
+        for (int iEntry = mCellOffsets[cell]; iEntry < mCellOffsets[cell + 1]; iEntry++) {
+          f(mEntries[iEntry]);
+        }
+      }
+    }
+  }
+
+  /// Map phi to [0, 2pi)
+  static float wrapPhi(float phi)
+  {
+    if (phi >= 0.f && phi < TwoPi) {
+      return phi;
+    }
+    float wrapped = phi - TwoPi * std::floor(phi / TwoPi);
+    return wrapped >= TwoPi ? 0.f : wrapped;
+  }
+
+  /// Difference phi1 - phi2 of two angles in [0, 2pi), mapped to [-pi, pi]
+  static float deltaPhi(float phi1, float phi2)
+  {
+    float dPhi = phi1 - phi2;
+    if (dPhi > static_cast<float>(M_PI)) {
+      dPhi -= TwoPi;
+    } else if (dPhi < -static_cast<float>(M_PI)) {
+      dPhi += TwoPi;
+    }
+    return dPhi;
+  }
+
+ private:
+  std::vector<float> mPhi;
+  std::vector<float> mEta;
+  std::vector<int> mTrackCell;
+  std::vector<int> mCellOffsets; // tracks of cell c are mEntries[mCellOffsets[c]..mCellOffsets[c + 1])
+  std::vector<int> mEntries;
+  float mEtaMin = 0.f;
+  float mEtaMax = 0.f;
+  float mEtaCell = 1.f;
+  float mPhiCell = TwoPi;
+  int mNEta = 0;
+  int mNPhi = 0;
+
+  int etaCell(float eta) const
+  {
+    return std::clamp(static_cast<int>(std::floor((eta - mEtaMin) / mEtaCell)), 0, mNEta - 1);
+  }
+  int phiCell(float phi) const
+  {
+    return std::min(static_cast<int>(phi / mPhiCell), mNPhi - 1);
+  }
+};
+
+/**
+ * Match clusters and tracks using a prebuilt track grid.
  *
- * Match cluster with tracks, where maxNumberMatches are considered in dR=maxMatchingDistance.
- * If no unique match was found for a jet, an index of -1 is stored.
- * The same map is created for clusters matched to tracks e.g. for electron analyses.
+ * Each cluster is matched to at most maxNumberMatches tracks with dR < maxMatchingDistance,
+ * ordered by increasing dR. The distance in phi is taken across the phi = 0 boundary.
+ * The same grid can be reused for any number of cluster collections (e.g. all clusterizers
+ * of a collision), the result is overwritten.
  *
+ * @param trackIndex grid over the track collection.
  * @param clusterPhi cluster collection phi.
  * @param clusterEta cluster collection eta.
- * @param trackPhi track collection phi.
- * @param trackEta track collection eta.
  * @param maxMatchingDistance Maximum matching distance.
  * @param maxNumberMatches Maximum number of matches (e.g. 5 closest).
- *
- * @returns (cluster to track index map, track to cluster index map)
+ * @param result cluster to track matches, with track indices as positions in the track collection.
  */
-MatchResult matchTracksToCluster(
-  std::span<float> clusterPhi,
-  std::span<float> clusterEta,
-  std::span<float> trackPhi,
-  std::span<float> trackEta,
+inline void matchTracksToCluster(
+  EtaPhiGridIndex const& trackIndex,
+  std::span<const float> clusterPhi,
+  std::span<const float> clusterEta,
   double maxMatchingDistance,
-  int maxNumberMatches)
+  int maxNumberMatches,
+  MatchResult& result)
 {
-  const std::size_t nClusters = clusterEta.size();
-  const std::size_t nTracks = trackEta.size();
-  MatchResult result;
-
-  if (nClusters == 0 || nTracks == 0) {
-    // There are no jets, so nothing to be done.
-    return result;
-  }
-  // Input sizes must match
   if (clusterPhi.size() != clusterEta.size()) {
     throw std::invalid_argument("cluster collection eta and phi sizes don't match. Check the inputs.");
   }
-  if (trackPhi.size() != trackEta.size()) {
-    throw std::invalid_argument("track collection eta and phi sizes don't match. Check the inputs.");
-  }
+  const std::size_t nClusters = clusterEta.size();
+  result.clear();
+  result.offsets.reserve(nClusters + 1);
+  result.offsets.push_back(0);
 
-  result.matchIndexTrack.resize(nClusters);
-  result.matchDeltaPhi.resize(nClusters);
-  result.matchDeltaEta.resize(nClusters);
-
-  // Build the KD-trees using vectors
-  // We build two trees:
-  // treeBase, which contains the base collection.
-  // treeTag, which contains the tag collection.
-  // The trees are built to match in two dimensions (eta, phi)
-  TKDTree<int, float> treeTrack(trackEta.size(), 2, 1);
-  treeTrack.SetData(0, trackEta.data());
-  treeTrack.SetData(1, trackPhi.data());
-  treeTrack.Build();
-
-  // Find the track closest to each cluster.
+  std::vector<std::pair<float, int>> candidates;
   for (std::size_t iCluster = 0; iCluster < nClusters; iCluster++) {
-    float point[2] = {clusterEta[iCluster], clusterPhi[iCluster]};
-    int index[50];      // size 50 for safety
-    float distance[50]; // size 50 for safery
-    std::fill_n(index, 50, -1);
-    std::fill_n(distance, 50, std::numeric_limits<float>::max());
-    treeTrack.FindNearestNeighbors(point, maxNumberMatches, index, distance);
-
-    // allocate enough memory
-    result.matchIndexTrack[iCluster].reserve(maxNumberMatches);
-    result.matchDeltaPhi[iCluster].reserve(maxNumberMatches);
-    result.matchDeltaEta[iCluster].reserve(maxNumberMatches);
-
-    // test whether indices are matching:
-    for (int m = 0; m < maxNumberMatches; m++) {
-      if (index[m] >= 0 && distance[m] < maxMatchingDistance) {
-        result.matchIndexTrack[iCluster].push_back(index[m]);
-        result.matchDeltaPhi[iCluster].push_back(trackPhi[index[m]] - clusterPhi[iCluster]);
-        result.matchDeltaEta[iCluster].push_back(trackEta[index[m]] - clusterEta[iCluster]);
+    const float eta = clusterEta[iCluster];
+    const float phi = EtaPhiGridIndex::wrapPhi(clusterPhi[iCluster]);
+    candidates.clear();
+    trackIndex.forEachCandidate(eta, phi, static_cast<float>(maxMatchingDistance), [&](int iTrack) {
+      const float dEta = trackIndex.eta(iTrack) - eta;
+      const float dPhi = EtaPhiGridIndex::deltaPhi(trackIndex.phi(iTrack), phi);
+      const float distance = std::sqrt(dEta * dEta + dPhi * dPhi);
+      if (distance < maxMatchingDistance) {
+        candidates.emplace_back(distance, iTrack);
       }
+    });
+    const std::size_t nMatches = std::min(candidates.size(), static_cast<std::size_t>(std::max(maxNumberMatches, 0)));
+    std::partial_sort(candidates.begin(), candidates.begin() + nMatches, candidates.end());
+    for (std::size_t m = 0; m < nMatches; m++) {
+      const int iTrack = candidates[m].second;
+      result.matchIndexTrack.push_back(iTrack);
+      result.matchDeltaPhi.push_back(EtaPhiGridIndex::deltaPhi(trackIndex.phi(iTrack), phi));
+      result.matchDeltaEta.push_back(trackIndex.eta(iTrack) - eta);
     }
+    result.offsets.push_back(static_cast<int>(result.matchIndexTrack.size()));
+  }
+}
+
+/**
+ * Match clusters and tracks.
+ *
+ * Convenience overload which builds the track grid for a single cluster collection.
+ *
+ * @param clusterPhi cluster collection phi.
+ * @param clusterEta cluster collection eta.
+ * @param trackPhi track collection phi.
+ * @param trackEta track collection eta.
+ * @param maxMatchingDistance Maximum matching distance.
+ * @param maxNumberMatches Maximum number of matches (e.g. 5 closest).
+ *
+ * @returns cluster to track matches
+ */
+inline MatchResult matchTracksToCluster(
+  std::span<const float> clusterPhi,
+  std::span<const float> clusterEta,
+  std::span<const float> trackPhi,
+  std::span<const float> trackEta,
+  double maxMatchingDistance,
+  int maxNumberMatches)
+{
+  MatchResult result;
+  EtaPhiGridIndex trackIndex;
+  if (!trackEta.empty()) {
+    trackIndex.build(trackPhi, trackEta, static_cast<float>(maxMatchingDistance));
   }
+  matchTracksToCluster(trackIndex, clusterPhi, clusterEta, maxMatchingDistance, maxNumberMatches, result);
   return result;
 }
 }; // namespace tmemcutilities
@@ -59,15 +59,21 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <gsl/span>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <span>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -142,6 +148,8 @@ struct EmcalCorrectionTask {
   Configurable<bool> applySoftwareTriggerSelection{"applySoftwareTriggerSelection", false, "Apply software trigger selection"};
   Configurable<std::string> softwareTriggerSelection{"softwareTriggerSelection", "fGammaHighPtEMCAL,fGammaHighPtDCAL", "Default: fGammaHighPtEMCAL,fGammaHighPtDCAL"};
   Configurable<bool> storePerDFInfo{"storePerDFInfo", false, "store addition information per DF."};
+  Configurable<int> nClusterizerThreads{"nClusterizerThreads", 1, "Number of threads running the clusterizers in processFull and processMCFull. With more than one thread the BCs are clusterized in chunks and the tables are filled afterwards in BC order"};
+  Configurable<int> nBCsPerChunk{"nBCsPerChunk", 256, "Number of BCs with EMCal cells clusterized together when running with more than one thread"};
   ConfigurableAxis thConfigAxisClusters{"thConfigAxisClusters", {1000, 0.5f, 1000.5f}, ""};
   ConfigurableAxis thConfigAxisCells{"thConfigAxisCells", {1000, 0.5f, 1000.5f}, ""};
   // cross talk emulation configs
@@ -175,7 +183,68 @@ struct EmcalCorrectionTask {
   std::vector<float> mClusterPhi;
   std::vector<float> mClusterEta;
 
+  // Track grids for the matching, built once per collision and shared by all clusterizers
+  EtaPhiGridIndex mTrackIndex;
+  EtaPhiGridIndex mSecondaryIndex;
+  std::vector<int64_t> mTrackGlobalIndex;
+  std::vector<int64_t> mSecondaryGlobalIndex;
+  int64_t mTrackIndexCollisionId = -1;
+  int64_t mSecondaryIndexCollisionId = -1;
+  MatchResult mMatchResult;
+  MatchResult mMatchResultSecondary;
+
   std::vector<o2::aod::EMCALClusterDefinition> mClusterDefinitions;
+
+  // Output of one clusterizer for one BC
+  struct ClusterizerOutput {
+    std::vector<o2::emcal::AnalysisCluster> clusters;
+    std::vector<o2::emcal::ClusterLabel> labels;
+    std::vector<float> phi;
+    std::vector<float> eta;
+  };
+  // Cells of one BC and the clusters found by each clusterizer. The buffers are reused for the following chunks.
+  struct BCClusterizationJob {
+    int64_t bcIndex = -1;
+    std::vector<o2::emcal::Cell> cells;
+    std::vector<int64_t> cellIndices;
+    std::vector<o2::emcal::CellLabel> cellLabels;
+    std::vector<ClusterizerOutput> outputs;
+  };
+  // Clusterizers and cluster factory owned by one worker thread
+  struct ClusterizationWorker {
+    std::vector<std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>>> clusterizers;
+    o2::emcal::ClusterFactory<o2::emcal::Cell> clusterFactory;
+  };
+  bool mParallelClusterization = false;
+  std::vector<std::unique_ptr<ClusterizationWorker>> mWorkers;
+  std::vector<BCClusterizationJob> mJobs = std::vector<BCClusterizationJob>(1);
+  size_t mNJobs = 0; // number of jobs waiting to be clusterized in parallel mode
+  ClusterizerOutput mSerialOutput;
+  // Threads running the workers 1..n-1 for the lifetime of the task, worker 0 runs on the calling thread
+  struct ClusterizationPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeUp;   // a new chunk is ready or the pool is stopped
+    std::condition_variable finished; // a worker is done with the current chunk
+    uint64_t generation = 0;          // number of chunks handed to the pool
+    size_t nBusy = 0;                 // threads still working on the current chunk
+    bool stop = false;
+    std::atomic<size_t> nextJob{0};
+    std::vector<std::exception_ptr> errors; // exception thrown by each worker in the current chunk
+
+    ~ClusterizationPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      wakeUp.notify_all();
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+  };
+  std::unique_ptr<ClusterizationPool> mPool; // declared after the workers and jobs so that it is stopped first
   // QA
   o2::framework::HistogramRegistry mHistManager{"EMCALCorrectionTaskQAHistograms"};
 
@@ -259,16 +328,9 @@ struct EmcalCorrectionTask {
         mClusterDefinitions.push_back(clusDef);
       }
     }
-    mClusterFactories.setGeometry(geometry);
-    mClusterFactories.SetECALogWeight(logWeight);
-    mClusterFactories.setExoticCellFraction(exoticCellFraction);
-    mClusterFactories.setExoticCellDiffTime(exoticCellDiffTime);
-    mClusterFactories.setExoticCellMinAmplitude(exoticCellMinAmplitude);
-    mClusterFactories.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
-    // TODO: Fix setUseWeightExotic in the O2 code to use bool as argument not float!
-    mClusterFactories.setUseWeightExotic(static_cast<float>(useWeightExotic));
+    setupClusterFactory(mClusterFactories);
     for (const auto& clusterDefinition : mClusterDefinitions) {
-      mClusterizers.emplace_back(std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy));
+      mClusterizers.emplace_back(makeClusterizer(clusterDefinition));
       LOG(info) << "Cluster definition initialized: " << clusterDefinition.toString();
       LOG(info) << "timeMin: " << clusterDefinition.timeMin;
       LOG(info) << "timeMax: " << clusterDefinition.timeMax;
@@ -278,14 +340,34 @@ struct EmcalCorrectionTask {
       LOG(info) << "minCellEnergy: " << clusterDefinition.minCellEnergy;
       LOG(info) << "storageID: " << clusterDefinition.storageID;
     }
-    for (const auto& clusterizer : mClusterizers) {
-      clusterizer->setGeometry(geometry);
-    }
-
     if (mClusterizers.empty()) {
       LOG(error) << "No cluster definitions specified!";
     }
 
+    // Every worker gets its own clusterizers and cluster factory, only the geometry is shared.
+    // The geometry fills its supermodule matrices lazily from gGeoManager on first use, which is
+    // not thread safe: load all of them here so that the workers only read them.
+    mParallelClusterization = nClusterizerThreads.value > 1;
+    if (mParallelClusterization && !loadSuperModuleMatrices()) {
+      LOG(error) << "EMCal supermodule matrices not available, running the clusterizers serially instead of with " << nClusterizerThreads.value << " threads";
+      mParallelClusterization = false;
+    }
+    if (mParallelClusterization) {
+      mPool = std::make_unique<ClusterizationPool>();
+      mPool->errors.resize(nClusterizerThreads.value);
+      for (int iWorker = 0; iWorker < nClusterizerThreads.value; iWorker++) {
+        auto& worker = mWorkers.emplace_back(std::make_unique<ClusterizationWorker>());
+        setupClusterFactory(worker->clusterFactory);
+        for (const auto& clusterDefinition : mClusterDefinitions) {
+          worker->clusterizers.emplace_back(makeClusterizer(clusterDefinition));
+        }
+      }
+      for (int iWorker = 1; iWorker < nClusterizerThreads.value; iWorker++) {
+        mPool->threads.emplace_back([this, iWorker]() { clusterizationThread(iWorker); });
+      }
+      LOG(info) << "Running the clusterizers with " << nClusterizerThreads.value << " threads on chunks of " << nBCsPerChunk.value << " BCs";
+    }
+
     // 500 clusters per event is a good upper limit
     mClusterPhi.reserve(500 * mClusterizers.size());
     mClusterEta.reserve(500 * mClusterizers.size());
@@ -435,6 +517,7 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    resetTrackMatching();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
 
@@ -473,8 +556,10 @@ struct EmcalCorrectionTask {
         }
       }
 
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
+      // in parallel mode the cells are kept in the job until the chunk of BCs is clusterized
+      BCClusterizationJob& job = acquireClusterizationJob(bc.globalIndex());
+      std::vector<o2::emcal::Cell>& cellsBC = job.cells;
+      std::vector<int64_t>& cellIndicesBC = job.cellIndices;
       for (const auto& cell : cellsInBC) {
         auto amplitude = cell.amplitude();
         if (static_cast<bool>(hasShaperCorrection) && emcal::intToChannelType(cell.cellType()) == emcal::ChannelType_t::LOW_GAIN) { // Apply shaper correction to LG cells
@@ -505,49 +590,17 @@ struct EmcalCorrectionTask {
       LOG(debug) << "Converted cells. Contains: " << cellsBC.size() << ". Originally " << cellsInBC.size() << ". About to run clusterizer.";
       //  this is a test
       //  Run the clusterizers
+      if (mParallelClusterization) {
+        nBCsProcessed++;
+        if (mNJobs >= static_cast<size_t>(nBCsPerChunk.value)) {
+          flushClusterizationJobs(bcs, collisions, tracks, previousCollisionId, true);
+        }
+        continue;
+      }
       LOG(debug) << "Running clusterizers";
       for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
         cellsToCluster(iClusterizer, cellsBC);
-
-        if (collisionsInFoundBC.size() == 1) {
-          // dummy loop to get the first collision
-          for (const auto& col : collisionsInFoundBC) {
-            if (previousCollisionId > col.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 1);
-              continue;
-            }
-            previousCollisionId = col.globalIndex();
-            if (col.foundBCId() == bc.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 0); // CollisionID ordered and foundBC matches -> Fill as healthy
-              mHistManager.fill(HIST("hCollisionTimeReso"), col.collisionTimeRes());
-              mHistManager.fill(HIST("hCollPerBC"), 1);
-              mHistManager.fill(HIST("hCollisionType"), 1);
-              math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
-
-              MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
-
-              // Store the clusters in the table where a matching collision could
-              // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
-            } else {
-              mHistManager.fill(HIST("hBCMatchErrors"), 2);
-            }
-          }
-        } else { // ambiguous
-          // LOG(warning) << "No vertex found for event. Assuming (0,0,0).";
-          bool hasCollision = false;
-          mHistManager.fill(HIST("hCollPerBC"), collisionsInFoundBC.size());
-          if (collisionsInFoundBC.size() == 0) {
-            mHistManager.fill(HIST("hCollisionType"), 0);
-          } else {
-            hasCollision = true;
-            mHistManager.fill(HIST("hCollisionType"), 2);
-          }
-          fillAmbigousClusterTable<BcEvSels::iterator>(bc, iClusterizer, cellIndicesBC, hasCollision);
-        }
-
+        fillClustersOfBC(bc, collisionsInFoundBC, iClusterizer, cellIndicesBC, tracks, previousCollisionId, true);
         mClusterPhi.clear();
         mClusterEta.clear();
         LOG(debug) << "Cluster loop done for clusterizer " << iClusterizer;
@@ -556,6 +609,10 @@ struct EmcalCorrectionTask {
       nBCsProcessed++;
     } // end of bc loop
 
+    if (mParallelClusterization) {
+      flushClusterizationJobs(bcs, collisions, tracks, previousCollisionId, true);
+    }
+
     // Loop through all collisions and fill emcalcollisionmatch with a boolean stating, whether the collision was ambiguous (not the only collision in its BC)
     // NOTE: we can not do zorro selection here since emcalcollisionmatch needs to alway be filled to be joinable with collision table
     for (const auto& collision : collisions) {
@@ -596,6 +653,7 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    resetTrackMatching();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
 
@@ -685,17 +743,13 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
-              MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, mMatchResult);
 
-              MatchResult indexMapPairSecondary;
-              std::vector<int64_t> secondaryGlobalIndex;
-              doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, secondaryGlobalIndex, tracks);
+              doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, mMatchResultSecondary, tracks);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex, &indexMapPairSecondary, &secondaryGlobalIndex);
+              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &mMatchResult, &mTrackGlobalIndex, &mMatchResultSecondary, &mSecondaryGlobalIndex);
             } else {
               mHistManager.fill(HIST("hBCMatchErrors"), 2);
             }
@@ -763,6 +817,7 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    resetTrackMatching();
 
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
@@ -796,9 +851,11 @@ struct EmcalCorrectionTask {
         }
       }
 
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
-      std::vector<o2::emcal::CellLabel> cellLabels;
+      // in parallel mode the cells are kept in the job until the chunk of BCs is clusterized
+      BCClusterizationJob& job = acquireClusterizationJob(bc.globalIndex());
+      std::vector<o2::emcal::Cell>& cellsBC = job.cells;
+      std::vector<int64_t>& cellIndicesBC = job.cellIndices;
+      std::vector<o2::emcal::CellLabel>& cellLabels = job.cellLabels;
       for (const auto& cell : cellsInBC) {
         mHistManager.fill(HIST("hContributors"), cell.mcParticle_as<aod::StoredMcParticles_001>().size());
         auto cellParticles = cell.mcParticle_as<aod::StoredMcParticles_001>();
@@ -868,47 +925,17 @@ struct EmcalCorrectionTask {
       LOG(debug) << "Converted cells. Contains: " << cellsBC.size() << ". Originally " << cellsInBC.size() << ". About to run clusterizer.";
       //  this is a test
       //  Run the clusterizers
+      if (mParallelClusterization) {
+        nBCsProcessed++;
+        if (mNJobs >= static_cast<size_t>(nBCsPerChunk.value)) {
+          flushClusterizationJobs(bcs, collisions, tracks, previousCollisionId, false);
+        }
+        continue;
+      }
       LOG(debug) << "Running clusterizers";
       for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
         cellsToCluster(iClusterizer, cellsBC, cellLabels);
-
-        if (collisionsInFoundBC.size() == 1) {
-          // dummy loop to get the first collision
-          for (const auto& col : collisionsInFoundBC) {
-            if (previousCollisionId > col.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 1);
-              continue;
-            }
-            previousCollisionId = col.globalIndex();
-            if (col.foundBCId() == bc.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 0); // CollisionID ordered and foundBC matches -> Fill as healthy
-              mHistManager.fill(HIST("hCollPerBC"), 1);
-              mHistManager.fill(HIST("hCollisionType"), 1);
-              math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
-
-              MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
-
-              // Store the clusters in the table where a matching collision could
-              // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
-            } else {
-              mHistManager.fill(HIST("hBCMatchErrors"), 2);
-            }
-          }
-        } else { // ambiguous
-          // LOG(warning) << "No vertex found for event. Assuming (0,0,0).";
-          bool hasCollision = false;
-          mHistManager.fill(HIST("hCollPerBC"), collisionsInFoundBC.size());
-          if (collisionsInFoundBC.size() == 0) {
-            mHistManager.fill(HIST("hCollisionType"), 0);
-          } else {
-            hasCollision = true;
-            mHistManager.fill(HIST("hCollisionType"), 2);
-          }
-          fillAmbigousClusterTable<BcEvSels::iterator>(bc, iClusterizer, cellIndicesBC, hasCollision);
-        }
+        fillClustersOfBC(bc, collisionsInFoundBC, iClusterizer, cellIndicesBC, tracks, previousCollisionId, false);
         mClusterPhi.clear();
         mClusterEta.clear();
         LOG(debug) << "Cluster loop done for clusterizer " << iClusterizer;
@@ -917,6 +944,10 @@ struct EmcalCorrectionTask {
       nBCsProcessed++;
     } // end of bc loop
 
+    if (mParallelClusterization) {
+      flushClusterizationJobs(bcs, collisions, tracks, previousCollisionId, false);
+    }
+
     // Loop through all collisions and fill emcalcollisionmatch with a boolean stating, whether the collision was ambiguous (not the only collision in its BC)
     for (const auto& collision : collisions) {
       auto globalbcid = collision.foundBC_as<BcEvSels>().globalIndex();
@@ -958,6 +989,7 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    resetTrackMatching();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
       // Convert aod::Calo to o2::emcal::Cell which can be used with the clusterizer.
@@ -1079,17 +1111,13 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
-              MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, mMatchResult);
 
-              MatchResult indexMapPairSecondary;
-              std::vector<int64_t> secondaryGlobalIndex;
-              doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, secondaryGlobalIndex, tracks);
+              doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, mMatchResultSecondary, tracks);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex, &indexMapPairSecondary, &secondaryGlobalIndex);
+              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &mMatchResult, &mTrackGlobalIndex, &mMatchResultSecondary, &mSecondaryGlobalIndex);
             } else {
               mHistManager.fill(HIST("hBCMatchErrors"), 2);
             }
@@ -1266,44 +1294,243 @@ struct EmcalCorrectionTask {
   }
   PROCESS_SWITCH(EmcalCorrectionTask, processStandalone, "run stand alone analysis", false);
 
-  void cellsToCluster(size_t iClusterizer, const gsl::span<o2::emcal::Cell> cellsBC, gsl::span<const o2::emcal::CellLabel> cellLabels = {})
+  void setupClusterFactory(o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory)
+  {
+    clusterFactory.setGeometry(geometry);
+    clusterFactory.SetECALogWeight(logWeight);
+    clusterFactory.setExoticCellFraction(exoticCellFraction);
+    clusterFactory.setExoticCellDiffTime(exoticCellDiffTime);
+    clusterFactory.setExoticCellMinAmplitude(exoticCellMinAmplitude);
+    clusterFactory.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
+    // TODO: Fix setUseWeightExotic in the O2 code to use bool as argument not float!
+    clusterFactory.setUseWeightExotic(static_cast<float>(useWeightExotic));
+  }
+
+  std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>> makeClusterizer(o2::aod::EMCALClusterDefinition const& clusterDefinition)
+  {
+    auto clusterizer = std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy);
+    clusterizer->setGeometry(geometry);
+    return clusterizer;
+  }
+
+  /// Run one clusterizer on the cells of a BC and build the analysis clusters.
+  /// Only touches the given clusterizer, factory and output, so it can run on a worker thread.
+  static void runClusterizer(o2::emcal::Clusterizer<o2::emcal::Cell>& clusterizer, o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory, const gsl::span<o2::emcal::Cell> cellsBC, gsl::span<const o2::emcal::CellLabel> cellLabels, ClusterizerOutput& output)
   {
-    mClusterizers.at(iClusterizer)->findClusters(cellsBC);
+    clusterizer.findClusters(cellsBC);
 
-    auto emcalClusters = mClusterizers.at(iClusterizer)->getFoundClusters();
-    auto emcalClustersInputIndices = mClusterizers.at(iClusterizer)->getFoundClustersInputIndices();
-    LOG(debug) << "Retrieved results. About to setup cluster factory.";
+    auto emcalClusters = clusterizer.getFoundClusters();
+    auto emcalClustersInputIndices = clusterizer.getFoundClustersInputIndices();
 
     // Convert to analysis clusters.
     // First, the cluster factory requires cluster and cell information in order
     // to build the clusters.
-    mAnalysisClusters.clear();
-    mClusterLabels.clear();
-    mClusterFactories.reset();
+    output.clusters.clear();
+    output.labels.clear();
+    output.phi.clear();
+    output.eta.clear();
+    clusterFactory.reset();
     // in preparation for future O2 changes
     // mClusterFactories.setClusterizerSettings(mClusterDefinitions.at(iClusterizer).minCellEnergy, mClusterDefinitions.at(iClusterizer).timeMin, mClusterDefinitions.at(iClusterizer).timeMax, mClusterDefinitions.at(iClusterizer).recalcShowerShape5x5);
     if (cellLabels.empty()) {
-      mClusterFactories.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices);
+      clusterFactory.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices);
     } else {
-      mClusterFactories.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices, cellLabels);
+      clusterFactory.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices, cellLabels);
     }
 
-    LOG(debug) << "Cluster factory set up.";
-    // Convert to analysis clusters.
-    for (int icl = 0; icl < mClusterFactories.getNumberOfClusters(); icl++) {
+    for (int icl = 0; icl < clusterFactory.getNumberOfClusters(); icl++) {
       o2::emcal::ClusterLabel clusterLabel;
-      auto analysisCluster = mClusterFactories.buildCluster(icl, &clusterLabel);
-      mAnalysisClusters.emplace_back(analysisCluster);
-      mClusterLabels.push_back(clusterLabel);
+      auto analysisCluster = clusterFactory.buildCluster(icl, &clusterLabel);
       auto pos = analysisCluster.getGlobalPosition();
-      mClusterPhi.emplace_back(RecoDecay::constrainAngle(pos.Phi()));
-      mClusterEta.emplace_back(pos.Eta());
-      LOG(debug) << "Cluster " << icl << ": E: " << analysisCluster.E() << ", NCells " << analysisCluster.getNCells();
+      output.phi.emplace_back(RecoDecay::constrainAngle(pos.Phi()));
+      output.eta.emplace_back(pos.Eta());
+      output.clusters.emplace_back(analysisCluster);
+      output.labels.push_back(clusterLabel);
+    }
+  }
+
+  /// Make the clusters of output the current clusters used to fill the tables.
+  /// The previous buffers are handed back to output for reuse.
+  void takeClusters(ClusterizerOutput& output)
+  {
+    std::swap(mAnalysisClusters, output.clusters);
+    std::swap(mClusterLabels, output.labels);
+    std::swap(mClusterPhi, output.phi);
+    std::swap(mClusterEta, output.eta);
+  }
+
+  void cellsToCluster(size_t iClusterizer, const gsl::span<o2::emcal::Cell> cellsBC, gsl::span<const o2::emcal::CellLabel> cellLabels = {})
+  {
+    runClusterizer(*mClusterizers.at(iClusterizer), mClusterFactories, cellsBC, cellLabels, mSerialOutput);
+    takeClusters(mSerialOutput);
+    for (size_t icl = 0; icl < mAnalysisClusters.size(); icl++) {
+      LOG(debug) << "Cluster " << icl << ": E: " << mAnalysisClusters[icl].E() << ", NCells " << mAnalysisClusters[icl].getNCells();
     }
     mHistManager.fill(HIST("hNCluster"), mAnalysisClusters.size());
     LOG(debug) << "Converted to analysis clusters.";
   }
 
+  /// Job holding the cells of the BC. In serial mode the single job is reused for every BC.
+  BCClusterizationJob& acquireClusterizationJob(int64_t bcIndex)
+  {
+    if (mParallelClusterization) {
+      if (mNJobs == mJobs.size()) {
+        mJobs.emplace_back();
+      }
+      mNJobs++;
+    }
+    BCClusterizationJob& job = mJobs[mParallelClusterization ? mNJobs - 1 : 0];
+    job.bcIndex = bcIndex;
+    job.cells.clear();
+    job.cellIndices.clear();
+    job.cellLabels.clear();
+    return job;
+  }
+
+  /// Load the matrices of all supermodules into the geometry. Returns false if one is missing.
+  bool loadSuperModuleMatrices()
+  {
+    if (!geometry) {
+      return false;
+    }
+    for (int iSM = 0; iSM < geometry->GetNumberOfSuperModules(); iSM++) {
+      if (!geometry->GetMatrixForSuperModule(iSM)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Clusterize pending jobs with the given worker until none is left. An exception is kept for the calling thread.
+  void processClusterizationJobs(size_t iWorker)
+  {
+    ClusterizationWorker& worker = *mWorkers[iWorker];
+    try {
+      for (size_t iJob = mPool->nextJob++; iJob < mNJobs; iJob = mPool->nextJob++) {
+        auto& job = mJobs[iJob];
+        job.outputs.resize(worker.clusterizers.size());
+        for (size_t iClusterizer = 0; iClusterizer < worker.clusterizers.size(); iClusterizer++) {
+          runClusterizer(*worker.clusterizers[iClusterizer], worker.clusterFactory, job.cells, job.cellLabels, job.outputs[iClusterizer]);
+        }
+      }
+    } catch (...) {
+      mPool->errors[iWorker] = std::current_exception();
+    }
+  }
+
+  /// Loop of a pool thread: wait for a chunk, clusterize its share of the jobs, report back
+  void clusterizationThread(size_t iWorker)
+  {
+    uint64_t generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mPool->mutex);
+        mPool->wakeUp.wait(lock, [this, generation]() { return mPool->stop || mPool->generation != generation; });
+        if (mPool->stop) {
+          return;
+        }
+        generation = mPool->generation;
+      }
+      processClusterizationJobs(iWorker);
+      {
+        std::lock_guard<std::mutex> lock(mPool->mutex);
+        mPool->nBusy--;
+      }
+      mPool->finished.notify_one();
+    }
+  }
+
+  /// Clusterize all pending jobs on the worker threads. An exception thrown by a worker is rethrown here.
+  void runClusterizationJobs()
+  {
+    mPool->nextJob = 0;
+    {
+      std::lock_guard<std::mutex> lock(mPool->mutex);
+      mPool->nBusy = mPool->threads.size();
+      mPool->generation++;
+    }
+    mPool->wakeUp.notify_all();
+    processClusterizationJobs(0);
+    {
+      std::unique_lock<std::mutex> lock(mPool->mutex);
+      mPool->finished.wait(lock, [this]() { return mPool->nBusy == 0; });
+    }
+    for (auto& error : mPool->errors) {
+      if (error) {
+        std::exception_ptr exception = error;
+        error = nullptr;
+        std::rethrow_exception(exception);
+      }
+    }
+  }
+
+  /// Clusterize the pending jobs in parallel, then fill the tables in BC order as the serial mode does
+  template <typename Collisions>
+  void flushClusterizationJobs(BcEvSels const& bcs, Collisions const& collisions, MyGlobTracks const& tracks, int& previousCollisionId, bool fillTimeReso)
+  {
+    if (mNJobs == 0) {
+      return;
+    }
+    runClusterizationJobs();
+    for (size_t iJob = 0; iJob < mNJobs; iJob++) {
+      auto& job = mJobs[iJob];
+      auto bc = bcs.iteratorAt(job.bcIndex);
+      auto collisionsInFoundBC = collisions.sliceBy(collisionsPerFoundBC, job.bcIndex);
+      for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
+        takeClusters(job.outputs[iClusterizer]);
+        mHistManager.fill(HIST("hNCluster"), mAnalysisClusters.size());
+        fillClustersOfBC(bc, collisionsInFoundBC, iClusterizer, job.cellIndices, tracks, previousCollisionId, fillTimeReso);
+        mClusterPhi.clear();
+        mClusterEta.clear();
+      }
+    }
+    mNJobs = 0;
+  }
+
+  /// Fill the tables with the current clusters of one clusterizer for a BC
+  template <typename BC, typename Collisions>
+  void fillClustersOfBC(BC const& bc, Collisions const& collisionsInFoundBC, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, MyGlobTracks const& tracks, int& previousCollisionId, bool fillTimeReso)
+  {
+    if (collisionsInFoundBC.size() == 1) {
+      // dummy loop to get the first collision
+      for (const auto& col : collisionsInFoundBC) {
+        if (previousCollisionId > col.globalIndex()) {
+          mHistManager.fill(HIST("hBCMatchErrors"), 1);
+          continue;
+        }
+        previousCollisionId = col.globalIndex();
+        if (col.foundBCId() == bc.globalIndex()) {
+          mHistManager.fill(HIST("hBCMatchErrors"), 0); // CollisionID ordered and foundBC matches -> Fill as healthy
+          if (fillTimeReso) {
+            mHistManager.fill(HIST("hCollisionTimeReso"), col.collisionTimeRes());
+          }
+          mHistManager.fill(HIST("hCollPerBC"), 1);
+          mHistManager.fill(HIST("hCollisionType"), 1);
+          math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
+
+          doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, mMatchResult);
+
+          // Store the clusters in the table where a matching collision could
+          // be identified.
+          fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &mMatchResult, &mTrackGlobalIndex);
+        } else {
+          mHistManager.fill(HIST("hBCMatchErrors"), 2);
+        }
+      }
+    } else { // ambiguous
+      // LOG(warning) << "No vertex found for event. Assuming (0,0,0).";
+      bool hasCollision = false;
+      mHistManager.fill(HIST("hCollPerBC"), collisionsInFoundBC.size());
+      if (collisionsInFoundBC.size() == 0) {
+        mHistManager.fill(HIST("hCollisionType"), 0);
+      } else {
+        hasCollision = true;
+        mHistManager.fill(HIST("hCollisionType"), 2);
+      }
+      fillAmbigousClusterTable<BC>(bc, iClusterizer, cellIndicesBC, hasCollision);
+    }
+  }
+
   template <typename Collision>
   void fillClusterTable(Collision const& col, math_utils::Point3D<float> const& vertexPos, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, MatchResult* indexMapPair = nullptr, const std::vector<int64_t>* trackGlobalIndex = nullptr, MatchResult* indexMapPairSecondaries = nullptr, const std::vector<int64_t>* secondariesGlobalIndex = nullptr)
   {
@@ -1367,24 +1594,22 @@ struct EmcalCorrectionTask {
         mHistManager.fill(HIST("hClusterFCrossSigmaShortE"), cluster.E(), cluster.getFCross(), cluster.getM20());
       }
       if (indexMapPair && trackGlobalIndex) {
-        if (iCluster < indexMapPair->matchIndexTrack.size() && !indexMapPair->matchIndexTrack.empty()) {
-          for (unsigned int iTrack = 0; iTrack < indexMapPair->matchIndexTrack[iCluster].size(); iTrack++) {
-            if (indexMapPair->matchIndexTrack[iCluster][iTrack] >= 0) {
-              LOG(debug) << "Found track " << (*trackGlobalIndex)[indexMapPair->matchIndexTrack[iCluster][iTrack]] << " in cluster " << cluster.getID();
-              matchedTracks(clusters.lastIndex(), (*trackGlobalIndex)[indexMapPair->matchIndexTrack[iCluster][iTrack]], indexMapPair->matchDeltaPhi[iCluster][iTrack], indexMapPair->matchDeltaEta[iCluster][iTrack]);
-              mHistManager.fill(HIST("hMatchedPrimaryTracks"), indexMapPair->matchDeltaEta[iCluster][iTrack], indexMapPair->matchDeltaPhi[iCluster][iTrack]);
-            }
+        if (iCluster < indexMapPair->nClusters()) {
+          for (int iMatch = indexMapPair->begin(iCluster); iMatch < indexMapPair->end(iCluster); iMatch++) {
+            const int64_t trackId = (*trackGlobalIndex)[indexMapPair->matchIndexTrack[iMatch]];
+            LOG(debug) << "Found track " << trackId << " in cluster " << cluster.getID();
+            matchedTracks(clusters.lastIndex(), trackId, indexMapPair->matchDeltaPhi[iMatch], indexMapPair->matchDeltaEta[iMatch]);
+            mHistManager.fill(HIST("hMatchedPrimaryTracks"), indexMapPair->matchDeltaEta[iMatch], indexMapPair->matchDeltaPhi[iMatch]);
           }
         }
       }
       if (indexMapPairSecondaries && secondariesGlobalIndex) {
-        if (iCluster < indexMapPairSecondaries->matchIndexTrack.size() && !indexMapPairSecondaries->matchIndexTrack.empty()) {
-          for (unsigned int iTrack = 0; iTrack < indexMapPairSecondaries->matchIndexTrack[iCluster].size(); iTrack++) {
-            if (indexMapPairSecondaries->matchIndexTrack[iCluster][iTrack] >= 0) {
-              LOG(debug) << "Found secondary track " << (*secondariesGlobalIndex)[indexMapPairSecondaries->matchIndexTrack[iCluster][iTrack]] << " in cluster " << cluster.getID();
-              matchedSecondaries(clusters.lastIndex(), (*secondariesGlobalIndex)[indexMapPairSecondaries->matchIndexTrack[iCluster][iTrack]], indexMapPairSecondaries->matchDeltaPhi[iCluster][iTrack], indexMapPairSecondaries->matchDeltaEta[iCluster][iTrack]);
-              mHistManager.fill(HIST("hMatchedSecondaries"), indexMapPairSecondaries->matchDeltaEta[iCluster][iTrack], indexMapPairSecondaries->matchDeltaPhi[iCluster][iTrack]);
-            }
+        if (iCluster < indexMapPairSecondaries->nClusters()) {
+          for (int iMatch = indexMapPairSecondaries->begin(iCluster); iMatch < indexMapPairSecondaries->end(iCluster); iMatch++) {
+            const int64_t trackId = (*secondariesGlobalIndex)[indexMapPairSecondaries->matchIndexTrack[iMatch]];
+            LOG(debug) << "Found secondary track " << trackId << " in cluster " << cluster.getID();
+            matchedSecondaries(clusters.lastIndex(), trackId, indexMapPairSecondaries->matchDeltaPhi[iMatch], indexMapPairSecondaries->matchDeltaEta[iMatch]);
+            mHistManager.fill(HIST("hMatchedSecondaries"), indexMapPairSecondaries->matchDeltaEta[iMatch], indexMapPairSecondaries->matchDeltaPhi[iMatch]);
           }
         }
       }
@@ -1440,56 +1665,72 @@ struct EmcalCorrectionTask {
     } // end of cluster loop
   }
 
+  void resetTrackMatching()
+  {
+    mTrackIndexCollisionId = -1;
+    mSecondaryIndexCollisionId = -1;
+  }
+
   template <typename Collision>
-  void doTrackMatching(Collision const& col, MyGlobTracks const& tracks, MatchResult& indexMapPair, std::vector<int64_t>& trackGlobalIndex)
+  void doTrackMatching(Collision const& col, MyGlobTracks const& tracks, MatchResult& indexMapPair)
   {
-    auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
-    int nTracksInCol = groupedTracks.size();
-    std::vector<float> trackPhi;
-    std::vector<float> trackEta;
-    // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(nTracksInCol);
-    trackEta.reserve(nTracksInCol);
-    trackGlobalIndex.reserve(nTracksInCol);
-    fillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
-
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, MaxMatchesPerCluster);
+    // the tracks do not depend on the clusterizer, build the grid only for the first one
+    if (col.globalIndex() != mTrackIndexCollisionId) {
+      auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
+      int nTracksInCol = groupedTracks.size();
+      std::vector<float> trackPhi;
+      std::vector<float> trackEta;
+      // reserve memory to reduce on the fly memory allocation
+      trackPhi.reserve(nTracksInCol);
+      trackEta.reserve(nTracksInCol);
+      mTrackGlobalIndex.clear();
+      mTrackGlobalIndex.reserve(nTracksInCol);
+      fillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, mTrackGlobalIndex);
+      mTrackIndex.build(trackPhi, trackEta, maxMatchingDistance);
+      mTrackIndexCollisionId = col.globalIndex();
+    }
+    matchTracksToCluster(mTrackIndex, mClusterPhi, mClusterEta, maxMatchingDistance, MaxMatchesPerCluster, indexMapPair);
   }
 
   template <typename Collision>
-  void doSecondaryTrackMatching(Collision const& col, EMV0Legs const& v0legs, MatchResult& indexMapPair, std::vector<int64_t>& trackGlobalIndex, MyGlobTracks const& tracks)
+  void doSecondaryTrackMatching(Collision const& col, EMV0Legs const& v0legs, MatchResult& indexMapPair, MyGlobTracks const& tracks)
   {
-    auto groupedV0Legs = v0legs.sliceBy(perCollisionEMV0Legs, col.globalIndex());
-    int nLegsInCol = groupedV0Legs.size();
-    std::vector<float> trackPhi;
-    std::vector<float> trackEta;
-    // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(nLegsInCol);
-    trackEta.reserve(nLegsInCol);
-    trackGlobalIndex.reserve(nLegsInCol);
-
-    float trackEtaEmcal = 0.f;
-    float trackPhiEmcal = 0.f;
-    for (const auto& leg : groupedV0Legs) {
-      if (leg.trackId() < 0 || leg.trackId() > tracks.size()) {
-        continue;
-      }
-      auto track = tracks.iteratorAt(leg.trackId());
-      trackEtaEmcal = track.trackEtaEmcal();
-      trackPhiEmcal = track.trackPhiEmcal();
-      // Tracks that do not point to the EMCal/DCal/PHOS get default values of -999
-      // This way we can cut out tracks that do not point to the EMCal+DCal
-      if (trackEtaEmcal < TrackNotOnEMCal || trackPhiEmcal < TrackNotOnEMCal) {
-        continue;
-      }
-      if (trackMinPt > 0 && track.pt() < trackMinPt) {
-        continue;
+    if (col.globalIndex() != mSecondaryIndexCollisionId) {
+      auto groupedV0Legs = v0legs.sliceBy(perCollisionEMV0Legs, col.globalIndex());
+      int nLegsInCol = groupedV0Legs.size();
+      std::vector<float> trackPhi;
+      std::vector<float> trackEta;
+      // reserve memory to reduce on the fly memory allocation
+      trackPhi.reserve(nLegsInCol);
+      trackEta.reserve(nLegsInCol);
+      mSecondaryGlobalIndex.clear();
+      mSecondaryGlobalIndex.reserve(nLegsInCol);
+
+      float trackEtaEmcal = 0.f;
+      float trackPhiEmcal = 0.f;
+      for (const auto& leg : groupedV0Legs) {
+        if (leg.trackId() < 0 || leg.trackId() > tracks.size()) {
+          continue;
+        }
+        auto track = tracks.iteratorAt(leg.trackId());
+        trackEtaEmcal = track.trackEtaEmcal();
+        trackPhiEmcal = track.trackPhiEmcal();
+        // Tracks that do not point to the EMCal/DCal/PHOS get default values of -999
+        // This way we can cut out tracks that do not point to the EMCal+DCal
+        if (trackEtaEmcal < TrackNotOnEMCal || trackPhiEmcal < TrackNotOnEMCal) {
+          continue;
+        }
+        if (trackMinPt > 0 && track.pt() < trackMinPt) {
+          continue;
+        }
+        trackPhi.emplace_back(RecoDecay::constrainAngle(trackPhiEmcal));
+        trackEta.emplace_back(trackEtaEmcal);
+        mSecondaryGlobalIndex.emplace_back(track.globalIndex());
       }
-      trackPhi.emplace_back(RecoDecay::constrainAngle(trackPhiEmcal));
-      trackEta.emplace_back(trackEtaEmcal);
-      trackGlobalIndex.emplace_back(track.globalIndex());
+      mSecondaryIndex.build(trackPhi, trackEta, maxMatchingDistance);
+      mSecondaryIndexCollisionId = col.globalIndex();
     }
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, MaxMatchesPerCluster);
+    matchTracksToCluster(mSecondaryIndex, mClusterPhi, mClusterEta, maxMatchingDistance, MaxMatchesPerCluster, indexMapPair);
   }
 
   template <typename Tracks>
@@ -44,6 +44,9 @@ struct HeavyFlavourDefinitionTask {
   Preslice<aod::JetParticles> particlesPerCollision = aod::jmcparticle::mcCollisionId;
   Preslice<soa::Join<aod::JMcParticles, aod::JMcParticlePIs>> particlesPerMcCollision = aod::jmcparticle::mcCollisionId;
 
+  jettaggingutilities::JetFlavourIndex flavourIndex;
+  jettaggingutilities::HfShowerOriginCache originCache;
+
   void init(InitContext const&)
   {
   }
@@ -55,8 +58,9 @@ struct HeavyFlavourDefinitionTask {
 
   void processMCDByConstituents(aod::JetCollision const& /*collision*/, JetTableMCD const& mcdjets, JetTracksMCD const& tracks, aod::JetParticles const& particles)
   {
+    originCache.reset(particles);
     for (auto const& mcdjet : mcdjets) {
-      int8_t origin = jettaggingutilities::mcdJetFromHFShower(mcdjet, tracks, particles, maxDeltaR, searchUpToQuark);
+      int8_t origin = jettaggingutilities::mcdJetFromHFShower(mcdjet, tracks, particles, maxDeltaR, searchUpToQuark, &originCache);
       flavourTableMCD(origin);
     }
   }
@@ -64,15 +68,19 @@ struct HeavyFlavourDefinitionTask {
 
   void processMCDByDistance(soa::Join<aod::JCollisions, aod::JCollisionPIs, aod::JMcCollisionLbs>::iterator const& collision, soa::Join<JetTableMCD, aod::ChargedMCDetectorLevelJetsMatchedToChargedMCParticleLevelJets> const& mcdjets, soa::Join<JetTableMCP, aod::ChargedMCParticleLevelJetsMatchedToChargedMCDetectorLevelJets> const& /*mcpjets*/, aod::JetParticles const& particles) // it used only for charged jets now
   {
+    if (mcdjets.size() == 0) {
+      return;
+    }
+    auto const particlesPerColl = particles.sliceBy(particlesPerCollision, collision.mcCollisionId());
+    flavourIndex.build(particlesPerColl);
     for (auto const& mcdjet : mcdjets) {
-      auto const particlesPerColl = particles.sliceBy(particlesPerCollision, collision.mcCollisionId());
       int8_t origin = -1;
       if (mcdjet.has_matchedJetGeo()) {
         for (auto const& mcpjet : mcdjet.template matchedJetGeo_as<soa::Join<JetTableMCP, aod::ChargedMCParticleLevelJetsMatchedToChargedMCDetectorLevelJets>>()) {
           if (searchUpToQuark) {
-            origin = jettaggingutilities::getJetFlavor(mcpjet, particlesPerColl);
+            origin = flavourIndex.getJetFlavor(mcpjet);
           } else {
-            origin = jettaggingutilities::getJetFlavorHadron(mcpjet, particlesPerColl);
+            origin = flavourIndex.getJetFlavorHadron(mcpjet);
           }
         }
       } else {
@@ -85,8 +93,9 @@ struct HeavyFlavourDefinitionTask {
 
   void processMCPByConstituents(JetTableMCP const& mcpjets, aod::JetParticles const& particles)
   {
+    originCache.reset(particles);
     for (auto const& mcpjet : mcpjets) {
-      int8_t origin = jettaggingutilities::mcpJetFromHFShower(mcpjet, particles, maxDeltaR, searchUpToQuark);
+      int8_t origin = jettaggingutilities::mcpJetFromHFShower(mcpjet, particles, maxDeltaR, searchUpToQuark, &originCache);
       flavourTableMCP(origin);
     }
   }
@@ -94,12 +103,16 @@ struct HeavyFlavourDefinitionTask {
 
   void processMCPByDistance(aod::JetMcCollision const& /*mcCollision*/, JetTableMCP const& mcpjets, aod::JetParticles const& particles)
   {
+    if (mcpjets.size() == 0) {
+      return;
+    }
+    flavourIndex.build(particles);
     for (auto const& mcpjet : mcpjets) {
       int8_t origin = -1;
       if (searchUpToQuark) {
-        origin = jettaggingutilities::getJetFlavor(mcpjet, particles);
+        origin = flavourIndex.getJetFlavor(mcpjet);
       } else {
-        origin = jettaggingutilities::getJetFlavorHadron(mcpjet, particles);
+        origin = flavourIndex.getJetFlavorHadron(mcpjet);
       }
       flavourTableMCP(origin);
     }
@@ -92,6 +92,8 @@ struct JetTaggerHFTask {
   Configurable<std::vector<float>> paramsResoFuncBeautyJetMC{"paramsResoFuncBeautyJetMC", std::vector<float>{-1.0}, "parameters of gaus(0)+expo(3)+expo(5)+expo(7)))"};
   Configurable<std::vector<float>> paramsResoFuncLfJetMC{"paramsResoFuncLfJetMC", std::vector<float>{-1.0}, "parameters of gaus(0)+expo(3)+expo(5)+expo(7)))"};
   Configurable<float> minSignImpXYSig{"minSignImpXYSig", -40.0, "minimum of signed impact parameter significance"};
+  Configurable<int> nNodesResoFuncTable{"nNodesResoFuncTable", jettaggingutilities::ResolutionFunctionCdf::DefaultNodes, "number of nodes of the tabulated cumulative resolution functions used for the track probability"};
+  Configurable<bool> validateResoFuncTable{"validateResoFuncTable", false, "compare the tabulated track probabilities with the TF1 integrals at init"};
   Configurable<float> tagPointForIP{"tagPointForIP", 2.5, "tagging working point for IP"};
   Configurable<float> tagPointForIPxyz{"tagPointForIPxyz", 2.5, "tagging working point for IP xyz"};
   Configurable<int64_t> timestampCCDBForIP{"timestampCCDBForIP", -1, "timestamp of the resolution function file for IP method used to query in CCDB"};
@@ -173,6 +175,19 @@ struct JetTaggerHFTask {
   std::vector<std::unique_ptr<TF1>> vecfSignImpXYSigBeautyJetMcCCDB;
   std::vector<std::unique_ptr<TF1>> vecfSignImpXYSigLfJetMcCCDB;
 
+  // resolution functions tabulated at init, used for the track probabilities
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigData;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigIncJetMC;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigCharmJetMC;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigBeautyJetMC;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigLfJetMC;
+
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> vecCdfSignImpXYSigDataJetCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> vecCdfSignImpXYSigIncJetMcCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> vecCdfSignImpXYSigCharmJetMcCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> vecCdfSignImpXYSigBeautyJetMcCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> vecCdfSignImpXYSigLfJetMcCCDB;
+
   std::vector<uint16_t> decisionNonML;
   std::vector<float> scoreML;
 
@@ -184,35 +199,35 @@ struct JetTaggerHFTask {
     float jetProb = -1.0;
     if (!isMC) {
       if (usepTcategorize) {
-        jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigDataJetCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+        jetProb = jettaggingutilities::getJetProbability(vecCdfSignImpXYSigDataJetCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
       } else {
-        jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigData, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+        jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigData, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
       }
     } else {
       if (useResoFuncFromIncJet) {
         if (usepTcategorize) {
-          jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigIncJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+          jetProb = jettaggingutilities::getJetProbability(vecCdfSignImpXYSigIncJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
         } else {
-          jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigIncJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+          jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigIncJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
         }
       } else {
         if (origin == JetTaggingSpecies::charm) {
           if (usepTcategorize) {
-            jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigCharmJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(vecCdfSignImpXYSigCharmJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           } else {
-            jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigCharmJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigCharmJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           }
         } else if (origin == JetTaggingSpecies::beauty) {
           if (usepTcategorize) {
-            jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigBeautyJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(vecCdfSignImpXYSigBeautyJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           } else {
-            jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigBeautyJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigBeautyJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           }
         } else {
           if (usepTcategorize) {
-            jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigLfJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(vecCdfSignImpXYSigLfJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           } else {
-            jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigLfJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigLfJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           }
         }
       }
@@ -229,23 +244,23 @@ struct JetTaggerHFTask {
       auto geoSign = jettaggingutilities::getGeoSign(jet, track);
       float probTrack = -1;
       if (!isMC) {
-        probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigData, track, minSignImpXYSig);
+        probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigData, track, minSignImpXYSig);
         if (geoSign > 0)
           registry.fill(HIST("h_pos_track_probability"), probTrack);
         else
           registry.fill(HIST("h_neg_track_probability"), probTrack);
       } else {
         if (useResoFuncFromIncJet) {
-          probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigIncJetMC, track, minSignImpXYSig);
+          probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigIncJetMC, track, minSignImpXYSig);
         } else {
           if (origin == JetTaggingSpecies::charm) {
-            probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigCharmJetMC, track, minSignImpXYSig);
+            probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigCharmJetMC, track, minSignImpXYSig);
           }
           if (origin == JetTaggingSpecies::beauty) {
-            probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigBeautyJetMC, track, minSignImpXYSig);
+            probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigBeautyJetMC, track, minSignImpXYSig);
           }
           if (origin == JetTaggingSpecies::lightflavour) {
-            probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigLfJetMC, track, minSignImpXYSig);
+            probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigLfJetMC, track, minSignImpXYSig);
           }
         }
         if (geoSign > 0)
@@ -498,6 +513,36 @@ struct JetTaggerHFTask {
       vecfSignImpXYSigLfJetMcCCDB.emplace_back(jettaggingutilities::setResolutionFunction(params));
     }
 
+    // Tabulate the cumulative resolution functions once, the track probabilities are then table lookups
+    if (useJetProb) {
+      if constexpr (!isMCD) {
+        cdfSignImpXYSigData.compile(fSignImpXYSigData.get(), minSignImpXYSig, nNodesResoFuncTable);
+      } else if (useResoFuncFromIncJet) {
+        cdfSignImpXYSigIncJetMC.compile(fSignImpXYSigIncJetMC.get(), minSignImpXYSig, nNodesResoFuncTable);
+      } else {
+        cdfSignImpXYSigCharmJetMC.compile(fSignImpXYSigCharmJetMC.get(), minSignImpXYSig, nNodesResoFuncTable);
+        cdfSignImpXYSigBeautyJetMC.compile(fSignImpXYSigBeautyJetMC.get(), minSignImpXYSig, nNodesResoFuncTable);
+        cdfSignImpXYSigLfJetMC.compile(fSignImpXYSigLfJetMC.get(), minSignImpXYSig, nNodesResoFuncTable);
+      }
+      vecCdfSignImpXYSigDataJetCCDB = jettaggingutilities::setResolutionFunctionCdfs(vecfSignImpXYSigDataJetCCDB, minSignImpXYSig, nNodesResoFuncTable);
+      vecCdfSignImpXYSigIncJetMcCCDB = jettaggingutilities::setResolutionFunctionCdfs(vecfSignImpXYSigIncJetMcCCDB, minSignImpXYSig, nNodesResoFuncTable);
+      vecCdfSignImpXYSigCharmJetMcCCDB = jettaggingutilities::setResolutionFunctionCdfs(vecfSignImpXYSigCharmJetMcCCDB, minSignImpXYSig, nNodesResoFuncTable);
+      vecCdfSignImpXYSigBeautyJetMcCCDB = jettaggingutilities::setResolutionFunctionCdfs(vecfSignImpXYSigBeautyJetMcCCDB, minSignImpXYSig, nNodesResoFuncTable);
+      vecCdfSignImpXYSigLfJetMcCCDB = jettaggingutilities::setResolutionFunctionCdfs(vecfSignImpXYSigLfJetMcCCDB, minSignImpXYSig, nNodesResoFuncTable);
+      if (validateResoFuncTable) {
+        auto validate = [&](jettaggingutilities::ResolutionFunctionCdf const& cdf, std::unique_ptr<TF1> const& fResoFunc, const std::string& name) {
+          if (cdf.isValid()) {
+            LOG(info) << "max. deviation of tabulated track probability (" << name << "): " << cdf.getMaxDeviation(fResoFunc.get(), minSignImpXYSig);
+          }
+        };
+        validate(cdfSignImpXYSigData, fSignImpXYSigData, "data");
+        validate(cdfSignImpXYSigIncJetMC, fSignImpXYSigIncJetMC, "inclusive MC");
+        validate(cdfSignImpXYSigCharmJetMC, fSignImpXYSigCharmJetMC, "charm MC");
+        validate(cdfSignImpXYSigBeautyJetMC, fSignImpXYSigBeautyJetMC, "beauty MC");
+        validate(cdfSignImpXYSigLfJetMC, fSignImpXYSigLfJetMC, "light flavour MC");
+      }
+    }
+
     // Use QA for effectivness of track probability
     if (trackProbQA) {
       AxisSpec trackProbabilityAxis = {binTrackProbability, "Track proability"};
@@ -45,6 +45,7 @@
 #include <fastjet/PseudoJet.hh>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <type_traits>
@@ -83,8 +84,8 @@ struct JetSubstructureTask {
 
   Service<o2::framework::O2DatabasePDG> pdg;
   std::vector<fastjet::PseudoJet> jetConstituents;
-  std::vector<fastjet::PseudoJet> jetReclustered;
   JetFinder jetReclusterer;
+  jetsubstructureutilities::JetReclusteringHistory reclusteringHistory;
 
   std::vector<float> energyMotherVec;
   std::vector<float> ptLeadingVec;
@@ -143,19 +144,14 @@ struct JetSubstructureTask {
     ptLeadingVec.clear();
     ptSubLeadingVec.clear();
     thetaVec.clear();
-    jetReclustered.clear();
-    fastjet::ClusterSequenceArea clusterSeq(jetReclusterer.findJets(jetConstituents, jetReclustered));
-    jetReclustered = sorted_by_pt(jetReclustered);
-    fastjet::PseudoJet daughterSubJet = jetReclustered[0];
-    fastjet::PseudoJet parentSubJet1;
-    fastjet::PseudoJet parentSubJet2;
-    bool softDropped = false;
-    auto nsd = 0.0;
-
-    while (daughterSubJet.has_parents(parentSubJet1, parentSubJet2)) {
-      if (parentSubJet1.perp() < parentSubJet2.perp()) {
-        std::swap(parentSubJet1, parentSubJet2);
-      }
+    reclusteringHistory.recluster(jetConstituents, jetReclusterer);
+    const float jetR = jet.r() / 100.f;
+    const std::size_t iSoftDrop = reclusteringHistory.softDropSplitting(zCut, beta, jetR);
+    const auto nsd = static_cast<double>(reclusteringHistory.nSoftDrop(zCut, beta, jetR));
+
+    for (std::size_t iSplitting = 0; iSplitting < reclusteringHistory.size(); iSplitting++) {
+      const auto& parentSubJet1 = reclusteringHistory.harder(iSplitting);
+      const auto& parentSubJet2 = reclusteringHistory.softer(iSplitting);
       std::vector<int32_t> tracks;
       std::vector<int32_t> candidates;
       std::vector<int32_t> clusters;
@@ -165,34 +161,27 @@ struct JetSubstructureTask {
         }
       }
       splittingTable(jet.globalIndex(), tracks, clusters, candidates, parentSubJet2.perp(), parentSubJet2.eta(), parentSubJet2.phi(), 0);
-      auto z = parentSubJet2.perp() / (parentSubJet1.perp() + parentSubJet2.perp());
-      auto theta = parentSubJet1.delta_R(parentSubJet2);
-      energyMotherVec.push_back(daughterSubJet.e());
+      energyMotherVec.push_back(reclusteringHistory.mother(iSplitting).e());
       ptLeadingVec.push_back(parentSubJet1.pt());
       ptSubLeadingVec.push_back(parentSubJet2.pt());
-      thetaVec.push_back(theta);
-
-      if (z >= zCut * TMath::Power(theta / (jet.r() / 100.f), beta)) {
-        if (!softDropped) {
-          auto zg = z;
-          auto rg = theta;
-          if constexpr (!isSubtracted && !isMCP) {
-            registry.fill(HIST("h2_jet_pt_jet_zg"), jet.pt(), zg);
-            registry.fill(HIST("h2_jet_pt_jet_rg"), jet.pt(), rg);
-          }
-          if constexpr (!isSubtracted && isMCP) {
-            registry.fill(HIST("h2_jet_pt_part_jet_zg_part"), jet.pt(), zg);
-            registry.fill(HIST("h2_jet_pt_part_jet_rg_part"), jet.pt(), rg);
-          }
-          if constexpr (isSubtracted && !isMCP) {
-            registry.fill(HIST("h2_jet_pt_jet_zg_eventwiseconstituentsubtracted"), jet.pt(), zg);
-            registry.fill(HIST("h2_jet_pt_jet_rg_eventwiseconstituentsubtracted"), jet.pt(), rg);
-          }
-          softDropped = true;
-        }
-        nsd++;
+      thetaVec.push_back(reclusteringHistory.theta(iSplitting));
+    }
+
+    if (iSoftDrop < reclusteringHistory.size()) {
+      auto zg = reclusteringHistory.z(iSoftDrop);
+      auto rg = reclusteringHistory.theta(iSoftDrop);
+      if constexpr (!isSubtracted && !isMCP) {
+        registry.fill(HIST("h2_jet_pt_jet_zg"), jet.pt(), zg);
+        registry.fill(HIST("h2_jet_pt_jet_rg"), jet.pt(), rg);
+      }
+      if constexpr (!isSubtracted && isMCP) {
+        registry.fill(HIST("h2_jet_pt_part_jet_zg_part"), jet.pt(), zg);
+        registry.fill(HIST("h2_jet_pt_part_jet_rg_part"), jet.pt(), rg);
+      }
+      if constexpr (isSubtracted && !isMCP) {
+        registry.fill(HIST("h2_jet_pt_jet_zg_eventwiseconstituentsubtracted"), jet.pt(), zg);
+        registry.fill(HIST("h2_jet_pt_jet_rg_eventwiseconstituentsubtracted"), jet.pt(), rg);
       }
-      daughterSubJet = parentSubJet1;
     }
     if constexpr (!isSubtracted && !isMCP) {
       registry.fill(HIST("h2_jet_pt_jet_nsd"), jet.pt(), nsd);
@@ -343,8 +332,8 @@ struct JetSubstructureTask {
     for (auto& jetConstituent : jet.template tracks_as<U>()) {
       fastjetutilities::fillTracks(jetConstituent, jetConstituents, jetConstituent.globalIndex());
     }
-    nSub = jetsubstructureutilities::getNSubjettiness(jet, tracks, tracks, tracks, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetReclustering<false, isSubtracted>(jet, splittingTable);
+    nSub = jetsubstructureutilities::getNSubjettiness(reclusteringHistory, jet.r() / 100.f, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetPairing<false>(jet, tracks, trackSlicer, pairTable);
     jetSubstructureSimple(jet, tracks);
     outputTable(energyMotherVec, ptLeadingVec, ptSubLeadingVec, thetaVec, nSub[0], nSub[1], nSub[2], pairJetPtVec, pairJetEnergyVec, pairJetThetaVec, pairJetPerpCone1PtVec, pairJetPerpCone1EnergyVec, pairJetPerpCone1ThetaVec, pairPerpCone1PerpCone1PtVec, pairPerpCone1PerpCone1EnergyVec, pairPerpCone1PerpCone1ThetaVec, pairPerpCone1PerpCone2PtVec, pairPerpCone1PerpCone2EnergyVec, pairPerpCone1PerpCone2ThetaVec, angularity, leadingConstituentPt, perpConeRho);
@@ -383,8 +372,8 @@ struct JetSubstructureTask {
     for (auto& jetConstituent : jet.template tracks_as<aod::JetParticles>()) {
       fastjetutilities::fillTracks(jetConstituent, jetConstituents, jetConstituent.globalIndex(), JetConstituentStatus::track, pdg->Mass(jetConstituent.pdgCode()));
     }
-    nSub = jetsubstructureutilities::getNSubjettiness(jet, particles, particles, particles, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetReclustering<true, false>(jet, jetSplittingsMCPTable);
+    nSub = jetsubstructureutilities::getNSubjettiness(reclusteringHistory, jet.r() / 100.f, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetPairing<true>(jet, particles, ParticlesPerMcCollision, jetPairsMCPTable);
     jetSubstructureSimple(jet, particles);
     jetSubstructureMCPTable(energyMotherVec, ptLeadingVec, ptSubLeadingVec, thetaVec, nSub[0], nSub[1], nSub[2], pairJetPtVec, pairJetEnergyVec, pairJetThetaVec, pairJetPerpCone1PtVec, pairJetPerpCone1EnergyVec, pairJetPerpCone1ThetaVec, pairPerpCone1PerpCone1PtVec, pairPerpCone1PerpCone1EnergyVec, pairPerpCone1PerpCone1ThetaVec, pairPerpCone1PerpCone2PtVec, pairPerpCone1PerpCone2EnergyVec, pairPerpCone1PerpCone2ThetaVec, angularity, leadingConstituentPt, perpConeRho);
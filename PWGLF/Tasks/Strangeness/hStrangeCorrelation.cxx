@@ -27,6 +27,7 @@
 #include "PWGLF/Utils/inelGt.h"
 
 #include "Common/CCDB/EventSelectionParams.h"
+#include "Common/Core/CorrectionMap.h"
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/Zorro.h"
 #include "Common/Core/ZorroSummary.h"
@@ -364,43 +365,43 @@ struct HStrangeCorrelation {
   ValidCollisions validCollisions;
 
   // objects to use for efficiency corrections
-  TH2F* hEfficiencyTrigger = nullptr;
-  TH3F* hEfficiencyTriggerMult = nullptr;
-  THnF* hEfficiencyTriggerMultVsPhi = nullptr;
-  TH2F* hEfficiencyPion = nullptr;
-  TH2F* hEfficiencyK0Short = nullptr;
-  THnF* hEfficiencyK0ShortMultVsPhi = nullptr;
-  TH2F* hEfficiencyLambda = nullptr;
-  THnF* hEfficiencyLambdaMultVsPhi = nullptr;
-  TH2F* hEfficiencyAntiLambda = nullptr;
-  THnF* hEfficiencyAntiLambdaMultVsPhi = nullptr;
-  TH2F* hEfficiencyXiMinus = nullptr;
-  THnF* hEfficiencyXiMinusMultVsPhi = nullptr;
-  TH2F* hEfficiencyXiPlus = nullptr;
-  THnF* hEfficiencyXiPlusMultVsPhi = nullptr;
-  TH2F* hEfficiencyOmegaMinus = nullptr;
-  THnF* hEfficiencyOmegaMinusMultVsPhi = nullptr;
-  TH2F* hEfficiencyOmegaPlus = nullptr;
-  THnF* hEfficiencyOmegaPlusMultVsPhi = nullptr;
-  TH2F* hEfficiencyHadron = nullptr;
-  TH3F* hEfficiencyHadronMult = nullptr;
-  TH1F* hPurityHadron = nullptr;
-  TH2F* hPurityHadronMult = nullptr;
+  o2::common::core::CorrectionMap hEfficiencyTrigger;
+  o2::common::core::CorrectionMap hEfficiencyTriggerMult;
+  o2::common::core::CorrectionMap hEfficiencyTriggerMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyPion;
+  o2::common::core::CorrectionMap hEfficiencyK0Short;
+  o2::common::core::CorrectionMap hEfficiencyK0ShortMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyLambda;
+  o2::common::core::CorrectionMap hEfficiencyLambdaMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyAntiLambda;
+  o2::common::core::CorrectionMap hEfficiencyAntiLambdaMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyXiMinus;
+  o2::common::core::CorrectionMap hEfficiencyXiMinusMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyXiPlus;
+  o2::common::core::CorrectionMap hEfficiencyXiPlusMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyOmegaMinus;
+  o2::common::core::CorrectionMap hEfficiencyOmegaMinusMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyOmegaPlus;
+  o2::common::core::CorrectionMap hEfficiencyOmegaPlusMultVsPhi;
+  o2::common::core::CorrectionMap hEfficiencyHadron;
+  o2::common::core::CorrectionMap hEfficiencyHadronMult;
+  o2::common::core::CorrectionMap hPurityHadron;
+  o2::common::core::CorrectionMap hPurityHadronMult;
   // objects to propagate the efficiency uncertainty
-  TH2F* hEfficiencyUncertaintyTrigger = nullptr;
-  TH3F* hEfficiencyUncertaintyTriggerMult = nullptr;
-  TH2F* hEfficiencyUncertaintyPion = nullptr;
-  TH2F* hEfficiencyUncertaintyK0Short = nullptr;
-  TH2F* hEfficiencyUncertaintyLambda = nullptr;
-  TH2F* hEfficiencyUncertaintyAntiLambda = nullptr;
-  TH2F* hEfficiencyUncertaintyXiMinus = nullptr;
-  TH2F* hEfficiencyUncertaintyXiPlus = nullptr;
-  TH2F* hEfficiencyUncertaintyOmegaMinus = nullptr;
-  TH2F* hEfficiencyUncertaintyOmegaPlus = nullptr;
-  TH2F* hEfficiencyUncertaintyHadron = nullptr;
-  TH3F* hEfficiencyUncertaintyHadronMult = nullptr;
-  TH1F* hPurityUncertaintyHadron = nullptr;
-  TH2F* hPurityUncertaintyHadronMult = nullptr;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyTrigger;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyTriggerMult;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyPion;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyK0Short;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyLambda;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyAntiLambda;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyXiMinus;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyXiPlus;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyOmegaMinus;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyOmegaPlus;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyHadron;
+  o2::common::core::CorrectionMap hEfficiencyUncertaintyHadronMult;
+  o2::common::core::CorrectionMap hPurityUncertaintyHadron;
+  o2::common::core::CorrectionMap hPurityUncertaintyHadronMult;
 
   using BinningTypePP = ColumnBinningPolicy<aod::collision::PosZ, aod::cent::CentFT0M>;
   using BinningTypePbPb = ColumnBinningPolicy<aod::collision::PosZ, aod::cent::CentFT0C>;
@@ -788,46 +789,46 @@ struct HStrangeCorrelation {
       LOG(fatal) << "Problem getting TList object with efficiencies!";
     }
 
-    hEfficiencyTrigger = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyTrigger"));
-    hEfficiencyTriggerMult = dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyTriggerMult"));
-    hEfficiencyTriggerMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyTriggerMultVsPhi"));
-    hEfficiencyK0Short = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyK0Short"));
-    hEfficiencyK0ShortMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyK0ShortMultVsPhi"));
-    hEfficiencyLambda = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyLambda"));
-    hEfficiencyLambdaMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyLambdaMultVsPhi"));
-    hEfficiencyAntiLambda = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyAntiLambda"));
-    hEfficiencyAntiLambdaMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyAntiLambdaMultVsPhi"));
-    hEfficiencyXiMinus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyXiMinus"));
-    hEfficiencyXiMinusMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyXiMinusMultVsPhi"));
-    hEfficiencyXiPlus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyXiPlus"));
-    hEfficiencyXiPlusMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyXiPlusMultVsPhi"));
-    hEfficiencyOmegaMinus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyOmegaMinus"));
-    hEfficiencyOmegaMinusMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyOmegaMinusMultVsPhi"));
-    hEfficiencyOmegaPlus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyOmegaPlus"));
-    hEfficiencyOmegaPlusMultVsPhi = dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyOmegaPlusMultVsPhi"));
-    hEfficiencyHadron = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyHadron"));
-    hEfficiencyHadronMult = dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyHadronMult"));
-    hEfficiencyPion = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyPion"));
-    hPurityHadron = dynamic_cast<TH1F*>(listEfficiencies->FindObject("hPurityHadron"));
-    hPurityHadronMult = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hPurityHadronMult"));
-    hEfficiencyUncertaintyTrigger = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyTrigger"));
-    hEfficiencyUncertaintyTriggerMult = dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyTriggerMult"));
-    hEfficiencyUncertaintyK0Short = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyK0Short"));
-    hEfficiencyUncertaintyLambda = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyLambda"));
-    hEfficiencyUncertaintyAntiLambda = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyAntiLambda"));
-    hEfficiencyUncertaintyXiMinus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyXiMinus"));
-    hEfficiencyUncertaintyXiPlus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyXiPlus"));
-    hEfficiencyUncertaintyOmegaMinus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyOmegaMinus"));
-    hEfficiencyUncertaintyOmegaPlus = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyOmegaPlus"));
-    hEfficiencyUncertaintyPion = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyPion"));
-    hEfficiencyUncertaintyHadron = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyHadron"));
-    hEfficiencyUncertaintyHadronMult = dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyHadronMult"));
-    hPurityUncertaintyHadron = dynamic_cast<TH1F*>(listEfficiencies->FindObject("hPurityUncertaintyHadron"));
-    hPurityUncertaintyHadronMult = dynamic_cast<TH2F*>(listEfficiencies->FindObject("hPurityUncertaintyHadronMult"));
-    if (efficiencyFlags.applyEfficiencyPropagation && !efficiencyFlags.applyEffAsFunctionOfMultAndPhi && !hEfficiencyUncertaintyTrigger) {
+    hEfficiencyTrigger.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyTrigger")));
+    hEfficiencyTriggerMult.compile(dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyTriggerMult")));
+    hEfficiencyTriggerMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyTriggerMultVsPhi")));
+    hEfficiencyK0Short.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyK0Short")));
+    hEfficiencyK0ShortMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyK0ShortMultVsPhi")));
+    hEfficiencyLambda.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyLambda")));
+    hEfficiencyLambdaMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyLambdaMultVsPhi")));
+    hEfficiencyAntiLambda.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyAntiLambda")));
+    hEfficiencyAntiLambdaMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyAntiLambdaMultVsPhi")));
+    hEfficiencyXiMinus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyXiMinus")));
+    hEfficiencyXiMinusMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyXiMinusMultVsPhi")));
+    hEfficiencyXiPlus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyXiPlus")));
+    hEfficiencyXiPlusMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyXiPlusMultVsPhi")));
+    hEfficiencyOmegaMinus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyOmegaMinus")));
+    hEfficiencyOmegaMinusMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyOmegaMinusMultVsPhi")));
+    hEfficiencyOmegaPlus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyOmegaPlus")));
+    hEfficiencyOmegaPlusMultVsPhi.compile(dynamic_cast<THnF*>(listEfficiencies->FindObject("hEfficiencyOmegaPlusMultVsPhi")));
+    hEfficiencyHadron.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyHadron")));
+    hEfficiencyHadronMult.compile(dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyHadronMult")));
+    hEfficiencyPion.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyPion")));
+    hPurityHadron.compile(dynamic_cast<TH1F*>(listEfficiencies->FindObject("hPurityHadron")));
+    hPurityHadronMult.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hPurityHadronMult")));
+    hEfficiencyUncertaintyTrigger.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyTrigger")));
+    hEfficiencyUncertaintyTriggerMult.compile(dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyTriggerMult")));
+    hEfficiencyUncertaintyK0Short.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyK0Short")));
+    hEfficiencyUncertaintyLambda.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyLambda")));
+    hEfficiencyUncertaintyAntiLambda.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyAntiLambda")));
+    hEfficiencyUncertaintyXiMinus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyXiMinus")));
+    hEfficiencyUncertaintyXiPlus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyXiPlus")));
+    hEfficiencyUncertaintyOmegaMinus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyOmegaMinus")));
+    hEfficiencyUncertaintyOmegaPlus.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyOmegaPlus")));
+    hEfficiencyUncertaintyPion.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyPion")));
+    hEfficiencyUncertaintyHadron.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyHadron")));
+    hEfficiencyUncertaintyHadronMult.compile(dynamic_cast<TH3F*>(listEfficiencies->FindObject("hEfficiencyUncertaintyHadronMult")));
+    hPurityUncertaintyHadron.compile(dynamic_cast<TH1F*>(listEfficiencies->FindObject("hPurityUncertaintyHadron")));
+    hPurityUncertaintyHadronMult.compile(dynamic_cast<TH2F*>(listEfficiencies->FindObject("hPurityUncertaintyHadronMult")));
+    if (efficiencyFlags.applyEfficiencyPropagation && !efficiencyFlags.applyEffAsFunctionOfMultAndPhi && !hEfficiencyUncertaintyTrigger.isValid()) {
       LOG(fatal) << "Problem getting hEfficiencyUncertaintyTrigger!";
     }
-    if (efficiencyFlags.applyEffAsFunctionOfMult && !hEfficiencyTriggerMult) {
+    if (efficiencyFlags.applyEffAsFunctionOfMult && !hEfficiencyTriggerMult.isValid()) {
       LOG(fatal) << "Problem getting hEfficiencyTriggerMult!";
     }
     LOG(info) << "Efficiencies now loaded for " << mRunNumber;
@@ -1178,20 +1179,20 @@ struct HStrangeCorrelation {
       std::array<double, 4> bintrig = {trigg.pt(), trigg.eta(), trigg.phi(), mult};
       if (efficiencyFlags.applyEfficiencyForTrigger) {
         if (!efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-          efficiencyTrigg = hEfficiencyTrigger->Interpolate(trigg.pt(), trigg.eta());
+          efficiencyTrigg = hEfficiencyTrigger.interpolate(trigg.pt(), trigg.eta());
           if (efficiencyFlags.applyPurityTrigger) {
-            purityTrigg = hPurityHadron->Interpolate(trigg.pt());
+            purityTrigg = hPurityHadron.interpolate(trigg.pt());
           }
           if (efficiencyFlags.applyEfficiencyPropagation) {
-            efficiencyTriggError = hEfficiencyUncertaintyTrigger->Interpolate(trigg.pt(), trigg.eta());
+            efficiencyTriggError = hEfficiencyUncertaintyTrigger.interpolate(trigg.pt(), trigg.eta());
             if (efficiencyFlags.applyPurityTrigger) {
-              purityTriggErr = hPurityHadron->Interpolate(trigg.pt());
+              purityTriggErr = hPurityHadron.interpolate(trigg.pt());
             }
           }
         } else {
-          efficiencyTrigg = hEfficiencyTriggerMultVsPhi->GetBinContent(hEfficiencyTriggerMultVsPhi->GetBin(bintrig.data()));
+          efficiencyTrigg = hEfficiencyTriggerMultVsPhi.getBinContent(bintrig.data());
           if (efficiencyFlags.applyEfficiencyPropagation) {
-            efficiencyTriggError = hEfficiencyTriggerMultVsPhi->GetBinError(hEfficiencyTriggerMultVsPhi->GetBin(bintrig.data()));
+            efficiencyTriggError = hEfficiencyTriggerMultVsPhi.getBinError(bintrig.data());
           }
         }
         if (efficiencyTrigg == 0) { // check for zero efficiency, do not apply if the case
@@ -1309,21 +1310,21 @@ struct HStrangeCorrelation {
           continue;
         }
 
-        std::array<TH2F*, AssocV0Types> hEfficiencyV0{nullptr, nullptr, nullptr};
-        std::array<TH2F*, AssocV0Types> hEfficiencyUncertaintyV0{nullptr, nullptr, nullptr};
-        std::array<THnF*, AssocV0Types> hEfficiencyV0MultVsPhi{nullptr, nullptr, nullptr};
+        std::array<const o2::common::core::CorrectionMap*, AssocV0Types> hEfficiencyV0{nullptr, nullptr, nullptr};
+        std::array<const o2::common::core::CorrectionMap*, AssocV0Types> hEfficiencyUncertaintyV0{nullptr, nullptr, nullptr};
+        std::array<const o2::common::core::CorrectionMap*, AssocV0Types> hEfficiencyV0MultVsPhi{nullptr, nullptr, nullptr};
         if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-          hEfficiencyV0MultVsPhi[0] = hEfficiencyK0ShortMultVsPhi;
-          hEfficiencyV0MultVsPhi[1] = hEfficiencyLambdaMultVsPhi;
-          hEfficiencyV0MultVsPhi[2] = hEfficiencyAntiLambdaMultVsPhi;
+          hEfficiencyV0MultVsPhi[0] = &hEfficiencyK0ShortMultVsPhi;
+          hEfficiencyV0MultVsPhi[1] = &hEfficiencyLambdaMultVsPhi;
+          hEfficiencyV0MultVsPhi[2] = &hEfficiencyAntiLambdaMultVsPhi;
         } else {
-          hEfficiencyV0[0] = hEfficiencyK0Short;
-          hEfficiencyV0[1] = hEfficiencyLambda;
-          hEfficiencyV0[2] = hEfficiencyAntiLambda;
+          hEfficiencyV0[0] = &hEfficiencyK0Short;
+          hEfficiencyV0[1] = &hEfficiencyLambda;
+          hEfficiencyV0[2] = &hEfficiencyAntiLambda;
 
-          hEfficiencyUncertaintyV0[0] = hEfficiencyUncertaintyK0Short;
-          hEfficiencyUncertaintyV0[1] = hEfficiencyUncertaintyLambda;
-          hEfficiencyUncertaintyV0[2] = hEfficiencyUncertaintyAntiLambda;
+          hEfficiencyUncertaintyV0[0] = &hEfficiencyUncertaintyK0Short;
+          hEfficiencyUncertaintyV0[1] = &hEfficiencyUncertaintyLambda;
+          hEfficiencyUncertaintyV0[2] = &hEfficiencyUncertaintyAntiLambda;
         }
 
         float etaWeight = 1;
@@ -1361,14 +1362,14 @@ struct HStrangeCorrelation {
           if (efficiencyFlags.applyEfficiencyCorrection) {
             if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
               std::array<double, 4> bin = {ptassoc, assoc.eta(), assoc.phi(), mult};
-              efficiency = hEfficiencyV0MultVsPhi[Index]->GetBinContent(hEfficiencyV0MultVsPhi[Index]->GetBin(bin.data()));
+              efficiency = hEfficiencyV0MultVsPhi[Index]->getBinContent(bin.data());
               if (efficiencyFlags.applyEfficiencyPropagation) {
-                efficiencyError = hEfficiencyV0MultVsPhi[Index]->GetBinError(hEfficiencyV0MultVsPhi[Index]->GetBin(bin.data()));
+                efficiencyError = hEfficiencyV0MultVsPhi[Index]->getBinError(bin.data());
               }
             } else {
-              efficiency = hEfficiencyV0[Index]->Interpolate(ptassoc, assoc.eta());
+              efficiency = hEfficiencyV0[Index]->interpolate(ptassoc, assoc.eta());
               if (efficiencyFlags.applyEfficiencyPropagation) {
-                efficiencyError = hEfficiencyUncertaintyV0[Index]->Interpolate(ptassoc, assoc.eta());
+                efficiencyError = hEfficiencyUncertaintyV0[Index]->interpolate(ptassoc, assoc.eta());
               }
             }
           }
@@ -1739,32 +1740,32 @@ struct HStrangeCorrelation {
       if (efficiencyFlags.applyEfficiencyForTrigger) {
         std::array<double, 4> bintrig = {trigg.pt(), trigg.eta(), trigg.phi(), mult};
         if (efficiencyFlags.applyEffAsFunctionOfMult) {
-          efficiencyTrigg = hEfficiencyTriggerMult->Interpolate(trigg.pt(), trigg.eta(), mult);
+          efficiencyTrigg = hEfficiencyTriggerMult.interpolate(trigg.pt(), trigg.eta(), mult);
         } else if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-          efficiencyTrigg = hEfficiencyTriggerMultVsPhi->GetBinContent(hEfficiencyTriggerMultVsPhi->GetBin(bintrig.data()));
+          efficiencyTrigg = hEfficiencyTriggerMultVsPhi.getBinContent(bintrig.data());
         } else {
-          efficiencyTrigg = hEfficiencyTrigger->Interpolate(trigg.pt(), trigg.eta());
+          efficiencyTrigg = hEfficiencyTrigger.interpolate(trigg.pt(), trigg.eta());
         }
         if (efficiencyFlags.applyPurityTrigger) {
           if (efficiencyFlags.applyEffAsFunctionOfMult) {
-            purityTrigg = hPurityHadronMult->Interpolate(trigg.pt(), mult);
+            purityTrigg = hPurityHadronMult.interpolate(trigg.pt(), mult);
           } else {
-            purityTrigg = hPurityHadron->Interpolate(trigg.pt());
+            purityTrigg = hPurityHadron.interpolate(trigg.pt());
           }
         }
         if (efficiencyFlags.applyEfficiencyPropagation) {
           if (efficiencyFlags.applyEffAsFunctionOfMult) {
-            efficiencyTriggError = hEfficiencyUncertaintyTriggerMult->Interpolate(trigg.pt(), trigg.eta(), mult);
+            efficiencyTriggError = hEfficiencyUncertaintyTriggerMult.interpolate(trigg.pt(), trigg.eta(), mult);
           } else if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-            efficiencyTriggError = hEfficiencyTriggerMultVsPhi->GetBinError(hEfficiencyTriggerMultVsPhi->GetBin(bintrig.data()));
+            efficiencyTriggError = hEfficiencyTriggerMultVsPhi.getBinError(bintrig.data());
           } else {
-            efficiencyTriggError = hEfficiencyUncertaintyTrigger->Interpolate(trigg.pt(), trigg.eta());
+            efficiencyTriggError = hEfficiencyUncertaintyTrigger.interpolate(trigg.pt(), trigg.eta());
           }
           if (efficiencyFlags.applyPurityTrigger) {
             if (efficiencyFlags.applyEffAsFunctionOfMult) {
-              purityTriggErr = hPurityUncertaintyHadronMult->Interpolate(trigg.pt(), mult);
+              purityTriggErr = hPurityUncertaintyHadronMult.interpolate(trigg.pt(), mult);
             } else {
-              purityTriggErr = hPurityUncertaintyHadron->Interpolate(trigg.pt());
+              purityTriggErr = hPurityUncertaintyHadron.interpolate(trigg.pt());
             }
           }
         }
@@ -1866,25 +1867,25 @@ struct HStrangeCorrelation {
           continue;
         }
 
-        std::array<TH2F*, AssocCascadeTypes> hEfficiencyCascade{nullptr, nullptr, nullptr, nullptr};
-        std::array<THnF*, AssocCascadeTypes> hEfficiencyCascadeMultVsPhi{nullptr, nullptr, nullptr, nullptr};
+        std::array<const o2::common::core::CorrectionMap*, AssocCascadeTypes> hEfficiencyCascade{nullptr, nullptr, nullptr, nullptr};
+        std::array<const o2::common::core::CorrectionMap*, AssocCascadeTypes> hEfficiencyCascadeMultVsPhi{nullptr, nullptr, nullptr, nullptr};
         if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-          hEfficiencyCascadeMultVsPhi[0] = hEfficiencyXiMinusMultVsPhi;
-          hEfficiencyCascadeMultVsPhi[1] = hEfficiencyXiPlusMultVsPhi;
-          hEfficiencyCascadeMultVsPhi[2] = hEfficiencyOmegaMinusMultVsPhi;
-          hEfficiencyCascadeMultVsPhi[3] = hEfficiencyOmegaPlusMultVsPhi;
+          hEfficiencyCascadeMultVsPhi[0] = &hEfficiencyXiMinusMultVsPhi;
+          hEfficiencyCascadeMultVsPhi[1] = &hEfficiencyXiPlusMultVsPhi;
+          hEfficiencyCascadeMultVsPhi[2] = &hEfficiencyOmegaMinusMultVsPhi;
+          hEfficiencyCascadeMultVsPhi[3] = &hEfficiencyOmegaPlusMultVsPhi;
         } else {
-          hEfficiencyCascade[0] = hEfficiencyXiMinus;
-          hEfficiencyCascade[1] = hEfficiencyXiPlus;
-          hEfficiencyCascade[2] = hEfficiencyOmegaMinus;
-          hEfficiencyCascade[3] = hEfficiencyOmegaPlus;
+          hEfficiencyCascade[0] = &hEfficiencyXiMinus;
+          hEfficiencyCascade[1] = &hEfficiencyXiPlus;
+          hEfficiencyCascade[2] = &hEfficiencyOmegaMinus;
+          hEfficiencyCascade[3] = &hEfficiencyOmegaPlus;
         }
 
-        std::array<TH2F*, AssocCascadeTypes> hEfficiencyUncertaintyCascade{nullptr, nullptr, nullptr, nullptr};
-        hEfficiencyUncertaintyCascade[0] = hEfficiencyUncertaintyXiMinus;
-        hEfficiencyUncertaintyCascade[1] = hEfficiencyUncertaintyXiPlus;
-        hEfficiencyUncertaintyCascade[2] = hEfficiencyUncertaintyOmegaMinus;
-        hEfficiencyUncertaintyCascade[3] = hEfficiencyUncertaintyOmegaPlus;
+        std::array<const o2::common::core::CorrectionMap*, AssocCascadeTypes> hEfficiencyUncertaintyCascade{nullptr, nullptr, nullptr, nullptr};
+        hEfficiencyUncertaintyCascade[0] = &hEfficiencyUncertaintyXiMinus;
+        hEfficiencyUncertaintyCascade[1] = &hEfficiencyUncertaintyXiPlus;
+        hEfficiencyUncertaintyCascade[2] = &hEfficiencyUncertaintyOmegaMinus;
+        hEfficiencyUncertaintyCascade[3] = &hEfficiencyUncertaintyOmegaPlus;
 
         float etaWeight = 1;
         if (checks.doOnTheFlyFlattening) {
@@ -1903,14 +1904,14 @@ struct HStrangeCorrelation {
           if (efficiencyFlags.applyEfficiencyCorrection) {
             if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
               std::array<double, 4> bin = {ptassoc, assoc.eta(), assoc.phi(), mult};
-              efficiency = hEfficiencyCascadeMultVsPhi[Index]->GetBinContent(hEfficiencyCascadeMultVsPhi[Index]->GetBin(bin.data()));
+              efficiency = hEfficiencyCascadeMultVsPhi[Index]->getBinContent(bin.data());
               if (efficiencyFlags.applyEfficiencyPropagation) {
-                efficiencyError = hEfficiencyCascadeMultVsPhi[Index]->GetBinError(hEfficiencyCascadeMultVsPhi[Index]->GetBin(bin.data()));
+                efficiencyError = hEfficiencyCascadeMultVsPhi[Index]->getBinError(bin.data());
               }
             } else {
-              efficiency = hEfficiencyCascade[Index]->Interpolate(ptassoc, assoc.eta());
+              efficiency = hEfficiencyCascade[Index]->interpolate(ptassoc, assoc.eta());
               if (efficiencyFlags.applyEfficiencyPropagation) {
-                efficiencyError = hEfficiencyUncertaintyCascade[Index]->Interpolate(ptassoc, assoc.eta());
+                efficiencyError = hEfficiencyUncertaintyCascade[Index]->interpolate(ptassoc, assoc.eta());
               }
             }
           }
@@ -2058,28 +2059,28 @@ struct HStrangeCorrelation {
       float purityTriggerError = 0.0f;
       if (efficiencyFlags.applyEfficiencyForTrigger) {
         if (efficiencyFlags.applyEffAsFunctionOfMult) {
-          efficiencyTrigger = hEfficiencyTriggerMult->Interpolate(trigg.pt(), trigg.eta(), mult);
+          efficiencyTrigger = hEfficiencyTriggerMult.interpolate(trigg.pt(), trigg.eta(), mult);
         } else {
-          efficiencyTrigger = hEfficiencyTrigger->Interpolate(trigg.pt(), trigg.eta());
+          efficiencyTrigger = hEfficiencyTrigger.interpolate(trigg.pt(), trigg.eta());
         }
         if (efficiencyFlags.applyPurityTrigger) {
           if (efficiencyFlags.applyEffAsFunctionOfMult) {
-            purityTrigger = hPurityHadronMult->Interpolate(trigg.pt(), mult);
+            purityTrigger = hPurityHadronMult.interpolate(trigg.pt(), mult);
           } else {
-            purityTrigger = hPurityHadron->Interpolate(trigg.pt());
+            purityTrigger = hPurityHadron.interpolate(trigg.pt());
           }
         }
         if (efficiencyFlags.applyEfficiencyPropagation) {
           if (efficiencyFlags.applyEffAsFunctionOfMult) {
-            efficiencyTriggerError = hEfficiencyUncertaintyTriggerMult->Interpolate(trigg.pt(), trigg.eta(), mult);
+            efficiencyTriggerError = hEfficiencyUncertaintyTriggerMult.interpolate(trigg.pt(), trigg.eta(), mult);
           } else {
-            efficiencyTriggerError = hEfficiencyUncertaintyTrigger->Interpolate(trigg.pt(), trigg.eta());
+            efficiencyTriggerError = hEfficiencyUncertaintyTrigger.interpolate(trigg.pt(), trigg.eta());
           }
           if (efficiencyFlags.applyPurityTrigger) {
             if (efficiencyFlags.applyEffAsFunctionOfMult) {
-              purityTriggerError = hPurityUncertaintyHadronMult->Interpolate(trigg.pt(), mult);
+              purityTriggerError = hPurityUncertaintyHadronMult.interpolate(trigg.pt(), mult);
             } else {
-              purityTriggerError = hPurityUncertaintyHadron->Interpolate(trigg.pt());
+              purityTriggerError = hPurityUncertaintyHadron.interpolate(trigg.pt());
             }
           }
         }
@@ -2157,34 +2158,34 @@ struct HStrangeCorrelation {
         float totalPurityUncert = 0.0;
         if (efficiencyFlags.applyEfficiencyCorrection) {
           if constexpr (requires { assocTrack.nSigmaTPCPi(); }) {
-            efficiency = hEfficiencyPion->Interpolate(ptassoc, assoc.eta());
+            efficiency = hEfficiencyPion.interpolate(ptassoc, assoc.eta());
             if (efficiencyFlags.applyEfficiencyPropagation) {
-              efficiencyUncertainty = hEfficiencyUncertaintyPion->Interpolate(ptassoc, assoc.eta());
+              efficiencyUncertainty = hEfficiencyUncertaintyPion.interpolate(ptassoc, assoc.eta());
             }
           } else {
             if (efficiencyFlags.applyEffAsFunctionOfMult) {
-              efficiency = hEfficiencyHadronMult->Interpolate(ptassoc, assoc.eta(), mult);
+              efficiency = hEfficiencyHadronMult.interpolate(ptassoc, assoc.eta(), mult);
             } else {
-              efficiency = hEfficiencyHadron->Interpolate(ptassoc, assoc.eta());
+              efficiency = hEfficiencyHadron.interpolate(ptassoc, assoc.eta());
             }
             if (efficiencyFlags.applyPurityHadron) {
               if (efficiencyFlags.applyEffAsFunctionOfMult) {
-                purity = hPurityHadronMult->Interpolate(ptassoc, mult);
+                purity = hPurityHadronMult.interpolate(ptassoc, mult);
               } else {
-                purity = hPurityHadron->Interpolate(ptassoc);
+                purity = hPurityHadron.interpolate(ptassoc);
               }
             }
             if (efficiencyFlags.applyEfficiencyPropagation) {
               if (efficiencyFlags.applyEffAsFunctionOfMult) {
-                efficiencyUncertainty = hEfficiencyUncertaintyHadronMult->Interpolate(ptassoc, assoc.eta(), mult);
+                efficiencyUncertainty = hEfficiencyUncertaintyHadronMult.interpolate(ptassoc, assoc.eta(), mult);
               } else {
-                efficiencyUncertainty = hEfficiencyUncertaintyHadron->Interpolate(ptassoc, assoc.eta());
+                efficiencyUncertainty = hEfficiencyUncertaintyHadron.interpolate(ptassoc, assoc.eta());
               }
               if (efficiencyFlags.applyPurityHadron) {
                 if (efficiencyFlags.applyEffAsFunctionOfMult) {
-                  purityUncertainty = hPurityUncertaintyHadronMult->Interpolate(ptassoc, mult);
+                  purityUncertainty = hPurityUncertaintyHadronMult.interpolate(ptassoc, mult);
                 } else {
-                  purityUncertainty = hPurityUncertaintyHadron->Interpolate(ptassoc);
+                  purityUncertainty = hPurityUncertaintyHadron.interpolate(ptassoc);
                 }
               }
             }
@@ -2231,28 +2232,28 @@ struct HStrangeCorrelation {
   void init(InitContext const&)
   {
     zorroSummary.setObject(zorro.getZorroSummary());
-    hEfficiencyPion = nullptr;
-    hEfficiencyK0Short = nullptr;
-    hEfficiencyLambda = nullptr;
-    hEfficiencyAntiLambda = nullptr;
-    hEfficiencyXiMinus = nullptr;
-    hEfficiencyXiPlus = nullptr;
-    hEfficiencyOmegaMinus = nullptr;
-    hEfficiencyOmegaPlus = nullptr;
-    hEfficiencyUncertaintyTrigger = nullptr;
-    hEfficiencyUncertaintyXiMinus = nullptr;
-    hEfficiencyUncertaintyXiPlus = nullptr;
-    hEfficiencyUncertaintyOmegaMinus = nullptr;
-    hEfficiencyUncertaintyOmegaPlus = nullptr;
-    hEfficiencyUncertaintyPion = nullptr;
-    hEfficiencyUncertaintyK0Short = nullptr;
-    hEfficiencyUncertaintyLambda = nullptr;
-    hEfficiencyUncertaintyAntiLambda = nullptr;
-
-    hEfficiencyHadron = nullptr;
-    hPurityHadron = nullptr;
-    hPurityUncertaintyHadron = nullptr;
-    hEfficiencyUncertaintyHadron = nullptr;
+    hEfficiencyPion.reset();
+    hEfficiencyK0Short.reset();
+    hEfficiencyLambda.reset();
+    hEfficiencyAntiLambda.reset();
+    hEfficiencyXiMinus.reset();
+    hEfficiencyXiPlus.reset();
+    hEfficiencyOmegaMinus.reset();
+    hEfficiencyOmegaPlus.reset();
+    hEfficiencyUncertaintyTrigger.reset();
+    hEfficiencyUncertaintyXiMinus.reset();
+    hEfficiencyUncertaintyXiPlus.reset();
+    hEfficiencyUncertaintyOmegaMinus.reset();
+    hEfficiencyUncertaintyOmegaPlus.reset();
+    hEfficiencyUncertaintyPion.reset();
+    hEfficiencyUncertaintyK0Short.reset();
+    hEfficiencyUncertaintyLambda.reset();
+    hEfficiencyUncertaintyAntiLambda.reset();
+
+    hEfficiencyHadron.reset();
+    hPurityHadron.reset();
+    hPurityUncertaintyHadron.reset();
+    hEfficiencyUncertaintyHadron.reset();
 
     // set bitmap for convenience
     doCorrelation = 0;
@@ -3264,7 +3265,7 @@ struct HStrangeCorrelation {
         histos.fill(HIST("hDCAxyTriggerHadron"), track.dcaXY(), track.pt());
         float efficiency = 1.0f;
         if (efficiencyFlags.applyEfficiencyCorrection) {
-          efficiency = hEfficiencyTrigger->Interpolate(track.pt(), track.eta());
+          efficiency = hEfficiencyTrigger.interpolate(track.pt(), track.eta());
         }
         if (efficiency == 0) { // check for zero efficiency, do not apply if the case
           efficiency = 1;
@@ -3292,9 +3293,9 @@ struct HStrangeCorrelation {
       histos.fill(HIST("hDCAzAssociatedHadron"), assoc.dcaZ(), assoc.pt());
       histos.fill(HIST("hDCAxyAssociatedHadron"), assoc.dcaXY(), assoc.pt());
       if (efficiencyFlags.applyEfficiencyCorrection) {
-        efficiency = hEfficiencyHadron->Interpolate(assoc.pt(), assoc.eta());
+        efficiency = hEfficiencyHadron.interpolate(assoc.pt(), assoc.eta());
         if (efficiencyFlags.applyPurityHadron) {
-          purity = hPurityHadron->Interpolate(assoc.pt());
+          purity = hPurityHadron.interpolate(assoc.pt());
         }
       }
       if (efficiency == 0) { // check for zero efficiency, do not apply if the case
@@ -3337,16 +3338,16 @@ struct HStrangeCorrelation {
     }
 
     // Do basic QA
-    std::array<TH2F*, AssocV0Types> hEfficiencyV0{nullptr, nullptr, nullptr};
-    std::array<THnF*, AssocV0Types> hEfficiencyV0MultVsPhi{nullptr, nullptr, nullptr};
+    std::array<const o2::common::core::CorrectionMap*, AssocV0Types> hEfficiencyV0{nullptr, nullptr, nullptr};
+    std::array<const o2::common::core::CorrectionMap*, AssocV0Types> hEfficiencyV0MultVsPhi{nullptr, nullptr, nullptr};
     if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-      hEfficiencyV0MultVsPhi[0] = hEfficiencyK0ShortMultVsPhi;
-      hEfficiencyV0MultVsPhi[1] = hEfficiencyLambdaMultVsPhi;
-      hEfficiencyV0MultVsPhi[2] = hEfficiencyAntiLambdaMultVsPhi;
+      hEfficiencyV0MultVsPhi[0] = &hEfficiencyK0ShortMultVsPhi;
+      hEfficiencyV0MultVsPhi[1] = &hEfficiencyLambdaMultVsPhi;
+      hEfficiencyV0MultVsPhi[2] = &hEfficiencyAntiLambdaMultVsPhi;
     } else {
-      hEfficiencyV0[0] = hEfficiencyK0Short;
-      hEfficiencyV0[1] = hEfficiencyLambda;
-      hEfficiencyV0[2] = hEfficiencyAntiLambda;
+      hEfficiencyV0[0] = &hEfficiencyK0Short;
+      hEfficiencyV0[1] = &hEfficiencyLambda;
+      hEfficiencyV0[2] = &hEfficiencyAntiLambda;
     }
 
     for (auto const& v0 : associatedV0s) {
@@ -3381,11 +3382,11 @@ struct HStrangeCorrelation {
         if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
           if (efficiencyFlags.applyEfficiencyCorrection) {
             std::array<double, 4> bin = {v0Data.pt(), v0Data.eta(), v0Data.phi(), cent};
-            efficiency = hEfficiencyV0MultVsPhi[Index]->GetBinContent(hEfficiencyV0MultVsPhi[Index]->GetBin(bin.data()));
+            efficiency = hEfficiencyV0MultVsPhi[Index]->getBinContent(bin.data());
           }
         } else {
           if (efficiencyFlags.applyEfficiencyCorrection) {
-            efficiency = hEfficiencyV0[Index]->Interpolate(v0Data.pt(), v0Data.eta());
+            efficiency = hEfficiencyV0[Index]->interpolate(v0Data.pt(), v0Data.eta());
           }
         }
         if (efficiency == 0) { // check for zero efficiency, do not apply if the case
@@ -3518,19 +3519,19 @@ struct HStrangeCorrelation {
     if (efficiencyFlags.applyEfficiencyCorrection) {
       initEfficiencyFromCCDB(bc);
     }
-    std::array<TH2F*, AssocCascadeTypes> hEfficiencyCascade{nullptr, nullptr, nullptr, nullptr};
-    std::array<THnF*, AssocCascadeTypes> hEfficiencyCascadeMultVsPhi{nullptr, nullptr, nullptr, nullptr};
+    std::array<const o2::common::core::CorrectionMap*, AssocCascadeTypes> hEfficiencyCascade{nullptr, nullptr, nullptr, nullptr};
+    std::array<const o2::common::core::CorrectionMap*, AssocCascadeTypes> hEfficiencyCascadeMultVsPhi{nullptr, nullptr, nullptr, nullptr};
     if (efficiencyFlags.applyEfficiencyCorrection) {
       if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-        hEfficiencyCascadeMultVsPhi[0] = hEfficiencyXiMinusMultVsPhi;
-        hEfficiencyCascadeMultVsPhi[1] = hEfficiencyXiPlusMultVsPhi;
-        hEfficiencyCascadeMultVsPhi[2] = hEfficiencyOmegaMinusMultVsPhi;
-        hEfficiencyCascadeMultVsPhi[3] = hEfficiencyOmegaPlusMultVsPhi;
+        hEfficiencyCascadeMultVsPhi[0] = &hEfficiencyXiMinusMultVsPhi;
+        hEfficiencyCascadeMultVsPhi[1] = &hEfficiencyXiPlusMultVsPhi;
+        hEfficiencyCascadeMultVsPhi[2] = &hEfficiencyOmegaMinusMultVsPhi;
+        hEfficiencyCascadeMultVsPhi[3] = &hEfficiencyOmegaPlusMultVsPhi;
       } else {
-        hEfficiencyCascade[0] = hEfficiencyXiMinus;
-        hEfficiencyCascade[1] = hEfficiencyXiPlus;
-        hEfficiencyCascade[2] = hEfficiencyOmegaMinus;
-        hEfficiencyCascade[3] = hEfficiencyOmegaPlus;
+        hEfficiencyCascade[0] = &hEfficiencyXiMinus;
+        hEfficiencyCascade[1] = &hEfficiencyXiPlus;
+        hEfficiencyCascade[2] = &hEfficiencyOmegaMinus;
+        hEfficiencyCascade[3] = &hEfficiencyOmegaPlus;
       }
     }
     for (auto const& casc : associatedCascades) {
@@ -3576,9 +3577,9 @@ struct HStrangeCorrelation {
         if (efficiencyFlags.applyEfficiencyCorrection) {
           if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
             std::array<double, 4> bin = {cascData.pt(), cascData.eta(), cascData.phi(), cent};
-            efficiency = hEfficiencyCascadeMultVsPhi[Index]->GetBinContent(hEfficiencyCascadeMultVsPhi[Index]->GetBin(bin.data()));
+            efficiency = hEfficiencyCascadeMultVsPhi[Index]->getBinContent(bin.data());
           } else {
-            efficiency = hEfficiencyCascade[Index]->Interpolate(cascData.pt(), cascData.eta());
+            efficiency = hEfficiencyCascade[Index]->interpolate(cascData.pt(), cascData.eta());
           }
         }
         if (efficiency == 0) { // check for zero efficiency, do not apply if the case
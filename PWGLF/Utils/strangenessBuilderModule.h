@@ -47,12 +47,16 @@
 #include <TPDGCode.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <vector>
 
 // simple checkers, but ensure 8 bit integers
@@ -334,6 +338,10 @@ struct coreConfigurables : o2::framework::ConfigurableGroup {
 
   // test the possibility of refitting with material corrections (DCA Fitter option)
   o2::framework::Configurable<bool> refitWithMaterialCorrection{"refitWithMaterialCorrection", false, "do refit after material corrections were applied"};
+
+  // fit V0 and cascade candidates on several threads before filling the tables in the usual order
+  o2::framework::Configurable<int> nFitterThreads{"nFitterThreads", 1, "number of threads fitting V0 and cascade candidates. 1: serial (default)"};
+  o2::framework::Configurable<int> nCandidatesPerChunk{"nCandidatesPerChunk", 64, "number of candidates fitted by a thread at a time"};
 };
 
 // strangenessBuilder: V0 building options
@@ -610,6 +618,19 @@ class BuilderModule
   std::vector<int> ao2dV0toV0List;                     // index to relate v0s -> v0List
   std::vector<int> v0Map;                              // index to relate v0List -> v0sFromCascades
 
+  // for fitting candidates on several threads (baseOpts.nFitterThreads > 1)
+  // results are stored per position in sorted_v0 / sorted_cascade and picked up by the serial loops
+  enum prefitStatus : int8_t {
+    kNotPrefitted = -1,
+    kPrefitFailed = 0,
+    kPrefitSucceeded = 1
+  };
+  std::vector<o2::pwglf::strangenessBuilderHelper> fitHelpers; // one copy of straHelper per thread
+  std::vector<o2::pwglf::v0candidate> prefitV0s;
+  std::vector<int8_t> prefitV0Status;
+  std::vector<o2::pwglf::cascadeCandidate> prefitCascades;
+  std::vector<int8_t> prefitCascadeStatus;
+
   // declaration of structs here
   // (N.B.: will be invisible to the outside, create your own copies)
   o2::pwglf::strangenessbuilder::coreConfigurables baseOpts;
@@ -844,6 +865,47 @@ class BuilderModule
     return idx;
   }
 
+  // calls fitCandidate(helper, iCandidate) for all candidates, in chunks distributed over
+  // baseOpts.nFitterThreads threads. Each thread uses its own copy of straHelper, so the
+  // function must only write to the entry of iCandidate.
+  // The copies share the o2::base::Propagator singleton. This is safe because the propagator is
+  // only configured in initCCDB, before any fit: the DCA propagations are const calls that read
+  // the magnetic field and the material LUT. TGeo material corrections go through the
+  // TGeoNavigator of gGeoManager, which is not shared safely, so they are always fitted serially.
+  template <typename TFitFunction>
+  void fitInParallel(std::size_t nCandidates, TFitFunction const& fitCandidate)
+  {
+    const std::size_t chunkSize = std::max(1, baseOpts.nCandidatesPerChunk.value);
+    const std::size_t nChunks = (nCandidates + chunkSize - 1) / chunkSize;
+    const std::size_t nThreads = std::max<std::size_t>(1, std::min<std::size_t>(std::max(1, baseOpts.nFitterThreads.value), nChunks));
+    if (nThreads == 1 || straHelper.fitter.getMatCorrType() == o2::base::Propagator::MatCorrType::USEMatCorrTGeo) {
+      // serial: no need for a copy of the helper
+      for (std::size_t iCandidate = 0; iCandidate < nCandidates; iCandidate++) {
+        fitCandidate(straHelper, iCandidate);
+      }
+      return;
+    }
+    fitHelpers.assign(nThreads, straHelper); // copies carry magnetic field, material LUT and selections
+
+    std::atomic<std::size_t> nextChunk{0};
+    auto fitChunks = [&](std::size_t iThread) {
+      for (std::size_t iChunk = nextChunk++; iChunk < nChunks; iChunk = nextChunk++) {
+        const std::size_t lastCandidate = std::min(nCandidates, (iChunk + 1) * chunkSize);
+        for (std::size_t iCandidate = iChunk * chunkSize; iCandidate < lastCandidate; iCandidate++) {
+          fitCandidate(fitHelpers[iThread], iCandidate);
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t iThread = 1; iThread < nThreads; iThread++) {
+      threads.emplace_back(fitChunks, iThread);
+    }
+    fitChunks(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
   template <typename TCollisions, typename TCCDB, typename TBCs>
   bool initCCDB(TCCDB& ccdb, TBCs const& bcs, TCollisions const& collisions)
   {
@@ -988,6 +1050,18 @@ class BuilderModule
         histos.fill(HIST("hDeduplicationStatistics"), 1.0, v0tableGrouped.size());
 
         // process grouped duplicates, remove 'bad' ones
+        // first pass: prepare the (moved) track parametrizations of every combination to be tested
+        struct deduplicationCandidate {
+          size_t iV0 = 0;
+          size_t ic = 0;
+          o2::track::TrackParCov posTrackPar;
+          o2::track::TrackParCov negTrackPar;
+          bool built = false;
+          float pointingAngle = 0.0f;
+          float daughterDCA = 0.0f;
+        };
+        std::vector<deduplicationCandidate> deduplicationCandidates;
+        std::vector<bool> isDeduplicated(v0tableGrouped.size(), false);
         for (size_t iV0 = 0; iV0 < v0tableGrouped.size(); iV0++) {
           auto pTrack = tracks.rawIteratorAt(v0tableGrouped[iV0].posTrackId);
           auto nTrack = tracks.rawIteratorAt(v0tableGrouped[iV0].negTrackId);
@@ -1004,13 +1078,7 @@ class BuilderModule
           if (!isPosTPCOnly && !isNegTPCOnly) {
             continue;
           }
-
-          // fitness criteria defined here
-          float bestPointingAngle = 10; // a nonsense angle, anything's better
-          size_t bestPointingAngleIndex = -1;
-
-          float bestDCADaughters = 1e+3; // an excessively large DCA
-          size_t bestDCADaughtersIndex = -1;
+          isDeduplicated[iV0] = true;
 
           for (size_t ic = 0; ic < v0tableGrouped[iV0].collisionIds.size(); ic++) {
             // get track parametrizations, collisions
@@ -1041,22 +1109,57 @@ class BuilderModule
               }
             } // end TPC drift treatment
 
-            // process candidate with helper, generate properties for consulting
-            // first 'false' : do not apply selections: do as much as possible to preserve
-            // second 'false': do not calculate prong DCA to PV, unnecessary, costly if XIU = 83.1f
-            // candidate at this level and do not select with topo selections
-            if (straHelper.buildV0Candidate<false, false>(v0tableGrouped[iV0].collisionIds[ic], collision.posX(), collision.posY(), collision.posZ(), pTrack, nTrack, posTrackPar, negTrackPar, true, false, true)) {
+            deduplicationCandidate candidate;
+            candidate.iV0 = iV0;
+            candidate.ic = ic;
+            candidate.posTrackPar = posTrackPar;
+            candidate.negTrackPar = negTrackPar;
+            deduplicationCandidates.push_back(candidate);
+          } // end candidate loop
+        }
+
+        // second pass: fit the candidates, independent of each other
+        fitInParallel(deduplicationCandidates.size(), [&](o2::pwglf::strangenessBuilderHelper& helper, size_t iCandidate) {
+          auto& candidate = deduplicationCandidates[iCandidate];
+          auto const& group = v0tableGrouped[candidate.iV0];
+          auto const& collision = collisions.rawIteratorAt(group.collisionIds[candidate.ic]);
+          // process candidate with helper, generate properties for consulting
+          // first 'false' : do not apply selections: do as much as possible to preserve
+          // second 'false': do not calculate prong DCA to PV, unnecessary, costly if XIU = 83.1f
+          // candidate at this level and do not select with topo selections
+          candidate.built = helper.buildV0Candidate<false, false>(group.collisionIds[candidate.ic], collision.posX(), collision.posY(), collision.posZ(), tracks.rawIteratorAt(group.posTrackId), tracks.rawIteratorAt(group.negTrackId), candidate.posTrackPar, candidate.negTrackPar, true, false, true);
+          candidate.pointingAngle = helper.v0.pointingAngle;
+          candidate.daughterDCA = helper.v0.daughterDCA;
+        });
+
+        // third pass: keep the best candidate of each group
+        size_t iCandidate = 0;
+        for (size_t iV0 = 0; iV0 < v0tableGrouped.size(); iV0++) {
+          if (!isDeduplicated[iV0]) {
+            continue;
+          }
+
+          // fitness criteria defined here
+          float bestPointingAngle = 10; // a nonsense angle, anything's better
+          size_t bestPointingAngleIndex = -1;
+
+          float bestDCADaughters = 1e+3; // an excessively large DCA
+          size_t bestDCADaughtersIndex = -1;
+
+          for (; iCandidate < deduplicationCandidates.size() && deduplicationCandidates[iCandidate].iV0 == iV0; iCandidate++) {
+            auto const& candidate = deduplicationCandidates[iCandidate];
+            if (candidate.built) {
               // candidate built, check pointing angle
-              if (straHelper.v0.pointingAngle < bestPointingAngle) {
-                bestPointingAngle = straHelper.v0.pointingAngle;
-                bestPointingAngleIndex = ic;
+              if (candidate.pointingAngle < bestPointingAngle) {
+                bestPointingAngle = candidate.pointingAngle;
+                bestPointingAngleIndex = candidate.ic;
               }
-              if (straHelper.v0.daughterDCA < bestDCADaughters) {
-                bestDCADaughters = straHelper.v0.daughterDCA;
-                bestDCADaughtersIndex = ic;
+              if (candidate.daughterDCA < bestDCADaughters) {
+                bestDCADaughters = candidate.daughterDCA;
+                bestDCADaughtersIndex = candidate.ic;
               }
             } // end build V0
-          } // end candidate loop
+          }
 
           // mark de-duplicated candidates
           for (size_t ic = 0; ic < v0tableGrouped[iV0].collisionIds.size(); ic++) {
@@ -1455,6 +1558,57 @@ class BuilderModule
   }
 
   //__________________________________________________
+  // fit the V0s of the list on several threads, ahead of buildV0s. V0s with TPC-only daughters to be
+  // moved are left to buildV0s, since the drift correction depends on the order of processing
+  template <typename TCollisions, typename TTracks, typename TV0s>
+  void prefitV0Candidates(TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks)
+  {
+    prefitV0Status.assign(v0s.size(), kNotPrefitted);
+    prefitV0s.resize(v0s.size());
+    if (baseOpts.nFitterThreads.value <= 1) {
+      return;
+    }
+    std::vector<std::size_t> candidates;
+    candidates.reserve(v0s.size());
+    for (size_t iv0 = 0; iv0 < v0s.size(); iv0++) {
+      const auto& v0 = v0s[sorted_v0[iv0]];
+      if ((!v0BuilderOpts.generatePhotonCandidates.value && v0.v0Type > 1) || (!baseOpts.mEnabledTables[kV0CoresBase] && v0Map[iv0] == -2)) {
+        continue; // skipped by buildV0s
+      }
+      if (v0.collisionId >= 0 && eventSelectOpts.fillOnlySelectedCollisions && !isCollisionAccepted(collisions.rawIteratorAt(v0.collisionId))) {
+        continue;
+      }
+      if (v0BuilderOpts.moveTPCOnlyTracks) {
+        auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
+        auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
+        if ((posTrack.hasTPC() && !posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF()) ||
+            (negTrack.hasTPC() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF())) {
+          continue;
+        }
+      }
+      candidates.push_back(iv0);
+    }
+
+    fitInParallel(candidates.size(), [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t iCandidate) {
+      const std::size_t iv0 = candidates[iCandidate];
+      const auto& v0 = v0s[sorted_v0[iv0]];
+      float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+      if (v0.collisionId >= 0) {
+        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+        pvX = collision.posX();
+        pvY = collision.posY();
+        pvZ = collision.posZ();
+      }
+      auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
+      auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
+      auto posTrackPar = getTrackParCov(posTrack);
+      auto negTrackPar = getTrackParCov(negTrack);
+      const bool built = helper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates);
+      prefitV0s[iv0] = helper.v0;
+      prefitV0Status[iv0] = built ? kPrefitSucceeded : kPrefitFailed;
+    });
+  }
+
   template <class TBCs, typename THistoRegistry, typename TCollisions, typename TTracks, typename TV0s, typename TMCParticles, typename TProducts>
   void buildV0s(THistoRegistry& histos, TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TMCParticles const& mcParticles, TProducts& products)
   {
@@ -1467,6 +1621,8 @@ class BuilderModule
       mcParticleIsReco.resize(mcParticles.size(), false);
     }
 
+    prefitV0Candidates(collisions, v0s, tracks);
+
     int nV0s = 0;
     // Loops over all V0s in the time frame
     histos.fill(HIST("hInputStatistics"), kV0CoresBase, v0s.size());
@@ -1581,7 +1737,14 @@ class BuilderModule
         }
       }
 
-      if (!straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
+      bool v0Built = false;
+      if (prefitV0Status[iv0] != kNotPrefitted) {
+        straHelper.v0 = prefitV0s[iv0];
+        v0Built = (prefitV0Status[iv0] == kPrefitSucceeded);
+      } else {
+        v0Built = straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates);
+      }
+      if (!v0Built) {
         products.v0dataLink(-1, -1);
         continue;
       }
@@ -2042,6 +2205,77 @@ class BuilderModule
   }
 
   //__________________________________________________
+  // fit the cascades of the list on several threads, ahead of buildCascades (useKF = false) or buildKFCascades (useKF = true)
+  template <bool useKF, typename TCollisions, typename TCascades, typename TTracks>
+  void prefitCascadeCandidates(TCollisions const& collisions, TCascades const& cascades, TTracks const& tracks)
+  {
+    prefitCascadeStatus.assign(cascades.size(), kNotPrefitted);
+    prefitCascades.resize(cascades.size());
+    if (baseOpts.nFitterThreads.value <= 1) {
+      return;
+    }
+    std::vector<std::size_t> candidates;
+    candidates.reserve(cascades.size());
+    for (size_t icascade = 0; icascade < cascades.size(); icascade++) {
+      auto const& cascade = cascades[sorted_cascade[icascade]];
+      if (cascade.collisionId >= 0 && eventSelectOpts.fillOnlySelectedCollisions && !isCollisionAccepted(collisions.rawIteratorAt(cascade.collisionId))) {
+        continue;
+      }
+      if (!useKF && baseOpts.useV0BufferForCascades && (cascade.v0Id < 0 || v0Map[cascade.v0Id] < 0)) {
+        continue; // V0 not cached, skipped by buildCascades
+      }
+      candidates.push_back(icascade);
+    }
+
+    fitInParallel(candidates.size(), [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t iCandidate) {
+      const std::size_t icascade = candidates[iCandidate];
+      auto const& cascade = cascades[sorted_cascade[icascade]];
+      float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+      if (cascade.collisionId >= 0) {
+        auto const& collision = collisions.rawIteratorAt(cascade.collisionId);
+        pvX = collision.posX();
+        pvY = collision.posY();
+        pvZ = collision.posZ();
+      }
+      auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
+      auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
+      auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
+      bool built = false;
+      if constexpr (useKF) {
+        built = helper.buildCascadeCandidateWithKF(cascade.collisionId, pvX, pvY, pvZ,
+                                                   posTrack,
+                                                   negTrack,
+                                                   bachTrack,
+                                                   baseOpts.mEnabledTables[kCascBBs],
+                                                   cascadeBuilderOpts.kfConstructMethod,
+                                                   cascadeBuilderOpts.kfTuneForOmega,
+                                                   cascadeBuilderOpts.kfUseV0MassConstraint,
+                                                   cascadeBuilderOpts.kfUseCascadeMassConstraint,
+                                                   cascadeBuilderOpts.kfDoDCAFitterPreMinimV0,
+                                                   cascadeBuilderOpts.kfDoDCAFitterPreMinimCasc);
+      } else if (baseOpts.useV0BufferForCascades) {
+        built = helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                             v0sFromCascades[v0Map[cascade.v0Id]],
+                                             posTrack,
+                                             negTrack,
+                                             bachTrack,
+                                             baseOpts.mEnabledTables[kCascBBs],
+                                             cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                             baseOpts.mEnabledTables[kCascCovs]);
+      } else {
+        built = helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                             posTrack,
+                                             negTrack,
+                                             bachTrack,
+                                             baseOpts.mEnabledTables[kCascBBs],
+                                             cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                             baseOpts.mEnabledTables[kCascCovs]);
+      }
+      prefitCascades[icascade] = helper.cascade;
+      prefitCascadeStatus[icascade] = built ? kPrefitSucceeded : kPrefitFailed;
+    });
+  }
+
   template <typename THistoRegistry, typename TCollisions, typename TTracks, typename TCascades, typename TMCParticles, typename TProducts>
   void buildCascades(THistoRegistry& histos, TCollisions const& collisions, TCascades const& cascades, TTracks const& tracks, TMCParticles const& mcParticles, TProducts& products)
   {
@@ -2057,6 +2291,7 @@ class BuilderModule
     if (!baseOpts.mEnabledTables[kStoredCascCores]) {
       return; // don't do if no request for cascades in place
     }
+    prefitCascadeCandidates<false>(collisions, cascades, tracks);
     int nCascades = 0;
     // Loops over all cascades in the time frame
     histos.fill(HIST("hInputStatistics"), kStoredCascCores, cascades.size());
@@ -2143,14 +2378,21 @@ class BuilderModule
           continue; // didn't work out, skip
         }
 
-        if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
-                                              v0sFromCascades[v0Map[cascade.v0Id]],
-                                              posTrack,
-                                              negTrack,
-                                              bachTrack,
-                                              baseOpts.mEnabledTables[kCascBBs],
-                                              cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
-                                              baseOpts.mEnabledTables[kCascCovs])) {
+        if (prefitCascadeStatus[icascade] != kNotPrefitted) {
+          straHelper.cascade = prefitCascades[icascade];
+          if (prefitCascadeStatus[icascade] == kPrefitFailed) {
+            products.cascdataLink(-1);
+            interlinks.cascadeToCascCores.push_back(-1);
+            continue; // didn't work out, skip
+          }
+        } else if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                                     v0sFromCascades[v0Map[cascade.v0Id]],
+                                                     posTrack,
+                                                     negTrack,
+                                                     bachTrack,
+                                                     baseOpts.mEnabledTables[kCascBBs],
+                                                     cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                                     baseOpts.mEnabledTables[kCascCovs])) {
           products.cascdataLink(-1);
           interlinks.cascadeToCascCores.push_back(-1);
           continue; // didn't work out, skip
@@ -2158,13 +2400,20 @@ class BuilderModule
       } else {
         // this processing path generates the entire cascade
         // from tracks, without any need to have V0s generated.
-        if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
-                                              posTrack,
-                                              negTrack,
-                                              bachTrack,
-                                              baseOpts.mEnabledTables[kCascBBs],
-                                              cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
-                                              baseOpts.mEnabledTables[kCascCovs])) {
+        if (prefitCascadeStatus[icascade] != kNotPrefitted) {
+          straHelper.cascade = prefitCascades[icascade];
+          if (prefitCascadeStatus[icascade] == kPrefitFailed) {
+            products.cascdataLink(-1);
+            interlinks.cascadeToCascCores.push_back(-1);
+            continue; // didn't work out, skip
+          }
+        } else if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                                     posTrack,
+                                                     negTrack,
+                                                     bachTrack,
+                                                     baseOpts.mEnabledTables[kCascBBs],
+                                                     cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                                     baseOpts.mEnabledTables[kCascCovs])) {
           products.cascdataLink(-1);
           interlinks.cascadeToCascCores.push_back(-1);
           continue; // didn't work out, skip
@@ -2520,6 +2769,7 @@ class BuilderModule
     if (!baseOpts.mEnabledTables[kStoredKFCascCores]) {
       return; // don't do if no request for cascades in place
     }
+    prefitCascadeCandidates<true>(collisions, cascades, tracks);
     int nCascades = 0;
     // Loops over all cascades in the time frame
     histos.fill(HIST("hInputStatistics"), kStoredKFCascCores, cascades.size());
@@ -2543,17 +2793,24 @@ class BuilderModule
       auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
       auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
       auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
-      if (!straHelper.buildCascadeCandidateWithKF(cascade.collisionId, pvX, pvY, pvZ,
-                                                  posTrack,
-                                                  negTrack,
-                                                  bachTrack,
-                                                  baseOpts.mEnabledTables[kCascBBs],
-                                                  cascadeBuilderOpts.kfConstructMethod,
-                                                  cascadeBuilderOpts.kfTuneForOmega,
-                                                  cascadeBuilderOpts.kfUseV0MassConstraint,
-                                                  cascadeBuilderOpts.kfUseCascadeMassConstraint,
-                                                  cascadeBuilderOpts.kfDoDCAFitterPreMinimV0,
-                                                  cascadeBuilderOpts.kfDoDCAFitterPreMinimCasc)) {
+      if (prefitCascadeStatus[icascade] != kNotPrefitted) {
+        straHelper.cascade = prefitCascades[icascade];
+        if (prefitCascadeStatus[icascade] == kPrefitFailed) {
+          products.kfcascdataLink(-1);
+          interlinks.cascadeToKFCascCores.push_back(-1);
+          continue; // didn't work out, skip
+        }
+      } else if (!straHelper.buildCascadeCandidateWithKF(cascade.collisionId, pvX, pvY, pvZ,
+                                                         posTrack,
+                                                         negTrack,
+                                                         bachTrack,
+                                                         baseOpts.mEnabledTables[kCascBBs],
+                                                         cascadeBuilderOpts.kfConstructMethod,
+                                                         cascadeBuilderOpts.kfTuneForOmega,
+                                                         cascadeBuilderOpts.kfUseV0MassConstraint,
+                                                         cascadeBuilderOpts.kfUseCascadeMassConstraint,
+                                                         cascadeBuilderOpts.kfDoDCAFitterPreMinimV0,
+                                                         cascadeBuilderOpts.kfDoDCAFitterPreMinimCasc)) {
         products.kfcascdataLink(-1);
         interlinks.cascadeToKFCascCores.push_back(-1);
         continue; // didn't work out, skip
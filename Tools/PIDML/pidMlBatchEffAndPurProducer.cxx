@@ -97,6 +97,8 @@ struct PidMlBatchEffAndPurProducer {
   Configurable<std::string> localPath{"localPath", "/home/mkabus/PIDML/", "Base path to the local directory with ONNX models"};
   Configurable<bool> useFixedTimestamp{"useFixedTimestamp", false, "Whether to use fixed timestamp from configurable instead of timestamp calculated from the data"};
   Configurable<uint64_t> fixedTimestamp{"fixedTimestamp", 1524176895000, "Hardcoded timestamp for tests"};
+  Configurable<int> batchSize{"batchSize", 1024, "Max number of tracks passed to a single ONNX inference run"};
+  Configurable<int> nThreads{"nThreads", 0, "Number of intra-op threads of the ONNX session (0: ONNX Runtime default)"};
 
   Filter trackFilter = requireGlobalTrackInFilter();
 
@@ -104,6 +106,7 @@ struct PidMlBatchEffAndPurProducer {
                                             aod::pidTPCFullPi, aod::pidTPCFullKa, aod::pidTPCFullPr, aod::pidTPCFullEl, aod::pidTPCFullMu,
                                             aod::pidTOFFullPi, aod::pidTOFFullKa, aod::pidTOFFullPr, aod::pidTOFFullEl, aod::pidTOFFullMu>>;
   std::vector<PidONNXModel<BigTracks>> models;
+  std::vector<std::vector<float>> mlCertainties;
 
   void initHistos()
   {
@@ -226,11 +229,18 @@ struct PidMlBatchEffAndPurProducer {
       uint64_t timestamp = useFixedTimestamp ? fixedTimestamp.value : bc.timestamp();
       for (const int32_t& pid : pdgPids.value)
         models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
-                                                    ccdbApi, timestamp, pid, 1.1, &detectorMomentumLimits.value[0]));
+                                                    ccdbApi, timestamp, pid, 1.1, &detectorMomentumLimits.value[0], nThreads.value));
     } else {
       for (const int32_t& pid : pdgPids.value)
         models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
-                                                    ccdbApi, -1, pid, 1.1, &detectorMomentumLimits.value[0]));
+                                                    ccdbApi, -1, pid, 1.1, &detectorMomentumLimits.value[0], nThreads.value));
+    }
+
+    // one batched inference per model for all tracks of the TF
+    mlCertainties.resize(pdgPids.value.size());
+    for (size_t i = 0; i < pdgPids.value.size(); ++i) {
+      models[i].setBatchSize(batchSize.value);
+      models[i].applyModelBatch(tracks, mlCertainties[i]);
     }
 
     for (const auto& mcPart : mcParticles) {
@@ -240,14 +250,16 @@ struct PidMlBatchEffAndPurProducer {
       }
     }
 
+    size_t row = 0;
     for (const auto& track : tracks) {
+      const size_t trackRow = row++;
       if (track.has_mcParticle()) {
         auto mcPart = track.mcParticle();
         if (mcPart.isPhysicalPrimary()) {
           fillTrackedHist(mcPart.pdgCode(), track.pt());
 
           for (size_t i = 0; i < pdgPids.value.size(); ++i) {
-            float mlCertainty = models[i].applyModel(track);
+            float mlCertainty = mlCertainties[i][trackRow];
             nSigma_t nSigma = getNSigma(track, pdgPids.value[i]);
             bool isMCPid = mcPart.pdgCode() == pdgPids.value[i];
 
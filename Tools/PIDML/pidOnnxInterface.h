@@ -94,6 +94,18 @@ struct PidONNXInterface {
     return -1.0f;
   }
 
+  void applyModelBatch(const T& tracks, int pid, std::vector<float>& certainties)
+  {
+    for (std::size_t i = 0; i < mNPids; i++) {
+      if (mModels[i].mPid == pid) {
+        mModels[i].applyModelBatch(tracks, certainties);
+        return;
+      }
+    }
+    LOG(error) << "No suitable PID ML model found for expected pid: " << pid;
+    certainties.assign(tracks.size(), -1.0f);
+  }
+
   bool applyModelBoolean(const T::iterator& track, int pid)
   {
     for (std::size_t i = 0; i < mNPids; i++) {
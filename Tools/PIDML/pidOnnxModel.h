@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
@@ -83,7 +84,7 @@ template <typename T>
 struct PidONNXModel {
  public:
   PidONNXModel(std::string const& localPath, std::string const& ccdbPath, bool useCCDB, o2::ccdb::CcdbApi const& ccdbApi, uint64_t timestamp,
-               int pid, double minCertainty, const double* pLimits = &pidml_pt_cuts::defaultModelPLimits[0])
+               int pid, double minCertainty, const double* pLimits = &pidml_pt_cuts::defaultModelPLimits[0], int nThreads = 0)
     : mPid(pid), mMinCertainty(minCertainty), mPLimits(pLimits, pLimits + kNDetectors)
   {
     assert(mPLimits.size() == kNDetectors);
@@ -92,6 +93,9 @@ struct PidONNXModel {
     loadInputFiles(localPath, ccdbPath, useCCDB, ccdbApi, timestamp, pid, modelFile);
 
     Ort::SessionOptions sessionOptions;
+    if (nThreads > 0) {
+      sessionOptions.SetIntraOpNumThreads(nThreads);
+    }
     mEnv = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "pid-onnx-inferer");
     LOG(info) << "Loading ONNX model from file: " << modelFile;
     mSession.reset(new Ort::Session{*mEnv, modelFile.c_str(), sessionOptions});
@@ -141,6 +145,79 @@ struct PidONNXModel {
     return getModelOutput(track) >= mMinCertainty;
   }
 
+  /// Apply the model to all tracks of a table with batched inference.
+  /// Features are filled column-wise into a reusable matrix. Tracks are grouped by the available
+  /// detectors, so that all rows of one inference chunk have the same layout of missing values.
+  /// \param tracks table with the tracks to be classified
+  /// \param certainties output, one model certainty per track in the iteration order of the table
+  void applyModelBatch(const T& tracks, std::vector<float>& certainties)
+  {
+    const std::size_t nRows = tracks.size();
+    const std::size_t nColumns = mTrainColumns.size();
+    certainties.assign(nRows, 0.f);
+    if (nRows == 0) {
+      return;
+    }
+
+    // Sort rows into groups of the same detector mask (counting sort, stable)
+    std::array<std::size_t, NDetectorMasks + 1> groupOffsets{};
+    mBatchMasks.resize(nRows);
+    std::size_t row = 0;
+    for (const auto& track : tracks) {
+      const uint8_t mask = getDetectorMask(track);
+      mBatchMasks[row++] = mask;
+      ++groupOffsets[mask + 1];
+    }
+    for (std::size_t g = 0; g < NDetectorMasks; ++g) {
+      groupOffsets[g + 1] += groupOffsets[g];
+    }
+    std::array<std::size_t, NDetectorMasks> groupFill{};
+    std::copy(groupOffsets.begin(), groupOffsets.begin() + NDetectorMasks, groupFill.begin());
+    mBatchPositions.resize(nRows);
+    for (row = 0; row < nRows; ++row) {
+      mBatchPositions[row] = groupFill[mBatchMasks[row]]++;
+    }
+
+    // Fill the feature matrix column by column
+    mBatchFeatures.resize(nRows * nColumns);
+    for (std::size_t i = 0; i < nColumns; ++i) {
+      const uint8_t requiredMask = mColumnMasks[i];
+      const auto& scalingParams = mColumnScaling[i];
+      const auto getter = mGetters[i];
+      row = 0;
+      for (const auto& track : tracks) {
+        float value = std::numeric_limits<float>::quiet_NaN();
+        if ((mBatchMasks[row] & requiredMask) == requiredMask) {
+          value = getter(track);
+          if (scalingParams) {
+            value = scale(value, scalingParams.value());
+          }
+        }
+        mBatchFeatures[mBatchPositions[row] * nColumns + i] = value;
+        ++row;
+      }
+    }
+
+    // Run the inference in chunks that do not cross detector mask groups
+    mBatchOutput.resize(nRows);
+    for (std::size_t g = 0; g < NDetectorMasks; ++g) {
+      for (std::size_t first = groupOffsets[g]; first < groupOffsets[g + 1]; first += mBatchSize) {
+        const std::size_t nChunk = std::min(mBatchSize, groupOffsets[g + 1] - first);
+        runInference(&mBatchFeatures[first * nColumns], nChunk, &mBatchOutput[first]);
+      }
+    }
+
+    for (row = 0; row < nRows; ++row) {
+      certainties[row] = mBatchOutput[mBatchPositions[row]];
+    }
+  }
+
+  /// Set the maximum number of rows passed to a single inference run in applyModelBatch
+  void setBatchSize(std::size_t batchSize)
+  {
+    mBatchSize = std::max<std::size_t>(batchSize, 1);
+  }
+
   int mPid{0};
   double mMinCertainty{0};
 
@@ -207,6 +284,36 @@ struct PidONNXModel {
         mScalingParams[param[0].GetString()] = std::make_pair(param[1].GetFloat(), param[2].GetFloat());
       }
     }
+
+    // Resolve the per-column detector requirements and scaling parameters once
+    for (const auto& columnLabel : mTrainColumns) {
+      uint8_t requiredMask = 0;
+      if (columnLabel == "fTOFSignal" || columnLabel == "fBeta") {
+        requiredMask = MaskTOF;
+      } else if (columnLabel == "fTRDSignal" || columnLabel == "fTRDPattern") {
+        requiredMask = MaskTRD;
+      }
+      mColumnMasks.push_back(requiredMask);
+
+      auto scalingParamsEntry = mScalingParams.find(columnLabel);
+      if (scalingParamsEntry != mScalingParams.end()) {
+        mColumnScaling.emplace_back(scalingParamsEntry->second);
+      } else {
+        mColumnScaling.emplace_back(std::nullopt);
+      }
+    }
+  }
+
+  uint8_t getDetectorMask(const typename T::iterator& track) const
+  {
+    uint8_t mask = 0;
+    if (!pidml::pidutils::tofMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOF])) {
+      mask |= MaskTOF;
+    }
+    if (!pidml::pidutils::trdMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOFTRD])) {
+      mask |= MaskTRD;
+    }
+    return mask;
   }
 
   static float scale(float value, const std::pair<float, float>& scalingParams)
@@ -219,30 +326,18 @@ struct PidONNXModel {
     std::vector<float> output;
     output.reserve(mTrainColumns.size());
 
-    bool useTOF = !pidml::pidutils::tofMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOF]);
-    bool useTRD = !pidml::pidutils::trdMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOFTRD]);
+    const uint8_t mask = getDetectorMask(track);
 
     for (uint32_t i = 0; i < mTrainColumns.size(); ++i) {
-      auto& columnLabel = mTrainColumns[i];
-
-      if (
-        ((columnLabel == "fTRDSignal" || columnLabel == "fTRDPattern") && !useTRD) ||
-        ((columnLabel == "fTOFSignal" || columnLabel == "fBeta") && !useTOF)) {
+      if ((mask & mColumnMasks[i]) != mColumnMasks[i]) {
         output.push_back(std::numeric_limits<float>::quiet_NaN());
         continue;
       }
 
-      std::optional<std::pair<float, float>> scalingParams = std::nullopt;
-
-      auto scalingParamsEntry = mScalingParams.find(columnLabel);
-      if (scalingParamsEntry != mScalingParams.end()) {
-        scalingParams = scalingParamsEntry->second;
-      }
-
       float value = mGetters[i](track);
 
-      if (scalingParams) {
-        value = scale(value, scalingParams.value());
+      if (mColumnScaling[i]) {
+        value = scale(value, mColumnScaling[i].value());
       }
 
       output.push_back(value);
@@ -253,19 +348,24 @@ struct PidONNXModel {
 
   float getModelOutput(const typename T::iterator& track)
   {
-    // First rank of the expected model input is -1 which means that it is dynamic axis.
-    // Axis is exported as dynamic to make it possible to run model inference with the batch of
-    // tracks at once in the future (batch would need to have the same amount of quiet_NaNs in each row).
-    // For now we hardcode 1.
-    static constexpr int64_t BatchSize = 1;
+    std::vector<float> inputTensorValues = getValues(track);
+    float certainty = 0.f;
+    runInference(inputTensorValues.data(), 1, &certainty);
+    return certainty;
+  }
+
+  // Runs the model on nRows consecutive rows of the feature matrix pointed by input.
+  // First rank of the expected model input is -1 which means that it is a dynamic axis,
+  // so the same session serves both the single-track and the batched path.
+  void runInference(float* input, std::size_t nRows, float* output)
+  {
     auto inputShape = mInputShapes[0];
-    inputShape[0] = BatchSize;
+    inputShape[0] = static_cast<int64_t>(nRows);
+    const std::size_t nValues = nRows * mTrainColumns.size();
 
-    std::vector<float> inputTensorValues = getValues(track);
     std::vector<Ort::Value> inputTensors;
-
     Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-    inputTensors.emplace_back(Ort::Value::CreateTensor<float>(memInfo, inputTensorValues.data(), inputTensorValues.size(), inputShape.data(), inputShape.size()));
+    inputTensors.emplace_back(Ort::Value::CreateTensor<float>(memInfo, input, nValues, inputShape.data(), inputShape.size()));
 
     // Double-check the dimensions of the input tensor
     assert(inputTensors[0].IsTensor() &&
@@ -288,13 +388,17 @@ struct PidONNXModel {
       assert(outputTensors.size() == mOutputNames.size() && outputTensors[0].IsTensor());
       LOG(debug) << "output tensor shape: " << printShape(outputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
 
-      const float* outputValue = outputTensors[0].GetTensorData<float>();
-      float certainty = *outputValue;
-      return certainty;
+      // The certainty is the first value of each output row
+      const float* outputValues = outputTensors[0].GetTensorData<float>();
+      const std::size_t rowStride = outputTensors[0].GetTensorTypeAndShapeInfo().GetElementCount() / nRows;
+      for (std::size_t row = 0; row < nRows; ++row) {
+        output[row] = outputValues[row * rowStride];
+      }
+      return;
     } catch (const Ort::Exception& exception) {
       LOG(error) << "Error running model inference: " << exception.what();
     }
-    return false; // unreachable code
+    std::fill(output, output + nRows, 0.f);
   }
 
   // Pretty prints a shape dimension vector
@@ -307,9 +411,23 @@ struct PidONNXModel {
     return ss.str();
   }
 
+  static constexpr uint8_t MaskTOF = 0x1;
+  static constexpr uint8_t MaskTRD = 0x2;
+  static constexpr std::size_t NDetectorMasks = 4;
+  static constexpr std::size_t DefaultBatchSize = 1024;
+
   std::vector<std::string> mTrainColumns;
   std::vector<float (*)(const typename T::iterator&)> mGetters;
   std::map<std::string, std::pair<float, float>> mScalingParams;
+  std::vector<uint8_t> mColumnMasks;                                  // detectors required by each training column
+  std::vector<std::optional<std::pair<float, float>>> mColumnScaling; // scaling parameters of each training column
+
+  // Reusable buffers of the batched inference
+  std::size_t mBatchSize{DefaultBatchSize};
+  std::vector<float> mBatchFeatures;
+  std::vector<float> mBatchOutput;
+  std::vector<uint8_t> mBatchMasks;
+  std::vector<std::size_t> mBatchPositions;
 
   std::shared_ptr<Ort::Env> mEnv = nullptr;
   // No empty constructors for Session, we need a pointer
@@ -29,8 +29,13 @@
 #include <Framework/InitContext.h>
 #include <Framework/runDataProcessing.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -59,6 +64,9 @@ struct SimpleApplyPidOnnxModel {
   Configurable<bool> useFixedTimestamp{"useFixedTimestamp", false, "Whether to use fixed timestamp from configurable instead of timestamp calculated from the data"};
   Configurable<uint64_t> fixedTimestamp{"fixedTimestamp", 1524176895000, "Hardcoded timestamp for tests"};
 
+  Configurable<int> batchSize{"batchSize", 1024, "Max number of tracks passed to a single ONNX inference run in batched mode"};
+  Configurable<int> nThreads{"nThreads", 0, "Number of intra-op threads of the ONNX session (0: ONNX Runtime default)"};
+
   o2::ccdb::CcdbApi ccdbApi;
   int currentRunNumber = -1;
 
@@ -70,13 +78,15 @@ struct SimpleApplyPidOnnxModel {
   // Filter on isGlobalTrack (TracksSelection)
   using BigTracks = soa::Filtered<soa::Join<aod::FullTracks, aod::TracksDCA, aod::pidTOFbeta, aod::TrackSelection, aod::TOFSignal>>;
   PidONNXModel<BigTracks> pidModel; // One instance per model, e.g., one per each pid to predict
+  std::vector<float> certainties;   // Output buffer of the batched inference
 
   void init(InitContext const&)
   {
     if (useCcdb) {
       ccdbApi.init(ccdbUrl);
     } else {
-      pidModel = PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value, ccdbApi, -1, pdgPid.value, certainty.value);
+      pidModel = PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value, ccdbApi, -1, pdgPid.value, certainty.value, &pidml_pt_cuts::defaultModelPLimits[0], nThreads.value);
+      pidModel.setBatchSize(batchSize.value);
     }
   }
 
@@ -85,7 +95,8 @@ struct SimpleApplyPidOnnxModel {
     auto bc = collisions.iteratorAt(0).bc_as<aod::BCsWithTimestamps>();
     if (useCcdb && bc.runNumber() != currentRunNumber) {
       uint64_t timestamp = useFixedTimestamp ? fixedTimestamp.value : bc.timestamp();
-      pidModel = PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value, ccdbApi, timestamp, pdgPid.value, certainty.value);
+      pidModel = PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value, ccdbApi, timestamp, pdgPid.value, certainty.value, &pidml_pt_cuts::defaultModelPLimits[0], nThreads.value);
+      pidModel.setBatchSize(batchSize.value);
     }
 
     for (const auto& track : tracks) {
@@ -107,6 +118,44 @@ struct SimpleApplyPidOnnxModel {
     }
   }
   PROCESS_SWITCH(SimpleApplyPidOnnxModel, processTracksOnly, "Process with tracks only -- faster but no CCDB", false);
+
+  void processTracksOnlyBatched(BigTracks const& tracks)
+  {
+    pidModel.applyModelBatch(tracks, certainties);
+    size_t row = 0;
+    for (const auto& track : tracks) {
+      pidMLResults(track.index(), pdgPid.value, certainties[row++] >= certainty.value);
+    }
+  }
+  PROCESS_SWITCH(SimpleApplyPidOnnxModel, processTracksOnlyBatched, "Process with tracks only with batched inference -- no CCDB", false);
+
+  // Throughput comparison of the per-track and the batched inference on the same tracks
+  void processBenchmark(BigTracks const& tracks)
+  {
+    if (tracks.size() == 0) {
+      return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<float> perTrack;
+    perTrack.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      perTrack.push_back(pidModel.applyModel(track));
+    }
+    auto middle = std::chrono::steady_clock::now();
+    pidModel.applyModelBatch(tracks, certainties);
+    auto stop = std::chrono::steady_clock::now();
+
+    float maxDiff = 0.f;
+    for (size_t i = 0; i < perTrack.size(); ++i) {
+      maxDiff = std::max(maxDiff, std::abs(perTrack[i] - certainties[i]));
+    }
+    double perTrackSeconds = std::chrono::duration<double>(middle - start).count();
+    double batchedSeconds = std::chrono::duration<double>(stop - middle).count();
+    LOGF(info, "PID ML benchmark: %d tracks, per-track %.1f tracks/s, batched %.1f tracks/s (batch size %d), speed-up %.2f, max certainty difference %g",
+         tracks.size(), tracks.size() / perTrackSeconds, tracks.size() / batchedSeconds, batchSize.value, perTrackSeconds / batchedSeconds, maxDiff);
+  }
+  PROCESS_SWITCH(SimpleApplyPidOnnxModel, processBenchmark, "Compare throughput of per-track and batched inference -- no CCDB", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)